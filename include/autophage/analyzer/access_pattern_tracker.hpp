@@ -1,7 +1,9 @@
 #pragma once
 
 #include <autophage/core/types.hpp>
+#include <autophage/profiler/access_tracking.hpp>
 
+#include <array>
 #include <string>
 #include <unordered_map>
 
@@ -18,18 +20,88 @@ struct SystemStats
 {
     std::string systemName;
     AccessPattern pattern = AccessPattern::Linear;
+
+    /// Entities processed in the frame being recorded, or else in the last completed one
     u32 processedEntities = 0;
+
+    // Totals over the window (see AccessPatternTracker::WINDOW_FRAMES)
+    u64 linearAccesses = 0;
+    u64 randomAccesses = 0;
+
+    /// Mean entity-index distance between consecutive random lookups (0 if unknown)
+    f64 meanStride = 0.0;
+
+    /// Fraction of random lookups that revisited a recently touched entity
+    f64 reuseRatio = 0.0;
+
+    /// Mean number of lookups between revisits of the same entity
+    f64 meanReuseDistance = 0.0;
+
+    /// Completed frames in which the system reported accesses or processed entities
+    u64 frames = 0;
 };
 
+/// @brief Classifies each system's component access pattern
+///
+/// Classification covers the last WINDOW_FRAMES frames in which a system reported accesses plus
+/// the frame being recorded, so a system whose pattern changes is reclassified once the old
+/// frames leave the window.
+/// @note Fed automatically by collect() from the per-system counters the ECS reports to the
+///       profiler; recordAccess() remains for code that reports manually (call endFrame() after
+///       each frame's reports).
 class AccessPatternTracker
 {
 public:
+    /// Random lookups whose mean stride is at most this many entities count as sequential
+    static constexpr f64 SEQUENTIAL_STRIDE = 4.0;
+
+    /// Share of sequential accesses at or above which a system is Linear (and at or below
+    /// 1 - this, Random)
+    static constexpr f64 DOMINANT_SHARE = 0.9;
+
+    /// Frames per system that classification covers
+    static constexpr usize WINDOW_FRAMES = 32;
+
+    /// @brief Add manually reported accesses to the current frame (`count` entities, each
+    ///        accessed once)
     void recordAccess(const std::string& systemName, AccessPattern pattern, u32 count);
+
+    /// @brief Add measured access counts and processed entities for a system to the current
+    ///        frame
+    void recordCounts(const std::string& systemName, const AccessCounts& counts,
+                      u64 entities = 0);
+
+    /// @brief Pull the per-system counts of the last completed profiler frame and end the frame
+    /// @note Call once per frame, after the profiler's endFrame().
+    void collect();
+
+    /// @brief Close the current frame: its counts join the window, evicting the oldest
+    void endFrame();
+
+    /// @brief Classify a set of counts
+    [[nodiscard]] static AccessPattern classify(const AccessCounts& counts) noexcept;
+
     [[nodiscard]] const std::unordered_map<std::string, SystemStats>& getStats() const;
     void reset();
 
 private:
+    /// Per-frame counts of one system, oldest overwritten first
+    struct Window
+    {
+        AccessCounts current;
+        std::array<AccessCounts, WINDOW_FRAMES> frames{};
+        usize next = 0;
+
+        u64 currentEntities = 0;
+        u64 lastEntities = 0;
+        bool reported = false;  // Anything recorded in the current frame
+    };
+
+    void update(const std::string& systemName, const AccessCounts& counts, u64 entities);
+    static void refresh(SystemStats& stats, const Window& window);
+
     std::unordered_map<std::string, SystemStats> stats_;
+    std::unordered_map<std::string, Window> windows_;
 };
 
 }  // namespace autophage::analyzer
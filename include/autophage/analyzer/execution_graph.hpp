@@ -0,0 +1,158 @@
+#pragma once
+
+/// @file execution_graph.hpp
+/// @brief Dependency graph of systems and critical-path analysis of a frame
+///
+/// Systems run in registration order, but only pairs whose component accesses conflict (one
+/// writes a type the other reads or writes, or either makes structural changes) actually have
+/// to. The graph keeps exactly those ordering edges, weights each system by its measured time
+/// and finds the longest chain: the critical path, the frame time a perfectly parallel
+/// scheduler could not beat. Systems on it limit the frame; systems off it have slack (they
+/// could start later, or overlap others, without delaying the frame).
+
+#include <autophage/analyzer/stats_collector.hpp>
+#include <autophage/core/type_id.hpp>
+#include <autophage/core/types.hpp>
+#include <autophage/ecs/system_access.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace autophage::analyzer {
+
+// =============================================================================
+// Graph Nodes
+// =============================================================================
+
+/// @brief One system as seen by the graph
+struct ExecutionNode
+{
+    String name;
+
+    /// Component types read and written (empty: unknown, conflicts with all)
+    ecs::ComponentAccessSet access;
+
+    /// Measured cost of one update
+    f64 costNs = 0.0;
+};
+
+/// @brief Check whether two nodes must keep their relative order
+[[nodiscard]] bool nodesConflict(const ExecutionNode& a, const ExecutionNode& b);
+
+/// @brief Which timing of a system to use as its node cost
+enum class SystemCost : u8
+{
+    Last,  // Most recent update (per-frame analysis)
+    Mean,  // Rolling mean (typical frame)
+    P99,   // Rolling 99th percentile (bad frame)
+};
+
+// =============================================================================
+// Critical Path Report
+// =============================================================================
+
+/// @brief Schedule figures of one node
+struct NodeSchedule
+{
+    f64 earliestStartNs = 0.0;
+    f64 earliestFinishNs = 0.0;
+    f64 latestStartNs = 0.0;
+
+    /// How long the node could be delayed without lengthening the frame
+    f64 slackNs = 0.0;
+
+    /// Share of the critical path length spent in this node (0 if not on the path)
+    f64 criticalShare = 0.0;
+
+    bool critical = false;
+};
+
+/// @brief Result of a critical-path analysis
+struct CriticalPathReport
+{
+    /// Sum of all node costs (frame time with no overlap)
+    f64 serialNs = 0.0;
+
+    /// Length of the longest dependency chain (frame time with unlimited cores)
+    f64 criticalPathNs = 0.0;
+
+    /// serialNs / criticalPathNs: average number of systems that could run at once
+    f64 parallelism = 1.0;
+
+    /// Sum of node slack
+    f64 totalSlackNs = 0.0;
+
+    /// Node indices along the critical path, in execution order
+    std::vector<usize> criticalPath;
+
+    /// Per node, indexed like the graph
+    std::vector<NodeSchedule> nodes;
+};
+
+// =============================================================================
+// Execution Graph
+// =============================================================================
+
+/// @brief Dependency DAG of systems in execution order
+class ExecutionGraph
+{
+public:
+    /// @brief Append a node after all nodes added so far; edges to conflicting nodes are added
+    /// @return Node index
+    usize addNode(ExecutionNode node);
+
+    /// @brief Build a graph from ECS system statistics (ecs::SystemStats or compatible)
+    /// @note Any range whose elements have name, lastNs, meanNs, p99Ns and access (with reads,
+    ///       writes and structural) works, so the analyzer needs only the header-only
+    ///       ComponentAccessSet, not the ECS library.
+    template <typename Range>
+    [[nodiscard]] static ExecutionGraph fromSystems(const Range& systems,
+                                                    SystemCost cost = SystemCost::Mean)
+    {
+        ExecutionGraph graph;
+        for (const auto& stats : systems) {
+            ExecutionNode node;
+            node.name = stats.name;
+            node.access.reads = stats.access.reads;
+            node.access.writes = stats.access.writes;
+            node.access.structural = stats.access.structural;
+            switch (cost) {
+                case SystemCost::Last:
+                    node.costNs = stats.lastNs;
+                    break;
+                case SystemCost::Mean:
+                    node.costNs = stats.meanNs;
+                    break;
+                case SystemCost::P99:
+                    node.costNs = stats.p99Ns;
+                    break;
+            }
+            graph.addNode(std::move(node));
+        }
+        return graph;
+    }
+
+    [[nodiscard]] usize nodeCount() const noexcept { return nodes_.size(); }
+    [[nodiscard]] const ExecutionNode& node(usize index) const { return nodes_[index]; }
+
+    /// @brief Earlier nodes this node must wait for (direct edges, ascending)
+    [[nodiscard]] const std::vector<usize>& dependencies(usize index) const
+    {
+        return dependencies_[index];
+    }
+
+    /// @brief Update a node's cost (e.g. with a new frame's timing)
+    void setCost(usize index, f64 costNs) { nodes_[index].costNs = costNs; }
+
+    /// @brief Compute the critical path and per-node slack
+    [[nodiscard]] CriticalPathReport analyze() const;
+
+    /// @brief Turn a report into hints about what to split or parallelize
+    [[nodiscard]] std::vector<OptimizationHint> hints(const CriticalPathReport& report) const;
+
+private:
+    std::vector<ExecutionNode> nodes_;
+    std::vector<std::vector<usize>> dependencies_;
+};
+
+}  // namespace autophage::analyzer
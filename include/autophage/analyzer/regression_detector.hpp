@@ -0,0 +1,192 @@
+#pragma once
+
+/// @file regression_detector.hpp
+/// @brief Before/after statistical comparison of a system around variant switches
+///
+/// Frame timings are noisy, skewed and full of outliers, so comparing two means invites
+/// switching on noise. The detector keeps recent per-update costs of each subject (normally a
+/// system, normalized per processed entity so a changing population doesn't look like a
+/// regression). When a trial begins (a variant switch or hot-swap) those samples become the
+/// baseline; once enough samples of the new configuration arrive, the two sets are compared
+/// with a Mann-Whitney U test (rank based, no normality assumption) and a bootstrap
+/// confidence interval on the ratio of medians, and a verdict with its confidence is produced.
+
+#include <autophage/core/types.hpp>
+
+#include <deque>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace autophage::analyzer {
+
+// =============================================================================
+// Statistical Tests
+// =============================================================================
+
+/// @brief Result of a two-sided Mann-Whitney U test
+struct MannWhitneyResult
+{
+    /// U statistic of the second sample (large when its values tend to be larger)
+    f64 u = 0.0;
+
+    /// Normal approximation z-score, with tie and continuity correction
+    f64 z = 0.0;
+
+    /// Two-sided p-value (1 when either sample is empty)
+    f64 pValue = 1.0;
+};
+
+/// @brief Test whether two samples come from the same distribution
+[[nodiscard]] MannWhitneyResult mannWhitneyU(std::span<const f64> a, std::span<const f64> b);
+
+/// @brief Median of a sample (0 when empty)
+[[nodiscard]] f64 median(std::span<const f64> values);
+
+/// @brief Bootstrap confidence interval for median(b) / median(a) - 1
+/// @param confidence Two-sided confidence level, e.g. 0.95
+/// @return {low, high}; {0, 0} when either sample is empty
+[[nodiscard]] std::pair<f64, f64> bootstrapMedianChange(std::span<const f64> a,
+                                                        std::span<const f64> b,
+                                                        f64 confidence, u32 iterations,
+                                                        u64 seed);
+
+// =============================================================================
+// Verdicts
+// =============================================================================
+
+/// @brief Outcome of comparing a candidate configuration against its baseline
+enum class RegressionVerdict : u8
+{
+    Improved,      // Candidate is significantly cheaper
+    Regressed,     // Candidate is significantly more expensive
+    NoChange,      // No difference beyond noise (or below the minimum effect)
+    Inconclusive,  // Not enough baseline samples to judge
+};
+
+/// @brief Convert verdict to string
+[[nodiscard]] constexpr StringView toString(RegressionVerdict verdict) noexcept
+{
+    switch (verdict) {
+        case RegressionVerdict::Improved:
+            return "Improved";
+        case RegressionVerdict::Regressed:
+            return "Regressed";
+        case RegressionVerdict::NoChange:
+            return "NoChange";
+        case RegressionVerdict::Inconclusive:
+            return "Inconclusive";
+    }
+    return "Unknown";
+}
+
+/// @brief Detector configuration
+struct RegressionConfig
+{
+    /// Samples required on each side before a verdict
+    usize minSamples = 30;
+
+    /// Recent samples kept per subject (the baseline at most)
+    usize maxSamples = 256;
+
+    /// Samples dropped right after a switch (cold caches, first-use allocations)
+    usize warmupSamples = 5;
+
+    /// Two-sided confidence required for Improved/Regressed
+    f64 confidence = 0.95;
+
+    /// Smallest relative change in medians worth acting on
+    f64 minEffect = 0.03;
+
+    u32 bootstrapIterations = 1000;
+    u64 seed = 0x9E3779B97F4A7C15ull;
+};
+
+/// @brief Verdict of one trial
+struct RegressionResult
+{
+    String subject;
+    String baselineLabel;
+    String candidateLabel;
+
+    RegressionVerdict verdict = RegressionVerdict::Inconclusive;
+
+    /// 1 - p-value of the Mann-Whitney test
+    f64 confidence = 0.0;
+    f64 pValue = 1.0;
+
+    f64 baselineMedian = 0.0;
+    f64 candidateMedian = 0.0;
+
+    /// candidateMedian / baselineMedian - 1 (positive: slower)
+    f64 relativeChange = 0.0;
+
+    /// Bootstrap confidence interval of relativeChange
+    f64 changeLow = 0.0;
+    f64 changeHigh = 0.0;
+
+    usize baselineSamples = 0;
+    usize candidateSamples = 0;
+};
+
+/// @brief Compare two samples and classify the change of `candidate` relative to `baseline`
+[[nodiscard]] RegressionResult compareSamples(std::span<const f64> baseline,
+                                              std::span<const f64> candidate,
+                                              const RegressionConfig& config = {});
+
+// =============================================================================
+// Regression Detector
+// =============================================================================
+
+/// @brief Tracks subjects' recent costs and judges trials started by configuration switches
+/// @note Not thread-safe; fed from the optimizer once per frame.
+class RegressionDetector
+{
+public:
+    explicit RegressionDetector(const RegressionConfig& config = {});
+
+    /// @brief Record one update of a subject
+    /// @param cost Cost of the update (e.g. nanoseconds)
+    /// @param units Work processed (e.g. entities); the sample is cost / units when units > 0
+    void addSample(StringView subject, f64 cost, u64 units = 0);
+
+    /// @brief Start comparing a new configuration against the subject's recent samples
+    /// @note Replaces any trial already running for the subject.
+    void beginTrial(StringView subject, StringView baselineLabel, StringView candidateLabel);
+
+    /// @brief Abandon a running trial, keeping the samples recorded since it began
+    void cancelTrial(StringView subject);
+
+    /// @brief Check whether a trial is running for the subject
+    [[nodiscard]] bool hasTrial(StringView subject) const;
+
+    /// @brief Judge the subject's trial once the candidate has enough samples
+    /// @return The verdict (the trial ends and the candidate becomes the new history), or
+    ///         nothing while no trial is running or samples are still being gathered
+    [[nodiscard]] Optional<RegressionResult> evaluate(StringView subject);
+
+    /// @brief Forget a subject entirely
+    void reset(StringView subject);
+
+    [[nodiscard]] const RegressionConfig& config() const noexcept { return config_; }
+
+private:
+    struct Subject
+    {
+        std::deque<f64> recent;
+        std::vector<f64> baseline;
+        String baselineLabel;
+        String candidateLabel;
+        usize warmupRemaining = 0;
+        bool trialActive = false;
+    };
+
+    [[nodiscard]] Subject* find(StringView subject);
+    [[nodiscard]] const Subject* find(StringView subject) const;
+
+    RegressionConfig config_;
+    std::unordered_map<String, Subject> subjects_;
+};
+
+}  // namespace autophage::analyzer
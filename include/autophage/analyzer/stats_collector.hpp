@@ -1,8 +1,11 @@
 #pragma once
 
+#include <autophage/analyzer/time_series.hpp>
 #include <autophage/core/types.hpp>
+#include <autophage/profiler/metrics.hpp>
 #include <autophage/profiler/profiler.hpp>
 
+#include <chrono>
 #include <string>
 #include <vector>
 
@@ -15,14 +18,89 @@ struct OptimizationHint
     u8 severity;  // 0=Info, 1=Warning, 2=Critical
 };
 
+/// @brief One value added to a series
+struct SeriesSample
+{
+    SeriesId series = INVALID_SERIES_ID;
+    f64 value = 0.0;
+};
+
+/// @brief Samples the profiler once per frame into a time-series store and derives hints
+///
+/// Every collect() appends the latest frame to fixed series (frame time, FPS, entity count,
+/// memory, allocation and hardware counters), one series per named metric ("metric/<name>")
+/// and one per zone recorded by the calling thread ("zone/<name>", summed over calls, in ms).
+/// Decisions can then look at windowed aggregates instead of a single snapshot.
 class StatsCollector
 {
 public:
+    // Fixed series names
+    static constexpr StringView FRAME_TIME_MS = "frame.time_ms";
+    static constexpr StringView FPS = "frame.fps";
+    static constexpr StringView ENTITY_COUNT = "frame.entities";
+    static constexpr StringView MEMORY_USED = "memory.used_bytes";
+    static constexpr StringView ALLOCATED_BYTES = "memory.allocated_bytes";
+    static constexpr StringView ALLOCATION_COUNT = "memory.allocations";
+    static constexpr StringView CACHE_MISSES = "hw.cache_misses";
+    static constexpr StringView BRANCH_MISPREDICTIONS = "hw.branch_mispredictions";
+    static constexpr StringView DTLB_MISSES = "hw.dtlb_misses";
+
+    StatsCollector();
+
+    /// @brief Sample the profiler at the current steady-clock time
     void collect();
+
+    /// @brief Sample the profiler at an explicit time (seconds, non-decreasing)
+    void collect(f64 timeSeconds);
+
+    /// @brief Move the sample time without sampling the profiler (replaying recorded samples)
+    void advance(f64 timeSeconds) noexcept { lastTime_ = timeSeconds; }
+
+    /// @brief Add an application-provided sample to a named series at the last collect() time
+    void record(StringView series, f64 value);
+
+    /// @brief Also append every sample recorded from now on to `out` (nullptr to stop)
+    /// @note The caller owns and clears the vector; names resolve through timeSeries().
+    void captureSamples(std::vector<SeriesSample>* out) noexcept { capture_ = out; }
+
+    /// @brief Time of the last collect() or advance(), in seconds
+    [[nodiscard]] f64 lastTime() const noexcept { return lastTime_; }
+
     [[nodiscard]] std::vector<OptimizationHint> analyze() const;
 
+    /// @brief Aggregate a series by name over a window ending at the last collect() time
+    [[nodiscard]] WindowAggregate aggregate(StringView series, TimeWindow window) const;
+
+    [[nodiscard]] const TimeSeriesStore& timeSeries() const noexcept { return store_; }
+
+    /// @brief Latest aggregated profiler statistics (spike counts, percentiles)
+    [[nodiscard]] const ProfilerStats& profilerStats() const noexcept { return latest_; }
+
 private:
-    ProfilerStats currentStub_;
+    /// @brief Record a sample at the last collect() time
+    void put(SeriesId id, f64 value);
+
+    struct FixedSeries
+    {
+        SeriesId frameTime = INVALID_SERIES_ID;
+        SeriesId fps = INVALID_SERIES_ID;
+        SeriesId entityCount = INVALID_SERIES_ID;
+        SeriesId memoryUsed = INVALID_SERIES_ID;
+        SeriesId allocatedBytes = INVALID_SERIES_ID;
+        SeriesId allocationCount = INVALID_SERIES_ID;
+        SeriesId cacheMisses = INVALID_SERIES_ID;
+        SeriesId branchMispredictions = INVALID_SERIES_ID;
+        SeriesId dtlbMisses = INVALID_SERIES_ID;
+    };
+
+    TimeSeriesStore store_;
+    FixedSeries fixed_;
+    std::vector<SeriesId> zoneSeries_;    // Indexed by ZoneId
+    std::vector<SeriesId> metricSeries_;  // Indexed by MetricId
+    ProfilerStats latest_;
+    std::chrono::steady_clock::time_point start_;
+    f64 lastTime_ = 0.0;
+    std::vector<SeriesSample>* capture_ = nullptr;
 };
 
 }  // namespace autophage::analyzer
@@ -0,0 +1,153 @@
+#pragma once
+
+/// @file time_series.hpp
+/// @brief Compact in-memory time-series store with downsampled tiers
+///
+/// Every series is kept at three resolutions: 10ms buckets over the last second, 100ms buckets
+/// over the last 10 seconds and 1s buckets over the last 5 minutes. Each bucket stores count,
+/// sum, sum of squares, min and max, so means, deviations and extremes over any of the windows
+/// come out of at most a few hundred buckets regardless of frame rate. Buckets are stored
+/// column by column per tier and reused as a ring, so memory is fixed per series.
+
+#include <autophage/core/types.hpp>
+
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace autophage::analyzer {
+
+// =============================================================================
+// Windows
+// =============================================================================
+
+/// @brief Window length (and matching resolution tier) for aggregates
+enum class TimeWindow : u8
+{
+    Last1s,    // 10ms buckets
+    Last10s,   // 100ms buckets
+    Last5min,  // 1s buckets
+
+    Count
+};
+
+inline constexpr usize TIME_WINDOW_COUNT = static_cast<usize>(TimeWindow::Count);
+
+/// @brief Convert time window to string
+[[nodiscard]] constexpr StringView toString(TimeWindow window) noexcept
+{
+    switch (window) {
+        case TimeWindow::Last1s:
+            return "1s";
+        case TimeWindow::Last10s:
+            return "10s";
+        case TimeWindow::Last5min:
+            return "5min";
+        case TimeWindow::Count:
+            break;
+    }
+    return "Unknown";
+}
+
+/// @brief Aggregate of one series over a window
+struct WindowAggregate
+{
+    u64 count = 0;
+    f64 sum = 0.0;
+    f64 mean = 0.0;
+    f64 stddev = 0.0;
+    f64 min = 0.0;
+    f64 max = 0.0;
+
+    /// Least-squares slope of the bucket means, in value units per second (0 with < 2 buckets)
+    f64 slopePerSecond = 0.0;
+
+    [[nodiscard]] bool empty() const noexcept { return count == 0; }
+};
+
+// =============================================================================
+// Time Series Store
+// =============================================================================
+
+/// @brief Interned series identifier
+using SeriesId = u32;
+
+inline constexpr SeriesId INVALID_SERIES_ID = ~SeriesId{0};
+
+/// @brief Fixed-memory store of named series at three resolutions
+/// @note Not thread-safe; owned by the analyzer and fed from the frame loop.
+class TimeSeriesStore
+{
+public:
+    /// @brief Register (or look up) a series by name
+    [[nodiscard]] SeriesId series(StringView name);
+
+    /// @brief Find a series by name
+    [[nodiscard]] SeriesId findSeries(StringView name) const;
+
+    /// @brief Name of a series (empty for unknown ids)
+    [[nodiscard]] StringView seriesName(SeriesId id) const;
+
+    [[nodiscard]] usize seriesCount() const noexcept { return names_.size(); }
+
+    /// @brief Add a sample at a time in seconds (times should be non-decreasing)
+    void record(SeriesId id, f64 timeSeconds, f64 value);
+
+    /// @brief Add a sample to a series by name (registers it on first use)
+    void record(StringView name, f64 timeSeconds, f64 value)
+    {
+        record(series(name), timeSeconds, value);
+    }
+
+    /// @brief Aggregate the samples of a series that fall in the window ending at `now`
+    [[nodiscard]] WindowAggregate aggregate(SeriesId id, TimeWindow window, f64 now) const;
+
+    /// @brief Aggregate ending at the latest recorded time
+    [[nodiscard]] WindowAggregate aggregate(SeriesId id, TimeWindow window) const
+    {
+        return aggregate(id, window, latestTime_);
+    }
+
+    /// @brief Latest time passed to record()
+    [[nodiscard]] f64 latestTime() const noexcept { return latestTime_; }
+
+    /// @brief Drop all series and samples
+    void clear();
+
+private:
+    struct TierLayout
+    {
+        f64 bucketSeconds;
+        usize bucketCount;
+    };
+
+    static constexpr std::array<TierLayout, TIME_WINDOW_COUNT> TIERS = {{
+        {0.01, 100},
+        {0.1, 100},
+        {1.0, 300},
+    }};
+
+    /// @brief Buckets of one tier for every series, one column per field
+    struct Tier
+    {
+        std::vector<i64> bucket;  // Absolute bucket number held by each slot (-1: empty)
+        std::vector<u32> count;
+        std::vector<f64> sum;
+        std::vector<f64> sumSquares;
+        std::vector<f64> min;
+        std::vector<f64> max;
+    };
+
+    [[nodiscard]] static usize slotBase(SeriesId id, TimeWindow window) noexcept
+    {
+        return static_cast<usize>(id) * TIERS[static_cast<usize>(window)].bucketCount;
+    }
+
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, SeriesId> ids_;
+    std::array<Tier, TIME_WINDOW_COUNT> tiers_;
+    f64 latestTime_ = 0.0;
+};
+
+}  // namespace autophage::analyzer
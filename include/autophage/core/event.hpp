@@ -8,8 +8,11 @@
 #include <autophage/core/types.hpp>
 
 #include <algorithm>
+#include <array>
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include <memory_resource>
 #include <mutex>
 #include <unordered_map>
 #include <vector>
@@ -75,8 +78,12 @@ public:
         TypeId type = typeId<E>();
 
         // Copy listener list to avoid deadlocks/invalidation during callback
-        // if callback modifies subscriptions (rudimentary safety)
-        std::vector<std::function<void(const E&)>> callbacks;
+        // if callback modifies subscriptions (rudimentary safety). Up to INLINE_LISTENERS
+        // callbacks are copied into stack storage; larger lists fall back to the heap.
+        using Callback = std::function<void(const E&)>;
+        alignas(Callback) std::array<std::byte, INLINE_LISTENERS * sizeof(Callback)> storage;
+        std::pmr::monotonic_buffer_resource arena(storage.data(), storage.size());
+        std::pmr::vector<Callback> callbacks(&arena);
 
         {
             std::lock_guard<std::mutex> lock(mutex_);
@@ -97,6 +104,8 @@ public:
     }
 
 private:
+    static constexpr usize INLINE_LISTENERS = 8;
+
     struct IEventDispatcher
     {
         virtual ~IEventDispatcher() = default;
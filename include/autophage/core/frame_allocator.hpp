@@ -0,0 +1,101 @@
+#pragma once
+
+/// @file frame_allocator.hpp
+/// @brief Per-thread, double-buffered frame allocator
+///
+/// Every thread bump-allocates from its own arena, so frameAlloc() takes no lock. Each arena has
+/// two buffers that swap when the frame advances (beginFrame() calls advanceFrameAllocators()):
+/// memory allocated during frame N stays valid until the end of frame N+1, long enough to hand
+/// results from one frame to the next. Nothing is ever freed individually.
+///
+/// When a buffer fills up, a new block is chained on instead of failing. On reuse, a chained
+/// buffer is coalesced into one block of the combined size, so steady-state frames touch a single
+/// allocation.
+
+#include <autophage/core/platform.hpp>
+#include <autophage/core/types.hpp>
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace autophage {
+
+// =============================================================================
+// Frame Allocation
+// =============================================================================
+
+/// @brief Default size of a frame allocator block
+inline constexpr usize DEFAULT_FRAME_BLOCK_SIZE = usize{256} * 1024;
+
+/// @brief Allocate memory that lives until the end of the next frame
+/// @param size Size in bytes
+/// @param alignment Alignment requirement (power of 2)
+/// @return Pointer to allocated memory, or nullptr if the system is out of memory
+[[nodiscard]] void* frameAlloc(usize size, usize alignment = 16) noexcept;
+
+/// @brief Allocate an uninitialized array that lives until the end of the next frame
+template <typename T> [[nodiscard]] T* frameAllocArray(usize count) noexcept
+{
+    return static_cast<T*>(frameAlloc(sizeof(T) * count, alignof(T)));
+}
+
+/// @brief Start a new frame for every thread's arena
+/// @note Called by beginFrame(). Each thread swaps buffers lazily on its next allocation.
+void advanceFrameAllocators() noexcept;
+
+/// @brief Set the size of newly created blocks (existing blocks are kept)
+void setFrameAllocatorBlockSize(usize bytes) noexcept;
+
+/// @brief Frame allocator usage of the calling thread
+struct FrameAllocatorStats
+{
+    /// Bytes handed out by the buffer of the current frame
+    usize bytesThisFrame = 0;
+
+    /// Capacity of both buffers
+    usize capacity = 0;
+
+    /// Blocks chained because a buffer overflowed (cumulative)
+    u64 overflowBlocks = 0;
+};
+
+/// @brief Get frame allocator statistics for the calling thread
+[[nodiscard]] FrameAllocatorStats getFrameAllocatorStats() noexcept;
+
+// =============================================================================
+// Standard Library Adapter
+// =============================================================================
+
+/// @brief Standard allocator backed by frameAlloc (deallocation is a no-op)
+/// @note Containers using it must not outlive the next frame.
+template <typename T> class FrameStlAllocator
+{
+public:
+    using value_type = T;
+
+    FrameStlAllocator() noexcept = default;
+
+    template <typename U> FrameStlAllocator(const FrameStlAllocator<U>& /*other*/) noexcept {}
+
+    [[nodiscard]] T* allocate(usize count)
+    {
+        T* ptr = frameAllocArray<T>(count);
+        if (!ptr) AUTOPHAGE_UNLIKELY {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+
+    void deallocate(T* /*ptr*/, usize /*count*/) noexcept {}
+
+    template <typename U> bool operator==(const FrameStlAllocator<U>& /*other*/) const noexcept
+    {
+        return true;
+    }
+};
+
+/// @brief Vector whose storage lives in the frame allocator
+template <typename T> using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+
+}  // namespace autophage
@@ -3,11 +3,14 @@
 /// @file memory.hpp
 /// @brief Memory utilities and allocators for Autophage Engine
 
+#include <autophage/core/assert.hpp>
 #include <autophage/core/platform.hpp>
 #include <autophage/core/types.hpp>
 
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
+#include <mutex>
 #include <new>
 
 namespace autophage {
@@ -110,17 +113,113 @@ enum class MemoryTag : u16
     return "Unknown";
 }
 
+// =============================================================================
+// Current Memory Tag
+// =============================================================================
+
+namespace detail {
+
+/// @brief Heap activity of one thread, for attributing allocations to a code region
+struct ThreadAllocationCounters
+{
+    u64 allocations = 0;
+    u64 allocatedBytes = 0;
+};
+
+/// @brief The engine's thread-locals below, exported for code compiled by the JIT (which
+///        cannot define thread-locals of its own and must share the engine's anyway)
+[[nodiscard]] MemoryTag& engineCurrentMemoryTag() noexcept;
+[[nodiscard]] ThreadAllocationCounters& engineAllocationCounters() noexcept;
+
+#if defined(AUTOPHAGE_JIT_MODULE)
+[[nodiscard]] inline MemoryTag& currentMemoryTag() noexcept
+{
+    return engineCurrentMemoryTag();
+}
+
+[[nodiscard]] inline ThreadAllocationCounters& allocationCounters() noexcept
+{
+    return engineAllocationCounters();
+}
+#else
+/// Tag charged for untagged heap allocations made on this thread (see MemoryTagScope)
+inline thread_local MemoryTag t_currentMemoryTag = MemoryTag::Unknown;
+
+inline thread_local ThreadAllocationCounters t_allocationCounters;
+
+[[nodiscard]] AUTOPHAGE_FORCE_INLINE MemoryTag& currentMemoryTag() noexcept
+{
+    return t_currentMemoryTag;
+}
+
+[[nodiscard]] AUTOPHAGE_FORCE_INLINE ThreadAllocationCounters& allocationCounters() noexcept
+{
+    return t_allocationCounters;
+}
+#endif
+
+}  // namespace detail
+
+/// @brief Tag charged for untagged allocations on the calling thread
+[[nodiscard]] inline MemoryTag getCurrentMemoryTag() noexcept
+{
+    return detail::currentMemoryTag();
+}
+
+/// @brief RAII scope that charges untagged allocations on this thread to a tag
+/// @note Only global operator new/delete consult the current tag, and only when built with
+///       AUTOPHAGE_TRACK_GLOBAL_ALLOCATIONS. SystemRegistry opens a Systems scope around updates.
+class MemoryTagScope
+{
+public:
+    explicit MemoryTagScope(MemoryTag tag) noexcept : previous_(detail::currentMemoryTag())
+    {
+        detail::currentMemoryTag() = tag;
+    }
+
+    ~MemoryTagScope() { detail::currentMemoryTag() = previous_; }
+
+    MemoryTagScope(const MemoryTagScope&) = delete;
+    MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+
+private:
+    MemoryTag previous_;
+};
+
+/// @brief Whether global operator new/delete are routed through tagged tracking
+[[nodiscard]] constexpr bool isGlobalAllocationTrackingEnabled() noexcept
+{
+#if defined(AUTOPHAGE_TRACK_GLOBAL_ALLOCATIONS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+/// @brief Allocations made by the calling thread since it started (all tags)
+[[nodiscard]] inline detail::ThreadAllocationCounters getThreadAllocationCounters() noexcept
+{
+    return detail::allocationCounters();
+}
+
 // =============================================================================
 // Memory Statistics
 // =============================================================================
 
+/// @brief Number of memory tags (size of per-tag arrays)
+inline constexpr usize MEMORY_TAG_COUNT = static_cast<usize>(MemoryTag::Count);
+
 /// @brief Memory allocation statistics per tag
+/// @note Counters are cumulative since start-up (or the last reset); diff two snapshots for
+///       per-frame figures.
 struct MemoryStats
 {
     usize currentBytes = 0;
     usize peakBytes = 0;
     u64 totalAllocations = 0;
     u64 totalDeallocations = 0;
+    u64 totalAllocatedBytes = 0;
+    u64 totalFreedBytes = 0;
 };
 
 /// @brief Get memory statistics for a specific tag
@@ -132,10 +231,33 @@ struct MemoryStats
 /// @brief Reset memory statistics
 void resetMemoryStats() noexcept;
 
+/// @brief Record an allocation made outside the tagged allocation functions
+/// @note For allocators that manage their own memory; pair with trackDeallocation().
+void trackAllocation(MemoryTag tag, usize size) noexcept;
+
+/// @brief Record a deallocation made outside the tagged allocation functions
+void trackDeallocation(MemoryTag tag, usize size) noexcept;
+
+// =============================================================================
+// Allocation Sampling
+// =============================================================================
+
+/// @brief Callback for sampled allocations; runs on the allocating thread
+/// @note Allocations made by the hook itself are tracked but never sampled.
+using AllocationSampleHook = void (*)(MemoryTag tag, usize size);
+
+/// @brief Install (or clear, with nullptr) the allocation sample hook
+/// @param intervalBytes Average number of bytes allocated per thread between samples, so
+///        large allocations are proportionally more likely to be sampled
+void setAllocationSampleHook(AllocationSampleHook hook, usize intervalBytes) noexcept;
+
 // =============================================================================
 // Tagged Allocation Functions
 // =============================================================================
 
+// Tagged blocks carry a small header in front of the returned pointer recording the requested
+// size, so frees report exact byte counts. Always release them with taggedFree/taggedAlignedFree.
+
 /// @brief Allocate memory with tag for tracking
 [[nodiscard]] void* taggedAlloc(usize size, MemoryTag tag) noexcept;
 
@@ -148,6 +270,19 @@ void taggedAlignedFree(void* ptr, MemoryTag tag) noexcept;
 /// @brief Free tagged memory
 void taggedFree(void* ptr, MemoryTag tag) noexcept;
 
+/// @brief Requested size of a live tagged allocation
+[[nodiscard]] usize taggedAllocationSize(const void* ptr) noexcept;
+
+namespace detail {
+
+/// @brief Tracked malloc/free backing the global operator new/delete replacement
+/// @note The block's tag is recorded at allocation, so frees are charged correctly even when
+///       released under a different MemoryTagScope.
+[[nodiscard]] void* trackedHeapAlloc(usize size, usize alignment) noexcept;
+void trackedHeapFree(void* ptr) noexcept;
+
+}  // namespace detail
+
 // =============================================================================
 // Linear Allocator (Arena)
 // =============================================================================
@@ -299,11 +434,20 @@ public:
         }
     }
 
+    /// @brief Check whether a pointer lies inside this pool's blocks
+    [[nodiscard]] bool owns(const void* ptr) const noexcept
+    {
+        const auto* bytes = static_cast<const Byte*>(ptr);
+        return memory_ && bytes >= memory_ && bytes < memory_ + capacity_ * ALIGNED_BLOCK_SIZE;
+    }
+
     [[nodiscard]] usize allocated() const noexcept { return allocatedCount_; }
     [[nodiscard]] usize capacity() const noexcept { return capacity_; }
     [[nodiscard]] usize available() const noexcept { return capacity_ - allocatedCount_; }
 
 private:
+    static constexpr usize ALIGNED_BLOCK_SIZE = (BlockSize + Alignment - 1) & ~(Alignment - 1);
+
     Byte* memory_ = nullptr;
     void* freeList_ = nullptr;
     usize capacity_ = 0;
@@ -311,6 +455,294 @@ private:
     MemoryTag tag_;
 };
 
+// =============================================================================
+// Growable Pool Allocators
+// =============================================================================
+
+namespace detail {
+
+/// @brief Slabs of fixed-size blocks, chained so they can all be released together
+/// @note Slabs are only freed on destruction, so block memory stays readable for the lifetime of
+///       the pool (the lock-free free list relies on this).
+template <usize BlockSize, usize Alignment> class PoolSlabList
+{
+    static_assert(BlockSize >= sizeof(void*), "Block size must be at least pointer size");
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be power of 2");
+
+public:
+    static constexpr usize BLOCK_STRIDE = (BlockSize + Alignment - 1) & ~(Alignment - 1);
+
+    PoolSlabList(usize blocksPerSlab, MemoryTag tag) noexcept
+        : blocksPerSlab_(blocksPerSlab > 0 ? blocksPerSlab : 1), tag_(tag)
+    {}
+
+    ~PoolSlabList()
+    {
+        while (slabs_) {
+            void* next = *static_cast<void**>(slabs_);
+            taggedAlignedFree(slabs_, tag_);
+            slabs_ = next;
+        }
+    }
+
+    PoolSlabList(const PoolSlabList&) = delete;
+    PoolSlabList& operator=(const PoolSlabList&) = delete;
+
+    /// @brief Allocate a slab and link its blocks into a chain
+    /// @param last Receives the final block of the chain (whose next pointer is nullptr)
+    /// @return First block of the chain, or nullptr if out of memory
+    [[nodiscard]] void* addSlab(void*& last) noexcept
+    {
+        auto* slab = static_cast<Byte*>(
+            taggedAlignedAlloc(SLAB_HEADER + BLOCK_STRIDE * blocksPerSlab_, Alignment, tag_));
+        if (!slab) {
+            return nullptr;
+        }
+        *reinterpret_cast<void**>(slab) = slabs_;
+        slabs_ = slab;
+        ++slabCount_;
+
+        Byte* first = slab + SLAB_HEADER;
+        for (usize i = 0; i + 1 < blocksPerSlab_; ++i) {
+            *reinterpret_cast<void**>(first + i * BLOCK_STRIDE) = first + (i + 1) * BLOCK_STRIDE;
+        }
+        last = first + (blocksPerSlab_ - 1) * BLOCK_STRIDE;
+        *static_cast<void**>(last) = nullptr;
+        return first;
+    }
+
+    [[nodiscard]] usize blocksPerSlab() const noexcept { return blocksPerSlab_; }
+    [[nodiscard]] usize slabCount() const noexcept { return slabCount_; }
+    [[nodiscard]] MemoryTag tag() const noexcept { return tag_; }
+
+private:
+    // Slab header holds the link to the previous slab, padded so blocks stay aligned
+    static constexpr usize SLAB_HEADER = Alignment > sizeof(void*) ? Alignment : sizeof(void*);
+
+    void* slabs_ = nullptr;
+    usize blocksPerSlab_;
+    usize slabCount_ = 0;
+    MemoryTag tag_;
+};
+
+}  // namespace detail
+
+/// @brief Single-threaded pool that chains a new slab instead of running out
+/// @tparam BlockSize Size of each block
+/// @tparam Alignment Alignment of each block
+template <usize BlockSize, usize Alignment = alignof(std::max_align_t)> class GrowablePoolAllocator
+{
+public:
+    /// @brief Create a pool; the first slab is allocated on first use
+    explicit GrowablePoolAllocator(usize blocksPerSlab = 256, MemoryTag tag = MemoryTag::Core)
+        : slabs_(blocksPerSlab, tag)
+    {}
+
+    GrowablePoolAllocator(const GrowablePoolAllocator&) = delete;
+    GrowablePoolAllocator& operator=(const GrowablePoolAllocator&) = delete;
+
+    /// @brief Allocate a block, growing the pool if needed
+    /// @return Block, or nullptr only if the system is out of memory
+    [[nodiscard]] void* alloc() noexcept
+    {
+        if (!freeList_) AUTOPHAGE_UNLIKELY {
+            void* last = nullptr;
+            freeList_ = slabs_.addSlab(last);
+            if (!freeList_) {
+                return nullptr;
+            }
+        }
+
+        void* block = freeList_;
+        freeList_ = *static_cast<void**>(freeList_);
+        ++allocatedCount_;
+        return block;
+    }
+
+    /// @brief Return a block to the pool
+    void free(void* ptr) noexcept
+    {
+        if (!ptr)
+            return;
+
+        *static_cast<void**>(ptr) = freeList_;
+        freeList_ = ptr;
+        --allocatedCount_;
+    }
+
+    /// @brief Allocate and construct an object
+    template <typename T, typename... Args> [[nodiscard]] T* create(Args&&... args)
+    {
+        static_assert(sizeof(T) <= BlockSize, "Type too large for pool");
+        static_assert(alignof(T) <= Alignment, "Type alignment exceeds pool alignment");
+
+        void* ptr = alloc();
+        if (!ptr)
+            return nullptr;
+        return new (ptr) T(std::forward<Args>(args)...);
+    }
+
+    /// @brief Destroy and return an object
+    template <typename T> void destroy(T* ptr)
+    {
+        if (ptr) {
+            ptr->~T();
+            free(ptr);
+        }
+    }
+
+    [[nodiscard]] usize allocated() const noexcept { return allocatedCount_; }
+    [[nodiscard]] usize capacity() const noexcept
+    {
+        return slabs_.slabCount() * slabs_.blocksPerSlab();
+    }
+    [[nodiscard]] usize slabCount() const noexcept { return slabs_.slabCount(); }
+
+private:
+    detail::PoolSlabList<BlockSize, Alignment> slabs_;
+    void* freeList_ = nullptr;
+    usize allocatedCount_ = 0;
+};
+
+/// @brief Growable pool that any thread may allocate from and free to
+/// @note The free list is a lock-free stack whose head packs a 16-bit version tag into the unused
+///       upper bits of a 48-bit pointer, so a block popped and pushed back between another
+///       thread's read and CAS (ABA) cannot corrupt it. Only growing takes a lock.
+template <usize BlockSize, usize Alignment = alignof(std::max_align_t)>
+class ConcurrentPoolAllocator
+{
+    static_assert(sizeof(void*) == 8, "Tagged free list requires 64-bit pointers");
+
+public:
+    /// @brief Create a pool; the first slab is allocated on first use
+    explicit ConcurrentPoolAllocator(usize blocksPerSlab = 256, MemoryTag tag = MemoryTag::Core)
+        : slabs_(blocksPerSlab, tag)
+    {}
+
+    ConcurrentPoolAllocator(const ConcurrentPoolAllocator&) = delete;
+    ConcurrentPoolAllocator& operator=(const ConcurrentPoolAllocator&) = delete;
+
+    /// @brief Allocate a block, growing the pool if needed (thread-safe)
+    /// @return Block, or nullptr only if the system is out of memory
+    [[nodiscard]] void* alloc() noexcept
+    {
+        for (;;) {
+            u64 head = head_.load(std::memory_order_acquire);
+            while (void* block = pointerOf(head)) {
+                // The block may be popped concurrently; slabs are never freed, so the read is
+                // safe and a stale value is rejected by the tagged CAS
+                void* next = std::atomic_ref<void*>(*static_cast<void**>(block))
+                                 .load(std::memory_order_relaxed);
+                if (head_.compare_exchange_weak(head, pack(next, tagOf(head) + 1),
+                                                std::memory_order_acquire,
+                                                std::memory_order_acquire)) {
+                    allocatedCount_.fetch_add(1, std::memory_order_relaxed);
+                    return block;
+                }
+            }
+            if (!grow()) AUTOPHAGE_UNLIKELY {
+                return nullptr;
+            }
+        }
+    }
+
+    /// @brief Return a block to the pool (thread-safe, from any thread)
+    void free(void* ptr) noexcept
+    {
+        if (!ptr)
+            return;
+
+        push(ptr, ptr);
+        allocatedCount_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /// @brief Allocate and construct an object
+    template <typename T, typename... Args> [[nodiscard]] T* create(Args&&... args)
+    {
+        static_assert(sizeof(T) <= BlockSize, "Type too large for pool");
+        static_assert(alignof(T) <= Alignment, "Type alignment exceeds pool alignment");
+
+        void* ptr = alloc();
+        if (!ptr)
+            return nullptr;
+        return new (ptr) T(std::forward<Args>(args)...);
+    }
+
+    /// @brief Destroy and return an object
+    template <typename T> void destroy(T* ptr)
+    {
+        if (ptr) {
+            ptr->~T();
+            free(ptr);
+        }
+    }
+
+    [[nodiscard]] usize allocated() const noexcept
+    {
+        return allocatedCount_.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] usize capacity() const noexcept
+    {
+        return slabCount_.load(std::memory_order_relaxed) * slabs_.blocksPerSlab();
+    }
+    [[nodiscard]] usize slabCount() const noexcept
+    {
+        return slabCount_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr u64 POINTER_MASK = (u64{1} << 48) - 1;
+
+    [[nodiscard]] static u64 pack(void* ptr, u64 tag) noexcept
+    {
+        return (tag << 48) | (reinterpret_cast<u64>(ptr) & POINTER_MASK);
+    }
+    [[nodiscard]] static void* pointerOf(u64 head) noexcept
+    {
+        return reinterpret_cast<void*>(head & POINTER_MASK);
+    }
+    [[nodiscard]] static u64 tagOf(u64 head) noexcept { return head >> 48; }
+
+    /// @brief Push a chain of linked blocks (first..last) onto the free list
+    void push(void* first, void* last) noexcept
+    {
+        u64 head = head_.load(std::memory_order_relaxed);
+        do {
+            std::atomic_ref<void*>(*static_cast<void**>(last))
+                .store(pointerOf(head), std::memory_order_relaxed);
+        } while (!head_.compare_exchange_weak(head, pack(first, tagOf(head) + 1),
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed));
+    }
+
+    bool grow() noexcept
+    {
+        std::lock_guard lock(growMutex_);
+
+        // Another thread may have grown (or blocks were freed) while we waited
+        if (pointerOf(head_.load(std::memory_order_acquire))) {
+            return true;
+        }
+
+        void* last = nullptr;
+        void* first = slabs_.addSlab(last);
+        if (!first) {
+            return false;
+        }
+        AUTOPHAGE_ASSERT((reinterpret_cast<u64>(first) & ~POINTER_MASK) == 0,
+                         "Pool block address exceeds 48 bits");
+        slabCount_.store(slabs_.slabCount(), std::memory_order_relaxed);
+        push(first, last);
+        return true;
+    }
+
+    std::atomic<u64> head_{0};
+    std::atomic<usize> allocatedCount_{0};
+    std::atomic<usize> slabCount_{0};
+    std::mutex growMutex_;
+    detail::PoolSlabList<BlockSize, Alignment> slabs_;
+};
+
 // =============================================================================
 // Scope-based temporary allocator
 // =============================================================================
@@ -0,0 +1,152 @@
+#pragma once
+
+/// @file memory_resource.hpp
+/// @brief std::pmr::memory_resource adapters for the engine allocators
+///
+/// Lets pmr containers (std::pmr::vector, std::pmr::unordered_map, ...) draw their storage from
+/// a LinearAllocator arena, a PoolAllocator, or the tagged heap. The tagged heap resource also
+/// keeps its own byte count and can enforce a budget, so a subsystem handed one resource can be
+/// measured and capped independently of the global MemoryStats.
+
+#include <autophage/core/memory.hpp>
+#include <autophage/core/types.hpp>
+
+#include <atomic>
+#include <memory_resource>
+#include <new>
+
+namespace autophage {
+
+// =============================================================================
+// Linear Memory Resource
+// =============================================================================
+
+/// @brief Memory resource that bump-allocates from a LinearAllocator
+/// @note Deallocation is a no-op; memory comes back when the arena is reset. Throws
+///       std::bad_alloc when the arena is full.
+class LinearMemoryResource final : public std::pmr::memory_resource
+{
+public:
+    explicit LinearMemoryResource(LinearAllocator& arena) noexcept : arena_(arena) {}
+
+    [[nodiscard]] LinearAllocator& arena() noexcept { return arena_; }
+
+private:
+    void* do_allocate(usize bytes, usize alignment) override;
+    void do_deallocate(void* ptr, usize bytes, usize alignment) override;
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    LinearAllocator& arena_;
+};
+
+// =============================================================================
+// Pool Memory Resource
+// =============================================================================
+
+/// @brief Memory resource serving fixed-size requests from a PoolAllocator
+/// @note Requests larger than BlockSize, more aligned than Alignment, or made while the pool is
+///       exhausted go to the upstream resource.
+template <usize BlockSize, usize Alignment = alignof(std::max_align_t)>
+class PoolMemoryResource final : public std::pmr::memory_resource
+{
+public:
+    explicit PoolMemoryResource(
+        PoolAllocator<BlockSize, Alignment>& pool,
+        std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+        : pool_(pool), upstream_(upstream)
+    {}
+
+    [[nodiscard]] PoolAllocator<BlockSize, Alignment>& pool() noexcept { return pool_; }
+    [[nodiscard]] std::pmr::memory_resource* upstream() const noexcept { return upstream_; }
+
+private:
+    void* do_allocate(usize bytes, usize alignment) override
+    {
+        if (bytes <= BlockSize && alignment <= Alignment) {
+            if (void* ptr = pool_.alloc()) AUTOPHAGE_LIKELY {
+                return ptr;
+            }
+        }
+        return upstream_->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, usize bytes, usize alignment) override
+    {
+        if (pool_.owns(ptr)) {
+            pool_.free(ptr);
+        } else {
+            upstream_->deallocate(ptr, bytes, alignment);
+        }
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    PoolAllocator<BlockSize, Alignment>& pool_;
+    std::pmr::memory_resource* upstream_;
+};
+
+// =============================================================================
+// Tagged Heap Memory Resource
+// =============================================================================
+
+/// @brief Memory resource over the tagged heap with per-resource accounting
+/// @note Thread-safe. Allocations are charged to the tag in MemoryStats as usual, and also to
+///       this resource's own counters.
+class TaggedMemoryResource final : public std::pmr::memory_resource
+{
+public:
+    /// @param tag Tag charged with every allocation
+    /// @param budgetBytes Maximum bytes in use at once (0 = unlimited); exceeding it throws
+    ///        std::bad_alloc
+    explicit TaggedMemoryResource(MemoryTag tag, usize budgetBytes = 0) noexcept
+        : tag_(tag), budget_(budgetBytes)
+    {}
+
+    // Non-copyable (outstanding blocks are accounted here)
+    TaggedMemoryResource(const TaggedMemoryResource&) = delete;
+    TaggedMemoryResource& operator=(const TaggedMemoryResource&) = delete;
+
+    [[nodiscard]] MemoryTag tag() const noexcept { return tag_; }
+
+    /// @brief Bytes currently allocated through this resource
+    [[nodiscard]] usize bytesInUse() const noexcept
+    {
+        return bytesInUse_.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Highest value bytesInUse() has reached
+    [[nodiscard]] usize peakBytes() const noexcept
+    {
+        return peakBytes_.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Allocations refused because they would exceed the budget
+    [[nodiscard]] u64 rejectedAllocations() const noexcept
+    {
+        return rejected_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] usize budget() const noexcept { return budget_.load(std::memory_order_relaxed); }
+
+    /// @brief Change the budget (0 = unlimited); existing allocations are not affected
+    void setBudget(usize budgetBytes) noexcept
+    {
+        budget_.store(budgetBytes, std::memory_order_relaxed);
+    }
+
+private:
+    void* do_allocate(usize bytes, usize alignment) override;
+    void do_deallocate(void* ptr, usize bytes, usize alignment) override;
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    MemoryTag tag_;
+    std::atomic<usize> budget_;
+    std::atomic<usize> bytesInUse_{0};
+    std::atomic<usize> peakBytes_{0};
+    std::atomic<u64> rejected_{0};
+};
+
+}  // namespace autophage
@@ -197,4 +197,17 @@ struct PlatformInfo {
     };
 }
 
+/// @brief Hardware the process runs on (detected once, at first use)
+struct MachineInfo {
+    String cpuModel;   // CPU brand string ("unknown" if it can't be read)
+    u32 logicalCores;  // Hardware threads (at least 1)
+};
+
+/// @brief Get information about the host machine
+[[nodiscard]] const MachineInfo& getMachineInfo();
+
+/// @brief Hash identifying this build: source revision (AUTOPHAGE_BUILD_ID), compiler, build
+///        type, SIMD level and profile level, as 16 hex digits
+[[nodiscard]] const String& getBuildHash();
+
 }  // namespace autophage
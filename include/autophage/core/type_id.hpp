@@ -5,6 +5,7 @@
 
 #include <autophage/core/types.hpp>
 
+#include <string_view>
 #include <type_traits>
 
 namespace autophage {
@@ -26,6 +27,15 @@ struct FnvHash {
     return (*str == '\0') ? hash : fnv1aHash(str + 1, (hash ^ static_cast<u64>(*str)) * FnvHash::PRIME);
 }
 
+/// @brief Compile-time FNV-1a hash for string views
+[[nodiscard]] constexpr u64 fnv1aHash(std::string_view str) noexcept {
+    u64 hash = FnvHash::OFFSET_BASIS;
+    for (char c : str) {
+        hash = (hash ^ static_cast<u64>(c)) * FnvHash::PRIME;
+    }
+    return hash;
+}
+
 /// @brief Compile-time hash combining
 [[nodiscard]] constexpr u64 hashCombine(u64 h1, u64 h2) noexcept {
     return h1 ^ (h2 + 0x9e3779b97f4a7c15ULL + (h1 << 6) + (h1 >> 2));
@@ -48,10 +58,27 @@ template <typename T>
 #endif
 }
 
+/// @brief The type's name alone, without the compiler's function signature around it
+/// @note GCC and Clang spell the signature differently ("[with T = X]" vs "[T = X]") but the
+///       type the same, so code compiled by the JIT (Clang) agrees with a GCC-built engine.
+template <typename T>
+[[nodiscard]] constexpr std::string_view typeName() noexcept {
+    std::string_view raw = rawTypeName<T>();
+#if defined(__clang__) || defined(__GNUC__)
+    usize start = raw.find("T = ");
+    usize end = raw.rfind(']');
+    if (start != std::string_view::npos && end != std::string_view::npos && end > start) {
+        start += 4;
+        return raw.substr(start, end - start);
+    }
+#endif
+    return raw;
+}
+
 /// @brief Hash a type name at compile time
 template <typename T>
 [[nodiscard]] constexpr u64 typeNameHash() noexcept {
-    return fnv1aHash(rawTypeName<T>());
+    return fnv1aHash(typeName<T>());
 }
 
 }  // namespace detail
@@ -11,8 +11,12 @@
 #include <variant>
 
 // C++23 features with fallback
+// (<expected> may exist while std::expected does not, e.g. Clang 17 with libstdc++ when
+// compiling JIT sources, so test the feature macro rather than the header)
 #if __has_include(<expected>)
     #include <expected>
+#endif
+#if defined(__cpp_lib_expected)
     #define AUTOPHAGE_HAS_EXPECTED 1
 #else
     #define AUTOPHAGE_HAS_EXPECTED 0
@@ -58,6 +62,18 @@ using f64 = double;
 using String = std::string;
 using StringView = std::string_view;
 
+/// @brief Transparent string hash: unordered containers keyed by String (with std::equal_to<>)
+///        can then be searched with a StringView or C string without allocating
+struct StringHash
+{
+    using is_transparent = void;
+
+    [[nodiscard]] usize operator()(StringView text) const noexcept
+    {
+        return std::hash<StringView>{}(text);
+    }
+};
+
 // =============================================================================
 // Utility Types
 // =============================================================================
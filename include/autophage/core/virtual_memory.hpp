@@ -0,0 +1,168 @@
+#pragma once
+
+/// @file virtual_memory.hpp
+/// @brief Reserve address space up front and commit pages on demand
+///
+/// A reserved range occupies address space but no physical memory until pages are committed.
+/// Growing a buffer inside a reservation therefore never moves it: existing pointers stay valid
+/// and growth costs only the newly committed pages, instead of a reallocate-and-copy of
+/// everything stored so far.
+///
+/// Large ranges can also ask for huge pages (fewer TLB misses when streaming over millions of
+/// components) and for placement on a NUMA node (keeping a worker's data in local memory).
+/// Placement is Linux-only and best effort: where the system can't honour it, memory is still
+/// returned, just with normal pages and the default node policy.
+
+#include <autophage/core/memory.hpp>
+#include <autophage/core/types.hpp>
+
+namespace autophage {
+
+// =============================================================================
+// Virtual Memory Primitives
+// =============================================================================
+
+/// @brief System page size in bytes
+[[nodiscard]] usize getPageSize() noexcept;
+
+/// @brief Reserve address space without backing memory (inaccessible until committed)
+/// @param size Size in bytes (rounded up to the page size)
+/// @return Base of the reservation, or nullptr on failure
+[[nodiscard]] void* reserveVirtualMemory(usize size) noexcept;
+
+/// @brief Make a page-aligned sub-range of a reservation readable and writable
+/// @return false if the system refuses to commit the pages
+[[nodiscard]] bool commitVirtualMemory(void* ptr, usize size) noexcept;
+
+/// @brief Return the physical pages of a committed sub-range to the system
+/// @note The range stays reserved and becomes inaccessible again.
+void decommitVirtualMemory(void* ptr, usize size) noexcept;
+
+/// @brief Release a whole reservation
+/// @param size Size passed to reserveVirtualMemory
+void releaseVirtualMemory(void* ptr, usize size) noexcept;
+
+// =============================================================================
+// Memory Placement
+// =============================================================================
+
+/// @brief Huge page usage for a memory range
+enum class HugePagePolicy : u8
+{
+    None,         // Normal pages
+    Transparent,  // Align to the huge page size and madvise(MADV_HUGEPAGE)
+    Explicit,     // Reserve from the hugetlbfs pool (MAP_HUGETLB), else fall back to Transparent
+};
+
+/// @brief Convert huge page policy to string
+[[nodiscard]] constexpr StringView toString(HugePagePolicy policy) noexcept
+{
+    switch (policy) {
+        case HugePagePolicy::None:
+            return "None";
+        case HugePagePolicy::Transparent:
+            return "Transparent";
+        case HugePagePolicy::Explicit:
+            return "Explicit";
+    }
+    return "Unknown";
+}
+
+/// @brief Sentinel for "no NUMA preference"
+inline constexpr i32 ANY_NUMA_NODE = -1;
+
+/// @brief Where and how the pages of a memory range are placed
+struct MemoryPlacement
+{
+    HugePagePolicy hugePages = HugePagePolicy::None;
+
+    /// NUMA node to place pages on (ANY_NUMA_NODE: first-touch default)
+    i32 numaNode = ANY_NUMA_NODE;
+
+    /// Bind strictly to numaNode (MPOL_BIND) instead of preferring it (MPOL_PREFERRED).
+    /// Strict binding fails allocations when the node is full rather than spilling over.
+    bool strictNuma = false;
+
+    /// @brief Placement on the NUMA node of the calling thread
+    [[nodiscard]] static MemoryPlacement
+    localNode(HugePagePolicy hugePages = HugePagePolicy::None) noexcept;
+};
+
+/// @brief Default huge page size (2 MiB on x86-64 when the system reports none)
+[[nodiscard]] usize getHugePageSize() noexcept;
+
+/// @brief Number of NUMA nodes (1 on non-NUMA systems and non-Linux platforms)
+[[nodiscard]] u32 getNumaNodeCount() noexcept;
+
+/// @brief NUMA node of the CPU the calling thread is running on (0 if unknown)
+[[nodiscard]] u32 getCurrentNumaNode() noexcept;
+
+/// @brief Apply transparent huge page advice and NUMA policy to a page-aligned range
+/// @note Explicit huge pages can't be applied after the fact and are treated as Transparent.
+/// @return false if any part of the placement was refused
+bool applyMemoryPlacement(void* ptr, usize size, const MemoryPlacement& placement) noexcept;
+
+// =============================================================================
+// Virtual Range
+// =============================================================================
+
+/// @brief Owning reservation whose committed prefix grows on demand
+/// @note Committed bytes are charged to the tag in MemoryStats.
+class VirtualRange
+{
+public:
+    /// @brief Smallest amount committed at once, so small growth steps don't each cost a syscall
+    static constexpr usize MIN_COMMIT_SIZE = usize{64} * 1024;
+
+    VirtualRange() = default;
+
+    /// @brief Reserve at least the given number of bytes
+    /// @note Check valid(): the reservation fails if address space is exhausted. Check
+    ///       hugePages() for the huge page policy actually in effect.
+    explicit VirtualRange(usize reserveBytes, MemoryTag tag = MemoryTag::Core,
+                          const MemoryPlacement& placement = {});
+
+    ~VirtualRange();
+
+    // Non-copyable, moveable
+    VirtualRange(const VirtualRange&) = delete;
+    VirtualRange& operator=(const VirtualRange&) = delete;
+    VirtualRange(VirtualRange&& other) noexcept;
+    VirtualRange& operator=(VirtualRange&& other) noexcept;
+
+    /// @brief Ensure at least the first `bytes` bytes are committed
+    /// @note Commits geometrically (at least doubling, MIN_COMMIT_SIZE minimum) up to the
+    ///       reservation size, so repeated small requests amortize to few system calls.
+    /// @return false if bytes exceeds the reservation or the system refuses to commit
+    [[nodiscard]] bool commit(usize bytes) noexcept;
+
+    /// @brief Decommit everything past the first `bytes` bytes (rounded up to a commit unit)
+    void shrink(usize bytes) noexcept;
+
+    [[nodiscard]] bool valid() const noexcept { return base_ != nullptr; }
+    [[nodiscard]] Byte* data() const noexcept { return base_; }
+    [[nodiscard]] usize reserved() const noexcept { return reserved_; }
+    [[nodiscard]] usize committed() const noexcept { return committed_; }
+
+    /// @brief Huge page policy in effect (may be weaker than requested)
+    [[nodiscard]] HugePagePolicy hugePages() const noexcept { return hugePages_; }
+
+    /// @brief NUMA node the range is placed on (ANY_NUMA_NODE if none or refused)
+    [[nodiscard]] i32 numaNode() const noexcept { return numaNode_; }
+
+    /// @brief Granularity of commits (page or huge page size)
+    [[nodiscard]] usize commitUnit() const noexcept { return commitUnit_; }
+
+private:
+    void release() noexcept;
+
+    Byte* base_ = nullptr;
+    usize reserved_ = 0;
+    usize committed_ = 0;
+    usize commitUnit_ = 0;
+    MemoryTag tag_ = MemoryTag::Core;
+    HugePagePolicy hugePages_ = HugePagePolicy::None;
+    i32 numaNode_ = ANY_NUMA_NODE;
+};
+
+}  // namespace autophage
@@ -6,10 +6,13 @@
 #include <autophage/core/memory.hpp>
 #include <autophage/core/type_id.hpp>
 #include <autophage/core/types.hpp>
+#include <autophage/core/virtual_memory.hpp>
 #include <autophage/ecs/entity.hpp>
 
 #include <algorithm>
+#include <limits>
 #include <memory>
+#include <memory_resource>
 #include <stdexcept>
 #include <unordered_map>
 #include <vector>
@@ -46,16 +49,168 @@ public:
     [[nodiscard]] virtual const void* getRaw(Entity entity) const = 0;
 };
 
+// =============================================================================
+// Dense Component Storage
+// =============================================================================
+
+/// @brief Reserve address space for a fixed maximum number of components
+/// @note Passed to ComponentArray or ComponentRegistry::registerComponent.
+struct ReservedStorage
+{
+    usize maxComponents = 0;
+    MemoryTag tag = MemoryTag::Components;
+
+    /// Huge pages / NUMA node for the reservation (e.g. MemoryPlacement::localNode() from the
+    /// worker that will process this component type)
+    MemoryPlacement placement{};
+};
+
+namespace detail {
+
+/// @brief Contiguous component buffer with two growth modes
+///
+/// Heap mode behaves like a vector over a memory resource: growth reallocates and moves every
+/// element. Reserved mode lives in a VirtualRange sized for the maximum count up front; growth
+/// only commits more pages, so it never copies or moves elements.
+template <typename T> class DenseArray
+{
+public:
+    explicit DenseArray(std::pmr::memory_resource* resource) noexcept : resource_(resource) {}
+
+    explicit DenseArray(const ReservedStorage& storage)
+        : range_(reservedBytes(storage.maxComponents), storage.tag, storage.placement),
+          maxCapacity_(storage.maxComponents)
+    {
+        static_assert(alignof(T) <= 4096, "Component alignment exceeds the page size");
+        if (!range_.valid()) {
+            throw std::bad_alloc();
+        }
+        data_ = reinterpret_cast<T*>(range_.data());
+    }
+
+    ~DenseArray()
+    {
+        clear();
+        if (!isReserved() && data_) {
+            resource_->deallocate(data_, capacity_ * sizeof(T), alignof(T));
+        }
+    }
+
+    // Non-copyable (owns its buffer)
+    DenseArray(const DenseArray&) = delete;
+    DenseArray& operator=(const DenseArray&) = delete;
+
+    [[nodiscard]] T& operator[](usize index) noexcept { return data_[index]; }
+    [[nodiscard]] const T& operator[](usize index) const noexcept { return data_[index]; }
+    [[nodiscard]] T& back() noexcept { return data_[size_ - 1]; }
+
+    [[nodiscard]] T* data() noexcept { return data_; }
+    [[nodiscard]] const T* data() const noexcept { return data_; }
+    [[nodiscard]] usize size() const noexcept { return size_; }
+    [[nodiscard]] usize capacity() const noexcept { return capacity_; }
+    [[nodiscard]] bool isReserved() const noexcept { return range_.valid(); }
+
+    void push_back(T&& value)
+    {
+        if (size_ == capacity_) AUTOPHAGE_UNLIKELY {
+            grow(size_ + 1);
+        }
+        new (data_ + size_) T(std::move(value));
+        ++size_;
+    }
+
+    void pop_back() noexcept
+    {
+        --size_;
+        data_[size_].~T();
+    }
+
+    void reserve(usize count)
+    {
+        if (count > capacity_) {
+            grow(count);
+        }
+    }
+
+    /// @brief Destroy all elements (committed pages / heap capacity are kept)
+    void clear() noexcept
+    {
+        std::destroy_n(data_, size_);
+        size_ = 0;
+    }
+
+private:
+    [[nodiscard]] static usize reservedBytes(usize maxComponents)
+    {
+        if (maxComponents > std::numeric_limits<usize>::max() / sizeof(T)) {
+            throw std::length_error("Reserved component storage size overflows");
+        }
+        return maxComponents * sizeof(T);
+    }
+
+    void grow(usize minCapacity)
+    {
+        if (isReserved()) {
+            if (minCapacity > maxCapacity_ || !range_.commit(minCapacity * sizeof(T))) {
+                throw std::length_error("Reserved component storage exhausted");
+            }
+            capacity_ = std::min(range_.committed() / sizeof(T), maxCapacity_);
+            return;
+        }
+
+        usize newCapacity = std::max({minCapacity, capacity_ * 2, usize{8}});
+        T* newData = static_cast<T*>(resource_->allocate(newCapacity * sizeof(T), alignof(T)));
+        std::uninitialized_move_n(data_, size_, newData);
+        std::destroy_n(data_, size_);
+        if (data_) {
+            resource_->deallocate(data_, capacity_ * sizeof(T), alignof(T));
+        }
+        data_ = newData;
+        capacity_ = newCapacity;
+    }
+
+    T* data_ = nullptr;
+    usize size_ = 0;
+    usize capacity_ = 0;
+    std::pmr::memory_resource* resource_ = std::pmr::get_default_resource();
+    VirtualRange range_;
+    usize maxCapacity_ = 0;
+};
+
+}  // namespace detail
+
 // =============================================================================
 // Sparse Set Component Storage
 // =============================================================================
 
 /// @brief Sparse set based component storage
 /// Provides O(1) add/remove/lookup with cache-friendly iteration
+/// @note All arrays draw from one std::pmr::memory_resource, so component data can be placed in
+///       an engine arena (see memory_resource.hpp). With ReservedStorage the component data
+///       instead lives in reserved address space, so adding components never moves existing
+///       ones. Removing any component still moves the last one into its slot, so a pointer
+///       returned by get() is only stable until the next remove() on this array.
 template <Component T> class ComponentArray : public IComponentArray
 {
 public:
-    ComponentArray() = default;
+    explicit ComponentArray(
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : denseEntities_(resource), denseComponents_(resource), sparse_(resource)
+    {}
+
+    /// @brief Keep component data in reserved virtual memory for up to maxComponents entries
+    /// @throws std::length_error when maxComponents * sizeof(T) overflows, or when adding more
+    ///         components than reserved
+    explicit ComponentArray(const ReservedStorage& storage,
+                            std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : denseEntities_(resource), denseComponents_(storage), sparse_(resource)
+    {}
+
+    /// @brief Resource backing the dense and sparse arrays
+    [[nodiscard]] std::pmr::memory_resource* resource() const noexcept
+    {
+        return denseEntities_.get_allocator().resource();
+    }
 
     [[nodiscard]] TypeId componentType() const noexcept override { return typeId<T>(); }
 
@@ -153,7 +308,10 @@ public:
     }
 
     /// @brief Get all entities with this component
-    [[nodiscard]] const std::vector<Entity>& entities() const { return denseEntities_; }
+    [[nodiscard]] const std::pmr::vector<Entity>& entities() const { return denseEntities_; }
+
+    /// @brief Whether component data lives in reserved virtual memory
+    [[nodiscard]] bool isReserved() const noexcept { return denseComponents_.isReserved(); }
 
     /// @brief Direct access to dense component data (for SIMD operations)
     [[nodiscard]] T* data() noexcept { return denseComponents_.data(); }
@@ -179,9 +337,9 @@ public:
 private:
     static constexpr usize INVALID_INDEX = ~usize{0};
 
-    std::vector<Entity> denseEntities_;  // Entity IDs
-    std::vector<T> denseComponents_;     // Contiguous component data
-    std::vector<usize> sparse_;          // Entity index -> dense index
+    std::pmr::vector<Entity> denseEntities_;  // Entity IDs
+    detail::DenseArray<T> denseComponents_;   // Contiguous component data
+    std::pmr::vector<usize> sparse_;          // Entity index -> dense index
 };
 
 // =============================================================================
@@ -229,17 +387,40 @@ private:
 class ComponentRegistry
 {
 public:
-    ComponentRegistry() = default;
+    /// @param resource Default resource for the storage of newly registered component types
+    explicit ComponentRegistry(
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : resource_(resource)
+    {}
 
     /// @brief Register a component type
-    template <Component T> void registerComponent()
+    template <Component T> void registerComponent() { registerComponent<T>(resource_); }
+
+    /// @brief Register a component type whose storage draws from the given resource
+    /// @note No effect if the type is already registered.
+    template <Component T> void registerComponent(std::pmr::memory_resource* resource)
     {
         TypeId id = typeId<T>();
         if (arrays_.find(id) == arrays_.end()) {
-            arrays_[id] = std::make_unique<ComponentArray<T>>();
+            arrays_[id] = std::make_unique<ComponentArray<T>>(resource);
         }
     }
 
+    /// @brief Register a component type stored in reserved virtual memory
+    /// @note No effect if the type is already registered.
+    template <Component T> void registerComponent(const ReservedStorage& storage)
+    {
+        TypeId id = typeId<T>();
+        if (arrays_.find(id) == arrays_.end()) {
+            arrays_[id] = std::make_unique<ComponentArray<T>>(storage, resource_);
+        }
+    }
+
+    /// @brief Set the default resource for component types registered from now on
+    void setMemoryResource(std::pmr::memory_resource* resource) noexcept { resource_ = resource; }
+
+    [[nodiscard]] std::pmr::memory_resource* memoryResource() const noexcept { return resource_; }
+
     /// @brief Get or create a component array
     template <Component T> ComponentArray<T>& getArray()
     {
@@ -298,6 +479,7 @@ public:
 
 private:
     std::unordered_map<TypeId, std::unique_ptr<IComponentArray>> arrays_;
+    std::pmr::memory_resource* resource_;
 };
 
 }  // namespace autophage::ecs
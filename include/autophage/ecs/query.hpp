@@ -3,10 +3,14 @@
 /// @file query.hpp
 /// @brief Query system for iterating entities with specific components
 
+#include <autophage/core/frame_allocator.hpp>
 #include <autophage/core/types.hpp>
+#include <autophage/profiler/access_tracking.hpp>
 #include <autophage/ecs/component_storage.hpp>
 #include <autophage/ecs/entity.hpp>
+#include <autophage/ecs/system_stats.hpp>
 
+#include <memory_resource>
 #include <tuple>
 #include <vector>
 
@@ -31,24 +35,32 @@ public:
     {
         // Get the smallest array to iterate (optimization)
         auto& primary = *std::get<0>(arrays_);
+        recordLinearAccess(primary.size());
 
+        usize visited = 0;
         primary.forEach([&](Entity entity, auto& /*unused*/) {
             if (matchesAll(entity)) {
                 func(entity, *std::get<ComponentArray<Components>*>(arrays_)->get(entity)...);
+                ++visited;
             }
         });
+        reportEntitiesProcessed(visited);
     }
 
     /// @brief Iterate over all entities matching the query (const)
     template <typename Func> void forEach(Func&& func) const
     {
         const auto& primary = *std::get<0>(arrays_);
+        recordLinearAccess(primary.size());
 
+        usize visited = 0;
         primary.forEach([&](Entity entity, const auto& /*unused*/) {
             if (matchesAll(entity)) {
                 func(entity, *std::get<ComponentArray<Components>*>(arrays_)->get(entity)...);
+                ++visited;
             }
         });
+        reportEntitiesProcessed(visited);
     }
 
     /// @brief Get all entities matching the query
@@ -66,6 +78,39 @@ public:
         return result;
     }
 
+    /// @brief Get all entities matching the query, stored in the given resource
+    [[nodiscard]] std::pmr::vector<Entity> entities(std::pmr::memory_resource* resource) const
+    {
+        const auto& primary = *std::get<0>(arrays_);
+        std::pmr::vector<Entity> result(resource);
+        result.reserve(primary.size());
+
+        primary.forEach([&](Entity entity, const auto& /*unused*/) {
+            if (matchesAll(entity)) {
+                result.push_back(entity);
+            }
+        });
+
+        return result;
+    }
+
+    /// @brief Get all entities matching the query without touching the heap
+    /// @note Storage comes from the frame allocator and stays valid until the end of next frame.
+    [[nodiscard]] FrameVector<Entity> frameEntities() const
+    {
+        const auto& primary = *std::get<0>(arrays_);
+        FrameVector<Entity> result;
+        result.reserve(primary.size());
+
+        primary.forEach([&](Entity entity, const auto& /*unused*/) {
+            if (matchesAll(entity)) {
+                result.push_back(entity);
+            }
+        });
+
+        return result;
+    }
+
     /// @brief Count entities matching the query
     [[nodiscard]] usize count() const
     {
@@ -160,7 +205,11 @@ public:
           primaryEntities_(std::get<0>(arrays_)->entities())
     {}
 
-    Iterator begin() { return Iterator(this, 0); }
+    Iterator begin()
+    {
+        recordLinearAccess(primaryEntities_.size());
+        return Iterator(this, 0);
+    }
     Iterator end() { return Iterator(this, primaryEntities_.size()); }
 
 private:
@@ -172,7 +221,7 @@ private:
     }
 
     std::tuple<ComponentArray<Components>*...> arrays_;
-    const std::vector<Entity>& primaryEntities_;
+    const std::pmr::vector<Entity>& primaryEntities_;
 };
 
 }  // namespace autophage::ecs
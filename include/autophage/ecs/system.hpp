@@ -3,9 +3,14 @@
 /// @file system.hpp
 /// @brief System definitions for ECS
 
+#include <autophage/core/memory.hpp>
 #include <autophage/core/type_id.hpp>
 #include <autophage/core/types.hpp>
+#include <autophage/ecs/system_access.hpp>
+#include <autophage/ecs/system_stats.hpp>
+#include <autophage/profiler/profiler.hpp>
 
+#include <array>
 #include <functional>
 #include <memory>
 #include <string>
@@ -48,6 +53,10 @@ public:
 
     /// @brief Enable or disable the system
     virtual void setEnabled(bool enabled) = 0;
+
+    /// @brief Declare the component types the system reads and writes
+    /// @note Leave empty to rely on the accesses SystemRegistry observes during updates.
+    virtual void declareAccess([[maybe_unused]] ComponentAccessSet& access) const {}
 };
 
 // =============================================================================
@@ -92,6 +101,9 @@ enum class SystemVariant : u8
     Approximate,  // Degraded/approximate implementation
 };
 
+/// @brief Number of SystemVariant values
+inline constexpr usize SYSTEM_VARIANT_COUNT = 4;
+
 /// @brief Convert variant to string
 [[nodiscard]] inline constexpr const char* toString(SystemVariant variant) noexcept
 {
@@ -108,6 +120,18 @@ enum class SystemVariant : u8
     return "Unknown";
 }
 
+/// @brief Parse a variant name as returned by toString()
+[[nodiscard]] inline Optional<SystemVariant> variantFromString(StringView name) noexcept
+{
+    for (usize i = 0; i < SYSTEM_VARIANT_COUNT; ++i) {
+        auto variant = static_cast<SystemVariant>(i);
+        if (name == toString(variant)) {
+            return variant;
+        }
+    }
+    return std::nullopt;
+}
+
 /// @brief System with multiple implementations that can be hot-swapped
 class IVariantSystem
 {
@@ -133,11 +157,15 @@ public:
 class SystemRegistry
 {
 public:
+    /// @brief Calibrates the tick clock that system timings are measured with
+    SystemRegistry();
+
     /// @brief Register a system
     template <typename T, typename... Args> T& registerSystem(Args&&... args)
     {
         auto system = std::make_unique<T>(std::forward<Args>(args)...);
         T& ref = *system;
+        records_.push_back(makeRecord(*system));
         systems_.push_back(std::move(system));
         return ref;
     }
@@ -148,7 +176,8 @@ public:
         TypeId id = typeId<T>();
         for (auto& system : systems_) {
             if (system->systemId() == id) {
-                return static_cast<T*>(system.get());
+                // ISystem is a virtual base, so only dynamic_cast can reach T
+                return dynamic_cast<T*>(system.get());
             }
         }
         return nullptr;
@@ -172,7 +201,8 @@ public:
                 auto newSystem = std::make_unique<NewT>(std::forward<Args>(args)...);
                 NewT& ref = *newSystem;
 
-                // Replace in registry
+                // Replace in registry (statistics restart for the new implementation)
+                records_[static_cast<usize>(it - systems_.begin())] = makeRecord(*newSystem);
                 *it = std::move(newSystem);
 
                 // Initialize new system
@@ -204,7 +234,8 @@ public:
                 auto newSystem = std::make_unique<NewT>(std::forward<Args>(args)...);
                 NewT& ref = *newSystem;
 
-                // Replace in registry
+                // Replace in registry (statistics restart for the new implementation)
+                records_[static_cast<usize>(it - systems_.begin())] = makeRecord(*newSystem);
                 *it = std::move(newSystem);
 
                 // Initialize new system
@@ -226,12 +257,19 @@ public:
         }
     }
 
-    /// @brief Update all enabled systems
+    /// @brief Update all enabled systems, timing each one unless profiling is disabled
+    /// @note Untagged heap allocations made by systems are charged to MemoryTag::Systems
     void updateAll(World& world, f32 dt)
     {
-        for (auto& system : systems_) {
-            if (system->isEnabled()) {
-                system->update(world, dt);
+        MemoryTagScope memoryScope(MemoryTag::Systems);
+        for (usize i = 0; i < systems_.size(); ++i) {
+            if (!systems_[i]->isEnabled()) {
+                continue;
+            }
+            if (profilingEnabled_) {
+                updateProfiled(i, world, dt);
+            } else {
+                systems_[i]->update(world, dt);
             }
         }
     }
@@ -252,10 +290,60 @@ public:
     [[nodiscard]] usize count() const noexcept { return systems_.size(); }
 
     /// @brief Clear all systems
-    void clear() { systems_.clear(); }
+    void clear()
+    {
+        systems_.clear();
+        records_.clear();
+    }
+
+    // =========================================================================
+    // Statistics
+    // =========================================================================
+
+    /// @brief Aggregate statistics for every system that has run, in execution order
+    [[nodiscard]] std::vector<SystemStats> systemStats() const;
+
+    /// @brief Per-variant statistics for every variant system and variant that has run
+    [[nodiscard]] std::vector<SystemStats> variantStats() const;
+
+    /// @brief Statistics for one system (optionally restricted to one variant)
+    [[nodiscard]] Optional<SystemStats> statsFor(
+        TypeId systemId, Optional<SystemVariant> variant = std::nullopt) const;
+
+    /// @brief Statistics for one system by type
+    template <typename T>
+    [[nodiscard]] Optional<SystemStats> statsFor(
+        Optional<SystemVariant> variant = std::nullopt) const
+    {
+        return statsFor(typeId<T>(), variant);
+    }
+
+    /// @brief Discard all collected statistics
+    void resetStats();
+
+    /// @brief Enable or disable automatic per-system timing (enabled by default)
+    void setProfilingEnabled(bool enabled) noexcept { profilingEnabled_ = enabled; }
+    [[nodiscard]] bool isProfilingEnabled() const noexcept { return profilingEnabled_; }
 
 private:
+    /// @brief Profiling state kept alongside each system
+    struct SystemRecord
+    {
+        ZoneId zone = INVALID_ZONE_ID;
+        IVariantSystem* variants = nullptr;  // Non-null if the system supports variants
+        ComponentAccessSet declaredAccess;
+        ComponentAccessSet observedAccess;
+        SystemTimingWindow timing;
+        std::array<SystemTimingWindow, SYSTEM_VARIANT_COUNT> variantTiming;
+    };
+
+    [[nodiscard]] static SystemRecord makeRecord(ISystem& system);
+    void updateProfiled(usize index, World& world, f32 dt);
+    [[nodiscard]] SystemStats makeStats(usize index, Optional<SystemVariant> variant) const;
+
     std::vector<std::unique_ptr<ISystem>> systems_;
+    std::vector<SystemRecord> records_;  // Parallel to systems_
+    bool profilingEnabled_ = true;
 };
 
 }  // namespace autophage::ecs
@@ -0,0 +1,181 @@
+#pragma once
+
+/// @file system_access.hpp
+/// @brief Component read/write sets of systems, declared or detected while they run
+///
+/// Two systems can run concurrently only if neither writes a component type the other reads
+/// or writes. Systems may declare their sets (ISystem::declareAccess); otherwise SystemRegistry
+/// records what World accessors a system touches during its profiled updates. Queries and views
+/// hand out mutable references, so they count as writes; declare reads explicitly to be exact.
+
+#include <autophage/core/platform.hpp>
+#include <autophage/core/type_id.hpp>
+#include <autophage/core/types.hpp>
+#include <autophage/profiler/profiler.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace autophage::ecs {
+
+// =============================================================================
+// Component Access Set
+// =============================================================================
+
+/// @brief Component types a system reads and writes
+struct ComponentAccessSet
+{
+    /// Sorted, unique; a type that is written is listed only in writes
+    std::vector<TypeId> reads;
+    std::vector<TypeId> writes;
+
+    /// Creates or destroys entities (conflicts with every other system)
+    bool structural = false;
+
+    /// @brief Nothing declared or observed (the system's effects are unknown)
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return reads.empty() && writes.empty() && !structural;
+    }
+
+    void addRead(TypeId id)
+    {
+        if (std::ranges::binary_search(writes, id)) {
+            return;
+        }
+        insertSorted(reads, id);
+    }
+
+    void addWrite(TypeId id)
+    {
+        if (auto it = std::ranges::lower_bound(reads, id); it != reads.end() && *it == id) {
+            reads.erase(it);
+        }
+        insertSorted(writes, id);
+    }
+
+    /// @brief Declare component types as read (`access.read<Velocity, Mass>()`)
+    template <typename... Ts> ComponentAccessSet& read()
+    {
+        (addRead(typeId<Ts>()), ...);
+        return *this;
+    }
+
+    /// @brief Declare component types as written
+    template <typename... Ts> ComponentAccessSet& write()
+    {
+        (addWrite(typeId<Ts>()), ...);
+        return *this;
+    }
+
+    /// @brief Declare that the system creates or destroys entities
+    ComponentAccessSet& makesStructuralChanges() noexcept
+    {
+        structural = true;
+        return *this;
+    }
+
+    /// @brief Check whether two systems must not run concurrently
+    /// @note Unknown (empty) sets conflict with everything.
+    [[nodiscard]] bool conflictsWith(const ComponentAccessSet& other) const
+    {
+        if (structural || other.structural || empty() || other.empty()) {
+            return true;
+        }
+        return intersects(writes, other.writes) || intersects(writes, other.reads) ||
+               intersects(reads, other.writes);
+    }
+
+    void clear() noexcept
+    {
+        reads.clear();
+        writes.clear();
+        structural = false;
+    }
+
+private:
+    static void insertSorted(std::vector<TypeId>& ids, TypeId id)
+    {
+        auto it = std::ranges::lower_bound(ids, id);
+        if (it == ids.end() || *it != id) {
+            ids.insert(it, id);
+        }
+    }
+
+    [[nodiscard]] static bool intersects(const std::vector<TypeId>& a,
+                                         const std::vector<TypeId>& b) noexcept
+    {
+        auto ia = a.begin();
+        auto ib = b.begin();
+        while (ia != a.end() && ib != b.end()) {
+            if (*ia == *ib) {
+                return true;
+            }
+            if (*ia < *ib) {
+                ++ia;
+            } else {
+                ++ib;
+            }
+        }
+        return false;
+    }
+};
+
+// =============================================================================
+// Access Detection
+// =============================================================================
+
+namespace detail {
+
+/// @brief The engine's thread-local below, exported for code compiled by the JIT (see
+///        engineCurrentMemoryTag() in memory.hpp)
+[[nodiscard]] ComponentAccessSet*& engineComponentAccess() noexcept;
+
+#if defined(AUTOPHAGE_JIT_MODULE)
+[[nodiscard]] inline ComponentAccessSet* componentAccess() noexcept
+{
+    return engineComponentAccess();
+}
+#else
+/// Set of the system being updated on this thread (null outside profiled updates)
+inline thread_local ComponentAccessSet* t_componentAccess = nullptr;
+
+[[nodiscard]] AUTOPHAGE_FORCE_INLINE ComponentAccessSet* componentAccess() noexcept
+{
+    return t_componentAccess;
+}
+#endif
+
+}  // namespace detail
+
+/// @brief Record component reads for the currently updating system
+template <typename... Ts> AUTOPHAGE_FORCE_INLINE void reportComponentRead()
+{
+#if AUTOPHAGE_PROFILE_LEVEL > 0
+    if (ComponentAccessSet* access = detail::componentAccess()) {
+        access->read<Ts...>();
+    }
+#endif
+}
+
+/// @brief Record component writes for the currently updating system
+template <typename... Ts> AUTOPHAGE_FORCE_INLINE void reportComponentWrite()
+{
+#if AUTOPHAGE_PROFILE_LEVEL > 0
+    if (ComponentAccessSet* access = detail::componentAccess()) {
+        access->write<Ts...>();
+    }
+#endif
+}
+
+/// @brief Record that the currently updating system created or destroyed entities
+AUTOPHAGE_FORCE_INLINE void reportStructuralChange() noexcept
+{
+#if AUTOPHAGE_PROFILE_LEVEL > 0
+    if (ComponentAccessSet* access = detail::componentAccess()) {
+        access->structural = true;
+    }
+#endif
+}
+
+}  // namespace autophage::ecs
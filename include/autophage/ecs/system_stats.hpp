@@ -0,0 +1,139 @@
+#pragma once
+
+/// @file system_stats.hpp
+/// @brief Rolling per-system timing statistics collected by SystemRegistry
+
+#include <autophage/core/types.hpp>
+#include <autophage/core/type_id.hpp>
+#include <autophage/ecs/system_access.hpp>
+
+#include <array>
+
+namespace autophage::ecs {
+
+enum class SystemVariant : u8;
+
+// =============================================================================
+// Entity Accounting
+// =============================================================================
+
+namespace detail {
+
+/// @brief The engine's thread-local below, exported for code compiled by the JIT (see
+///        engineCurrentMemoryTag() in memory.hpp)
+[[nodiscard]] u64& engineEntitiesProcessed() noexcept;
+
+#if defined(AUTOPHAGE_JIT_MODULE)
+[[nodiscard]] inline u64& entitiesProcessed() noexcept
+{
+    return engineEntitiesProcessed();
+}
+#else
+/// Entities processed on this thread; SystemRegistry diffs it around each update
+inline thread_local u64 t_entitiesProcessed = 0;
+
+[[nodiscard]] AUTOPHAGE_FORCE_INLINE u64& entitiesProcessed() noexcept
+{
+    return t_entitiesProcessed;
+}
+#endif
+
+}  // namespace detail
+
+/// @brief Attribute processed entities to the currently updating system
+/// @note Query::forEach reports automatically; call this from loops over views or raw arrays.
+inline void reportEntitiesProcessed(usize count) noexcept
+{
+    detail::entitiesProcessed() += count;
+}
+
+// =============================================================================
+// System Statistics
+// =============================================================================
+
+/// @brief Number of recent updates kept per system (and per variant)
+inline constexpr usize SYSTEM_STATS_WINDOW = 128;
+
+/// @brief Snapshot of a system's timing statistics
+struct SystemStats
+{
+    String name;
+    TypeId systemId;
+
+    /// Set for per-variant statistics, empty for the system-wide aggregate
+    Optional<SystemVariant> variant;
+
+    /// Updates since registration (or the last reset)
+    u64 invocations = 0;
+
+    /// Updates in the rolling window the figures below are computed from
+    usize windowSize = 0;
+
+    f64 lastNs = 0.0;
+    f64 meanNs = 0.0;
+    f64 p99Ns = 0.0;
+    f64 minNs = 0.0;
+    f64 maxNs = 0.0;
+
+    u64 lastEntities = 0;
+    f64 meanEntities = 0.0;
+
+    /// Heap allocations made during updates (tagged allocations, plus every new/delete when
+    /// built with AUTOPHAGE_TRACK_GLOBAL_ALLOCATIONS)
+    u64 lastAllocations = 0;
+    f64 meanAllocations = 0.0;
+    f64 meanAllocatedBytes = 0.0;
+
+    /// Component read/write set (declared by the system, else observed while it ran)
+    ComponentAccessSet access;
+    bool accessDeclared = false;
+
+    /// @brief Mean cost per processed entity (0 if the system reports no entities)
+    [[nodiscard]] f64 nsPerEntity() const noexcept
+    {
+        return meanEntities > 0.0 ? meanNs / meanEntities : 0.0;
+    }
+};
+
+/// @brief Fixed-size ring of recent update timings (raw profiler ticks)
+class SystemTimingWindow
+{
+public:
+    /// @brief Record one update
+    void record(i64 ticks, u64 entities, u64 allocations = 0, u64 allocatedBytes = 0) noexcept
+    {
+        ticks_[next_] = ticks;
+        entities_[next_] = entities;
+        allocations_[next_] = allocations;
+        allocatedBytes_[next_] = allocatedBytes;
+        next_ = (next_ + 1) % SYSTEM_STATS_WINDOW;
+        if (size_ < SYSTEM_STATS_WINDOW) {
+            ++size_;
+        }
+        ++invocations_;
+    }
+
+    /// @brief Drop all samples
+    void reset() noexcept
+    {
+        next_ = 0;
+        size_ = 0;
+        invocations_ = 0;
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+    /// @brief Fill the timing fields of a snapshot (converts ticks to nanoseconds)
+    void fill(SystemStats& stats) const;
+
+private:
+    std::array<i64, SYSTEM_STATS_WINDOW> ticks_{};
+    std::array<u64, SYSTEM_STATS_WINDOW> entities_{};
+    std::array<u64, SYSTEM_STATS_WINDOW> allocations_{};
+    std::array<u64, SYSTEM_STATS_WINDOW> allocatedBytes_{};
+    usize next_ = 0;
+    usize size_ = 0;
+    u64 invocations_ = 0;
+};
+
+}  // namespace autophage::ecs
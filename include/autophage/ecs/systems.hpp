@@ -9,6 +9,8 @@
 #include <autophage/ecs/system.hpp>
 #include <autophage/ecs/world.hpp>
 
+#include <memory_resource>
+
 // SIMD headers
 #if defined(AUTOPHAGE_SIMD_AVX2) || defined(AUTOPHAGE_SIMD_AVX)
     #include <immintrin.h>
@@ -31,6 +33,11 @@ class VelocitySystemScalar : public System<VelocitySystemScalar>
 public:
     VelocitySystemScalar() : System("VelocitySystem::Scalar") {}
 
+    void declareAccess(ComponentAccessSet& access) const override
+    {
+        access.read<Velocity>().write<Transform>();
+    }
+
     void update(World& world, f32 dt) override
     {
         auto q = world.query<Transform, Velocity>();
@@ -49,6 +56,11 @@ class VelocitySystemSIMD : public System<VelocitySystemSIMD>
 public:
     VelocitySystemSIMD() : System("VelocitySystem::SIMD") {}
 
+    void declareAccess(ComponentAccessSet& access) const override
+    {
+        access.read<Velocity>().write<Transform>();
+    }
+
     void update(World& world, f32 dt) override
     {
         // For now, fall back to scalar - full SoA implementation needed for true SIMD
@@ -95,6 +107,11 @@ public:
 #endif
     }
 
+    void declareAccess(ComponentAccessSet& access) const override
+    {
+        access.read<Velocity>().write<Transform>();
+    }
+
     void update(World& world, f32 dt) override
     {
         if (!enabled_)
@@ -177,6 +194,11 @@ class GravitySystem : public System<GravitySystem>
 public:
     GravitySystem() : System("GravitySystem") {}
 
+    void declareAccess(ComponentAccessSet& access) const override
+    {
+        access.read<Mass, Gravity>().write<Velocity>();
+    }
+
     void update(World& world, f32 dt) override
     {
         // Global gravity for entities without custom Gravity component
@@ -206,6 +228,11 @@ class AccelerationSystem : public System<AccelerationSystem>
 public:
     AccelerationSystem() : System("AccelerationSystem") {}
 
+    void declareAccess(ComponentAccessSet& access) const override
+    {
+        access.read<Acceleration>().write<Velocity>();
+    }
+
     void update(World& world, f32 dt) override
     {
         auto q = world.query<Velocity, Acceleration>();
@@ -227,6 +254,11 @@ class HierarchySystem : public System<HierarchySystem>
 public:
     HierarchySystem() : System("HierarchySystem") {}
 
+    void declareAccess(ComponentAccessSet& access) const override
+    {
+        access.read<Hierarchy>().write<Transform>();
+    }
+
     void update(World& world, [[maybe_unused]] f32 dt) override
     {
         // Process entities by depth level (root first, then children)
@@ -260,6 +292,11 @@ class BoundsSystem : public System<BoundsSystem>
 public:
     BoundsSystem() : System("BoundsSystem") {}
 
+    void declareAccess(ComponentAccessSet& access) const override
+    {
+        access.read<Transform>().write<AABB>();
+    }
+
     void update(World& world, [[maybe_unused]] f32 dt) override
     {
         auto q = world.query<Transform, AABB>();
@@ -287,7 +324,17 @@ public:
 class CleanupSystem : public System<CleanupSystem>
 {
 public:
-    CleanupSystem() : System("CleanupSystem") { toDestroy_.reserve(100); }
+    /// @param resource Resource backing the per-frame list of entities to destroy
+    explicit CleanupSystem(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : System("CleanupSystem"), toDestroy_(resource)
+    {
+        toDestroy_.reserve(100);
+    }
+
+    void declareAccess(ComponentAccessSet& access) const override
+    {
+        access.read<Destroyed>().makesStructuralChanges();
+    }
 
     void update(World& world, [[maybe_unused]] f32 dt) override
     {
@@ -307,7 +354,7 @@ public:
     }
 
 private:
-    std::vector<Entity> toDestroy_;
+    std::pmr::vector<Entity> toDestroy_;
 };
 
 }  // namespace autophage::ecs
@@ -12,6 +12,7 @@ public:
     PhysicsSystem();
 
     void update(World& world, f32 dt) override;
+    void declareAccess(ComponentAccessSet& access) const override;
 
     // IVariantSystem implementation
     [[nodiscard]] std::vector<SystemVariant> availableVariants() const override;
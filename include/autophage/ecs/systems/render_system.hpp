@@ -11,6 +11,7 @@ public:
     explicit RenderSystem(IWindow& window);
 
     void update(World& world, f32 dt) override;
+    void declareAccess(ComponentAccessSet& access) const override;
 
 private:
     IWindow& window_;
@@ -8,6 +8,8 @@
 #include <autophage/ecs/entity.hpp>
 #include <autophage/ecs/query.hpp>
 #include <autophage/ecs/system.hpp>
+#include <autophage/ecs/system_access.hpp>
+#include <autophage/profiler/access_tracking.hpp>
 
 namespace autophage::ecs {
 
@@ -33,11 +35,16 @@ public:
     // =========================================================================
 
     /// @brief Create a new entity
-    [[nodiscard]] Entity createEntity() { return entities_.create(); }
+    [[nodiscard]] Entity createEntity()
+    {
+        reportStructuralChange();
+        return entities_.create();
+    }
 
     /// @brief Destroy an entity and all its components
     void destroyEntity(Entity entity)
     {
+        reportStructuralChange();
         if (entities_.destroy(entity)) {
             components_.onEntityDestroyed(entity);
         }
@@ -59,30 +66,40 @@ public:
     /// @brief Add a component to an entity
     template <Component T> T& addComponent(Entity entity, T component = T{})
     {
+        reportComponentWrite<T>();
         return components_.getArray<T>().set(entity, std::move(component));
     }
 
     /// @brief Get a component from an entity (mutable)
+    /// @note Counted as a random access and a write for the running system (see
+    ///       access_tracking.hpp and system_access.hpp)
     template <Component T> [[nodiscard]] T* getComponent(Entity entity)
     {
+        recordRandomAccess(entity.index);
+        reportComponentWrite<T>();
         return components_.getArray<T>().get(entity);
     }
 
     /// @brief Get a component from an entity (const)
     template <Component T> [[nodiscard]] const T* getComponent(Entity entity) const
     {
-        return components_.getArray<T>().get(entity);
+        recordRandomAccess(entity.index);
+        reportComponentRead<T>();
+        return components_.isRegistered<T>() ? components_.getArray<T>().get(entity) : nullptr;
     }
 
-    /// @brief Check if an entity has a component
+    /// @brief Check if an entity has a component (false for types never added)
     template <Component T> [[nodiscard]] bool hasComponent(Entity entity) const
     {
-        return components_.getArray<T>().has(entity);
+        recordRandomAccess(entity.index);
+        reportComponentRead<T>();
+        return components_.isRegistered<T>() && components_.getArray<T>().has(entity);
     }
 
     /// @brief Remove a component from an entity
     template <Component T> void removeComponent(Entity entity)
     {
+        reportComponentWrite<T>();
         components_.getArray<T>().remove(entity);
     }
 
@@ -96,12 +113,14 @@ public:
     /// @brief Create a query for entities with specific components
     template <Component... Components> [[nodiscard]] Query<Components...> query()
     {
+        reportComponentWrite<Components...>();
         return Query<Components...>(components_);
     }
 
     /// @brief Create a view for iterating entities with specific components
     template <Component... Components> [[nodiscard]] View<Components...> view()
     {
+        reportComponentWrite<Components...>();
         return View<Components...>(components_);
     }
 
@@ -124,6 +143,13 @@ public:
         return systems_.replaceSystem<T, NewT>(*this, std::forward<Args>(args)...);
     }
 
+    /// @brief Replace an existing system, found by name, with a new one
+    template <typename NewT, typename... Args>
+    NewT& replaceSystemByName(const char* name, Args&&... args)
+    {
+        return systems_.replaceSystemByName<NewT>(*this, name, std::forward<Args>(args)...);
+    }
+
     /// @brief Initialize all systems
     void initSystems() { systems_.initAll(*this); }
 
@@ -0,0 +1,245 @@
+#pragma once
+
+/// @file decision_log.hpp
+/// @brief Binary audit log of optimizer decisions, replayable against other rule sets
+///
+/// Every optimizer update appends a Frame record (frame number, time and, unless disabled, every
+/// series sample recorded that frame, which makes the log its own stats trace). Each fired rule
+/// action appends a Decision record with the statistics its conditions compared and whether it
+/// was applied, and each finished variant trial appends an Effect record with the measured
+/// verdict. Variant switches made by the VariantTuner append Tuner records, and a band decision
+/// also appends an Effect record comparing its best challenger with the original variant. Feeding the frames back into a StatsCollector reproduces exactly what the rules saw
+/// live, so an alternative rule set can be evaluated offline (see autophage_decision_replay).
+///
+/// File layout: a DecisionLogHeader followed by records, each `u8 type` then its fields:
+///
+///   String:   varint id | varint length | bytes
+///   Frame:    varint frame | f64 time | varint count | (varint series | f64 value) * count
+///   Decision: varint frame | varint rule | u8 kind | varint target | varint argument |
+///             u8 applied | varint count | (varint series | u8 stat | u8 window | f64 value) * count
+///   Effect:   varint frame | varint subject | varint baseline | varint candidate | u8 verdict |
+///             f64 confidence | f64 relative change | f64 baseline median |
+///             f64 candidate median | u8 rolled back
+///   Tuner:    varint frame | varint system | u8 kind | varint band | u8 from | u8 to |
+///             f64 ns per entity
+///
+/// Names are interned: a String record precedes the first record using its id. Records are
+/// buffered and written in large chunks, and logging stops at a size limit, so the cost on the
+/// frame is an append to memory. All integers are little-endian; a truncated tail (a crash
+/// mid-write) is ignored by the reader.
+
+#include <autophage/analyzer/regression_detector.hpp>
+#include <autophage/analyzer/stats_collector.hpp>
+#include <autophage/core/types.hpp>
+#include <autophage/optimizer/rule_engine.hpp>
+#include <autophage/optimizer/variant_tuner.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace autophage::optimizer {
+
+// =============================================================================
+// On-Disk Format
+// =============================================================================
+
+inline constexpr char DECISION_LOG_MAGIC[8] = {'A', 'P', 'D', 'E', 'C', 'L', 'O', 'G'};
+inline constexpr u32 DECISION_LOG_VERSION = 2;  // 2: Tuner records (version 1 still loads)
+
+/// @brief File header
+struct DecisionLogHeader
+{
+    char magic[8] = {};
+    u32 version = 0;
+    u32 flags = 0;  // DECISION_LOG_FLAG_*
+};
+static_assert(sizeof(DecisionLogHeader) == 16);
+
+/// @brief Frame records carry series samples
+inline constexpr u32 DECISION_LOG_FLAG_STATS = 1u << 0;
+
+/// @brief Record types
+enum class DecisionRecordType : u8
+{
+    String = 0,
+    Frame = 1,
+    Decision = 2,
+    Effect = 3,
+    Tuner = 4,
+};
+
+// =============================================================================
+// Writer
+// =============================================================================
+
+/// @brief Decision log settings
+struct DecisionLogConfig
+{
+    /// Write every series sample with each frame (needed for replay)
+    bool recordStats = true;
+
+    /// Buffered bytes that trigger a write to the file
+    usize flushBytes = 64 * 1024;
+
+    /// File size at which logging stops
+    u64 maxBytes = u64{256} << 20;
+};
+
+/// @brief Appends decision records to a log file
+class DecisionLogWriter
+{
+public:
+    DecisionLogWriter() = default;
+    ~DecisionLogWriter();
+
+    DecisionLogWriter(const DecisionLogWriter&) = delete;
+    DecisionLogWriter& operator=(const DecisionLogWriter&) = delete;
+
+    /// @brief Create (or truncate) a log file
+    bool open(const std::filesystem::path& path, const DecisionLogConfig& config = {});
+
+    /// @brief Flush and close the file
+    void close();
+
+    [[nodiscard]] bool isOpen() const noexcept { return file_ != nullptr; }
+    [[nodiscard]] const DecisionLogConfig& config() const noexcept { return config_; }
+
+    /// @brief Bytes in the file plus bytes still buffered
+    [[nodiscard]] u64 size() const noexcept { return written_ + buffer_.size(); }
+
+    /// @brief Log a frame and the samples recorded during it
+    /// @param series Store the sample ids belong to (resolves their names)
+    void writeFrame(u64 frame, f64 timeSeconds, std::span<const analyzer::SeriesSample> samples,
+                    const analyzer::TimeSeriesStore& series);
+
+    /// @brief Log a fired rule action
+    void writeDecision(u64 frame, const FiredAction& fired, bool applied);
+
+    /// @brief Log the verdict of a variant trial
+    void writeEffect(u64 frame, const analyzer::RegressionResult& result, bool rolledBack);
+
+    /// @brief Log a variant switch or band decision of the tuner, and the decision's verdict
+    void writeTunerEvent(u64 frame, const TunerEvent& event);
+
+    /// @brief Write buffered records to the file
+    void flush();
+
+private:
+    /// @brief Id of a name, writing its String record on first use
+    [[nodiscard]] u32 intern(StringView name);
+
+    /// @brief Flush if the buffer is full, stop at the size limit
+    void commit();
+
+    void putByte(u8 value) { buffer_.push_back(value); }
+    void putVarint(u64 value);
+    void putF64(f64 value);
+
+    std::FILE* file_ = nullptr;
+    DecisionLogConfig config_;
+    std::vector<u8> buffer_;
+    u64 written_ = 0;
+    bool full_ = false;
+
+    std::unordered_map<String, u32> strings_;
+    std::vector<u32> seriesStrings_;  // Indexed by SeriesId
+};
+
+// =============================================================================
+// Reader
+// =============================================================================
+
+/// @brief A sample of a logged frame
+struct LoggedSample
+{
+    u32 name = 0;  // Index into DecisionLogReader::names()
+    f64 value = 0.0;
+};
+
+/// @brief A logged frame
+struct LoggedFrame
+{
+    u64 frame = 0;
+    f64 timeSeconds = 0.0;
+    std::vector<LoggedSample> samples;
+};
+
+/// @brief A logged rule action
+struct LoggedDecision
+{
+    u64 frame = 0;
+    FiredAction fired;
+    bool applied = false;
+};
+
+/// @brief A logged trial verdict
+struct LoggedEffect
+{
+    u64 frame = 0;
+    analyzer::RegressionResult result;
+    bool rolledBack = false;
+    bool tuner = false;  // Verdict of a tuner band decision rather than of a trial
+};
+
+/// @brief A logged tuner event (a Decided event carries the verdict logged with it)
+struct LoggedTunerEvent
+{
+    u64 frame = 0;
+    TunerEvent event;
+};
+
+/// @brief Loads a whole decision log
+class DecisionLogReader
+{
+public:
+    /// @brief Read a log file
+    /// @return false if the file cannot be read or is not a decision log (see lastError())
+    bool load(const std::filesystem::path& path);
+
+    [[nodiscard]] const String& lastError() const noexcept { return lastError_; }
+    [[nodiscard]] const DecisionLogHeader& header() const noexcept { return header_; }
+
+    /// @brief Whether the file ended inside a record (the rest was loaded)
+    [[nodiscard]] bool truncated() const noexcept { return truncated_; }
+
+    [[nodiscard]] const std::vector<String>& names() const noexcept { return names_; }
+    [[nodiscard]] const std::vector<LoggedFrame>& frames() const noexcept { return frames_; }
+    [[nodiscard]] const std::vector<LoggedDecision>& decisions() const noexcept
+    {
+        return decisions_;
+    }
+    [[nodiscard]] const std::vector<LoggedEffect>& effects() const noexcept { return effects_; }
+    [[nodiscard]] const std::vector<LoggedTunerEvent>& tunerEvents() const noexcept
+    {
+        return tunerEvents_;
+    }
+
+private:
+    void clear();
+
+    DecisionLogHeader header_{};
+    std::vector<String> names_;
+    std::vector<LoggedFrame> frames_;
+    std::vector<LoggedDecision> decisions_;
+    std::vector<LoggedEffect> effects_;
+    std::vector<LoggedTunerEvent> tunerEvents_;
+    bool truncated_ = false;
+    String lastError_;
+};
+
+// =============================================================================
+// Replay
+// =============================================================================
+
+/// @brief Run a rule engine over the stats trace of a log, one update per logged frame
+/// @return Actions the engine fired, stamped with the logged frame number
+/// @note The engine should be freshly loaded: its evaluation interval and cooldowns count
+///       from the first logged frame. Every fired action is taken as applied, so rules are
+///       never rearmed the way refused live decisions are.
+[[nodiscard]] std::vector<LoggedDecision> replayRules(const DecisionLogReader& log,
+                                                      RuleEngine& engine);
+
+}  // namespace autophage::optimizer
@@ -1,21 +1,148 @@
 #pragma once
 
+#include <autophage/analyzer/execution_graph.hpp>
+#include <autophage/analyzer/regression_detector.hpp>
 #include <autophage/analyzer/stats_collector.hpp>
 #include <autophage/core/types.hpp>
 #include <autophage/ecs/world.hpp>
+#include <autophage/optimizer/decision_log.hpp>
+#include <autophage/optimizer/rule_engine.hpp>
+#include <autophage/optimizer/tuning_profile.hpp>
+#include <autophage/optimizer/variant_tuner.hpp>
 
+#include <array>
+#include <filesystem>
+#include <functional>
+#include <unordered_map>
 
 namespace autophage::optimizer {
 
 class Optimizer
 {
 public:
-    explicit Optimizer(analyzer::StatsCollector& stats);
+    /// @brief Updates to wait after a rollback before trying the rejected variant again
+    static constexpr u32 ROLLBACK_COOLDOWN_UPDATES = 600;
 
+    /// @brief Updates between automatic saves of the tuning profile (when one is in use)
+    static constexpr u32 PROFILE_SAVE_INTERVAL_UPDATES = 3600;
+
+    /// @brief Applies a rule action the optimizer has no built-in support for
+    /// @return true if the action was applied
+    using ActionHandler = std::function<bool(ecs::World&, const RuleAction&)>;
+
+    explicit Optimizer(analyzer::StatsCollector& stats,
+                       const analyzer::RegressionConfig& regressionConfig = {},
+                       const VariantTunerConfig& tunerConfig = {});
+
+    /// @brief Record this frame's metrics, tune variant systems, judge rule-driven switches
+    ///        and hot swaps, and apply fired rules
     void update(ecs::World& world);
 
+    /// @brief Replace the rules with a rule file, reloaded when it changes
+    /// @return false (keeping the current rules) if the file is missing or malformed
+    bool loadRules(const std::filesystem::path& path) { return rules_.loadFile(path); }
+
+    /// @brief Replace the rules with rule text
+    bool loadRuleText(StringView text) { return rules_.load(text); }
+
+    [[nodiscard]] const RuleEngine& rules() const noexcept { return rules_; }
+
+    /// @brief Per entity-count band variant choices of every variant system
+    /// @note Systems switched by a rule are pinned and left out of tuning.
+    [[nodiscard]] VariantTuner& tuner() noexcept { return tuner_; }
+    [[nodiscard]] const VariantTuner& tuner() const noexcept { return tuner_; }
+
+    /// @brief Start from the tuning saved for this machine and build in a profile file, and keep
+    ///        saving to it every PROFILE_SAVE_INTERVAL_UPDATES updates
+    /// @return false if the file could not be read (it is still used for saving)
+    bool useTuningProfile(const std::filesystem::path& path);
+
+    /// @brief Write the current tuning to the profile file now (e.g. before shutdown)
+    bool saveTuningProfile();
+
+    [[nodiscard]] const TuningProfile& tuningProfile() const noexcept { return profile_; }
+
+    /// @brief Record every update, fired rule, tuner switch and trial verdict to a binary
+    ///        decision log
+    bool openDecisionLog(const std::filesystem::path& path, const DecisionLogConfig& config = {})
+    {
+        return decisionLog_.open(path, config);
+    }
+
+    /// @brief Flush and close the decision log
+    void closeDecisionLog() { decisionLog_.close(); }
+
+    [[nodiscard]] const DecisionLogWriter& decisionLog() const noexcept { return decisionLog_; }
+
+    /// @brief Updates run so far (the frame numbers of the decision log)
+    [[nodiscard]] u64 frame() const noexcept { return frame_; }
+
+    /// @brief Install the backend for an action kind (overrides the built-in switchVariant)
+    void setActionHandler(RuleActionKind kind, ActionHandler handler)
+    {
+        handlers_[static_cast<usize>(kind)] = std::move(handler);
+    }
+
+    /// @brief Verdict of the most recent trial (variant switch or hot swap), if any finished
+    [[nodiscard]] const Optional<analyzer::RegressionResult>& lastVerdict() const noexcept
+    {
+        return lastVerdict_;
+    }
+
+    /// @brief System dependency graph of the last update, weighted by that frame's timings
+    [[nodiscard]] const analyzer::ExecutionGraph& executionGraph() const noexcept
+    {
+        return graph_;
+    }
+
+    /// @brief Critical path of the last update
+    [[nodiscard]] const analyzer::CriticalPathReport& criticalPath() const noexcept
+    {
+        return criticalPath_;
+    }
+
 private:
+    /// @brief Rebuild the execution graph from the systems' latest timings
+    void analyzeExecution(const std::vector<ecs::SystemStats>& systems);
+
+    /// @brief Trial and rollback state of one system
+    struct SystemTrack
+    {
+        u64 invocations = 0;
+        ecs::SystemVariant previous = ecs::SystemVariant::Scalar;
+        bool variantTrial = false;  // The running trial can be rolled back to `previous`
+        u32 cooldown = 0;
+    };
+
+    /// @brief Record world and per-system series that rules can refer to
+    void recordMetrics(ecs::World& world, const std::vector<ecs::SystemStats>& systems);
+
+    /// @brief Feed a system's latest update into the detector, judge its trial
+    /// @param variants The system's variant interface, if it has one (enables rollback)
+    void trackSystem(const ecs::SystemStats& stats, ecs::IVariantSystem* variants);
+
+    /// @brief Dispatch one action fired by a rule
+    /// @return true if the action was applied
+    bool apply(ecs::World& world, const FiredAction& fired);
+
+    /// @brief Switch a system's variant and start a trial measuring the switch
+    bool switchVariant(ecs::World& world, const FiredAction& fired);
+
     analyzer::StatsCollector& stats_;
+    analyzer::RegressionDetector detector_;
+    Optional<analyzer::RegressionResult> lastVerdict_;
+    analyzer::ExecutionGraph graph_;
+    analyzer::CriticalPathReport criticalPath_;
+    VariantTuner tuner_;
+    TuningProfile profile_;
+    std::filesystem::path profilePath_;
+    u32 updatesSinceProfileSave_ = 0;
+    RuleEngine rules_;
+    DecisionLogWriter decisionLog_;
+    std::vector<analyzer::SeriesSample> frameSamples_;
+    u64 frame_ = 0;
+    std::array<ActionHandler, RULE_ACTION_KIND_COUNT> handlers_;
+    std::unordered_map<String, SystemTrack> tracks_;
 };
 
 }  // namespace autophage::optimizer
@@ -0,0 +1,240 @@
+#pragma once
+
+/// @file rule_engine.hpp
+/// @brief Declarative optimization rules over analyzer metrics
+///
+/// Rules are plain text, one statement per line (`#` starts a comment):
+///
+///     evaluate every 30                # Frames between evaluations (default 1)
+///
+///     rule physics_simd priority 10 cooldown 600
+///         when world.entities > 500 hysteresis 50
+///         and  system/PhysicsSystem.ns_per_entity mean 10s > 2.0
+///         do   switchVariant PhysicsSystem SIMD
+///     end
+///
+/// A condition reads `<series> [stat] [window] <op> <number> [hysteresis <number>]`, where the
+/// series is any StatsCollector series, stat is mean (default), min, max, stddev, slope or count,
+/// window is 1s (default), 10s or 5min, and op is one of < <= > >= == !=.
+///
+/// Actions: `switchVariant <System> <Variant>`, `migrateLayout <Component> <AoS|SoA>`,
+/// `setThreadCount <n>` and `hotSwap <System> <source file>`.
+///
+/// Rules are edge triggered: a rule fires when all its conditions become true, then stays
+/// armed-off until they stop holding. Hysteresis widens the threshold while the rule is active
+/// (`> 500 hysteresis 50` keeps holding down to 450), so a metric hovering at the threshold does
+/// not toggle. A rule whose actions the caller could not apply is handed back with rearm() and
+/// fires again at the next evaluation its conditions still hold. Cooldown is the minimum number
+/// of frames between two firings. When rules with
+/// actions on the same target fire together, only the highest priority one is applied.
+
+#include <autophage/analyzer/stats_collector.hpp>
+#include <autophage/core/types.hpp>
+
+#include <filesystem>
+#include <vector>
+
+namespace autophage::optimizer {
+
+// =============================================================================
+// Rule Definitions
+// =============================================================================
+
+/// @brief Operation requested by a rule
+enum class RuleActionKind : u8
+{
+    SwitchVariant,   // target: system name, argument: variant name
+    MigrateLayout,   // target: component name, argument: AoS or SoA
+    SetThreadCount,  // argument: thread count
+    HotSwap,         // target: system name, argument: source file path
+
+    Count
+};
+
+inline constexpr usize RULE_ACTION_KIND_COUNT = static_cast<usize>(RuleActionKind::Count);
+
+/// @brief Convert action kind to its DSL keyword
+[[nodiscard]] constexpr StringView toString(RuleActionKind kind) noexcept
+{
+    switch (kind) {
+        case RuleActionKind::SwitchVariant:
+            return "switchVariant";
+        case RuleActionKind::MigrateLayout:
+            return "migrateLayout";
+        case RuleActionKind::SetThreadCount:
+            return "setThreadCount";
+        case RuleActionKind::HotSwap:
+            return "hotSwap";
+        case RuleActionKind::Count:
+            break;
+    }
+    return "Unknown";
+}
+
+/// @brief One action of a rule
+struct RuleAction
+{
+    RuleActionKind kind = RuleActionKind::SwitchVariant;
+    String target;
+    String argument;
+};
+
+/// @brief Statistic of a series window a condition compares
+enum class MetricStat : u8
+{
+    Mean,
+    Min,
+    Max,
+    StdDev,
+    Slope,  // Per second
+    Count,
+};
+
+/// @brief Convert statistic to its DSL keyword
+[[nodiscard]] constexpr StringView toString(MetricStat stat) noexcept
+{
+    switch (stat) {
+        case MetricStat::Mean:
+            return "mean";
+        case MetricStat::Min:
+            return "min";
+        case MetricStat::Max:
+            return "max";
+        case MetricStat::StdDev:
+            return "stddev";
+        case MetricStat::Slope:
+            return "slope";
+        case MetricStat::Count:
+            return "count";
+    }
+    return "Unknown";
+}
+
+/// @brief Comparison of a condition
+enum class CompareOp : u8
+{
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+    Equal,
+    NotEqual,
+};
+
+/// @brief `<series> <stat> <window> <op> <threshold> hysteresis <h>`
+struct RuleCondition
+{
+    String series;
+    MetricStat stat = MetricStat::Mean;
+    analyzer::TimeWindow window = analyzer::TimeWindow::Last1s;
+    CompareOp op = CompareOp::Greater;
+    f64 threshold = 0.0;
+    f64 hysteresis = 0.0;
+};
+
+/// @brief A named set of conditions (all must hold) and the actions they trigger
+struct Rule
+{
+    String name;
+    i32 priority = 0;
+    u32 cooldownFrames = 0;
+    std::vector<RuleCondition> conditions;
+    std::vector<RuleAction> actions;
+};
+
+/// @brief Parsed rule file
+struct RuleSet
+{
+    u32 evaluateEvery = 1;
+    std::vector<Rule> rules;  // Sorted by descending priority (stable)
+};
+
+/// @brief Parse rule text
+/// @param error Receives "<line>: <message>" on failure (optional)
+/// @return false if the text is malformed (out is left untouched)
+[[nodiscard]] bool parseRules(StringView text, RuleSet& out, String* error = nullptr);
+
+// =============================================================================
+// Rule Engine
+// =============================================================================
+
+/// @brief Statistic a condition compared when its rule fired
+struct ConditionInput
+{
+    String series;
+    MetricStat stat = MetricStat::Mean;
+    analyzer::TimeWindow window = analyzer::TimeWindow::Last1s;
+    f64 value = 0.0;
+};
+
+/// @brief Action chosen by an evaluation, with the rule that chose it
+struct FiredAction
+{
+    String rule;
+    RuleAction action;
+    std::vector<ConditionInput> inputs;  // One per condition of the rule
+};
+
+/// @brief Evaluates a rule set against a StatsCollector every N frames
+class RuleEngine
+{
+public:
+    /// @brief Frames between checks of the rule file's modification time
+    static constexpr u32 RELOAD_CHECK_INTERVAL = 60;
+
+    /// @brief Replace the rules with parsed text
+    /// @return false (keeping the current rules) if the text is malformed
+    bool load(StringView text, StringView sourceName = "<rules>");
+
+    /// @brief Load rules from a file and watch it for changes
+    bool loadFile(const std::filesystem::path& path);
+
+    /// @brief Reload the watched file if it was modified since it was loaded
+    /// @return true if new rules were loaded
+    bool reloadIfChanged();
+
+    /// @brief Advance one frame and evaluate if due
+    /// @return Actions to apply (empty on frames without evaluation)
+    [[nodiscard]] std::vector<FiredAction> update(const analyzer::StatsCollector& stats);
+
+    /// @brief Evaluate now, regardless of the evaluation interval
+    [[nodiscard]] std::vector<FiredAction> evaluate(const analyzer::StatsCollector& stats);
+
+    /// @brief Report that the actions a rule just fired were not applied
+    ///
+    /// Undoes the firing: the rule fires again at the next evaluation its conditions still hold,
+    /// and its cooldown does not start.
+    void rearm(StringView rule);
+
+    [[nodiscard]] const RuleSet& rules() const noexcept { return rules_; }
+    [[nodiscard]] const String& lastError() const noexcept { return lastError_; }
+
+    /// @brief Frames advanced by update()
+    [[nodiscard]] u64 frame() const noexcept { return frame_; }
+
+private:
+    struct RuleState
+    {
+        bool active = false;
+        bool fired = false;
+        u64 lastFiredFrame = 0;
+        bool firedBefore = false;  // fired/lastFiredFrame before the latest firing, for rearm()
+        u64 firedBeforeFrame = 0;
+        std::vector<analyzer::SeriesId> series;  // Resolved lazily, parallel to conditions
+    };
+
+    /// @param value Receives the compared statistic
+    [[nodiscard]] static bool conditionHolds(const RuleCondition& condition,
+                                             analyzer::SeriesId& series, bool active,
+                                             const analyzer::StatsCollector& stats, f64& value);
+
+    RuleSet rules_;
+    std::vector<RuleState> states_;  // Parallel to rules_.rules
+    String lastError_;
+    u64 frame_ = 0;
+
+    std::filesystem::path path_;
+    std::filesystem::file_time_type loadedWriteTime_{};
+};
+
+}  // namespace autophage::optimizer
@@ -0,0 +1,106 @@
+#pragma once
+
+/// @file tuning_profile.hpp
+/// @brief Tuning decisions persisted across runs
+///
+/// What the tuner learns is only valid for the hardware and the build it was measured on, so
+/// every entry is keyed by CPU model, hardware thread count and build hash, plus system name
+/// and entity-count band. One file can hold entries for many machines and builds (a shared
+/// deployment directory, say); each process loads only those matching itself and writes its
+/// own back without disturbing the rest: save() holds a `.lock` file next to the profile while
+/// it re-reads the file, merges its entries over what is there and renames the result into
+/// place, so concurrent writers never drop each other's entries.
+///
+/// The file is text, one band per line, tab separated:
+///
+///     cpu model <TAB> threads <TAB> build hash <TAB> system <TAB> band <TAB> chosen variant
+///         <TAB> variant:weight:mean:variance,variant:weight:mean:variance...
+
+#include <autophage/core/types.hpp>
+#include <autophage/ecs/system.hpp>
+#include <autophage/optimizer/variant_bandit.hpp>
+
+#include <filesystem>
+#include <vector>
+
+namespace autophage::optimizer {
+
+// =============================================================================
+// Profile Entries
+// =============================================================================
+
+/// @brief Measured cost of one variant in a band (cost per entity)
+struct TunedArm
+{
+    ecs::SystemVariant variant = ecs::SystemVariant::Scalar;
+    ArmStats stats;
+};
+
+/// @brief Tuning result of one system in one entity-count band
+struct TunedBand
+{
+    String system;
+    u32 band = 0;
+    ecs::SystemVariant chosen = ecs::SystemVariant::Scalar;
+    std::vector<TunedArm> arms;
+};
+
+/// @brief Machine and build a profile entry was measured on
+struct TuningProfileKey
+{
+    String cpuModel;
+    u32 logicalCores = 0;
+    String buildHash;
+
+    /// @brief Key of the running process
+    [[nodiscard]] static TuningProfileKey current();
+
+    [[nodiscard]] bool operator==(const TuningProfileKey&) const = default;
+};
+
+// =============================================================================
+// Tuning Profile
+// =============================================================================
+
+/// @brief Collection of tuned bands for any number of machines and builds
+class TuningProfile
+{
+public:
+    /// @brief Magic first line of a profile file
+    static constexpr StringView FILE_HEADER = "autophage-tuning-profile 1";
+
+    /// @brief Replace the contents with a profile file
+    /// @return false if the file is missing or not a profile (contents are then unchanged)
+    bool load(const std::filesystem::path& path);
+
+    /// @brief Merge the profile into a file (through a temporary file, so a crash never leaves
+    ///        half of one)
+    ///
+    /// Entries already in the file are kept unless this profile holds the same key, system and
+    /// band; entries removed from this profile are therefore not removed from the file.
+    /// @return false if the file could not be written or another writer held the lock too long
+    bool save(const std::filesystem::path& path) const;
+
+    /// @brief Bands measured under a key
+    [[nodiscard]] std::vector<TunedBand> bandsFor(const TuningProfileKey& key) const;
+
+    /// @brief Add or replace bands under a key (matched by system and band)
+    void store(const TuningProfileKey& key, const std::vector<TunedBand>& bands);
+
+    [[nodiscard]] usize size() const noexcept { return entries_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return entries_.empty(); }
+    void clear() noexcept { entries_.clear(); }
+
+private:
+    void storeEntry(const TuningProfileKey& key, const TunedBand& band);
+
+    struct Entry
+    {
+        TuningProfileKey key;
+        TunedBand band;
+    };
+
+    std::vector<Entry> entries_;
+};
+
+}  // namespace autophage::optimizer
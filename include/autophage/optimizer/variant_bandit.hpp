@@ -0,0 +1,100 @@
+#pragma once
+
+/// @file variant_bandit.hpp
+/// @brief Multi-armed bandit over the variants of one system
+///
+/// Each variant is an arm whose cost is the measured time per entity of one update. The
+/// bandit keeps a discounted running mean and variance per arm, so old measurements fade and
+/// the estimate follows load changes. Selection either takes the lowest optimistic cost bound
+/// (UCB) or the lowest cost drawn from each arm's posterior (Thompson sampling); both explore
+/// arms that are uncertain and exploit the one that is known to be cheap.
+
+#include <autophage/core/types.hpp>
+
+#include <random>
+#include <vector>
+
+namespace autophage::optimizer {
+
+/// @brief How the bandit trades exploration for exploitation
+enum class BanditPolicy : u8
+{
+    Ucb,       // Lowest confidence bound on cost
+    Thompson,  // Lowest cost sampled from a normal posterior per arm
+};
+
+/// @brief Convert bandit policy to string
+[[nodiscard]] constexpr StringView toString(BanditPolicy policy) noexcept
+{
+    switch (policy) {
+        case BanditPolicy::Ucb:
+            return "UCB";
+        case BanditPolicy::Thompson:
+            return "Thompson";
+    }
+    return "Unknown";
+}
+
+/// @brief Bandit parameters
+struct BanditConfig
+{
+    BanditPolicy policy = BanditPolicy::Thompson;
+
+    /// Extra time per frame, over all systems, that exploring slower variants may cost
+    f64 explorationBudgetUs = 200.0;
+
+    /// Weight kept by past samples at each new sample of the arm set (1: never forget)
+    f64 discount = 0.995;
+
+    /// Width of the UCB confidence term, in standard deviations
+    f64 ucbScale = 1.0;
+
+    /// Sample weight a persisted prior counts as at most, so the bandit can still unlearn it
+    f64 priorWeight = 8.0;
+
+    u64 seed = 0xD1B54A32D192ED03ull;
+};
+
+/// @brief Discounted cost statistics of one arm
+struct ArmStats
+{
+    f64 weight = 0.0;  // Effective number of samples
+    f64 mean = 0.0;
+    f64 variance = 0.0;
+
+    [[nodiscard]] bool empty() const noexcept { return weight <= 0.0; }
+};
+
+/// @brief Arms of one system (in one entity-count band)
+class VariantBandit
+{
+public:
+    VariantBandit() = default;
+    explicit VariantBandit(usize arms) : arms_(arms) {}
+
+    [[nodiscard]] usize armCount() const noexcept { return arms_.size(); }
+    [[nodiscard]] const ArmStats& arm(usize index) const { return arms_[index]; }
+
+    /// @brief Add a cost sample; all arms' past samples are discounted first
+    void record(usize arm, f64 cost, f64 discount);
+
+    /// @brief Seed an arm with persisted statistics, capped at a maximum weight
+    void setPrior(usize arm, const ArmStats& stats, f64 maxWeight);
+
+    /// @brief Arm with the lowest mean cost (nullopt before any sample)
+    [[nodiscard]] Optional<usize> best() const noexcept;
+
+    /// @brief Arm the policy wants to run next (untried arms first)
+    [[nodiscard]] usize choose(const BanditConfig& config, std::mt19937_64& rng) const;
+
+    /// @brief Expected cost of an arm; untried arms are assumed twice as slow as the best
+    [[nodiscard]] f64 expectedCost(usize arm) const noexcept;
+
+private:
+    /// @brief Standard deviation of an arm's samples, floored at 1% of its mean
+    [[nodiscard]] f64 spread(const ArmStats& stats) const noexcept;
+
+    std::vector<ArmStats> arms_;
+};
+
+}  // namespace autophage::optimizer
@@ -0,0 +1,269 @@
+#pragma once
+
+/// @file variant_tuner.hpp
+/// @brief Online benchmarking of every variant system, per entity-count band
+///
+/// Which implementation of a system is fastest depends on how many entities it processes
+/// (SIMD setup costs dominate small batches, for instance), so the tuner keeps a separate
+/// decision per band of entity counts. Bands are powers of four: [0, 4), [4, 16), [16, 64)...
+///
+/// While a band is undecided, the system's variants take turns running short trial windows
+/// (A A B B A A B B ...), so slow drift in frame conditions hits every variant alike. After a
+/// fixed number of rounds the cheapest variant by median cost per entity is chosen, but the
+/// system's original variant is only abandoned for a significant improvement (Mann-Whitney
+/// test plus a minimum effect). Decided bands are applied immediately whenever the population
+/// moves between them.
+///
+/// The Bandit strategy instead treats each band's variants as the arms of a VariantBandit and
+/// picks one per update. It never stops learning, so it follows hardware and load changes, and
+/// the exploration it does is capped by a time budget per frame.
+///
+/// Results can be exported into a TuningProfile and imported on the next run, so a restarted
+/// process starts tuned: Benchmark bands start decided, Bandit arms start from priors.
+///
+/// With recordEvents() on, every switch the tuner makes and every band decision is kept as a
+/// TunerEvent until takeEvents(), which is how the optimizer logs them.
+
+#include <autophage/analyzer/regression_detector.hpp>
+#include <autophage/core/types.hpp>
+#include <autophage/ecs/system.hpp>
+#include <autophage/ecs/system_stats.hpp>
+#include <autophage/optimizer/tuning_profile.hpp>
+#include <autophage/optimizer/variant_bandit.hpp>
+
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace autophage::ecs {
+class World;
+}
+
+namespace autophage::optimizer {
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+/// @brief How the tuner finds the fastest variant
+enum class VariantStrategy : u8
+{
+    Benchmark,  // Interleaved trial windows, then a fixed decision per band
+    Bandit,     // Continuous bandit selection under an exploration budget
+};
+
+/// @brief Trial window and decision parameters of the tuner
+struct VariantTunerConfig
+{
+    VariantStrategy strategy = VariantStrategy::Benchmark;
+
+    /// Measured updates of one variant before the next one takes over
+    u32 windowUpdates = 8;
+
+    /// Times each variant gets a window before the band is decided
+    u32 rounds = 4;
+
+    /// Updates discarded after each switch (cold caches, lazily built state)
+    u32 warmupUpdates = 1;
+
+    /// Confidence required to replace the original variant
+    f64 confidence = 0.95;
+
+    /// Minimum relative cost reduction required to replace the original variant
+    f64 minImprovement = 0.03;
+
+    /// Parameters of the Bandit strategy (the window, round and warmup settings don't apply)
+    BanditConfig bandit;
+};
+
+/// @brief Tuning state of one system in one band
+struct VariantChoice
+{
+    String system;
+    u32 band = 0;
+
+    /// Entity counts covered by the band: [minEntities, maxEntities)
+    u64 minEntities = 0;
+    u64 maxEntities = 0;
+
+    /// Benchmark: the band is decided. Bandit: every variant has been tried.
+    bool decided = false;
+
+    /// Chosen variant (the original variant until decided; Bandit: the cheapest so far)
+    ecs::SystemVariant variant = ecs::SystemVariant::Scalar;
+
+    /// Cost per entity of the chosen variant (0 until decided; Benchmark: median, Bandit: mean)
+    f64 nsPerEntity = 0.0;
+};
+
+/// @brief What the tuner did to a system
+enum class TunerEventKind : u8
+{
+    Trial,    // Benchmark: switched to the variant whose trial window opens
+    Decided,  // Benchmark: band decided (from: original variant, to: chosen, may be the same)
+    Apply,    // Benchmark: switched to the chosen variant of a decided band
+    Explore,  // Bandit: switched to a variant other than the cheapest so far
+    Exploit,  // Bandit: switched to the cheapest variant so far
+};
+
+/// @brief Number of TunerEventKind values
+inline constexpr usize TUNER_EVENT_KIND_COUNT = 5;
+
+/// @brief Convert an event kind to string
+[[nodiscard]] inline constexpr const char* toString(TunerEventKind kind) noexcept
+{
+    switch (kind) {
+        case TunerEventKind::Trial:
+            return "Trial";
+        case TunerEventKind::Decided:
+            return "Decided";
+        case TunerEventKind::Apply:
+            return "Apply";
+        case TunerEventKind::Explore:
+            return "Explore";
+        case TunerEventKind::Exploit:
+            return "Exploit";
+    }
+    return "Unknown";
+}
+
+/// @brief A variant switch or band decision of the tuner
+struct TunerEvent
+{
+    String system;
+    u32 band = 0;
+    TunerEventKind kind = TunerEventKind::Trial;
+    ecs::SystemVariant from = ecs::SystemVariant::Scalar;
+    ecs::SystemVariant to = ecs::SystemVariant::Scalar;
+
+    /// Expected cost per entity of `to` (0 while unmeasured)
+    f64 nsPerEntity = 0.0;
+
+    /// Decided: the measured comparison of the best challenger against the original variant
+    Optional<analyzer::RegressionResult> verdict;
+};
+
+// =============================================================================
+// Variant Tuner
+// =============================================================================
+
+/// @brief Picks the fastest variant of each variant system per entity-count band
+class VariantTuner
+{
+public:
+    /// @brief Log2 width of a band (2: each band spans a factor of four)
+    static constexpr u32 BAND_LOG2_WIDTH = 2;
+
+    explicit VariantTuner(const VariantTunerConfig& config = {})
+        : config_(config),
+          rng_(config.bandit.seed),
+          budgetNs_(config.bandit.explorationBudgetUs * 1000.0)
+    {}
+
+    /// @brief Band of an entity count
+    [[nodiscard]] static u32 bandOf(u64 entities) noexcept;
+
+    /// @brief Smallest entity count of a band
+    [[nodiscard]] static u64 bandStart(u32 band) noexcept;
+
+    /// @brief Start a frame: refill the exploration budget (update() does this itself)
+    void beginFrame() noexcept { budgetNs_ = config_.bandit.explorationBudgetUs * 1000.0; }
+
+    /// @brief Exploration budget left in this frame
+    [[nodiscard]] f64 explorationBudgetLeftUs() const noexcept { return budgetNs_ / 1000.0; }
+
+    /// @brief Observe every variant system in the world's registry after its latest update
+    /// @param systems Aggregate statistics from SystemRegistry::systemStats()
+    void update(ecs::World& world, const std::vector<ecs::SystemStats>& systems);
+
+    /// @brief Record one update of a system, measured with its current variant, and switch it
+    ///        to whichever variant should run next
+    /// @param costNs Duration of the update
+    /// @param entities Entities it processed (selects the band)
+    void observe(StringView name, ecs::IVariantSystem& system, f64 costNs, u64 entities);
+
+    /// @brief Stop tuning a system (its variant was chosen explicitly)
+    void pin(StringView name);
+
+    /// @brief Resume tuning a pinned system
+    void unpin(StringView name);
+
+    [[nodiscard]] bool isPinned(StringView name) const;
+
+    /// @brief Decided variant of a system for an entity count, if that band is decided
+    ///        (Bandit: the cheapest variant so far, once every variant has been tried)
+    [[nodiscard]] Optional<ecs::SystemVariant> chosenVariant(StringView name,
+                                                             u64 entities) const;
+
+    /// @brief State of every band seen so far, by system then band
+    [[nodiscard]] std::vector<VariantChoice> choices() const;
+
+    /// @brief Forget all measurements and decisions (pins and imported results are kept)
+    void reset();
+
+    /// @brief Decided (Benchmark) or measured (Bandit) bands, for storing in a TuningProfile
+    [[nodiscard]] std::vector<TunedBand> exportProfile() const;
+
+    /// @brief Start from earlier results; they apply to bands first seen afterwards
+    /// @note Benchmark bands start decided on the imported choice; Bandit arms start from the
+    ///       imported statistics, capped at BanditConfig::priorWeight samples.
+    void importProfile(const std::vector<TunedBand>& bands);
+
+    /// @brief Keep a TunerEvent for every switch and decision from now on (off by default)
+    void recordEvents(bool enabled)
+    {
+        recordEvents_ = enabled;
+        events_.clear();
+    }
+
+    /// @brief Events recorded since the last call
+    [[nodiscard]] std::vector<TunerEvent> takeEvents() { return std::exchange(events_, {}); }
+
+    [[nodiscard]] const VariantTunerConfig& config() const noexcept { return config_; }
+
+private:
+    struct BandTuning
+    {
+        VariantBandit bandit;                   // Bandit strategy
+        std::vector<std::vector<f64>> samples;  // Per variant, cost per entity
+        usize cursor = 0;                       // Variant whose window is running
+        u32 windowFill = 0;
+        u32 round = 0;
+        bool decided = false;
+        usize best = 0;
+        f64 bestCost = 0.0;
+        std::vector<ArmStats> summary;  // Per variant, median cost when decided
+    };
+
+    struct SystemTuning
+    {
+        std::vector<ecs::SystemVariant> variants;  // Original variant first
+        std::map<u32, BandTuning> bands;
+        u64 invocations = 0;
+        u32 warmup = 0;
+        bool pinned = false;
+    };
+
+    [[nodiscard]] SystemTuning& tuningFor(StringView name, const ecs::IVariantSystem& system);
+    [[nodiscard]] BandTuning& bandFor(StringView name, SystemTuning& tuning, u32 band);
+    void observeBandit(StringView name, u32 band, ecs::IVariantSystem& system,
+                       SystemTuning& tuning, BandTuning& state, f64 cost, u64 entities);
+    void decide(StringView name, u32 band, SystemTuning& tuning, BandTuning& state);
+
+    /// @brief Switch a system's variant, recording the event if it took
+    bool switchTo(StringView name, u32 band, ecs::IVariantSystem& system,
+                  ecs::SystemVariant variant, TunerEventKind kind, f64 nsPerEntity = 0.0);
+
+    VariantTunerConfig config_;
+    std::unordered_map<String, SystemTuning> systems_;
+    std::unordered_map<String, std::vector<TunedBand>> imported_;  // By system name
+    std::mt19937_64 rng_;
+    f64 budgetNs_ = 0.0;
+
+    bool recordEvents_ = false;
+    std::vector<TunerEvent> events_;
+};
+
+}  // namespace autophage::optimizer
@@ -0,0 +1,194 @@
+#pragma once
+
+/// @file access_tracking.hpp
+/// @brief Cheap per-thread counters of linear vs random component accesses
+///
+/// Iteration (Query::forEach, View) reports how many entries it streamed over; point lookups
+/// (World::getComponent/hasComponent) report the entity index they touched. Each random lookup
+/// also updates a stride estimate (distance from the previous lookup) and a reuse-distance
+/// estimate from a small direct-mapped table of recently touched indices. Everything is plain
+/// thread-local arithmetic, no atomics.
+///
+/// SystemRegistry diffs the counters around each system update and submits them against the
+/// system's zone; endFrame() publishes the frame's per-zone totals (getLastFrameAccess()).
+
+#include <autophage/core/types.hpp>
+#include <autophage/profiler/profiler.hpp>
+
+#include <array>
+#include <vector>
+
+namespace autophage {
+
+// =============================================================================
+// Access Counters
+// =============================================================================
+
+/// @brief Access counts over some interval (a system update, a frame)
+struct AccessCounts
+{
+    /// Entries visited by sequential iteration
+    u64 linear = 0;
+
+    /// Point lookups by entity
+    u64 random = 0;
+
+    /// Sum of |index delta| between consecutive lookups, and the number of deltas summed
+    u64 strideSum = 0;
+    u64 strideSamples = 0;
+
+    /// Lookups that hit an index seen recently, and the sum of their reuse distances
+    /// (number of lookups since the previous touch of the same index)
+    u64 reuseHits = 0;
+    u64 reuseDistanceSum = 0;
+
+    [[nodiscard]] bool empty() const noexcept { return linear == 0 && random == 0; }
+
+    [[nodiscard]] f64 meanStride() const noexcept
+    {
+        return strideSamples > 0 ? static_cast<f64>(strideSum) / static_cast<f64>(strideSamples)
+                                 : 0.0;
+    }
+
+    [[nodiscard]] f64 meanReuseDistance() const noexcept
+    {
+        return reuseHits > 0 ? static_cast<f64>(reuseDistanceSum) / static_cast<f64>(reuseHits)
+                             : 0.0;
+    }
+
+    AccessCounts& operator+=(const AccessCounts& other) noexcept
+    {
+        linear += other.linear;
+        random += other.random;
+        strideSum += other.strideSum;
+        strideSamples += other.strideSamples;
+        reuseHits += other.reuseHits;
+        reuseDistanceSum += other.reuseDistanceSum;
+        return *this;
+    }
+
+    [[nodiscard]] friend AccessCounts operator-(AccessCounts a, const AccessCounts& b) noexcept
+    {
+        a.linear -= b.linear;
+        a.random -= b.random;
+        a.strideSum -= b.strideSum;
+        a.strideSamples -= b.strideSamples;
+        a.reuseHits -= b.reuseHits;
+        a.reuseDistanceSum -= b.reuseDistanceSum;
+        return a;
+    }
+};
+
+namespace detail {
+
+/// Slots in the per-thread recent-lookup table (power of 2)
+inline constexpr usize ACCESS_REUSE_SLOTS = 256;
+
+/// Lookups further apart than this are not counted as reuse
+inline constexpr u64 ACCESS_REUSE_WINDOW = 4096;
+
+struct ThreadAccessState
+{
+    struct RecentLookup
+    {
+        u32 index = ~u32{0};
+        u64 time = 0;
+    };
+
+    AccessCounts counts;
+    u32 lastIndex = 0;
+    std::array<RecentLookup, ACCESS_REUSE_SLOTS> recent{};
+};
+
+/// @brief The engine's thread-local state, exported for code compiled by the JIT (see
+///        engineCurrentMemoryTag() in memory.hpp)
+[[nodiscard]] ThreadAccessState& engineAccessState() noexcept;
+
+#if defined(AUTOPHAGE_JIT_MODULE)
+[[nodiscard]] inline ThreadAccessState& accessState() noexcept
+{
+    return engineAccessState();
+}
+#else
+inline thread_local ThreadAccessState t_accessState;
+
+[[nodiscard]] AUTOPHAGE_FORCE_INLINE ThreadAccessState& accessState() noexcept
+{
+    return t_accessState;
+}
+#endif
+
+}  // namespace detail
+
+/// @brief Report that iteration streamed over `count` entries
+AUTOPHAGE_FORCE_INLINE void recordLinearAccess([[maybe_unused]] usize count) noexcept
+{
+#if AUTOPHAGE_PROFILE_LEVEL > 0
+    detail::accessState().counts.linear += count;
+#endif
+}
+
+/// @brief Report a point lookup of an entity index
+AUTOPHAGE_FORCE_INLINE void recordRandomAccess([[maybe_unused]] u32 entityIndex) noexcept
+{
+#if AUTOPHAGE_PROFILE_LEVEL > 0
+    auto& state = detail::accessState();
+    AccessCounts& counts = state.counts;
+
+    if (counts.random > 0) {
+        counts.strideSum += entityIndex > state.lastIndex ? entityIndex - state.lastIndex
+                                                           : state.lastIndex - entityIndex;
+        ++counts.strideSamples;
+    }
+    state.lastIndex = entityIndex;
+
+    u64 now = counts.random++;
+    u32 hash = (entityIndex * 2654435761u) >> 24;  // Fibonacci hash, top 8 bits
+    auto& slot = state.recent[hash & (detail::ACCESS_REUSE_SLOTS - 1)];
+    if (slot.index == entityIndex && now - slot.time <= detail::ACCESS_REUSE_WINDOW) {
+        ++counts.reuseHits;
+        counts.reuseDistanceSum += now - slot.time;
+    }
+    slot.index = entityIndex;
+    slot.time = now;
+#endif
+}
+
+/// @brief Cumulative counts of the calling thread
+[[nodiscard]] inline AccessCounts getThreadAccessCounts() noexcept
+{
+    return detail::accessState().counts;
+}
+
+// =============================================================================
+// Per-Zone Aggregation
+// =============================================================================
+
+/// @brief Accesses attributed to one zone (normally a system) during a frame
+struct ZoneAccessSample
+{
+    ZoneId zone = INVALID_ZONE_ID;
+    AccessCounts counts;
+
+    /// Entities the zone processed (reported by the ECS, see reportEntitiesProcessed())
+    u64 entities = 0;
+};
+
+/// @brief Attribute accesses and processed entities to a zone for the current frame
+///        (thread-safe)
+void submitZoneAccess(ZoneId zone, const AccessCounts& counts, u64 entities = 0);
+
+/// @brief Per-zone totals of the last completed frame, sorted by zone
+[[nodiscard]] std::vector<ZoneAccessSample> getLastFrameAccess();
+
+namespace detail {
+
+/// @brief Publish this frame's submissions and start a new frame (called by endFrame)
+void collectFrameAccess();
+
+/// @brief Drop pending and published counts (called by initProfiler)
+void resetFrameAccess();
+
+}  // namespace detail
+
+}  // namespace autophage
@@ -0,0 +1,83 @@
+#pragma once
+
+/// @file allocation_sampling.hpp
+/// @brief Sampled allocation call-site capture
+///
+/// Answers "who allocates on the hot path" without the cost of recording every allocation.
+/// Tagged allocations are sampled by byte volume (roughly one sample per sampleIntervalBytes per
+/// thread), the allocating call stack is captured, and identical stacks are folded. Each sample
+/// stands for about sampleIntervalBytes of allocation, which gives an unbiased estimate of the
+/// bytes allocated per call site.
+///
+/// @note Stacks are captured on Linux only. On other platforms startAllocationSampling() logs a
+///       warning and returns false.
+
+#include <autophage/core/memory.hpp>
+#include <autophage/core/types.hpp>
+
+#include <vector>
+
+namespace autophage {
+
+// =============================================================================
+// Allocation Sampling Configuration
+// =============================================================================
+
+/// @brief Allocation sampling configuration
+struct AllocationSamplingConfig
+{
+    /// Average bytes allocated per thread between samples (1 samples every allocation)
+    usize sampleIntervalBytes = usize{256} * 1024;
+
+    /// Frames captured per sample (clamped to MAX_SAMPLE_DEPTH)
+    u32 maxDepth = 32;
+};
+
+// =============================================================================
+// Allocation Sampling Report
+// =============================================================================
+
+/// @brief A unique allocating call stack
+struct AllocationSite
+{
+    /// Root-to-leaf frames joined with ';', prefixed with the memory tag (flamegraph format)
+    String stack;
+    MemoryTag tag = MemoryTag::Unknown;
+
+    u64 samples = 0;
+
+    /// Sum of the sizes of the sampled allocations
+    u64 sampledBytes = 0;
+
+    /// Estimated total bytes allocated from this site while sampling was active
+    u64 estimatedBytes = 0;
+};
+
+/// @brief Aggregated results of an allocation sampling session
+struct AllocationSamplingReport
+{
+    u64 totalSamples = 0;
+    u64 estimatedBytes = 0;
+
+    /// Sorted by estimatedBytes, highest first
+    std::vector<AllocationSite> sites;
+};
+
+// =============================================================================
+// Allocation Sampling Interface
+// =============================================================================
+
+/// @brief Start sampling tagged allocations (clears the previous session's samples)
+/// @return false if already running or unsupported on this platform
+bool startAllocationSampling(const AllocationSamplingConfig& config = {});
+
+/// @brief Stop sampling; collected samples remain available
+void stopAllocationSampling();
+
+/// @brief Check if allocation sampling is running
+[[nodiscard]] bool isAllocationSamplingActive() noexcept;
+
+/// @brief Symbolize and return the allocation sites sampled so far
+[[nodiscard]] AllocationSamplingReport getAllocationSamplingReport();
+
+}  // namespace autophage
@@ -0,0 +1,194 @@
+#pragma once
+
+/// @file binary_trace.hpp
+/// @brief Compact binary trace format and memory-mapped reader
+///
+/// File layout: a BinaryTraceHeader followed by a sequence of blocks. Every block starts with a
+/// BinaryBlockHeader so readers can skip payloads they do not need. Event blocks belong to a
+/// single thread and hold variable-length records:
+///
+///   u8 type | varint nameId (Zone, Counter) | zigzag varint start delta |
+///   varint duration (Zone, Frame) | varint frame (Frame) | f64 value (Counter)
+///
+/// Start deltas are relative to the previous record in the block (the first to the block's
+/// base timestamp). Names are interned: a String block defining every new name id is written
+/// before the first event block that references it, and ids are assigned in order from 0. All
+/// integers are little-endian.
+
+#include <autophage/core/platform.hpp>
+#include <autophage/core/types.hpp>
+#include <autophage/profiler/metrics.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+namespace autophage {
+
+// =============================================================================
+// On-Disk Format
+// =============================================================================
+
+inline constexpr char BINARY_TRACE_MAGIC[8] = {'A', 'P', 'T', 'R', 'A', 'C', 'E', '\0'};
+inline constexpr u32 BINARY_TRACE_VERSION = 1;
+
+/// @brief File header
+struct BinaryTraceHeader
+{
+    char magic[8] = {};
+    u32 version = 0;
+    u32 flags = 0;
+    i64 originTicks = 0;  // Timestamp of capture start
+    f64 nsPerTick = 1.0;  // Conversion from stored ticks to nanoseconds
+};
+static_assert(sizeof(BinaryTraceHeader) == 32);
+
+/// @brief Block types
+enum class BinaryBlockType : u32
+{
+    Events = 1,      // Records of one thread
+    Strings = 2,     // varint id | varint length | bytes, repeated `count` times
+    ThreadName = 3,  // Raw name bytes for `tid`
+};
+
+/// @brief Header preceding every block
+struct BinaryBlockHeader
+{
+    BinaryBlockType type = BinaryBlockType::Events;
+    u32 tid = 0;
+    u32 size = 0;   // Payload size in bytes (excluding this header)
+    u32 count = 0;  // Number of records in the payload
+    i64 baseTicks = 0;
+};
+static_assert(sizeof(BinaryBlockHeader) == 24);
+
+/// @brief Record types inside an event block
+enum class BinaryRecordType : u8
+{
+    Zone = 0,
+    Frame = 1,
+    Counter = 2,
+};
+
+// =============================================================================
+// Reader
+// =============================================================================
+
+/// @brief A decoded record (timestamps in nanoseconds relative to capture start)
+struct TraceRecord
+{
+    BinaryRecordType type = BinaryRecordType::Zone;
+    u32 tid = 0;
+    u32 nameId = 0;
+    i64 startNs = 0;
+    i64 durationNs = 0;
+    u64 frame = 0;
+    f64 value = 0.0;
+};
+
+/// @brief Aggregated statistics for one zone name
+struct ZoneStatistics
+{
+    u32 nameId = 0;
+    StringView name;
+    u64 count = 0;
+    i64 totalNs = 0;
+    i64 minNs = 0;
+    i64 maxNs = 0;
+
+    /// Duration distribution in nanoseconds
+    HistogramStats durations;
+
+    [[nodiscard]] f64 meanNs() const noexcept
+    {
+        return count > 0 ? static_cast<f64>(totalNs) / static_cast<f64>(count) : 0.0;
+    }
+};
+
+/// @brief Memory-mapped reader for binary trace files
+/// @note Only block headers are scanned on open; event payloads are decoded on demand,
+///       so files far larger than RAM can be analyzed.
+class BinaryTraceReader
+{
+public:
+    /// @brief Sequential decoder over all event blocks
+    class Cursor
+    {
+    public:
+        /// @brief Decode the next record
+        /// @return false at end of file or on corrupt data (see failed())
+        bool next(TraceRecord& record);
+
+        /// @brief Whether decoding stopped because of corrupt data
+        [[nodiscard]] bool failed() const noexcept { return failed_; }
+
+    private:
+        friend class BinaryTraceReader;
+
+        explicit Cursor(const BinaryTraceReader& reader);
+
+        bool enterNextBlock();
+
+        const BinaryTraceReader* reader_;
+        usize blockIndex_ = 0;
+        const u8* pos_ = nullptr;
+        const u8* end_ = nullptr;
+        u32 remaining_ = 0;
+        u32 tid_ = 0;
+        i64 prevTicks_ = 0;
+        bool failed_ = false;
+    };
+
+    BinaryTraceReader() = default;
+    ~BinaryTraceReader();
+
+    BinaryTraceReader(const BinaryTraceReader&) = delete;
+    BinaryTraceReader& operator=(const BinaryTraceReader&) = delete;
+
+    /// @brief Map a trace file and index its blocks
+    /// @return false if the file cannot be mapped or is not a valid trace (see lastError())
+    bool open(const String& path);
+
+    /// @brief Unmap the file
+    void close();
+
+    [[nodiscard]] bool isOpen() const noexcept { return data_ != nullptr; }
+    [[nodiscard]] const String& lastError() const noexcept { return lastError_; }
+    [[nodiscard]] const BinaryTraceHeader& header() const noexcept { return header_; }
+
+    /// @brief Total number of event records (from block headers)
+    [[nodiscard]] u64 eventCount() const noexcept { return eventCount_; }
+
+    /// @brief Number of event blocks
+    [[nodiscard]] usize blockCount() const noexcept { return eventBlocks_.size(); }
+
+    /// @brief Resolve an interned name (empty if unknown)
+    [[nodiscard]] StringView name(u32 id) const;
+
+    /// @brief Resolve a thread name (empty if unnamed)
+    [[nodiscard]] StringView threadName(u32 tid) const;
+
+    /// @brief Iterate all records in file order
+    [[nodiscard]] Cursor events() const { return Cursor(*this); }
+
+    /// @brief Aggregate per-zone duration statistics over the whole file
+    [[nodiscard]] std::vector<ZoneStatistics> zoneStatistics() const;
+
+private:
+    [[nodiscard]] i64 toNanoseconds(i64 ticks) const noexcept;
+
+    const u8* data_ = nullptr;
+    usize size_ = 0;
+#if defined(AUTOPHAGE_PLATFORM_WINDOWS)
+    void* fileHandle_ = nullptr;
+    void* mappingHandle_ = nullptr;
+#endif
+
+    BinaryTraceHeader header_{};
+    std::vector<usize> eventBlocks_;  // Offsets of event block headers
+    std::vector<StringView> names_;  // Indexed by id
+    std::unordered_map<u32, StringView> threadNames_;
+    u64 eventCount_ = 0;
+    String lastError_;
+};
+
+}  // namespace autophage
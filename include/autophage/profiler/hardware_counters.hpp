@@ -0,0 +1,54 @@
+#pragma once
+
+/// @file hardware_counters.hpp
+/// @brief CPU performance counters (cache, branch and TLB misses) for frame statistics
+///
+/// On Linux the counters are opened with perf_event_open for the thread that enables them
+/// (normally the main thread running beginFrame/endFrame). When enabled, endFrame() fills
+/// FrameStats::cacheMisses, branchMispredictions and dtlbMisses with per-frame deltas. Counters
+/// the kernel refuses (perf_event_paranoid, containers, missing PMU) simply read as zero.
+
+#include <autophage/core/types.hpp>
+
+namespace autophage {
+
+// =============================================================================
+// Hardware Counters
+// =============================================================================
+
+/// @brief Cumulative hardware counter values for the counting thread
+struct HardwareCounterValues
+{
+    u64 cacheMisses = 0;           // Last-level cache misses
+    u64 branchMispredictions = 0;  // Mispredicted branches
+    u64 dtlbMisses = 0;            // Data TLB load misses (page walks)
+};
+
+/// @brief Which counters were opened successfully
+struct HardwareCounterAvailability
+{
+    bool cacheMisses = false;
+    bool branchMispredictions = false;
+    bool dtlbMisses = false;
+
+    [[nodiscard]] bool any() const noexcept
+    {
+        return cacheMisses || branchMispredictions || dtlbMisses;
+    }
+};
+
+/// @brief Open the counters for the calling thread
+/// @return Counters that could be opened (none on unsupported platforms)
+HardwareCounterAvailability enableHardwareCounters();
+
+/// @brief Close the counters
+void disableHardwareCounters();
+
+/// @brief Check whether at least one counter is open
+[[nodiscard]] bool areHardwareCountersEnabled() noexcept;
+
+/// @brief Read the cumulative counter values (zeros for counters that are not open)
+/// @note Safe to call while another thread enables or disables the counters.
+[[nodiscard]] HardwareCounterValues readHardwareCounters() noexcept;
+
+}  // namespace autophage
@@ -0,0 +1,155 @@
+#pragma once
+
+/// @file metrics.hpp
+/// @brief Named counter, gauge and histogram metrics for the profiler
+
+#include <autophage/core/types.hpp>
+
+#include <array>
+#include <vector>
+
+namespace autophage {
+
+// =============================================================================
+// Metric Types
+// =============================================================================
+
+/// @brief Interned metric identifier
+using MetricId = u32;
+
+/// @brief Invalid metric ID (recording against it is a no-op)
+inline constexpr MetricId INVALID_METRIC_ID = ~MetricId{0};
+
+/// @brief Maximum number of distinct metrics
+inline constexpr usize MAX_METRICS = 256;
+
+/// @brief Maximum number of distinct histogram metrics
+inline constexpr usize MAX_HISTOGRAMS = 32;
+
+/// @brief Number of log2 buckets per histogram
+inline constexpr usize HISTOGRAM_BUCKETS = 64;
+
+/// @brief Kind of a metric
+enum class MetricKind : u8
+{
+    Counter,    // Monotonic sum, reported as per-frame delta
+    Gauge,      // Last written value
+    Histogram,  // Distribution of recorded values
+};
+
+/// @brief Convert metric kind to string
+[[nodiscard]] constexpr StringView toString(MetricKind kind) noexcept
+{
+    switch (kind) {
+        case MetricKind::Counter:
+            return "Counter";
+        case MetricKind::Gauge:
+            return "Gauge";
+        case MetricKind::Histogram:
+            return "Histogram";
+    }
+    return "Unknown";
+}
+
+/// @brief Value of a single metric for one frame
+struct MetricSample
+{
+    MetricId id = INVALID_METRIC_ID;
+    MetricKind kind = MetricKind::Counter;
+
+    /// Counter: delta this frame. Gauge: current value. Histogram: sum of values this frame.
+    f64 value = 0.0;
+
+    /// Histogram: number of values recorded this frame. Otherwise 0.
+    u64 count = 0;
+};
+
+/// @brief Cumulative histogram state since the metric was registered
+struct HistogramStats
+{
+    u64 count = 0;
+    f64 sum = 0.0;
+    f64 min = 0.0;
+    f64 max = 0.0;
+
+    /// Bucket i counts values in [2^(i-1), 2^i); bucket 0 counts values < 1
+    std::array<u64, HISTOGRAM_BUCKETS> buckets{};
+
+    /// @brief Accumulate a value (single-threaded; for offline aggregation)
+    void record(f64 value) noexcept;
+
+    [[nodiscard]] f64 mean() const noexcept
+    {
+        return count > 0 ? sum / static_cast<f64>(count) : 0.0;
+    }
+
+    /// @brief Approximate percentile (upper bound of the containing bucket, clamped to max)
+    /// @param p Percentile in [0, 1]
+    [[nodiscard]] f64 percentile(f64 p) const noexcept;
+};
+
+/// @brief Log2 bucket index used by histograms for a value
+[[nodiscard]] usize histogramBucketIndex(f64 value) noexcept;
+
+// =============================================================================
+// Metric Registry
+// =============================================================================
+
+/// @brief Register (or look up) a metric by name
+/// @param name Metric name (copied on first registration)
+/// @param kind Metric kind; must match the kind of an existing registration
+/// @return Metric ID, or INVALID_METRIC_ID if the registry is full or kinds conflict
+[[nodiscard]] MetricId registerMetric(StringView name, MetricKind kind);
+
+/// @brief Find a registered metric by name
+[[nodiscard]] MetricId findMetric(StringView name);
+
+/// @brief Get the name of a registered metric
+[[nodiscard]] StringView getMetricName(MetricId id);
+
+/// @brief Get the kind of a registered metric
+[[nodiscard]] MetricKind getMetricKind(MetricId id);
+
+/// @brief Get the number of registered metrics
+[[nodiscard]] usize getMetricCount();
+
+/// @brief Get cumulative statistics for a histogram metric
+[[nodiscard]] HistogramStats getHistogramStats(MetricId id);
+
+/// @brief Get the per-frame samples of a metric, aligned with getFrameHistory()
+/// @note Frames in which the metric was not yet registered report a zero sample
+[[nodiscard]] std::vector<f64> getMetricHistory(MetricId id);
+
+// =============================================================================
+// Metric Recording
+// =============================================================================
+
+/// @brief Add to a counter (name is interned on first use per thread)
+void recordCounter(const char* name, i64 value);
+
+/// @brief Add to a counter by ID
+void recordCounter(MetricId id, i64 value);
+
+/// @brief Set a gauge value
+void recordGauge(const char* name, f64 value);
+
+/// @brief Set a gauge value by ID
+void recordGauge(MetricId id, f64 value);
+
+/// @brief Record a value into a histogram
+void recordHistogram(const char* name, f64 value);
+
+/// @brief Record a value into a histogram by ID
+void recordHistogram(MetricId id, f64 value);
+
+namespace detail {
+
+/// @brief Fold all per-thread shards into per-frame samples (called by endFrame)
+void collectFrameMetrics(std::vector<MetricSample>& out);
+
+/// @brief Discard pending deltas so the next frame starts clean (called by initProfiler)
+void resetMetricBaselines();
+
+}  // namespace detail
+
+}  // namespace autophage
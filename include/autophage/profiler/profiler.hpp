@@ -3,8 +3,12 @@
 /// @file profiler.hpp
 /// @brief Main profiler interface for Autophage Engine
 
+#include <autophage/core/memory.hpp>
+#include <autophage/core/type_id.hpp>
 #include <autophage/core/types.hpp>
+#include <autophage/profiler/metrics.hpp>
 
+#include <array>
 #include <chrono>
 #include <string>
 #include <vector>
@@ -23,6 +27,15 @@ using Duration = std::chrono::nanoseconds;
 // Frame Statistics
 // =============================================================================
 
+/// @brief Allocation activity of one memory tag during a frame
+struct MemoryFrameStats
+{
+    u64 allocations = 0;
+    u64 deallocations = 0;
+    u64 allocatedBytes = 0;
+    u64 freedBytes = 0;
+};
+
 /// @brief Statistics for a single frame
 struct FrameStats
 {
@@ -34,15 +47,22 @@ struct FrameStats
     u32 systemCount = 0;
     usize memoryUsed = 0;
 
-    // Hardware metrics (optional/platform dependent)
-    u64 cpuCycles = 0;
+    // Hardware metrics (optional/platform dependent, see hardware_counters.hpp)
+    u64 cpuCycles = 0;  // Timestamp counter ticks elapsed during the frame (see tick_clock.hpp)
     u64 cacheMisses = 0;
     u64 branchMispredictions = 0;
+    u64 dtlbMisses = 0;
     u64 contextSwitches = 0;
 
-    // Memory metrics
+    // Memory metrics (allocations made since the previous endFrame)
     u64 allocationCount = 0;
     u64 deallocationCount = 0;
+    u64 allocatedBytes = 0;
+    u64 freedBytes = 0;
+    std::array<MemoryFrameStats, MEMORY_TAG_COUNT> memoryByTag{};
+
+    // Named metrics folded at endFrame (indexed by MetricId)
+    std::vector<MetricSample> metrics;
 };
 
 /// @brief Aggregated statistics over multiple frames
@@ -70,8 +90,54 @@ struct ProfilerStats
     // Aggregated Hardware metrics
     f64 avgCacheMisses = 0.0;
     f64 avgBranchMispredictions = 0.0;
+    f64 avgDtlbMisses = 0.0;
+};
+
+// =============================================================================
+// Zone Descriptors
+// =============================================================================
+
+/// @brief Compact id of a registered zone descriptor
+using ZoneId = u16;
+
+inline constexpr ZoneId INVALID_ZONE_ID = 0xFFFF;
+
+/// @brief Maximum number of distinct zone sites
+inline constexpr usize MAX_ZONE_DESCRIPTORS = 4096;
+
+/// @brief Static description of an instrumented code site
+/// @note Constructed at compile time by AUTOPHAGE_PROFILE_SCOPE, so the hot path never touches
+///       name/file/line and only records a ZoneId plus timestamps.
+struct ZoneDescriptor
+{
+    const char* name = nullptr;
+    const char* file = nullptr;
+    u32 line = 0;
+    u64 nameHash = 0;
+
+    constexpr ZoneDescriptor() = default;
+    constexpr ZoneDescriptor(const char* zoneName, const char* zoneFile, u32 zoneLine) noexcept
+        : name(zoneName), file(zoneFile), line(zoneLine), nameHash(detail::fnv1aHash(zoneName))
+    {}
 };
 
+/// @brief Register a zone site (thread-safe; the same name/file/line always maps to one id)
+/// @return Descriptor id, or INVALID_ZONE_ID if MAX_ZONE_DESCRIPTORS is exceeded
+[[nodiscard]] ZoneId registerZone(const ZoneDescriptor& descriptor);
+
+/// @brief Register a zone for a runtime name (e.g. a system name); the name is copied
+/// @return Descriptor id (the same name always maps to one id), or INVALID_ZONE_ID if full
+[[nodiscard]] ZoneId registerZone(StringView name);
+
+/// @brief Get a registered descriptor (nullptr for unknown ids)
+[[nodiscard]] const ZoneDescriptor* getZoneDescriptor(ZoneId id) noexcept;
+
+/// @brief Find the first descriptor registered with a name hash
+[[nodiscard]] ZoneId findZone(u64 nameHash) noexcept;
+
+/// @brief Number of registered descriptors
+[[nodiscard]] usize getZoneDescriptorCount() noexcept;
+
 // =============================================================================
 // Profiler Zone
 // =============================================================================
@@ -80,6 +146,7 @@ struct ProfilerStats
 struct ProfileZone
 {
     u64 id = 0;
+    ZoneId descriptor = INVALID_ZONE_ID;
     const char* name = nullptr;
     const char* file = nullptr;
     u32 line = 0;
@@ -125,7 +192,11 @@ void resetProfilerStats();
 // Zone Management
 // =============================================================================
 
-/// @brief Begin a profiling zone
+/// @brief Begin a profiling zone from a registered descriptor (hot path)
+/// @return Zone ID
+[[nodiscard]] u64 beginZone(ZoneId descriptor);
+
+/// @brief Begin a profiling zone, registering its descriptor on first use
 /// @param name Zone name (must be string literal)
 /// @param file Source file
 /// @param line Source line
@@ -136,34 +207,75 @@ void resetProfilerStats();
 /// @param zoneId Zone ID returned by beginZone
 void endZone(u64 zoneId);
 
-/// @brief Get all zones from current frame
+/// @brief Get all zones recorded by the calling thread in the current frame
 [[nodiscard]] const std::vector<ProfileZone>& getZones();
 
 // =============================================================================
 // Metric Recording
 // =============================================================================
 
-/// @brief Record a counter value
-void recordCounter(const char* name, i64 value);
-
-/// @brief Record a gauge value
-void recordGauge(const char* name, f64 value);
+// Counters, gauges and histograms are declared in metrics.hpp
 
-/// @brief Record a memory allocation
+/// @brief Record a memory allocation made outside the tagged allocators
+/// @param tag MemoryTag name (see toString(MemoryTag)); unknown names count as Unknown
 void recordAllocation(usize bytes, const char* tag = nullptr);
 
-/// @brief Record a memory deallocation
+/// @brief Record a memory deallocation made outside the tagged allocators
 void recordDeallocation(usize bytes, const char* tag = nullptr);
 
 // =============================================================================
 // Utility Macros
 // =============================================================================
 
-/// @brief Profile a scope with automatic begin/end
-#define AUTOPHAGE_PROFILE_SCOPE(name) \
-    ::autophage::ScopedTimer _profiler_scope_##__LINE__(name, __FILE__, __LINE__)
-
-/// @brief Profile a function
-#define AUTOPHAGE_PROFILE_FUNCTION() AUTOPHAGE_PROFILE_SCOPE(__func__)
+/// Instrumentation detail compiled in: 0 = none, 1 = coarse (AUTOPHAGE_PROFILE_SCOPE/FUNCTION),
+/// 2 = detail (AUTOPHAGE_PROFILE_SCOPE_DETAIL), 3 = verbose (AUTOPHAGE_PROFILE_SCOPE_VERBOSE)
+#ifndef AUTOPHAGE_PROFILE_LEVEL
+    #define AUTOPHAGE_PROFILE_LEVEL 2
+#endif
+
+#define AUTOPHAGE_DETAIL_CONCAT_IMPL(a, b) a##b
+#define AUTOPHAGE_DETAIL_CONCAT(a, b) AUTOPHAGE_DETAIL_CONCAT_IMPL(a, b)
+
+/// Descriptor registration runs once per site; later passes only read the cached id
+#define AUTOPHAGE_DETAIL_PROFILE_ZONE(storage, name, suffix)                                      \
+    storage ::autophage::ZoneDescriptor AUTOPHAGE_DETAIL_CONCAT(_profiler_site_, suffix){        \
+        name, __FILE__, __LINE__};                                                               \
+    static const ::autophage::ZoneId AUTOPHAGE_DETAIL_CONCAT(_profiler_zone_, suffix) =           \
+        ::autophage::registerZone(AUTOPHAGE_DETAIL_CONCAT(_profiler_site_, suffix));             \
+    ::autophage::ScopedTimer AUTOPHAGE_DETAIL_CONCAT(_profiler_scope_, suffix)(                   \
+        AUTOPHAGE_DETAIL_CONCAT(_profiler_zone_, suffix))
+
+#if AUTOPHAGE_PROFILE_LEVEL >= 1
+    /// @brief Profile a scope with automatic begin/end (name must be a string literal)
+    #define AUTOPHAGE_PROFILE_SCOPE(name) \
+        AUTOPHAGE_DETAIL_PROFILE_ZONE(static constexpr, name, __LINE__)
+
+    /// @brief Profile a function
+    #define AUTOPHAGE_PROFILE_FUNCTION() \
+        AUTOPHAGE_DETAIL_PROFILE_ZONE(static const, __func__, __LINE__)
+#else
+    #define AUTOPHAGE_PROFILE_SCOPE(name) static_cast<void>(0)
+    #define AUTOPHAGE_PROFILE_FUNCTION() static_cast<void>(0)
+#endif
+
+#if AUTOPHAGE_PROFILE_LEVEL >= 2
+    /// @brief Profile a fine-grained scope (stripped below level 2)
+    #define AUTOPHAGE_PROFILE_SCOPE_DETAIL(name) AUTOPHAGE_PROFILE_SCOPE(name)
+#else
+    #define AUTOPHAGE_PROFILE_SCOPE_DETAIL(name) static_cast<void>(0)
+#endif
+
+#if AUTOPHAGE_PROFILE_LEVEL >= 3
+    /// @brief Profile a very hot scope (stripped below level 3)
+    #define AUTOPHAGE_PROFILE_SCOPE_VERBOSE(name) AUTOPHAGE_PROFILE_SCOPE(name)
+#else
+    #define AUTOPHAGE_PROFILE_SCOPE_VERBOSE(name) static_cast<void>(0)
+#endif
+
+/// @brief Profile a scope and charge its untagged heap allocations to a MemoryTag
+/// @note The tag scope stays active at every profile level; only the zone is stripped.
+#define AUTOPHAGE_PROFILE_SCOPE_TAGGED(name, tag)                                                 \
+    ::autophage::MemoryTagScope AUTOPHAGE_DETAIL_CONCAT(_profiler_memory_, __LINE__)(tag);      \
+    AUTOPHAGE_PROFILE_SCOPE(name)
 
 }  // namespace autophage
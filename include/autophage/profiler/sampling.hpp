@@ -0,0 +1,117 @@
+#pragma once
+
+/// @file sampling.hpp
+/// @brief Statistical sampling profiler
+///
+/// Complements instrumented zones: every registered thread gets a CPU-time timer that delivers
+/// SIGPROF at a fixed rate. The signal handler walks the frame-pointer chain into a preallocated
+/// per-thread ring and tags the sample with the innermost active profiler zone, so hotspots in
+/// unannotated (third-party, gameplay) code are attributed without recompiling.
+///
+/// Stacks are only complete for code built with frame pointers (AUTOPHAGE_ENABLE_FRAME_POINTERS);
+/// otherwise the innermost frame is still exact and outer frames may be truncated.
+///
+/// @note Linux only. On other platforms startSamplingProfiler() logs a warning and returns false.
+
+#include <autophage/core/types.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace autophage {
+
+// =============================================================================
+// Sampling Configuration
+// =============================================================================
+
+/// @brief Maximum frames captured per sample
+inline constexpr u32 MAX_SAMPLE_DEPTH = 64;
+
+/// @brief Sampling profiler configuration
+struct SamplingConfig
+{
+    /// Samples per second of thread CPU time
+    u32 frequencyHz = 1000;
+
+    /// Ring capacity per thread (rounded up to a power of two). Samples taken while a ring is
+    /// full are dropped.
+    usize samplesPerThread = usize{1} << 12;
+
+    /// Frames captured per sample (clamped to MAX_SAMPLE_DEPTH)
+    u32 maxDepth = MAX_SAMPLE_DEPTH;
+
+    /// How often the background thread folds rings into the aggregate
+    std::chrono::milliseconds drainInterval{100};
+};
+
+// =============================================================================
+// Sampling Report
+// =============================================================================
+
+/// @brief A unique call stack and how often it was sampled
+struct FoldedStack
+{
+    /// Root-to-leaf frames joined with ';', prefixed with the active zone (flamegraph format)
+    String stack;
+    u64 count = 0;
+};
+
+/// @brief Samples attributed to one profiler zone
+struct ZoneSampleCount
+{
+    /// Innermost active zone when the sample was taken ("<no zone>" outside zones)
+    String zone;
+    u64 count = 0;
+};
+
+/// @brief Aggregated results of a sampling session
+struct SamplingReport
+{
+    u64 totalSamples = 0;
+    u64 droppedSamples = 0;
+
+    /// Sorted by count, highest first
+    std::vector<ZoneSampleCount> zones;
+
+    /// Sorted by count, highest first
+    std::vector<FoldedStack> stacks;
+};
+
+// =============================================================================
+// Sampling Interface
+// =============================================================================
+
+/// @brief Start sampling all registered threads (the calling thread is registered implicitly)
+/// @return false if already running, unsupported on this platform, or timers cannot be created
+bool startSamplingProfiler(const SamplingConfig& config = {});
+
+/// @brief Stop sampling and fold all pending samples
+void stopSamplingProfiler();
+
+/// @brief Check if sampling is running
+[[nodiscard]] bool isSamplingProfilerActive() noexcept;
+
+/// @brief Opt the calling thread into sampling
+/// @note May be called before or during a session. The thread is unregistered when it exits.
+void registerSamplingThread();
+
+/// @brief Symbolize and return the samples collected so far in the current (or last) session
+[[nodiscard]] SamplingReport getSamplingReport();
+
+/// @brief Write the current report as folded stacks ("frame;frame;frame count" per line)
+/// @return false if the file cannot be written
+bool writeFoldedStacks(const String& path);
+
+namespace detail {
+
+/// @brief Track the innermost profiler zone of the calling thread (async-signal-safe reads)
+void pushSampleZone(const char* name) noexcept;
+void popSampleZone() noexcept;
+
+/// @brief Resolve a code address to a demangled symbol (or module+offset / raw hex)
+[[nodiscard]] String symbolizeAddress(std::uintptr_t address);
+
+}  // namespace detail
+
+}  // namespace autophage
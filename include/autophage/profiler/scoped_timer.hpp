@@ -17,6 +17,10 @@ public:
     explicit ScopedTimer(const char* name, const char* file = nullptr, u32 line = 0)
         : zoneId_(beginZone(name, file, line)) {}
 
+    /// @brief Start timing a zone from a registered descriptor
+    explicit ScopedTimer(ZoneId descriptor)
+        : zoneId_(beginZone(descriptor)) {}
+
     /// @brief Stop timing and record duration
     ~ScopedTimer() {
         endZone(zoneId_);
@@ -0,0 +1,119 @@
+#pragma once
+
+/// @file tick_clock.hpp
+/// @brief Calibrated CPU timestamp counter used for all profiler timestamps
+///
+/// Reading the counter is a single instruction (rdtsc on x64, cntvct_el0 on ARM64), far cheaper
+/// than a clock_gettime call. Timestamps stay in raw ticks on the hot path and are converted to
+/// nanoseconds only when durations are aggregated or exported.
+///
+/// Until calibrateTickClock() has measured the counter's rate, readTicks() returns steady_clock
+/// nanoseconds (at 1 ns per tick), so durations are correct before calibration too; only an
+/// interval that straddles calibration mixes the two sources. On x64 CPUs whose TSC is not
+/// invariant (its rate follows frequency scaling), the clock stays on steady_clock.
+
+#include <autophage/core/platform.hpp>
+#include <autophage/core/types.hpp>
+
+#include <atomic>
+#include <chrono>
+
+#if defined(AUTOPHAGE_COMPILER_MSVC)
+    #include <intrin.h>
+#elif defined(AUTOPHAGE_ARCH_X64) || defined(AUTOPHAGE_ARCH_X86)
+    #include <x86intrin.h>
+#endif
+
+namespace autophage {
+
+namespace detail {
+
+/// Nanoseconds per tick, set by calibrateTickClock()
+inline std::atomic<f64> g_nanosecondsPerTick{1.0};
+
+/// Set by calibrateTickClock() (after g_nanosecondsPerTick) once the CPU counter's rate is
+/// known; stays clear when the counter does not tick at a constant rate
+inline std::atomic<bool> g_hardwareTicks{false};
+
+[[nodiscard]] inline i64 steadyNanoseconds() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/// @brief Read the CPU counter itself (steady_clock nanoseconds where there is none)
+[[nodiscard]] AUTOPHAGE_FORCE_INLINE i64 readCounter() noexcept
+{
+#if defined(AUTOPHAGE_ARCH_X64) || defined(AUTOPHAGE_ARCH_X86)
+    return static_cast<i64>(__rdtsc());
+#elif defined(AUTOPHAGE_ARCH_ARM64) && defined(AUTOPHAGE_COMPILER_MSVC)
+    return static_cast<i64>(_ReadStatusReg(ARM64_CNTVCT));
+#elif defined(AUTOPHAGE_ARCH_ARM64)
+    u64 ticks;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(ticks));
+    return static_cast<i64>(ticks);
+#else
+    return steadyNanoseconds();
+#endif
+}
+
+}  // namespace detail
+
+// =============================================================================
+// Tick Source
+// =============================================================================
+
+/// @brief Read the raw timestamp counter
+/// @note Falls back to steady_clock nanoseconds before calibration, on architectures without a
+///       usable counter, and on x64 when the TSC is not invariant
+[[nodiscard]] AUTOPHAGE_FORCE_INLINE i64 readTicks() noexcept
+{
+    if (detail::g_hardwareTicks.load(std::memory_order_acquire)) AUTOPHAGE_LIKELY {
+        return detail::readCounter();
+    }
+    return detail::steadyNanoseconds();
+}
+
+// =============================================================================
+// Calibration
+// =============================================================================
+
+/// @brief Measure the tick rate against steady_clock and switch readTicks() to the CPU counter
+///        (runs once; later calls are no-ops)
+/// @note Called by initProfiler() and by the ECS system registry. Takes roughly 10ms the first
+///       time.
+void calibrateTickClock();
+
+/// @brief Whether the CPU counter ticks at a constant rate across P-states and cores
+/// @note False on x64 CPUs without invariant TSC; readTicks() then uses steady_clock.
+[[nodiscard]] bool isTickClockInvariant() noexcept;
+
+/// @brief Whether readTicks() reads the CPU counter rather than steady_clock
+[[nodiscard]] inline bool isTickClockHardware() noexcept
+{
+    return detail::g_hardwareTicks.load(std::memory_order_acquire);
+}
+
+/// @brief Counter frequency in ticks per second
+[[nodiscard]] f64 getTicksPerSecond() noexcept;
+
+/// @brief Nanoseconds per tick
+[[nodiscard]] inline f64 getNanosecondsPerTick() noexcept
+{
+    return detail::g_nanosecondsPerTick.load(std::memory_order_relaxed);
+}
+
+/// @brief Convert a tick count (or difference) to nanoseconds
+[[nodiscard]] inline i64 ticksToNanoseconds(i64 ticks) noexcept
+{
+    return static_cast<i64>(static_cast<f64>(ticks) * getNanosecondsPerTick());
+}
+
+/// @brief Convert a tick difference to a chrono duration
+[[nodiscard]] inline std::chrono::nanoseconds ticksToDuration(i64 ticks) noexcept
+{
+    return std::chrono::nanoseconds(ticksToNanoseconds(ticks));
+}
+
+}  // namespace autophage
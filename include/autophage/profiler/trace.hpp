@@ -0,0 +1,82 @@
+#pragma once
+
+/// @file trace.hpp
+/// @brief Streaming trace capture of profiler zones, counters and frame markers
+
+#include <autophage/core/types.hpp>
+
+#include <chrono>
+
+namespace autophage {
+
+// =============================================================================
+// Trace Configuration
+// =============================================================================
+
+/// @brief On-disk trace format
+enum class TraceFormat : u8
+{
+    ChromeJson,  // Chrome Trace Event JSON (chrome://tracing, ui.perfetto.dev)
+    Binary,      // Compact delta/varint encoding, read with BinaryTraceReader
+};
+
+/// @brief Trace capture configuration
+struct TraceConfig
+{
+    /// Output file path
+    String path;
+
+    TraceFormat format = TraceFormat::ChromeJson;
+
+    /// Ring buffer capacity per recording thread (rounded up to a power of two). Each capture
+    /// applies its own value: a thread's ring is resized at its first event of the capture.
+    /// Events recorded while a thread's ring is full are dropped, never blocked on.
+    usize eventsPerThread = usize{1} << 16;
+
+    /// How often the background thread drains rings to disk
+    std::chrono::milliseconds flushInterval{50};
+};
+
+/// @brief Counters describing an active or finished capture
+struct TraceCaptureStats
+{
+    u64 eventsWritten = 0;
+    u64 eventsDropped = 0;
+    u64 bytesWritten = 0;
+};
+
+// =============================================================================
+// Trace Capture Interface
+// =============================================================================
+
+/// @brief Start streaming profiler events to a file
+/// @return false if a capture is already running or the file cannot be opened
+bool startTraceCapture(const TraceConfig& config);
+
+/// @brief Stop the capture, drain all buffers and close the file
+void stopTraceCapture();
+
+/// @brief Check if a capture is running
+[[nodiscard]] bool isTraceCaptureActive() noexcept;
+
+/// @brief Get statistics for the current (or last) capture
+[[nodiscard]] TraceCaptureStats getTraceCaptureStats();
+
+/// @brief Name the calling thread in trace output
+/// @param name Thread name (copied)
+void setProfilerThreadName(StringView name);
+
+namespace detail {
+
+/// @brief Record a completed zone on the calling thread (timestamps from readTicks())
+void traceZone(const char* name, i64 startTicks, i64 endTicks);
+
+/// @brief Record a frame marker spanning [startTicks, endTicks]
+void traceFrame(FrameNumber frame, i64 startTicks, i64 endTicks);
+
+/// @brief Record a counter value at a point in time
+void traceCounter(const char* name, i64 timestampTicks, f64 value);
+
+}  // namespace detail
+
+}  // namespace autophage
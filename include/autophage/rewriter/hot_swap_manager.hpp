@@ -26,17 +26,22 @@ public:
     /// @brief Hot-swap a system using JIT compiled code
     /// @param systemName The name of the system to replace
     /// @param source The C++ source code for the new implementation
+    /// @param functionName The `extern "C" void (World&, float)` update function in the source
+    ///        (the name passed to Rewriter::generateSystemSource for generated code)
     /// @return true if swap was successful
-    bool hotSwapFromSource(const std::string& systemName, const std::string& source);
+    bool hotSwapFromSource(const std::string& systemName, const std::string& source,
+                           const std::string& functionName = "updateSystem");
 
 private:
     /// @brief A system implementation that delegates to JIT'd code
+    /// @note Keeps the name of the system it replaces, so its statistics (and the optimizer's
+    ///       trial of the swap) continue under that name
     class JITSystem : public ecs::System<JITSystem>
     {
     public:
         using UpdateFunc = void (*)(ecs::World&, f32);
 
-        explicit JITSystem(UpdateFunc func) : System("JITSystem"), updateFunc_(func) {}
+        JITSystem(String name, UpdateFunc func) : System(std::move(name)), updateFunc_(func) {}
 
         void update(ecs::World& world, f32 dt) override
         {
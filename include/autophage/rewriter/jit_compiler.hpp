@@ -5,31 +5,64 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace autophage::rewriter {
 
+/// @brief Optimization level of JIT-compiled code (clang's -O0 to -O3)
+enum class JITOptLevel : u8
+{
+    O0,
+    O1,
+    O2,
+    O3,
+};
+
+/// @brief Settings applied to every compile()
+struct JITConfig
+{
+    JITOptLevel optLevel = JITOptLevel::O2;
+
+    /// Generate code for the exact host CPU and its features instead of a portable baseline
+    bool targetHostCpu = true;
+
+    /// Searched for #include after the engine headers
+    std::vector<std::string> includeDirs;
+
+    /// Preprocessor definitions, "NAME" or "NAME=VALUE"
+    std::vector<std::string> defines;
+};
+
 /// @brief Interface for runtime compilation
+///
+/// Sources are compiled in-process by the Clang frontend (as C++23, with the engine headers
+/// and the engine's build-affecting definitions available) and the resulting LLVM module is
+/// added to an ORC LLJIT. Every compile() gets its own JITDylib, so a function name can be
+/// compiled again (e.g. a newer version of a hot-swapped system) without clashing. Engine
+/// functions the code calls are resolved from the running process.
 class JITCompiler
 {
 public:
-    JITCompiler();
+    explicit JITCompiler(JITConfig config = {});
     ~JITCompiler();
 
     /// @brief Compile a C++ string to a function
     /// @param source The C++ source code
-    /// @param functionName The name of the function to retrieve
-    /// @return A void pointer to the function or nullptr on failure
+    /// @param functionName The name of the function to retrieve (declare it extern "C")
+    /// @return A void pointer to the function or nullptr on failure (see getLastError())
     void* compile(const std::string& source, const std::string& functionName);
 
     /// @brief Map a function pointer to a symbol name in the JIT
     void addSymbol(const std::string& name, void* address);
 
-    /// @brief Get the last error message
+    /// @brief Get the last error message (compiler diagnostics on compile failures)
     [[nodiscard]] std::string getLastError() const;
 
     /// @brief Check if JIT is enabled and available
     [[nodiscard]] bool isAvailable() const noexcept;
 
+    [[nodiscard]] const JITConfig& config() const noexcept;
+
 private:
     class Impl;
     std::unique_ptr<Impl> impl_;
@@ -1,11 +1,85 @@
 #include <autophage/analyzer/access_pattern_tracker.hpp>
 
+#include <algorithm>
+#include <limits>
+
 namespace autophage::analyzer {
 
 void AccessPatternTracker::recordAccess(const std::string& systemName, AccessPattern pattern,
                                         u32 count)
 {
-    stats_[systemName] = {systemName, pattern, count};
+    // Manual reports carry no stride, so random lookups are never mistaken for sequential ones
+    AccessCounts counts;
+    switch (pattern) {
+        case AccessPattern::Linear:
+            counts.linear = count;
+            break;
+        case AccessPattern::Random:
+            counts.random = count;
+            break;
+        case AccessPattern::Mixed:
+            counts.linear = count / 2;
+            counts.random = count - count / 2;
+            break;
+    }
+    update(systemName, counts, count);
+}
+
+void AccessPatternTracker::recordCounts(const std::string& systemName, const AccessCounts& counts,
+                                        u64 entities)
+{
+    update(systemName, counts, entities);
+}
+
+void AccessPatternTracker::collect()
+{
+    for (const auto& sample : getLastFrameAccess()) {
+        const ZoneDescriptor* zone = getZoneDescriptor(sample.zone);
+        if (zone && zone->name) {
+            update(zone->name, sample.counts, sample.entities);
+        }
+    }
+    endFrame();
+}
+
+void AccessPatternTracker::endFrame()
+{
+    for (auto& [name, window] : windows_) {
+        if (!window.reported) {
+            continue;
+        }
+        window.frames[window.next] = window.current;
+        window.next = (window.next + 1) % WINDOW_FRAMES;
+        window.current = {};
+        window.lastEntities = window.currentEntities;
+        window.currentEntities = 0;
+        window.reported = false;
+
+        SystemStats& stats = stats_[name];
+        ++stats.frames;
+        refresh(stats, window);
+    }
+}
+
+AccessPattern AccessPatternTracker::classify(const AccessCounts& counts) noexcept
+{
+    u64 total = counts.linear + counts.random;
+    if (total == 0 || counts.random == 0) {
+        return AccessPattern::Linear;
+    }
+
+    bool sequentialLookups =
+        counts.strideSamples > 0 && counts.meanStride() <= SEQUENTIAL_STRIDE;
+    u64 sequential = counts.linear + (sequentialLookups ? counts.random : 0);
+    f64 share = static_cast<f64>(sequential) / static_cast<f64>(total);
+
+    if (share >= DOMINANT_SHARE) {
+        return AccessPattern::Linear;
+    }
+    if (share <= 1.0 - DOMINANT_SHARE) {
+        return AccessPattern::Random;
+    }
+    return AccessPattern::Mixed;
 }
 
 const std::unordered_map<std::string, SystemStats>& AccessPatternTracker::getStats() const
@@ -16,6 +90,44 @@ const std::unordered_map<std::string, SystemStats>& AccessPatternTracker::getSta
 void AccessPatternTracker::reset()
 {
     stats_.clear();
+    windows_.clear();
+}
+
+void AccessPatternTracker::update(const std::string& systemName, const AccessCounts& counts,
+                                  u64 entities)
+{
+    if (counts.empty() && entities == 0) {
+        return;
+    }
+
+    Window& window = windows_[systemName];
+    window.current += counts;
+    window.currentEntities += entities;
+    window.reported = true;
+
+    SystemStats& stats = stats_[systemName];
+    stats.systemName = systemName;
+    refresh(stats, window);
+}
+
+void AccessPatternTracker::refresh(SystemStats& stats, const Window& window)
+{
+    AccessCounts total = window.current;
+    for (const AccessCounts& frame : window.frames) {
+        total += frame;
+    }
+
+    stats.pattern = classify(total);
+    u64 entities = window.reported ? window.currentEntities : window.lastEntities;
+    stats.processedEntities =
+        static_cast<u32>(std::min<u64>(entities, std::numeric_limits<u32>::max()));
+    stats.linearAccesses = total.linear;
+    stats.randomAccesses = total.random;
+    stats.meanStride = total.meanStride();
+    stats.reuseRatio = total.random > 0
+                           ? static_cast<f64>(total.reuseHits) / static_cast<f64>(total.random)
+                           : 0.0;
+    stats.meanReuseDistance = total.meanReuseDistance();
 }
 
 }  // namespace autophage::analyzer
@@ -0,0 +1,153 @@
+#include <autophage/analyzer/execution_graph.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace autophage::analyzer {
+
+namespace {
+
+/// Critical path share above which a single system is worth splitting
+constexpr f64 DOMINANT_CRITICAL_SHARE = 0.5;
+
+/// Parallelism above which overlapping systems is worth reporting
+constexpr f64 USEFUL_PARALLELISM = 1.5;
+
+[[nodiscard]] String formatFixed(f64 value, int decimals)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+    return buffer;
+}
+
+}  // namespace
+
+bool nodesConflict(const ExecutionNode& a, const ExecutionNode& b)
+{
+    return a.access.conflictsWith(b.access);
+}
+
+// =============================================================================
+// Execution Graph
+// =============================================================================
+
+usize ExecutionGraph::addNode(ExecutionNode node)
+{
+    usize index = nodes_.size();
+    std::vector<usize> dependencies;
+    for (usize i = 0; i < index; ++i) {
+        if (nodesConflict(nodes_[i], node)) {
+            dependencies.push_back(i);
+        }
+    }
+    nodes_.push_back(std::move(node));
+    dependencies_.push_back(std::move(dependencies));
+    return index;
+}
+
+CriticalPathReport ExecutionGraph::analyze() const
+{
+    CriticalPathReport report;
+    report.nodes.resize(nodes_.size());
+    if (nodes_.empty()) {
+        return report;
+    }
+
+    // Nodes are already in topological order (edges only point forward)
+    for (usize i = 0; i < nodes_.size(); ++i) {
+        NodeSchedule& schedule = report.nodes[i];
+        for (usize dependency : dependencies_[i]) {
+            schedule.earliestStartNs =
+                std::max(schedule.earliestStartNs, report.nodes[dependency].earliestFinishNs);
+        }
+        schedule.earliestFinishNs = schedule.earliestStartNs + nodes_[i].costNs;
+        report.serialNs += nodes_[i].costNs;
+        report.criticalPathNs = std::max(report.criticalPathNs, schedule.earliestFinishNs);
+    }
+
+    // Latest finish: the earliest latest-start among successors, or the frame end
+    std::vector<f64> latestFinish(nodes_.size(), report.criticalPathNs);
+    for (usize i = nodes_.size(); i-- > 0;) {
+        NodeSchedule& schedule = report.nodes[i];
+        schedule.latestStartNs = latestFinish[i] - nodes_[i].costNs;
+        schedule.slackNs = std::max(0.0, schedule.latestStartNs - schedule.earliestStartNs);
+        report.totalSlackNs += schedule.slackNs;
+        for (usize dependency : dependencies_[i]) {
+            latestFinish[dependency] = std::min(latestFinish[dependency], schedule.latestStartNs);
+        }
+    }
+
+    if (report.criticalPathNs <= 0.0) {
+        return report;
+    }
+    report.parallelism = report.serialNs / report.criticalPathNs;
+
+    // Walk back from the node finishing last through the predecessor that released it
+    f64 epsilon = report.criticalPathNs * 1e-9;
+    usize current = 0;
+    for (usize i = 0; i < nodes_.size(); ++i) {
+        if (report.nodes[i].earliestFinishNs >= report.nodes[current].earliestFinishNs) {
+            current = i;
+        }
+    }
+    while (true) {
+        NodeSchedule& schedule = report.nodes[current];
+        schedule.critical = true;
+        schedule.criticalShare = nodes_[current].costNs / report.criticalPathNs;
+        report.criticalPath.push_back(current);
+
+        bool found = false;
+        for (usize dependency : dependencies_[current]) {
+            if (std::abs(report.nodes[dependency].earliestFinishNs - schedule.earliestStartNs) <=
+                epsilon) {
+                current = dependency;
+                found = true;
+            }
+        }
+        if (!found) {
+            break;
+        }
+    }
+    std::ranges::reverse(report.criticalPath);
+    return report;
+}
+
+std::vector<OptimizationHint> ExecutionGraph::hints(const CriticalPathReport& report) const
+{
+    std::vector<OptimizationHint> hints;
+    if (nodes_.size() < 2 || report.criticalPathNs <= 0.0) {
+        return hints;
+    }
+
+    for (usize index : report.criticalPath) {
+        const NodeSchedule& schedule = report.nodes[index];
+        if (schedule.criticalShare >= DOMINANT_CRITICAL_SHARE) {
+            hints.push_back(
+                {nodes_[index].name,
+                 "Limits frame time (" + formatFixed(schedule.criticalShare * 100.0, 0) +
+                     "% of the critical path); split it or parallelize its inner loop",
+                 1});
+        }
+    }
+
+    for (const auto& node : nodes_) {
+        if (node.access.empty()) {
+            hints.push_back({node.name,
+                             "No known component access; it is ordered against every system",
+                             0});
+        }
+    }
+
+    if (report.parallelism >= USEFUL_PARALLELISM) {
+        hints.push_back({"Scheduler",
+                         "Independent systems could overlap: critical path " +
+                             formatFixed(report.criticalPathNs / 1e6, 3) + " ms of " +
+                             formatFixed(report.serialNs / 1e6, 3) + " ms serial (" +
+                             formatFixed(report.parallelism, 1) + "x)",
+                         0});
+    }
+    return hints;
+}
+
+}  // namespace autophage::analyzer
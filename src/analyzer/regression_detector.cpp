@@ -0,0 +1,260 @@
+#include <autophage/analyzer/regression_detector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace autophage::analyzer {
+
+// =============================================================================
+// Statistical Tests
+// =============================================================================
+
+MannWhitneyResult mannWhitneyU(std::span<const f64> a, std::span<const f64> b)
+{
+    MannWhitneyResult result;
+    if (a.empty() || b.empty()) {
+        return result;
+    }
+
+    struct Ranked
+    {
+        f64 value;
+        bool second;
+    };
+
+    std::vector<Ranked> all;
+    all.reserve(a.size() + b.size());
+    for (f64 value : a) {
+        all.push_back({value, false});
+    }
+    for (f64 value : b) {
+        all.push_back({value, true});
+    }
+    std::ranges::sort(all, {}, &Ranked::value);
+
+    // Tied values share the average of the ranks they span
+    f64 rankSumSecond = 0.0;
+    f64 tieTerm = 0.0;
+    for (usize i = 0; i < all.size();) {
+        usize j = i + 1;
+        while (j < all.size() && all[j].value == all[i].value) {
+            ++j;
+        }
+        auto ties = static_cast<f64>(j - i);
+        f64 rank = (static_cast<f64>(i + 1) + static_cast<f64>(j)) / 2.0;
+        for (usize k = i; k < j; ++k) {
+            if (all[k].second) {
+                rankSumSecond += rank;
+            }
+        }
+        tieTerm += ties * ties * ties - ties;
+        i = j;
+    }
+
+    auto n1 = static_cast<f64>(a.size());
+    auto n2 = static_cast<f64>(b.size());
+    f64 n = n1 + n2;
+    result.u = rankSumSecond - n2 * (n2 + 1.0) / 2.0;
+
+    f64 variance = n1 * n2 / 12.0 * ((n + 1.0) - tieTerm / (n * (n - 1.0)));
+    if (variance <= 0.0) {
+        return result;  // Every value identical
+    }
+
+    f64 diff = result.u - n1 * n2 / 2.0;
+    f64 corrected = std::abs(diff) <= 0.5 ? 0.0 : diff - std::copysign(0.5, diff);
+    result.z = corrected / std::sqrt(variance);
+    result.pValue = std::erfc(std::abs(result.z) / std::sqrt(2.0));
+    return result;
+}
+
+namespace {
+
+/// @brief Median of a scratch buffer (reorders it)
+[[nodiscard]] f64 medianInPlace(std::span<f64> values)
+{
+    if (values.empty()) {
+        return 0.0;
+    }
+    usize mid = values.size() / 2;
+    std::ranges::nth_element(values, values.begin() + static_cast<std::ptrdiff_t>(mid));
+    f64 upper = values[mid];
+    if (values.size() % 2 != 0) {
+        return upper;
+    }
+    f64 lower = *std::max_element(values.begin(),
+                                  values.begin() + static_cast<std::ptrdiff_t>(mid));
+    return (lower + upper) / 2.0;
+}
+
+[[nodiscard]] f64 relativeChange(f64 baseline, f64 candidate) noexcept
+{
+    return baseline > 0.0 ? candidate / baseline - 1.0 : 0.0;
+}
+
+}  // namespace
+
+f64 median(std::span<const f64> values)
+{
+    std::vector<f64> scratch(values.begin(), values.end());
+    return medianInPlace(scratch);
+}
+
+std::pair<f64, f64> bootstrapMedianChange(std::span<const f64> a, std::span<const f64> b,
+                                          f64 confidence, u32 iterations, u64 seed)
+{
+    if (a.empty() || b.empty() || iterations == 0) {
+        return {0.0, 0.0};
+    }
+
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<usize> pickA(0, a.size() - 1);
+    std::uniform_int_distribution<usize> pickB(0, b.size() - 1);
+
+    std::vector<f64> resampleA(a.size());
+    std::vector<f64> resampleB(b.size());
+    std::vector<f64> changes;
+    changes.reserve(iterations);
+
+    for (u32 i = 0; i < iterations; ++i) {
+        for (f64& value : resampleA) {
+            value = a[pickA(rng)];
+        }
+        for (f64& value : resampleB) {
+            value = b[pickB(rng)];
+        }
+        changes.push_back(relativeChange(medianInPlace(resampleA), medianInPlace(resampleB)));
+    }
+    std::ranges::sort(changes);
+
+    f64 tail = std::clamp((1.0 - confidence) / 2.0, 0.0, 0.5);
+    auto last = static_cast<f64>(changes.size() - 1);
+    auto low = static_cast<usize>(std::floor(tail * last));
+    auto high = static_cast<usize>(std::ceil((1.0 - tail) * last));
+    return {changes[low], changes[high]};
+}
+
+// =============================================================================
+// Verdicts
+// =============================================================================
+
+RegressionResult compareSamples(std::span<const f64> baseline, std::span<const f64> candidate,
+                                const RegressionConfig& config)
+{
+    RegressionResult result;
+    result.baselineSamples = baseline.size();
+    result.candidateSamples = candidate.size();
+    result.baselineMedian = median(baseline);
+    result.candidateMedian = median(candidate);
+    result.relativeChange = relativeChange(result.baselineMedian, result.candidateMedian);
+
+    if (baseline.size() < config.minSamples || candidate.empty()) {
+        result.verdict = RegressionVerdict::Inconclusive;
+        return result;
+    }
+
+    MannWhitneyResult test = mannWhitneyU(baseline, candidate);
+    result.pValue = test.pValue;
+    result.confidence = 1.0 - test.pValue;
+
+    auto [low, high] = bootstrapMedianChange(baseline, candidate, config.confidence,
+                                             config.bootstrapIterations, config.seed);
+    result.changeLow = low;
+    result.changeHigh = high;
+
+    // Significant by rank test, interval excludes zero, and large enough to matter
+    bool significant = test.pValue < 1.0 - config.confidence && (low > 0.0 || high < 0.0) &&
+                       std::abs(result.relativeChange) >= config.minEffect;
+    if (!significant) {
+        result.verdict = RegressionVerdict::NoChange;
+    } else if (result.relativeChange > 0.0) {
+        result.verdict = RegressionVerdict::Regressed;
+    } else {
+        result.verdict = RegressionVerdict::Improved;
+    }
+    return result;
+}
+
+// =============================================================================
+// Regression Detector
+// =============================================================================
+
+RegressionDetector::RegressionDetector(const RegressionConfig& config) : config_(config) {}
+
+RegressionDetector::Subject* RegressionDetector::find(StringView subject)
+{
+    auto it = subjects_.find(String(subject));
+    return it != subjects_.end() ? &it->second : nullptr;
+}
+
+const RegressionDetector::Subject* RegressionDetector::find(StringView subject) const
+{
+    auto it = subjects_.find(String(subject));
+    return it != subjects_.end() ? &it->second : nullptr;
+}
+
+void RegressionDetector::addSample(StringView subject, f64 cost, u64 units)
+{
+    Subject& state = subjects_[String(subject)];
+    if (state.warmupRemaining > 0) {
+        --state.warmupRemaining;
+        return;
+    }
+
+    state.recent.push_back(units > 0 ? cost / static_cast<f64>(units) : cost);
+    while (state.recent.size() > config_.maxSamples) {
+        state.recent.pop_front();
+    }
+}
+
+void RegressionDetector::beginTrial(StringView subject, StringView baselineLabel,
+                                    StringView candidateLabel)
+{
+    Subject& state = subjects_[String(subject)];
+    state.baseline.assign(state.recent.begin(), state.recent.end());
+    state.recent.clear();
+    state.baselineLabel = String(baselineLabel);
+    state.candidateLabel = String(candidateLabel);
+    state.warmupRemaining = config_.warmupSamples;
+    state.trialActive = true;
+}
+
+void RegressionDetector::cancelTrial(StringView subject)
+{
+    if (Subject* state = find(subject)) {
+        state->baseline.clear();
+        state->trialActive = false;
+    }
+}
+
+bool RegressionDetector::hasTrial(StringView subject) const
+{
+    const Subject* state = find(subject);
+    return state && state->trialActive;
+}
+
+Optional<RegressionResult> RegressionDetector::evaluate(StringView subject)
+{
+    Subject* state = find(subject);
+    if (!state || !state->trialActive || state->recent.size() < config_.minSamples) {
+        return std::nullopt;
+    }
+
+    std::vector<f64> candidate(state->recent.begin(), state->recent.end());
+    RegressionResult result = compareSamples(state->baseline, candidate, config_);
+    result.subject = String(subject);
+    result.baselineLabel = std::move(state->baselineLabel);
+    result.candidateLabel = std::move(state->candidateLabel);
+
+    state->baseline.clear();
+    state->trialActive = false;
+    return result;
+}
+
+void RegressionDetector::reset(StringView subject)
+{
+    subjects_.erase(String(subject));
+}
+
+}  // namespace autophage::analyzer
@@ -1,27 +1,165 @@
 #include <autophage/analyzer/stats_collector.hpp>
 
+#include <algorithm>
+#include <string>
+#include <utility>
+
 namespace autophage::analyzer {
 
+namespace {
+
+/// Minimum samples in a window before it is trusted for a hint
+constexpr u64 MIN_WINDOW_SAMPLES = 10;
+
+/// Frame time growth over a minute, relative to the mean, reported as a regression trend
+constexpr f64 FRAME_TIME_TREND_PER_MINUTE = 0.25;
+
+/// Memory growth over a minute, relative to the mean, reported as a possible leak
+constexpr f64 MEMORY_TREND_PER_MINUTE = 0.10;
+
+[[nodiscard]] f64 toMilliseconds(Duration duration) noexcept
+{
+    return std::chrono::duration<f64, std::milli>(duration).count();
+}
+
+}  // namespace
+
+StatsCollector::StatsCollector() : start_(std::chrono::steady_clock::now())
+{
+    fixed_.frameTime = store_.series(FRAME_TIME_MS);
+    fixed_.fps = store_.series(FPS);
+    fixed_.entityCount = store_.series(ENTITY_COUNT);
+    fixed_.memoryUsed = store_.series(MEMORY_USED);
+    fixed_.allocatedBytes = store_.series(ALLOCATED_BYTES);
+    fixed_.allocationCount = store_.series(ALLOCATION_COUNT);
+    fixed_.cacheMisses = store_.series(CACHE_MISSES);
+    fixed_.branchMispredictions = store_.series(BRANCH_MISPREDICTIONS);
+    fixed_.dtlbMisses = store_.series(DTLB_MISSES);
+}
+
+// =============================================================================
+// Collection
+// =============================================================================
+
 void StatsCollector::collect()
 {
-    // In a real implementation, we would store historical data or fetch from Profiler.
-    // access autophage::getProfilerStats();
-    currentStub_ = autophage::getProfilerStats();
+    collect(std::chrono::duration<f64>(std::chrono::steady_clock::now() - start_).count());
+}
+
+void StatsCollector::collect(f64 timeSeconds)
+{
+    lastTime_ = timeSeconds;
+    latest_ = autophage::getProfilerStats();
+
+    const FrameStats& frame = autophage::getCurrentFrameStats();
+    f64 frameMs = toMilliseconds(frame.totalTime);
+    if (frameMs > 0.0) {
+        put(fixed_.frameTime, frameMs);
+        put(fixed_.fps, 1000.0 / frameMs);
+    }
+    put(fixed_.entityCount, static_cast<f64>(frame.entityCount));
+    put(fixed_.memoryUsed, static_cast<f64>(frame.memoryUsed));
+    put(fixed_.allocatedBytes, static_cast<f64>(frame.allocatedBytes));
+    put(fixed_.allocationCount, static_cast<f64>(frame.allocationCount));
+    put(fixed_.cacheMisses, static_cast<f64>(frame.cacheMisses));
+    put(fixed_.branchMispredictions, static_cast<f64>(frame.branchMispredictions));
+    put(fixed_.dtlbMisses, static_cast<f64>(frame.dtlbMisses));
+
+    for (const auto& sample : frame.metrics) {
+        if (sample.id >= metricSeries_.size()) {
+            metricSeries_.resize(sample.id + 1, INVALID_SERIES_ID);
+        }
+        SeriesId& id = metricSeries_[sample.id];
+        if (id == INVALID_SERIES_ID) {
+            id = store_.series("metric/" + String(getMetricName(sample.id)));
+        }
+        // Histograms are folded as a per-frame sum; the series tracks their mean value
+        f64 value = sample.kind == MetricKind::Histogram && sample.count > 0
+                        ? sample.value / static_cast<f64>(sample.count)
+                        : sample.value;
+        put(id, value);
+    }
+
+    // A zone entered several times per frame (or from several call sites sharing a
+    // descriptor) is reported once, with its summed time
+    std::vector<std::pair<ZoneId, f64>> zoneTotals;
+    for (const auto& zone : autophage::getZones()) {
+        if (zone.descriptor == INVALID_ZONE_ID || !zone.name) {
+            continue;
+        }
+        auto it = std::ranges::find(zoneTotals, zone.descriptor, &std::pair<ZoneId, f64>::first);
+        if (it == zoneTotals.end()) {
+            zoneTotals.emplace_back(zone.descriptor, toMilliseconds(zone.totalTime));
+        } else {
+            it->second += toMilliseconds(zone.totalTime);
+        }
+    }
+    for (const auto& [descriptor, totalMs] : zoneTotals) {
+        if (descriptor >= zoneSeries_.size()) {
+            zoneSeries_.resize(usize{descriptor} + 1, INVALID_SERIES_ID);
+        }
+        SeriesId& id = zoneSeries_[descriptor];
+        if (id == INVALID_SERIES_ID) {
+            const ZoneDescriptor* zone = getZoneDescriptor(descriptor);
+            if (!zone || !zone->name) {
+                continue;
+            }
+            id = store_.series(String("zone/") + zone->name);
+        }
+        put(id, totalMs);
+    }
+}
+
+void StatsCollector::record(StringView series, f64 value)
+{
+    put(store_.series(series), value);
 }
 
+void StatsCollector::put(SeriesId id, f64 value)
+{
+    store_.record(id, lastTime_, value);
+    if (capture_) {
+        capture_->push_back({id, value});
+    }
+}
+
+WindowAggregate StatsCollector::aggregate(StringView series, TimeWindow window) const
+{
+    SeriesId id = store_.findSeries(series);
+    return id != INVALID_SERIES_ID ? store_.aggregate(id, window, lastTime_) : WindowAggregate{};
+}
+
+// =============================================================================
+// Analysis
+// =============================================================================
+
 std::vector<OptimizationHint> StatsCollector::analyze() const
 {
     std::vector<OptimizationHint> hints;
 
-    // Example analysis
-    if (currentStub_.avgFps < 30.0 && currentStub_.sampleCount > 10) {
+    WindowAggregate fps = store_.aggregate(fixed_.fps, TimeWindow::Last10s, lastTime_);
+    if (fps.count > MIN_WINDOW_SAMPLES && fps.mean < 30.0) {
         hints.push_back({"Engine", "Low FPS detected (< 30)", 2});
     }
 
-    if (currentStub_.spikeCount > 5) {
+    if (latest_.spikeCount > 5) {
         hints.push_back({"Engine", "Frame time spikes detected", 1});
     }
 
+    // Trends need a longer window than a few frames to tell drift from noise
+    WindowAggregate frameTime = store_.aggregate(fixed_.frameTime, TimeWindow::Last5min,
+                                                 lastTime_);
+    if (frameTime.count > MIN_WINDOW_SAMPLES && frameTime.mean > 0.0 &&
+        frameTime.slopePerSecond * 60.0 > FRAME_TIME_TREND_PER_MINUTE * frameTime.mean) {
+        hints.push_back({"Engine", "Frame time trending upward over the last minutes", 1});
+    }
+
+    WindowAggregate memory = store_.aggregate(fixed_.memoryUsed, TimeWindow::Last5min, lastTime_);
+    if (memory.count > MIN_WINDOW_SAMPLES && memory.mean > 0.0 &&
+        memory.slopePerSecond * 60.0 > MEMORY_TREND_PER_MINUTE * memory.mean) {
+        hints.push_back({"Memory", "Memory usage growing steadily", 0});
+    }
+
     return hints;
 }
 
@@ -0,0 +1,164 @@
+#include <autophage/analyzer/time_series.hpp>
+#include <autophage/core/platform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace autophage::analyzer {
+
+// =============================================================================
+// Series Registry
+// =============================================================================
+
+SeriesId TimeSeriesStore::series(StringView name)
+{
+    std::string key(name);
+    if (auto it = ids_.find(key); it != ids_.end()) {
+        return it->second;
+    }
+
+    auto id = static_cast<SeriesId>(names_.size());
+    names_.push_back(key);
+    ids_.emplace(std::move(key), id);
+
+    for (usize t = 0; t < TIME_WINDOW_COUNT; ++t) {
+        Tier& tier = tiers_[t];
+        usize size = names_.size() * TIERS[t].bucketCount;
+        tier.bucket.resize(size, -1);
+        tier.count.resize(size, 0);
+        tier.sum.resize(size, 0.0);
+        tier.sumSquares.resize(size, 0.0);
+        tier.min.resize(size, 0.0);
+        tier.max.resize(size, 0.0);
+    }
+    return id;
+}
+
+SeriesId TimeSeriesStore::findSeries(StringView name) const
+{
+    auto it = ids_.find(std::string(name));
+    return it != ids_.end() ? it->second : INVALID_SERIES_ID;
+}
+
+StringView TimeSeriesStore::seriesName(SeriesId id) const
+{
+    return id < names_.size() ? StringView(names_[id]) : StringView();
+}
+
+void TimeSeriesStore::clear()
+{
+    names_.clear();
+    ids_.clear();
+    tiers_ = {};
+    latestTime_ = 0.0;
+}
+
+// =============================================================================
+// Recording
+// =============================================================================
+
+void TimeSeriesStore::record(SeriesId id, f64 timeSeconds, f64 value)
+{
+    if (id >= names_.size()) AUTOPHAGE_UNLIKELY {
+        return;
+    }
+
+    latestTime_ = std::max(latestTime_, timeSeconds);
+
+    for (usize t = 0; t < TIME_WINDOW_COUNT; ++t) {
+        const TierLayout& layout = TIERS[t];
+        Tier& tier = tiers_[t];
+
+        auto bucket = static_cast<i64>(std::floor(timeSeconds / layout.bucketSeconds));
+        auto ring = static_cast<i64>(layout.bucketCount);
+        usize slot = slotBase(id, static_cast<TimeWindow>(t)) +
+                     static_cast<usize>(((bucket % ring) + ring) % ring);
+
+        if (tier.bucket[slot] != bucket) {
+            // Slot still holds a bucket from a previous lap of the ring
+            tier.bucket[slot] = bucket;
+            tier.count[slot] = 0;
+            tier.sum[slot] = 0.0;
+            tier.sumSquares[slot] = 0.0;
+            tier.min[slot] = value;
+            tier.max[slot] = value;
+        }
+
+        ++tier.count[slot];
+        tier.sum[slot] += value;
+        tier.sumSquares[slot] += value * value;
+        tier.min[slot] = std::min(tier.min[slot], value);
+        tier.max[slot] = std::max(tier.max[slot], value);
+    }
+}
+
+// =============================================================================
+// Aggregation
+// =============================================================================
+
+WindowAggregate TimeSeriesStore::aggregate(SeriesId id, TimeWindow window, f64 now) const
+{
+    WindowAggregate result;
+    if (id >= names_.size() || window == TimeWindow::Count) AUTOPHAGE_UNLIKELY {
+        return result;
+    }
+
+    const TierLayout& layout = TIERS[static_cast<usize>(window)];
+    const Tier& tier = tiers_[static_cast<usize>(window)];
+    auto newest = static_cast<i64>(std::floor(now / layout.bucketSeconds));
+    i64 oldest = newest - static_cast<i64>(layout.bucketCount) + 1;
+
+    f64 sumSquares = 0.0;
+    f64 minValue = std::numeric_limits<f64>::max();
+    f64 maxValue = std::numeric_limits<f64>::lowest();
+
+    // Trend over bucket means: x is the bucket position in the window, y the bucket mean
+    f64 buckets = 0.0;
+    f64 sumX = 0.0;
+    f64 sumY = 0.0;
+    f64 sumXY = 0.0;
+    f64 sumXX = 0.0;
+
+    usize base = slotBase(id, window);
+    for (usize i = 0; i < layout.bucketCount; ++i) {
+        usize slot = base + i;
+        i64 bucket = tier.bucket[slot];
+        if (bucket < oldest || bucket > newest || tier.count[slot] == 0) {
+            continue;
+        }
+
+        result.count += tier.count[slot];
+        result.sum += tier.sum[slot];
+        sumSquares += tier.sumSquares[slot];
+        minValue = std::min(minValue, tier.min[slot]);
+        maxValue = std::max(maxValue, tier.max[slot]);
+
+        auto x = static_cast<f64>(bucket - oldest);
+        f64 y = tier.sum[slot] / static_cast<f64>(tier.count[slot]);
+        buckets += 1.0;
+        sumX += x;
+        sumY += y;
+        sumXY += x * y;
+        sumXX += x * x;
+    }
+
+    if (result.count == 0) {
+        return result;
+    }
+
+    auto n = static_cast<f64>(result.count);
+    result.mean = result.sum / n;
+    result.stddev = std::sqrt(std::max(0.0, sumSquares / n - result.mean * result.mean));
+    result.min = minValue;
+    result.max = maxValue;
+
+    f64 denominator = buckets * sumXX - sumX * sumX;
+    if (buckets >= 2.0 && denominator > 0.0) {
+        f64 slopePerBucket = (buckets * sumXY - sumX * sumY) / denominator;
+        result.slopePerSecond = slopePerBucket / layout.bucketSeconds;
+    }
+    return result;
+}
+
+}  // namespace autophage::analyzer
@@ -0,0 +1,218 @@
+/// @file frame_allocator.cpp
+/// @brief Per-thread, double-buffered frame allocator implementation
+
+#include <autophage/core/assert.hpp>
+#include <autophage/core/frame_allocator.hpp>
+#include <autophage/core/memory.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace autophage {
+
+namespace {
+
+std::atomic<u64> g_frameEpoch{0};
+std::atomic<usize> g_blockSize{DEFAULT_FRAME_BLOCK_SIZE};
+
+/// @brief Header of a chained block; the usable bytes follow it
+struct FrameBlock
+{
+    FrameBlock* next = nullptr;
+    usize capacity = 0;
+    usize used = 0;
+};
+
+/// Header padded to a cache line so the data area starts cache-line aligned
+constexpr usize CACHE_LINE = AUTOPHAGE_CACHE_LINE_SIZE;
+constexpr usize BLOCK_HEADER_SIZE = (sizeof(FrameBlock) + CACHE_LINE - 1) & ~(CACHE_LINE - 1);
+
+[[nodiscard]] Byte* blockData(FrameBlock* block) noexcept
+{
+    return reinterpret_cast<Byte*>(block) + BLOCK_HEADER_SIZE;
+}
+
+[[nodiscard]] FrameBlock* createBlock(usize capacity) noexcept
+{
+    void* memory = taggedAlignedAlloc(BLOCK_HEADER_SIZE + capacity, AUTOPHAGE_CACHE_LINE_SIZE,
+                                      MemoryTag::Temporary);
+    if (!memory) {
+        return nullptr;
+    }
+    auto* block = new (memory) FrameBlock{};
+    block->capacity = capacity;
+    return block;
+}
+
+void destroyChain(FrameBlock* block) noexcept
+{
+    while (block) {
+        FrameBlock* next = block->next;
+        taggedAlignedFree(block, MemoryTag::Temporary);
+        block = next;
+    }
+}
+
+/// @brief One half of a thread's arena: a chain of blocks filled front to back
+struct FrameBuffer
+{
+    FrameBlock* head = nullptr;
+    FrameBlock* current = nullptr;
+    usize bytesAllocated = 0;
+
+    [[nodiscard]] usize capacity() const noexcept
+    {
+        usize total = 0;
+        for (FrameBlock* block = head; block; block = block->next) {
+            total += block->capacity;
+        }
+        return total;
+    }
+
+    void reset() noexcept
+    {
+        bytesAllocated = 0;
+        if (head && head->next) {
+            // Overflowed last time: replace the chain with one block big enough for all of it
+            usize total = capacity();
+            destroyChain(head);
+            head = createBlock(total);
+        }
+        if (head) {
+            head->used = 0;
+        }
+        current = head;
+    }
+
+    void release() noexcept
+    {
+        destroyChain(head);
+        head = nullptr;
+        current = nullptr;
+        bytesAllocated = 0;
+    }
+};
+
+/// @brief Alignment padding needed at the current position of a block
+[[nodiscard]] usize paddingFor(FrameBlock* block, usize alignment) noexcept
+{
+    auto address = reinterpret_cast<std::uintptr_t>(blockData(block) + block->used);
+    return (alignment - (address & (alignment - 1))) & (alignment - 1);
+}
+
+struct ThreadFrameArena
+{
+    std::array<FrameBuffer, 2> buffers;
+    u32 active = 0;
+    u64 epoch = 0;
+    u64 overflowBlocks = 0;
+
+    ThreadFrameArena() : epoch(g_frameEpoch.load(std::memory_order_relaxed)) {}
+
+    ~ThreadFrameArena()
+    {
+        for (auto& buffer : buffers) {
+            buffer.release();
+        }
+    }
+
+    ThreadFrameArena(const ThreadFrameArena&) = delete;
+    ThreadFrameArena& operator=(const ThreadFrameArena&) = delete;
+
+    /// @brief Catch up with frames advanced since this thread last allocated
+    void sync() noexcept
+    {
+        u64 globalEpoch = g_frameEpoch.load(std::memory_order_relaxed);
+        if (globalEpoch == epoch) AUTOPHAGE_LIKELY {
+            return;
+        }
+
+        if (globalEpoch - epoch >= 2) {
+            // Both buffers hold data older than the previous frame
+            buffers[0].reset();
+            buffers[1].reset();
+        } else {
+            active ^= 1u;
+            buffers[active].reset();
+        }
+        epoch = globalEpoch;
+    }
+
+    [[nodiscard]] void* alloc(usize size, usize alignment) noexcept
+    {
+        sync();
+        FrameBuffer& buffer = buffers[active];
+
+        if (buffer.current) AUTOPHAGE_LIKELY {
+            FrameBlock* block = buffer.current;
+            usize padding = paddingFor(block, alignment);
+            if (block->used + padding + size <= block->capacity) {
+                void* ptr = blockData(block) + block->used + padding;
+                block->used += padding + size;
+                buffer.bytesAllocated += size;
+                return ptr;
+            }
+        }
+
+        // Chain a new block; the data area is cache-line aligned, so alignment up to that is free
+        usize capacity = std::max(g_blockSize.load(std::memory_order_relaxed),
+                                  size + (alignment > AUTOPHAGE_CACHE_LINE_SIZE ? alignment : 0));
+        FrameBlock* block = createBlock(capacity);
+        if (!block) AUTOPHAGE_UNLIKELY {
+            return nullptr;
+        }
+
+        if (buffer.current) {
+            buffer.current->next = block;
+            ++overflowBlocks;
+        } else {
+            buffer.head = block;
+        }
+        buffer.current = block;
+
+        usize padding = paddingFor(block, alignment);
+        void* ptr = blockData(block) + padding;
+        block->used = padding + size;
+        buffer.bytesAllocated += size;
+        return ptr;
+    }
+};
+
+thread_local ThreadFrameArena t_frameArena;
+
+}  // namespace
+
+// =============================================================================
+// Frame Allocation
+// =============================================================================
+
+void* frameAlloc(usize size, usize alignment) noexcept
+{
+    AUTOPHAGE_ASSERT((alignment & (alignment - 1)) == 0, "Alignment must be power of 2");
+    return t_frameArena.alloc(size, alignment);
+}
+
+void advanceFrameAllocators() noexcept
+{
+    g_frameEpoch.fetch_add(1, std::memory_order_relaxed);
+}
+
+void setFrameAllocatorBlockSize(usize bytes) noexcept
+{
+    g_blockSize.store(std::max<usize>(bytes, AUTOPHAGE_CACHE_LINE_SIZE),
+                      std::memory_order_relaxed);
+}
+
+FrameAllocatorStats getFrameAllocatorStats() noexcept
+{
+    t_frameArena.sync();
+    return FrameAllocatorStats{
+        .bytesThisFrame = t_frameArena.buffers[t_frameArena.active].bytesAllocated,
+        .capacity = t_frameArena.buffers[0].capacity() + t_frameArena.buffers[1].capacity(),
+        .overflowBlocks = t_frameArena.overflowBlocks,
+    };
+}
+
+}  // namespace autophage
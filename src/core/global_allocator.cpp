@@ -0,0 +1,155 @@
+/// @file global_allocator.cpp
+/// @brief Replacement global operator new/delete routed through tagged tracking
+///
+/// Only compiled with AUTOPHAGE_TRACK_GLOBAL_ALLOCATIONS. Every heap allocation made through
+/// new/delete (standard containers, std::function, std::string, ...) is charged to the calling
+/// thread's current MemoryTag (see MemoryTagScope), so MemoryStats and the per-frame deltas cover
+/// the whole engine rather than only explicit taggedAlloc calls. The cost is a 16-byte header per
+/// block plus a few relaxed atomic updates.
+
+#include <autophage/core/memory.hpp>
+
+#include <cstddef>
+#include <new>
+
+namespace {
+
+[[nodiscard]] void* allocateOrThrow(std::size_t size, std::size_t alignment)
+{
+    // operator new(0) must return a unique pointer
+    if (size == 0) {
+        size = 1;
+    }
+
+    for (;;) {
+        if (void* ptr = autophage::detail::trackedHeapAlloc(size, alignment)) {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+[[nodiscard]] void* allocateNoThrow(std::size_t size, std::size_t alignment) noexcept
+{
+    try {
+        return allocateOrThrow(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+}  // namespace
+
+// =============================================================================
+// Allocation
+// =============================================================================
+
+void* operator new(std::size_t size)
+{
+    return allocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new[](std::size_t size)
+{
+    return allocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocateNoThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocateNoThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocateNoThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocateNoThrow(size, static_cast<std::size_t>(alignment));
+}
+
+// =============================================================================
+// Deallocation
+// =============================================================================
+
+// The block header records size, tag and alignment, so every form frees the same way
+
+void operator delete(void* ptr) noexcept
+{
+    autophage::detail::trackedHeapFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    autophage::detail::trackedHeapFree(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    autophage::detail::trackedHeapFree(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    autophage::detail::trackedHeapFree(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    autophage::detail::trackedHeapFree(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    autophage::detail::trackedHeapFree(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    autophage::detail::trackedHeapFree(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+    autophage::detail::trackedHeapFree(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    autophage::detail::trackedHeapFree(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    autophage::detail::trackedHeapFree(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    autophage::detail::trackedHeapFree(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    autophage::detail::trackedHeapFree(ptr);
+}
@@ -4,6 +4,7 @@
 #include <autophage/core/assert.hpp>
 #include <autophage/core/memory.hpp>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <mutex>
@@ -19,30 +20,93 @@ struct TaggedMemoryTracker
     std::atomic<usize> peakBytes{0};
     std::atomic<u64> totalAllocations{0};
     std::atomic<u64> totalDeallocations{0};
+    std::atomic<u64> totalAllocatedBytes{0};
+    std::atomic<u64> totalFreedBytes{0};
 };
 
-std::array<TaggedMemoryTracker, static_cast<usize>(MemoryTag::Count)> g_memoryTrackers;
+std::array<TaggedMemoryTracker, MEMORY_TAG_COUNT> g_memoryTrackers;
 
-void trackAllocation(MemoryTag tag, usize size)
+// Allocation sampling
+std::atomic<AllocationSampleHook> g_sampleHook{nullptr};
+std::atomic<usize> g_sampleInterval{0};
+
+thread_local i64 t_bytesUntilSample = 0;
+thread_local bool t_inSampleHook = false;
+
+void sampleAllocation(MemoryTag tag, usize size)
 {
-    auto& tracker = g_memoryTrackers[static_cast<usize>(tag)];
-    usize current = tracker.currentBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    AllocationSampleHook hook = g_sampleHook.load(std::memory_order_acquire);
+    if (!hook || t_inSampleHook) {
+        return;
+    }
 
-    // Update peak (lock-free)
-    usize peak = tracker.peakBytes.load(std::memory_order_relaxed);
-    while (current > peak &&
-           !tracker.peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
-        // Retry
+    t_bytesUntilSample -= static_cast<i64>(size);
+    if (t_bytesUntilSample > 0) {
+        return;
     }
+    t_bytesUntilSample = static_cast<i64>(g_sampleInterval.load(std::memory_order_relaxed));
 
-    tracker.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    // The hook typically captures a stack and allocates itself; don't sample those
+    t_inSampleHook = true;
+    hook(tag, size);
+    t_inSampleHook = false;
 }
 
-void trackDeallocation(MemoryTag tag, usize size)
+/// @brief Prefix stored immediately before every tagged block
+struct AllocationHeader
 {
-    auto& tracker = g_memoryTrackers[static_cast<usize>(tag)];
-    tracker.currentBytes.fetch_sub(size, std::memory_order_relaxed);
-    tracker.totalDeallocations.fetch_add(1, std::memory_order_relaxed);
+    usize size = 0;
+    u32 offset = 0;  // Distance from the start of the underlying block to the user pointer
+    MemoryTag tag = MemoryTag::Unknown;
+    bool overAligned = false;  // Block came from alignedAlloc rather than malloc
+};
+
+static_assert(sizeof(AllocationHeader) <= 16, "Allocation header should fit a 16-byte prefix");
+
+/// Alignment malloc guarantees; anything stricter goes through alignedAlloc
+constexpr usize MALLOC_ALIGNMENT = alignof(std::max_align_t);
+
+[[nodiscard]] AllocationHeader* headerOf(const void* ptr) noexcept
+{
+    return reinterpret_cast<AllocationHeader*>(const_cast<Byte*>(static_cast<const Byte*>(ptr)) -
+                                               sizeof(AllocationHeader));
+}
+
+[[nodiscard]] void* allocateTagged(usize size, usize alignment, MemoryTag tag) noexcept
+{
+    // The header sits directly before the user pointer; pad the prefix to keep the alignment
+    bool overAligned = alignment > MALLOC_ALIGNMENT;
+    alignment = std::max(alignment, MALLOC_ALIGNMENT);
+    usize prefix = std::max(alignment, sizeof(AllocationHeader));
+
+    auto* base = static_cast<Byte*>(overAligned ? alignedAlloc(size + prefix, alignment)
+                                                : std::malloc(size + prefix));
+    if (!base) {
+        return nullptr;
+    }
+
+    Byte* ptr = base + prefix;
+    AllocationHeader* header = headerOf(ptr);
+    header->size = size;
+    header->offset = static_cast<u32>(prefix);
+    header->tag = tag;
+    header->overAligned = overAligned;
+
+    trackAllocation(tag, size);
+    return ptr;
+}
+
+void releaseTagged(void* ptr) noexcept
+{
+    AllocationHeader* header = headerOf(ptr);
+    trackDeallocation(header->tag, header->size);
+
+    Byte* base = static_cast<Byte*>(ptr) - header->offset;
+    if (header->overAligned) {
+        alignedFree(base);
+    } else {
+        std::free(base);
+    }
 }
 
 }  // namespace
@@ -59,18 +123,22 @@ MemoryStats getMemoryStats(MemoryTag tag) noexcept
         .peakBytes = tracker.peakBytes.load(std::memory_order_relaxed),
         .totalAllocations = tracker.totalAllocations.load(std::memory_order_relaxed),
         .totalDeallocations = tracker.totalDeallocations.load(std::memory_order_relaxed),
+        .totalAllocatedBytes = tracker.totalAllocatedBytes.load(std::memory_order_relaxed),
+        .totalFreedBytes = tracker.totalFreedBytes.load(std::memory_order_relaxed),
     };
 }
 
 MemoryStats getTotalMemoryStats() noexcept
 {
     MemoryStats total{};
-    for (usize i = 0; i < static_cast<usize>(MemoryTag::Count); ++i) {
-        const auto& tracker = g_memoryTrackers[i];
-        total.currentBytes += tracker.currentBytes.load(std::memory_order_relaxed);
-        total.peakBytes += tracker.peakBytes.load(std::memory_order_relaxed);
-        total.totalAllocations += tracker.totalAllocations.load(std::memory_order_relaxed);
-        total.totalDeallocations += tracker.totalDeallocations.load(std::memory_order_relaxed);
+    for (usize i = 0; i < MEMORY_TAG_COUNT; ++i) {
+        MemoryStats stats = getMemoryStats(static_cast<MemoryTag>(i));
+        total.currentBytes += stats.currentBytes;
+        total.peakBytes += stats.peakBytes;
+        total.totalAllocations += stats.totalAllocations;
+        total.totalDeallocations += stats.totalDeallocations;
+        total.totalAllocatedBytes += stats.totalAllocatedBytes;
+        total.totalFreedBytes += stats.totalFreedBytes;
     }
     return total;
 }
@@ -82,7 +150,48 @@ void resetMemoryStats() noexcept
         tracker.peakBytes.store(0, std::memory_order_relaxed);
         tracker.totalAllocations.store(0, std::memory_order_relaxed);
         tracker.totalDeallocations.store(0, std::memory_order_relaxed);
+        tracker.totalAllocatedBytes.store(0, std::memory_order_relaxed);
+        tracker.totalFreedBytes.store(0, std::memory_order_relaxed);
+    }
+}
+
+void trackAllocation(MemoryTag tag, usize size) noexcept
+{
+    auto& tracker = g_memoryTrackers[static_cast<usize>(tag)];
+    usize current = tracker.currentBytes.fetch_add(size, std::memory_order_relaxed) + size;
+
+    // Update peak (lock-free)
+    usize peak = tracker.peakBytes.load(std::memory_order_relaxed);
+    while (current > peak &&
+           !tracker.peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+        // Retry
     }
+
+    tracker.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    tracker.totalAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+    detail::t_allocationCounters.allocations++;
+    detail::t_allocationCounters.allocatedBytes += size;
+
+    sampleAllocation(tag, size);
+}
+
+void trackDeallocation(MemoryTag tag, usize size) noexcept
+{
+    auto& tracker = g_memoryTrackers[static_cast<usize>(tag)];
+    tracker.currentBytes.fetch_sub(size, std::memory_order_relaxed);
+    tracker.totalDeallocations.fetch_add(1, std::memory_order_relaxed);
+    tracker.totalFreedBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+// =============================================================================
+// Allocation Sampling
+// =============================================================================
+
+void setAllocationSampleHook(AllocationSampleHook hook, usize intervalBytes) noexcept
+{
+    g_sampleInterval.store(std::max<usize>(intervalBytes, 1), std::memory_order_relaxed);
+    g_sampleHook.store(hook, std::memory_order_release);
 }
 
 // =============================================================================
@@ -91,40 +200,61 @@ void resetMemoryStats() noexcept
 
 void* taggedAlloc(usize size, MemoryTag tag) noexcept
 {
-    void* ptr = std::malloc(size);
-    if (ptr) {
-        trackAllocation(tag, size);
-    }
-    return ptr;
+    return allocateTagged(size, MALLOC_ALIGNMENT, tag);
 }
 
 void* taggedAlignedAlloc(usize size, usize alignment, MemoryTag tag) noexcept
 {
-    void* ptr = alignedAlloc(size, alignment);
+    return allocateTagged(size, alignment, tag);
+}
+
+void taggedAlignedFree(void* ptr, [[maybe_unused]] MemoryTag tag) noexcept
+{
     if (ptr) {
-        trackAllocation(tag, size);
+        AUTOPHAGE_ASSERT(headerOf(ptr)->tag == tag, "Tagged memory freed with a different tag");
+        releaseTagged(ptr);
     }
-    return ptr;
 }
 
-void taggedAlignedFree(void* ptr, MemoryTag tag) noexcept
+void taggedFree(void* ptr, [[maybe_unused]] MemoryTag tag) noexcept
 {
     if (ptr) {
-        trackDeallocation(tag, 0);
-        alignedFree(ptr);
+        AUTOPHAGE_ASSERT(headerOf(ptr)->tag == tag, "Tagged memory freed with a different tag");
+        releaseTagged(ptr);
     }
 }
 
-void taggedFree(void* ptr, MemoryTag tag) noexcept
+usize taggedAllocationSize(const void* ptr) noexcept
+{
+    return ptr ? headerOf(ptr)->size : 0;
+}
+
+namespace detail {
+
+MemoryTag& engineCurrentMemoryTag() noexcept
+{
+    return t_currentMemoryTag;
+}
+
+ThreadAllocationCounters& engineAllocationCounters() noexcept
+{
+    return t_allocationCounters;
+}
+
+void* trackedHeapAlloc(usize size, usize alignment) noexcept
+{
+    return allocateTagged(size, alignment, t_currentMemoryTag);
+}
+
+void trackedHeapFree(void* ptr) noexcept
 {
     if (ptr) {
-        // Note: We don't know the size here, so we track 0
-        // In a production system, we'd store size in a header or use a size map
-        trackDeallocation(tag, 0);
-        std::free(ptr);
+        releaseTagged(ptr);
     }
 }
 
+}  // namespace detail
+
 // =============================================================================
 // Linear Allocator
 // =============================================================================
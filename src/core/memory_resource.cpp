@@ -0,0 +1,68 @@
+/// @file memory_resource.cpp
+/// @brief std::pmr::memory_resource adapters implementation
+
+#include <autophage/core/memory_resource.hpp>
+
+#include <algorithm>
+
+namespace autophage {
+
+// =============================================================================
+// Linear Memory Resource
+// =============================================================================
+
+void* LinearMemoryResource::do_allocate(usize bytes, usize alignment)
+{
+    void* ptr = arena_.alloc(bytes, alignment);
+    if (!ptr) AUTOPHAGE_UNLIKELY {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void LinearMemoryResource::do_deallocate(void* /*ptr*/, usize /*bytes*/, usize /*alignment*/) {}
+
+bool LinearMemoryResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+// =============================================================================
+// Tagged Heap Memory Resource
+// =============================================================================
+
+void* TaggedMemoryResource::do_allocate(usize bytes, usize alignment)
+{
+    usize budget = budget_.load(std::memory_order_relaxed);
+    usize inUse = bytesInUse_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    if (budget != 0 && inUse > budget) AUTOPHAGE_UNLIKELY {
+        bytesInUse_.fetch_sub(bytes, std::memory_order_relaxed);
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        throw std::bad_alloc();
+    }
+
+    void* ptr = taggedAlignedAlloc(bytes, std::max(alignment, alignof(std::max_align_t)), tag_);
+    if (!ptr) AUTOPHAGE_UNLIKELY {
+        bytesInUse_.fetch_sub(bytes, std::memory_order_relaxed);
+        throw std::bad_alloc();
+    }
+
+    usize peak = peakBytes_.load(std::memory_order_relaxed);
+    while (inUse > peak &&
+           !peakBytes_.compare_exchange_weak(peak, inUse, std::memory_order_relaxed)) {
+    }
+    return ptr;
+}
+
+void TaggedMemoryResource::do_deallocate(void* ptr, usize bytes, usize /*alignment*/)
+{
+    taggedAlignedFree(ptr, tag_);
+    bytesInUse_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+bool TaggedMemoryResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+}  // namespace autophage
@@ -2,10 +2,124 @@
 /// @brief Platform abstraction implementation
 
 #include <autophage/core/platform.hpp>
+#include <autophage/core/type_id.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#if (defined(AUTOPHAGE_ARCH_X64) || defined(AUTOPHAGE_ARCH_X86))
+    #if defined(AUTOPHAGE_COMPILER_MSVC)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
+#ifndef AUTOPHAGE_BUILD_ID
+    #define AUTOPHAGE_BUILD_ID "unknown"
+#endif
 
 namespace autophage {
 
-// Platform-specific implementations will go here
-// For now, the header provides all needed functionality via constexpr
+namespace {
+
+[[nodiscard]] String trim(String text)
+{
+    usize begin = text.find_first_not_of(" \t\r\n");
+    if (begin == String::npos) {
+        return {};
+    }
+    usize end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+}
+
+[[nodiscard]] String detectCpuModel()
+{
+#if defined(AUTOPHAGE_ARCH_X64) || defined(AUTOPHAGE_ARCH_X86)
+    // CPUID.80000002H-80000004H - processor brand string
+    char brand[49] = {};
+    #if defined(AUTOPHAGE_COMPILER_MSVC)
+    int regs[4] = {};
+    __cpuid(regs, static_cast<int>(0x80000000u));
+    if (static_cast<unsigned>(regs[0]) >= 0x80000004u) {
+        for (unsigned leaf = 0; leaf < 3; ++leaf) {
+            __cpuid(regs, static_cast<int>(0x80000002u + leaf));
+            std::memcpy(brand + leaf * 16, regs, sizeof(regs));
+        }
+    }
+    #else
+    unsigned regs[4] = {};
+    if (__get_cpuid(0x80000000u, &regs[0], &regs[1], &regs[2], &regs[3]) != 0 &&
+        regs[0] >= 0x80000004u) {
+        for (unsigned leaf = 0; leaf < 3; ++leaf) {
+            __get_cpuid(0x80000002u + leaf, &regs[0], &regs[1], &regs[2], &regs[3]);
+            std::memcpy(brand + leaf * 16, regs, sizeof(regs));
+        }
+    }
+    #endif
+    if (String model = trim(brand); !model.empty()) {
+        return model;
+    }
+#endif
+
+#if defined(AUTOPHAGE_PLATFORM_LINUX)
+    // ARM kernels report "Hardware" or "Model" rather than "model name"
+    if (std::FILE* file = std::fopen("/proc/cpuinfo", "r")) {
+        char line[256];
+        String model;
+        while (model.empty() && std::fgets(line, sizeof(line), file)) {
+            for (const char* key : {"model name", "Hardware", "Model"}) {
+                if (std::strncmp(line, key, std::strlen(key)) == 0) {
+                    if (const char* colon = std::strchr(line, ':')) {
+                        model = trim(colon + 1);
+                    }
+                    break;
+                }
+            }
+        }
+        std::fclose(file);
+        if (!model.empty()) {
+            return model;
+        }
+    }
+#endif
+    return "unknown";
+}
+
+}  // namespace
+
+const MachineInfo& getMachineInfo()
+{
+    static const MachineInfo info = [] {
+        MachineInfo machine;
+        machine.cpuModel = detectCpuModel();
+        machine.logicalCores = std::max(1u, std::thread::hardware_concurrency());
+        return machine;
+    }();
+    return info;
+}
+
+const String& getBuildHash()
+{
+    static const String hash = [] {
+        constexpr PlatformInfo platform = getPlatformInfo();
+        u64 value = detail::fnv1aHash(AUTOPHAGE_BUILD_ID);
+        for (StringView part : {platform.compiler, platform.build, platform.arch}) {
+            value = detail::hashCombine(value, detail::fnv1aHash(String(part).c_str()));
+        }
+        value = detail::hashCombine(value, platform.compilerVersion);
+        value = detail::hashCombine(value, platform.simdLevel);
+#if defined(AUTOPHAGE_PROFILE_LEVEL)
+        value = detail::hashCombine(value, static_cast<u64>(AUTOPHAGE_PROFILE_LEVEL));
+#endif
+
+        char buffer[17];
+        std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(value));
+        return String(buffer);
+    }();
+    return hash;
+}
 
 }  // namespace autophage
@@ -0,0 +1,488 @@
+/// @file tlsf_allocator.cpp
+/// @brief Two-Level Segregated Fit allocator implementation
+
+#include <autophage/core/assert.hpp>
+#include <autophage/core/logger.hpp>
+#include <autophage/core/tlsf_allocator.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <new>
+
+namespace autophage {
+
+namespace {
+
+constexpr usize FREE_BIT = 1;
+constexpr usize FLAG_MASK = TlsfAllocator::ALIGNMENT - 1;
+
+/// prevPhys + sizeAndFlags precede every payload
+constexpr usize BLOCK_HEADER_SIZE = 2 * sizeof(void*);
+
+/// Free blocks must hold their two list links
+constexpr usize MIN_BLOCK_SIZE = 2 * sizeof(void*);
+
+/// Pool bookkeeping at the start of each pool, padded to keep blocks aligned
+constexpr usize POOL_HEADER_SIZE = 32;
+
+/// Sizes below this map linearly into first-level list 0
+constexpr usize SMALL_BLOCK_SIZE = usize{1} << 9;
+
+[[nodiscard]] constexpr usize alignUp(usize value, usize alignment) noexcept
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+[[nodiscard]] u32 floorLog2(usize value) noexcept
+{
+    return static_cast<u32>(std::bit_width(value)) - 1;
+}
+
+}  // namespace
+
+namespace detail {
+
+/// Every block starts with prevPhys + sizeAndFlags; free blocks also keep their list links in
+/// what would otherwise be payload. Sizes are multiples of ALIGNMENT, so the low bits hold flags.
+struct TlsfBlock
+{
+    TlsfBlock* prevPhys;  // Physically preceding block (nullptr for the first in a pool)
+    usize sizeAndFlags;   // Payload size | FREE_BIT
+    TlsfBlock* nextFree;  // Free blocks only
+    TlsfBlock* prevFree;  // Free blocks only
+
+    [[nodiscard]] usize size() const noexcept { return sizeAndFlags & ~FLAG_MASK; }
+    [[nodiscard]] bool isFree() const noexcept { return (sizeAndFlags & FREE_BIT) != 0; }
+    [[nodiscard]] bool isSentinel() const noexcept { return size() == 0; }
+
+    void setSize(usize size) noexcept { sizeAndFlags = size | (sizeAndFlags & FLAG_MASK); }
+    void setFree(bool free) noexcept
+    {
+        sizeAndFlags = free ? (sizeAndFlags | FREE_BIT) : (sizeAndFlags & ~FREE_BIT);
+    }
+
+    [[nodiscard]] Byte* payload() noexcept
+    {
+        return reinterpret_cast<Byte*>(this) + BLOCK_HEADER_SIZE;
+    }
+
+    [[nodiscard]] TlsfBlock* next() noexcept
+    {
+        return reinterpret_cast<TlsfBlock*>(payload() + size());
+    }
+
+    [[nodiscard]] static TlsfBlock* fromPayload(const void* ptr) noexcept
+    {
+        return reinterpret_cast<TlsfBlock*>(const_cast<Byte*>(static_cast<const Byte*>(ptr)) -
+                                            BLOCK_HEADER_SIZE);
+    }
+
+    /// @brief Placement-initialize a header (leaves the list links untouched)
+    static TlsfBlock* at(void* address, TlsfBlock* prevPhys, usize size, bool free) noexcept
+    {
+        auto* block = static_cast<TlsfBlock*>(address);
+        block->prevPhys = prevPhys;
+        block->sizeAndFlags = size | (free ? FREE_BIT : 0);
+        return block;
+    }
+};
+
+}  // namespace detail
+
+// =============================================================================
+// Construction
+// =============================================================================
+
+TlsfAllocator::TlsfAllocator(const TlsfConfig& config) : config_(config)
+{
+    if (config_.poolSize > 0 && !addPoolLocked(config_.poolSize)) {
+        LOG_ERROR("Failed to reserve {} byte TLSF pool", config_.poolSize);
+    }
+}
+
+TlsfAllocator::~TlsfAllocator()
+{
+    if (liveAllocations_ > 0) {
+        LOG_WARN("TLSF allocator destroyed with {} live allocations ({} bytes)", liveAllocations_,
+                 usedBytes_);
+        trackDeallocation(config_.tag, usedBytes_);
+    }
+
+    while (pools_) {
+        Pool* next = pools_->next;
+        alignedFree(pools_->memory);
+        pools_ = next;
+    }
+}
+
+std::unique_lock<std::mutex> TlsfAllocator::lock() const noexcept
+{
+    return config_.threadSafe ? std::unique_lock(mutex_) : std::unique_lock<std::mutex>();
+}
+
+// =============================================================================
+// Public Interface
+// =============================================================================
+
+void* TlsfAllocator::alloc(usize size, usize alignment) noexcept
+{
+    AUTOPHAGE_ASSERT((alignment & (alignment - 1)) == 0, "Alignment must be power of 2");
+    auto guard = lock();
+    return allocLocked(size, alignment);
+}
+
+void TlsfAllocator::free(void* ptr) noexcept
+{
+    if (!ptr) {
+        return;
+    }
+    auto guard = lock();
+    freeLocked(ptr);
+}
+
+usize TlsfAllocator::usableSize(const void* ptr) noexcept
+{
+    return ptr ? Block::fromPayload(ptr)->size() : 0;
+}
+
+bool TlsfAllocator::addPool(usize bytes) noexcept
+{
+    auto guard = lock();
+    return addPoolLocked(bytes);
+}
+
+TlsfStats TlsfAllocator::stats() const noexcept
+{
+    auto guard = lock();
+    return TlsfStats{
+        .reservedBytes = reservedBytes_,
+        .usedBytes = usedBytes_,
+        .freeBytes = freeBytes_,
+        .liveAllocations = liveAllocations_,
+        .poolCount = poolCount_,
+    };
+}
+
+// =============================================================================
+// memory_resource
+// =============================================================================
+
+void* TlsfAllocator::do_allocate(usize bytes, usize alignment)
+{
+    void* ptr = alloc(bytes, alignment);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void TlsfAllocator::do_deallocate(void* ptr, usize /*bytes*/, usize /*alignment*/)
+{
+    free(ptr);
+}
+
+bool TlsfAllocator::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+// =============================================================================
+// Allocation
+// =============================================================================
+
+void* TlsfAllocator::allocLocked(usize size, usize alignment) noexcept
+{
+    if (size > MAX_ALLOCATION) AUTOPHAGE_UNLIKELY {
+        return nullptr;
+    }
+
+    alignment = std::max(alignment, ALIGNMENT);
+    usize adjusted = alignUp(std::max(size, MIN_BLOCK_SIZE), ALIGNMENT);
+
+    // Over-aligned requests need room to split off a leading free block
+    usize search = adjusted;
+    if (alignment > ALIGNMENT) {
+        search += alignment + BLOCK_HEADER_SIZE + MIN_BLOCK_SIZE;
+    }
+
+    Block* block = findFree(search);
+    if (!block && config_.growable) AUTOPHAGE_UNLIKELY {
+        // Size classes round requests up by at most 1/32, so this pool always fits
+        usize poolBytes = std::max(config_.poolSize, search + search / 16 + ALIGNMENT);
+        if (addPoolLocked(poolBytes)) {
+            block = findFree(search);
+        }
+    }
+    if (!block) AUTOPHAGE_UNLIKELY {
+        return nullptr;
+    }
+
+    removeFree(block);
+    if (alignment > ALIGNMENT) {
+        block = splitAlignedHead(block, alignment);
+    }
+    splitTail(block, adjusted);
+    block->setFree(false);
+
+    usedBytes_ += block->size();
+    ++liveAllocations_;
+    trackAllocation(config_.tag, block->size());
+    return block->payload();
+}
+
+void TlsfAllocator::freeLocked(void* ptr) noexcept
+{
+    Block* block = Block::fromPayload(ptr);
+    AUTOPHAGE_ASSERT(!block->isFree(), "Double free in TLSF allocator");
+
+    usedBytes_ -= block->size();
+    --liveAllocations_;
+    trackDeallocation(config_.tag, block->size());
+
+    // Coalesce with free neighbours so no two free blocks are ever adjacent
+    if (Block* prev = block->prevPhys; prev && prev->isFree()) {
+        removeFree(prev);
+        prev->setSize(prev->size() + BLOCK_HEADER_SIZE + block->size());
+        block = prev;
+        block->next()->prevPhys = block;
+    }
+    if (Block* next = block->next(); next->isFree()) {
+        removeFree(next);
+        block->setSize(block->size() + BLOCK_HEADER_SIZE + next->size());
+        block->next()->prevPhys = block;
+    }
+
+    block->setFree(true);
+    insertFree(block);
+}
+
+bool TlsfAllocator::addPoolLocked(usize bytes) noexcept
+{
+    usize blockBytes = alignUp(std::max(bytes, MIN_BLOCK_SIZE), ALIGNMENT);
+    if (blockBytes >= (usize{1} << FL_INDEX_MAX)) {
+        LOG_ERROR("TLSF pool of {} bytes exceeds the largest size class", bytes);
+        return false;
+    }
+
+    // [pool header][first block header + payload][sentinel header]
+    usize total = POOL_HEADER_SIZE + BLOCK_HEADER_SIZE + blockBytes + BLOCK_HEADER_SIZE;
+    usize poolAlignment = AUTOPHAGE_CACHE_LINE_SIZE;
+    bool placed = config_.placement.hugePages != HugePagePolicy::None ||
+                  config_.placement.numaNode != ANY_NUMA_NODE;
+    if (placed) {
+        // madvise/mbind work on whole pages; huge pages also need huge-page alignment
+        poolAlignment = config_.placement.hugePages != HugePagePolicy::None ? getHugePageSize()
+                                                                             : getPageSize();
+        total = alignUp(total, poolAlignment);
+        blockBytes = total - POOL_HEADER_SIZE - 2 * BLOCK_HEADER_SIZE;
+    }
+
+    void* memory = alignedAlloc(total, poolAlignment);
+    if (!memory) {
+        return false;
+    }
+    if (placed) {
+        // Best effort: without huge pages or the node policy the pool still works
+        (void)applyMemoryPlacement(memory, total, config_.placement);
+    }
+
+    auto* pool = new (memory) Pool{memory, total, pools_};
+    pools_ = pool;
+    ++poolCount_;
+    reservedBytes_ += total;
+
+    Block* first = Block::at(static_cast<Byte*>(memory) + POOL_HEADER_SIZE, nullptr, blockBytes,
+                             true);
+    // Zero-sized, permanently used sentinel stops coalescing at the end of the pool
+    Block::at(first->next(), first, 0, false);
+    insertFree(first);
+    return true;
+}
+
+// =============================================================================
+// Free Lists
+// =============================================================================
+
+void TlsfAllocator::mapping(usize size, u32& fl, u32& sl) noexcept
+{
+    if (size < SMALL_BLOCK_SIZE) {
+        fl = 0;
+        sl = static_cast<u32>(size / (SMALL_BLOCK_SIZE / SL_INDEX_COUNT));
+    } else {
+        u32 log2 = floorLog2(size);
+        sl = static_cast<u32>(size >> (log2 - SL_INDEX_COUNT_LOG2)) ^ SL_INDEX_COUNT;
+        fl = log2 - (FL_INDEX_SHIFT - 1);
+    }
+}
+
+TlsfAllocator::Block* TlsfAllocator::findFree(usize size) noexcept
+{
+    // Round up to the next size class so any block in the found list is large enough
+    if (size >= SMALL_BLOCK_SIZE) {
+        size += (usize{1} << (floorLog2(size) - SL_INDEX_COUNT_LOG2)) - 1;
+    }
+
+    u32 fl = 0;
+    u32 sl = 0;
+    mapping(size, fl, sl);
+    if (fl >= FL_INDEX_COUNT) {
+        return nullptr;
+    }
+
+    u32 slMap = slBitmap_[fl] & (~0u << sl);
+    if (slMap == 0) {
+        u32 flMap = flBitmap_ & (~0u << (fl + 1));
+        if (flMap == 0) {
+            return nullptr;
+        }
+        fl = static_cast<u32>(std::countr_zero(flMap));
+        slMap = slBitmap_[fl];
+    }
+    sl = static_cast<u32>(std::countr_zero(slMap));
+    return freeLists_[fl][sl];
+}
+
+void TlsfAllocator::insertFree(Block* block) noexcept
+{
+    u32 fl = 0;
+    u32 sl = 0;
+    mapping(block->size(), fl, sl);
+
+    Block* head = freeLists_[fl][sl];
+    block->nextFree = head;
+    block->prevFree = nullptr;
+    if (head) {
+        head->prevFree = block;
+    }
+    freeLists_[fl][sl] = block;
+    flBitmap_ |= 1u << fl;
+    slBitmap_[fl] |= 1u << sl;
+    freeBytes_ += block->size();
+}
+
+void TlsfAllocator::removeFree(Block* block) noexcept
+{
+    u32 fl = 0;
+    u32 sl = 0;
+    mapping(block->size(), fl, sl);
+
+    if (block->prevFree) {
+        block->prevFree->nextFree = block->nextFree;
+    }
+    if (block->nextFree) {
+        block->nextFree->prevFree = block->prevFree;
+    }
+    if (freeLists_[fl][sl] == block) {
+        freeLists_[fl][sl] = block->nextFree;
+        if (!block->nextFree) {
+            slBitmap_[fl] &= ~(1u << sl);
+            if (slBitmap_[fl] == 0) {
+                flBitmap_ &= ~(1u << fl);
+            }
+        }
+    }
+    freeBytes_ -= block->size();
+}
+
+// =============================================================================
+// Splitting
+// =============================================================================
+
+void TlsfAllocator::splitTail(Block* block, usize size) noexcept
+{
+    usize remaining = block->size() - size;
+    if (remaining < BLOCK_HEADER_SIZE + MIN_BLOCK_SIZE) {
+        return;
+    }
+
+    Block* tail =
+        Block::at(block->payload() + size, block, remaining - BLOCK_HEADER_SIZE, true);
+    block->setSize(size);
+    tail->next()->prevPhys = tail;
+    insertFree(tail);
+}
+
+TlsfAllocator::Block* TlsfAllocator::splitAlignedHead(Block* block, usize alignment) noexcept
+{
+    auto payload = reinterpret_cast<std::uintptr_t>(block->payload());
+    usize gap = alignUp(payload, alignment) - payload;
+    if (gap == 0) {
+        return block;
+    }
+    // The leading remainder must be large enough to stand as a free block
+    while (gap < BLOCK_HEADER_SIZE + MIN_BLOCK_SIZE) {
+        gap += alignment;
+    }
+
+    Block* aligned = Block::at(block->payload() + gap - BLOCK_HEADER_SIZE, block,
+                               block->size() - gap, false);
+    aligned->next()->prevPhys = aligned;
+    block->setSize(gap - BLOCK_HEADER_SIZE);
+    block->setFree(true);
+    insertFree(block);
+    return aligned;
+}
+
+// =============================================================================
+// Validation
+// =============================================================================
+
+bool TlsfAllocator::validate() const noexcept
+{
+    auto guard = lock();
+
+    usize freeBytes = 0;
+    usize usedBytes = 0;
+    usize freeBlocks = 0;
+    for (Pool* pool = pools_; pool; pool = pool->next) {
+        auto* block = reinterpret_cast<Block*>(static_cast<Byte*>(pool->memory) + POOL_HEADER_SIZE);
+        Block* prev = nullptr;
+        while (!block->isSentinel()) {
+            if (block->prevPhys != prev) {
+                return false;
+            }
+            if (block->isFree()) {
+                if (prev && prev->isFree()) {
+                    return false;  // Missed coalesce
+                }
+                freeBytes += block->size();
+                ++freeBlocks;
+            } else {
+                usedBytes += block->size();
+            }
+            prev = block;
+            block = block->next();
+        }
+        if (block->prevPhys != prev) {
+            return false;
+        }
+    }
+
+    usize listedBlocks = 0;
+    for (u32 fl = 0; fl < FL_INDEX_COUNT; ++fl) {
+        bool flSet = (flBitmap_ & (1u << fl)) != 0;
+        if (flSet != (slBitmap_[fl] != 0)) {
+            return false;
+        }
+        for (u32 sl = 0; sl < SL_INDEX_COUNT; ++sl) {
+            bool slSet = (slBitmap_[fl] & (1u << sl)) != 0;
+            if (slSet != (freeLists_[fl][sl] != nullptr)) {
+                return false;
+            }
+            for (Block* block = freeLists_[fl][sl]; block; block = block->nextFree) {
+                u32 blockFl = 0;
+                u32 blockSl = 0;
+                mapping(block->size(), blockFl, blockSl);
+                if (!block->isFree() || blockFl != fl || blockSl != sl) {
+                    return false;
+                }
+                ++listedBlocks;
+            }
+        }
+    }
+
+    return listedBlocks == freeBlocks && freeBytes == freeBytes_ && usedBytes == usedBytes_;
+}
+
+}  // namespace autophage
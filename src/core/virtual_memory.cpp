@@ -0,0 +1,369 @@
+/// @file virtual_memory.cpp
+/// @brief Address space reservation and on-demand commit
+
+#include <autophage/core/platform.hpp>
+#include <autophage/core/virtual_memory.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+
+#if defined(AUTOPHAGE_PLATFORM_WINDOWS)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+#if defined(AUTOPHAGE_PLATFORM_LINUX)
+    #include <sys/syscall.h>
+#endif
+
+namespace autophage {
+
+namespace {
+
+[[nodiscard]] usize roundUp(usize size, usize unit) noexcept
+{
+    return (size + unit - 1) & ~(unit - 1);
+}
+
+[[nodiscard]] usize roundUpToPage(usize size) noexcept
+{
+    return roundUp(size, getPageSize());
+}
+
+#if defined(AUTOPHAGE_PLATFORM_LINUX)
+
+// From <linux/mempolicy.h>; libnuma is not required
+constexpr int MPOL_PREFERRED_MODE = 1;
+constexpr int MPOL_BIND_MODE = 2;
+constexpr usize MAX_NUMA_NODES = 1024;
+
+bool setNumaPolicy(void* ptr, usize size, i32 node, bool strict) noexcept
+{
+    if (node < 0 || static_cast<usize>(node) >= MAX_NUMA_NODES) {
+        return false;
+    }
+
+    constexpr usize BITS = 8 * sizeof(unsigned long);
+    std::array<unsigned long, MAX_NUMA_NODES / BITS> mask{};
+    auto index = static_cast<usize>(node);
+    mask[index / BITS] |= 1UL << (index % BITS);
+
+    // The kernel reads maxnode - 1 bits
+    return syscall(SYS_mbind, ptr, size, strict ? MPOL_BIND_MODE : MPOL_PREFERRED_MODE,
+                   mask.data(), MAX_NUMA_NODES + 1, 0) == 0;
+}
+
+/// @brief Reserve a range aligned to `alignment` by over-reserving and trimming the ends
+[[nodiscard]] void* reserveAligned(usize size, usize alignment) noexcept
+{
+    usize total = size + alignment;
+    void* raw = reserveVirtualMemory(total);
+    if (!raw) {
+        return nullptr;
+    }
+
+    auto address = reinterpret_cast<std::uintptr_t>(raw);
+    std::uintptr_t aligned = roundUp(address, alignment);
+    usize head = aligned - address;
+    usize tail = total - head - size;
+    if (head > 0) {
+        munmap(raw, head);
+    }
+    if (tail > 0) {
+        munmap(reinterpret_cast<void*>(aligned + size), tail);
+    }
+    return reinterpret_cast<void*>(aligned);
+}
+
+/// @brief Reserve from the hugetlbfs pool; fails unless enough huge pages are configured
+[[nodiscard]] void* reserveHugeTlb(usize size) noexcept
+{
+    // No MAP_NORESERVE: the pool is charged up front, so faults can't SIGBUS later
+    void* ptr = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    return ptr == MAP_FAILED ? nullptr : ptr;
+}
+
+#endif
+
+}  // namespace
+
+// =============================================================================
+// Virtual Memory Primitives
+// =============================================================================
+
+usize getPageSize() noexcept
+{
+    static const usize pageSize = [] {
+#if defined(AUTOPHAGE_PLATFORM_WINDOWS)
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return static_cast<usize>(info.dwPageSize);
+#else
+        long size = sysconf(_SC_PAGESIZE);
+        return size > 0 ? static_cast<usize>(size) : usize{4096};
+#endif
+    }();
+    return pageSize;
+}
+
+void* reserveVirtualMemory(usize size) noexcept
+{
+    size = roundUpToPage(size);
+#if defined(AUTOPHAGE_PLATFORM_WINDOWS)
+    return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+    void* ptr = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return ptr == MAP_FAILED ? nullptr : ptr;
+#endif
+}
+
+bool commitVirtualMemory(void* ptr, usize size) noexcept
+{
+#if defined(AUTOPHAGE_PLATFORM_WINDOWS)
+    return VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+    return mprotect(ptr, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+void decommitVirtualMemory(void* ptr, usize size) noexcept
+{
+#if defined(AUTOPHAGE_PLATFORM_WINDOWS)
+    VirtualFree(ptr, size, MEM_DECOMMIT);
+#else
+    madvise(ptr, size, MADV_DONTNEED);
+    mprotect(ptr, size, PROT_NONE);
+#endif
+}
+
+void releaseVirtualMemory(void* ptr, usize size) noexcept
+{
+    if (!ptr) {
+        return;
+    }
+#if defined(AUTOPHAGE_PLATFORM_WINDOWS)
+    (void)size;
+    VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+    munmap(ptr, roundUpToPage(size));
+#endif
+}
+
+// =============================================================================
+// Memory Placement
+// =============================================================================
+
+MemoryPlacement MemoryPlacement::localNode(HugePagePolicy hugePages) noexcept
+{
+    return MemoryPlacement{
+        .hugePages = hugePages,
+        .numaNode = static_cast<i32>(getCurrentNumaNode()),
+    };
+}
+
+usize getHugePageSize() noexcept
+{
+    static const usize hugePageSize = [] {
+        usize size = usize{2} * 1024 * 1024;
+#if defined(AUTOPHAGE_PLATFORM_LINUX)
+        if (std::FILE* file = std::fopen("/proc/meminfo", "r")) {
+            char line[256];
+            unsigned long kib = 0;
+            while (std::fgets(line, sizeof(line), file)) {
+                if (std::sscanf(line, "Hugepagesize: %lu kB", &kib) == 1 && kib > 0) {
+                    size = static_cast<usize>(kib) * 1024;
+                    break;
+                }
+            }
+            std::fclose(file);
+        }
+#endif
+        return size;
+    }();
+    return hugePageSize;
+}
+
+u32 getNumaNodeCount() noexcept
+{
+    static const u32 nodeCount = [] {
+        u32 count = 0;
+#if defined(AUTOPHAGE_PLATFORM_LINUX)
+        char path[64];
+        for (usize node = 0; node < MAX_NUMA_NODES; ++node) {
+            std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%zu", node);
+            if (access(path, F_OK) != 0) {
+                break;
+            }
+            ++count;
+        }
+#endif
+        return std::max(count, u32{1});
+    }();
+    return nodeCount;
+}
+
+u32 getCurrentNumaNode() noexcept
+{
+#if defined(AUTOPHAGE_PLATFORM_LINUX)
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+        return node;
+    }
+#endif
+    return 0;
+}
+
+bool applyMemoryPlacement([[maybe_unused]] void* ptr, [[maybe_unused]] usize size,
+                          const MemoryPlacement& placement) noexcept
+{
+    bool applied = true;
+#if defined(AUTOPHAGE_PLATFORM_LINUX)
+    if (placement.hugePages != HugePagePolicy::None) {
+        applied &= madvise(ptr, size, MADV_HUGEPAGE) == 0;
+    }
+    if (placement.numaNode != ANY_NUMA_NODE) {
+        applied &= setNumaPolicy(ptr, size, placement.numaNode, placement.strictNuma);
+    }
+#else
+    applied = placement.hugePages == HugePagePolicy::None && placement.numaNode == ANY_NUMA_NODE;
+#endif
+    return applied;
+}
+
+// =============================================================================
+// Virtual Range
+// =============================================================================
+
+VirtualRange::VirtualRange(usize reserveBytes, MemoryTag tag,
+                           [[maybe_unused]] const MemoryPlacement& placement)
+    : reserved_(roundUpToPage(reserveBytes)), commitUnit_(getPageSize()), tag_(tag)
+{
+#if defined(AUTOPHAGE_PLATFORM_LINUX)
+    if (placement.hugePages != HugePagePolicy::None) {
+        usize hugePage = getHugePageSize();
+        usize hugeBytes = roundUp(reserveBytes, hugePage);
+
+        if (placement.hugePages == HugePagePolicy::Explicit) {
+            base_ = static_cast<Byte*>(reserveHugeTlb(hugeBytes));
+            if (base_) {
+                hugePages_ = HugePagePolicy::Explicit;
+            }
+        }
+        if (!base_) {
+            // Transparent huge pages only back ranges aligned to the huge page size
+            base_ = static_cast<Byte*>(reserveAligned(hugeBytes, hugePage));
+            if (base_ && madvise(base_, hugeBytes, MADV_HUGEPAGE) == 0) {
+                hugePages_ = HugePagePolicy::Transparent;
+            }
+        }
+        if (base_) {
+            reserved_ = hugeBytes;
+            if (hugePages_ != HugePagePolicy::None) {
+                commitUnit_ = hugePage;
+            }
+        }
+    }
+#endif
+
+    if (!base_) {
+        base_ = static_cast<Byte*>(reserveVirtualMemory(reserved_));
+    }
+    if (!base_) {
+        reserved_ = 0;
+        return;
+    }
+
+#if defined(AUTOPHAGE_PLATFORM_LINUX)
+    // Policy set on the reservation applies to every page committed later
+    if (placement.numaNode != ANY_NUMA_NODE &&
+        setNumaPolicy(base_, reserved_, placement.numaNode, placement.strictNuma)) {
+        numaNode_ = placement.numaNode;
+    }
+#endif
+}
+
+VirtualRange::~VirtualRange()
+{
+    release();
+}
+
+VirtualRange::VirtualRange(VirtualRange&& other) noexcept
+    : base_(other.base_), reserved_(other.reserved_), committed_(other.committed_),
+      commitUnit_(other.commitUnit_), tag_(other.tag_), hugePages_(other.hugePages_),
+      numaNode_(other.numaNode_)
+{
+    other.base_ = nullptr;
+    other.reserved_ = 0;
+    other.committed_ = 0;
+}
+
+VirtualRange& VirtualRange::operator=(VirtualRange&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        base_ = other.base_;
+        reserved_ = other.reserved_;
+        committed_ = other.committed_;
+        commitUnit_ = other.commitUnit_;
+        tag_ = other.tag_;
+        hugePages_ = other.hugePages_;
+        numaNode_ = other.numaNode_;
+
+        other.base_ = nullptr;
+        other.reserved_ = 0;
+        other.committed_ = 0;
+    }
+    return *this;
+}
+
+bool VirtualRange::commit(usize bytes) noexcept
+{
+    if (bytes <= committed_) AUTOPHAGE_LIKELY {
+        return true;
+    }
+    if (!base_ || bytes > reserved_) {
+        return false;
+    }
+
+    usize target = std::max({bytes, committed_ * 2, MIN_COMMIT_SIZE});
+    target = std::min(roundUp(target, commitUnit_), reserved_);
+    if (!commitVirtualMemory(base_ + committed_, target - committed_)) {
+        return false;
+    }
+
+    trackAllocation(tag_, target - committed_);
+    committed_ = target;
+    return true;
+}
+
+void VirtualRange::shrink(usize bytes) noexcept
+{
+    usize keep = std::min(roundUp(bytes, commitUnit_), committed_);
+    if (keep == committed_) {
+        return;
+    }
+    decommitVirtualMemory(base_ + keep, committed_ - keep);
+    trackDeallocation(tag_, committed_ - keep);
+    committed_ = keep;
+}
+
+void VirtualRange::release() noexcept
+{
+    if (base_) {
+        trackDeallocation(tag_, committed_);
+        releaseVirtualMemory(base_, reserved_);
+        base_ = nullptr;
+        reserved_ = 0;
+        committed_ = 0;
+    }
+}
+
+}  // namespace autophage
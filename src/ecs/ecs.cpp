@@ -4,6 +4,11 @@
 #include <autophage/ecs/world.hpp>
 #include <autophage/ecs/components.hpp>
 #include <autophage/ecs/systems.hpp>
+#include <autophage/profiler/access_tracking.hpp>
+#include <autophage/profiler/tick_clock.hpp>
+
+#include <algorithm>
+#include <utility>
 
 namespace autophage::ecs {
 
@@ -18,4 +23,192 @@ namespace autophage::ecs {
 // template class ComponentArray<Velocity>;
 // template class ComponentArray<Hierarchy>;
 
+// =============================================================================
+// Thread-Local State
+// =============================================================================
+
+namespace detail {
+
+ComponentAccessSet*& engineComponentAccess() noexcept
+{
+    return t_componentAccess;
+}
+
+u64& engineEntitiesProcessed() noexcept
+{
+    return t_entitiesProcessed;
+}
+
+}  // namespace detail
+
+// =============================================================================
+// System Statistics
+// =============================================================================
+
+void SystemTimingWindow::fill(SystemStats& stats) const
+{
+    stats.invocations = invocations_;
+    stats.windowSize = size_;
+    if (size_ == 0) {
+        return;
+    }
+
+    std::array<f64, SYSTEM_STATS_WINDOW> durations{};
+    f64 totalNs = 0.0;
+    f64 totalEntities = 0.0;
+    f64 totalAllocations = 0.0;
+    f64 totalAllocatedBytes = 0.0;
+    for (usize i = 0; i < size_; ++i) {
+        durations[i] = static_cast<f64>(ticksToNanoseconds(ticks_[i]));
+        totalNs += durations[i];
+        totalEntities += static_cast<f64>(entities_[i]);
+        totalAllocations += static_cast<f64>(allocations_[i]);
+        totalAllocatedBytes += static_cast<f64>(allocatedBytes_[i]);
+    }
+
+    usize last = (next_ + SYSTEM_STATS_WINDOW - 1) % SYSTEM_STATS_WINDOW;
+    stats.lastNs = static_cast<f64>(ticksToNanoseconds(ticks_[last]));
+    stats.lastEntities = entities_[last];
+    stats.meanNs = totalNs / static_cast<f64>(size_);
+    stats.meanEntities = totalEntities / static_cast<f64>(size_);
+    stats.lastAllocations = allocations_[last];
+    stats.meanAllocations = totalAllocations / static_cast<f64>(size_);
+    stats.meanAllocatedBytes = totalAllocatedBytes / static_cast<f64>(size_);
+
+    auto begin = durations.begin();
+    auto end = begin + static_cast<isize>(size_);
+    auto [minIt, maxIt] = std::minmax_element(begin, end);
+    stats.minNs = *minIt;
+    stats.maxNs = *maxIt;
+
+    auto p99 = begin + static_cast<isize>((size_ - 1) * 99 / 100);
+    std::nth_element(begin, p99, end);
+    stats.p99Ns = *p99;
+}
+
+// =============================================================================
+// System Registry
+// =============================================================================
+
+SystemRegistry::SystemRegistry()
+{
+    // Timings are converted with the measured tick rate even when the profiler never starts
+    calibrateTickClock();
+}
+
+SystemRegistry::SystemRecord SystemRegistry::makeRecord(ISystem& system)
+{
+    SystemRecord record;
+    record.zone = registerZone(StringView(system.name()));
+    record.variants = dynamic_cast<IVariantSystem*>(&system);
+    system.declareAccess(record.declaredAccess);
+    return record;
+}
+
+void SystemRegistry::updateProfiled(usize index, World& world, f32 dt)
+{
+    auto& record = records_[index];
+
+    u64 entitiesBefore = detail::t_entitiesProcessed;
+    auto allocationsBefore = getThreadAllocationCounters();
+    AccessCounts accessBefore = getThreadAccessCounts();
+    ComponentAccessSet* outerAccess = std::exchange(detail::t_componentAccess,
+                                                    &record.observedAccess);
+    u64 zone = beginZone(record.zone);
+    i64 start = readTicks();
+
+    systems_[index]->update(world, dt);
+
+    i64 elapsed = readTicks() - start;
+    endZone(zone);
+    detail::t_componentAccess = outerAccess;
+    u64 entities = detail::t_entitiesProcessed - entitiesBefore;
+    auto allocationsAfter = getThreadAllocationCounters();
+    u64 allocations = allocationsAfter.allocations - allocationsBefore.allocations;
+    u64 allocatedBytes = allocationsAfter.allocatedBytes - allocationsBefore.allocatedBytes;
+    submitZoneAccess(record.zone, getThreadAccessCounts() - accessBefore, entities);
+
+    record.timing.record(elapsed, entities, allocations, allocatedBytes);
+    if (record.variants) {
+        auto variant = static_cast<usize>(record.variants->currentVariant());
+        if (variant < SYSTEM_VARIANT_COUNT) {
+            record.variantTiming[variant].record(elapsed, entities, allocations, allocatedBytes);
+        }
+    }
+}
+
+SystemStats SystemRegistry::makeStats(usize index, Optional<SystemVariant> variant) const
+{
+    const auto& record = records_[index];
+
+    SystemStats stats;
+    stats.name = systems_[index]->name();
+    stats.systemId = systems_[index]->systemId();
+    stats.variant = variant;
+    stats.accessDeclared = !record.declaredAccess.empty();
+    stats.access = stats.accessDeclared ? record.declaredAccess : record.observedAccess;
+    if (variant) {
+        record.variantTiming[static_cast<usize>(*variant)].fill(stats);
+    } else {
+        record.timing.fill(stats);
+    }
+    return stats;
+}
+
+std::vector<SystemStats> SystemRegistry::systemStats() const
+{
+    std::vector<SystemStats> result;
+    result.reserve(systems_.size());
+    for (usize i = 0; i < systems_.size(); ++i) {
+        if (!records_[i].timing.empty()) {
+            result.push_back(makeStats(i, std::nullopt));
+        }
+    }
+    return result;
+}
+
+std::vector<SystemStats> SystemRegistry::variantStats() const
+{
+    std::vector<SystemStats> result;
+    for (usize i = 0; i < systems_.size(); ++i) {
+        if (!records_[i].variants) {
+            continue;
+        }
+        for (usize v = 0; v < SYSTEM_VARIANT_COUNT; ++v) {
+            if (!records_[i].variantTiming[v].empty()) {
+                result.push_back(makeStats(i, static_cast<SystemVariant>(v)));
+            }
+        }
+    }
+    return result;
+}
+
+Optional<SystemStats> SystemRegistry::statsFor(TypeId systemId,
+                                               Optional<SystemVariant> variant) const
+{
+    for (usize i = 0; i < systems_.size(); ++i) {
+        if (systems_[i]->systemId() != systemId) {
+            continue;
+        }
+        const auto& timing = variant ? records_[i].variantTiming[static_cast<usize>(*variant)]
+                                     : records_[i].timing;
+        if (timing.empty()) {
+            return std::nullopt;
+        }
+        return makeStats(i, variant);
+    }
+    return std::nullopt;
+}
+
+void SystemRegistry::resetStats()
+{
+    for (auto& record : records_) {
+        record.timing.reset();
+        record.observedAccess.clear();
+        for (auto& timing : record.variantTiming) {
+            timing.reset();
+        }
+    }
+}
+
 }  // namespace autophage::ecs
@@ -18,6 +18,11 @@ void PhysicsSystem::update(World& world, f32 dt)
     }
 }
 
+void PhysicsSystem::declareAccess(ComponentAccessSet& access) const
+{
+    access.read<Velocity>().write<Transform>();
+}
+
 std::vector<SystemVariant> PhysicsSystem::availableVariants() const
 {
     return {SystemVariant::Scalar, SystemVariant::SIMD};
@@ -39,13 +44,16 @@ bool PhysicsSystem::switchVariant(SystemVariant variant)
 
 void PhysicsSystem::updateScalar(World& world, f32 dt)
 {
+    usize processed = 0;
     for (auto [entity, transform, velocity] : world.view<Transform, Velocity>()) {
         // Apply velocity to position
         transform.position += velocity.linear * dt;
+        ++processed;
 
         // Apply generic gravity/acceleration if present
         // (Simplified for demo)
     }
+    reportEntitiesProcessed(processed);
 }
 
 void PhysicsSystem::updateSIMD(World& world, f32 dt)
@@ -55,7 +63,10 @@ void PhysicsSystem::updateSIMD(World& world, f32 dt)
 
     __m128 dt_vec = _mm_set1_ps(dt);
 
+    usize processed = 0;
     for (auto [entity, transform, velocity] : world.view<Transform, Velocity>()) {
+        ++processed;
+
         // Load position and velocity
         // Ensure alignment? Vec3 is aligned to 16 bytes.
         // Assuming ComponentArray allocation is aligned properly.
@@ -87,6 +98,7 @@ void PhysicsSystem::updateSIMD(World& world, f32 dt)
             _mm_storeu_ps(pos_ptr, result);
         }
     }
+    reportEntitiesProcessed(processed);
 }
 
 }  // namespace autophage::ecs
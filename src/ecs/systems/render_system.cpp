@@ -6,6 +6,11 @@ namespace autophage::ecs {
 
 RenderSystem::RenderSystem(IWindow& window) : System("RenderSystem"), window_(window) {}
 
+void RenderSystem::declareAccess(ComponentAccessSet& access) const
+{
+    access.read<Transform, Renderable>();
+}
+
 void RenderSystem::update(World& world, [[maybe_unused]] f32 dt)
 {
     // Clear screen
@@ -0,0 +1,498 @@
+#include <autophage/core/logger.hpp>
+#include <autophage/optimizer/decision_log.hpp>
+
+#include <cstring>
+
+namespace autophage::optimizer {
+
+namespace {
+
+// =============================================================================
+// Decoding Helpers
+// =============================================================================
+
+template <typename T> [[nodiscard]] bool readRaw(const u8*& pos, const u8* end, T& out) noexcept
+{
+    if (static_cast<usize>(end - pos) < sizeof(T)) {
+        return false;
+    }
+    std::memcpy(&out, pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+[[nodiscard]] bool readVarint(const u8*& pos, const u8* end, u64& out) noexcept
+{
+    out = 0;
+    for (u32 shift = 0; shift < 64; shift += 7) {
+        if (pos >= end) {
+            return false;
+        }
+        u8 byte = *pos++;
+        out |= static_cast<u64>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @brief Decodes records, resolving name ids against the names read so far
+class RecordDecoder
+{
+public:
+    RecordDecoder(const u8* pos, const u8* end, const std::vector<String>& names)
+        : pos_(pos), end_(end), names_(names)
+    {}
+
+    [[nodiscard]] bool atEnd() const noexcept { return pos_ >= end_; }
+
+    [[nodiscard]] bool byte(u8& out) noexcept { return readRaw(pos_, end_, out); }
+    [[nodiscard]] bool number(f64& out) noexcept { return readRaw(pos_, end_, out); }
+    [[nodiscard]] bool varint(u64& out) noexcept { return readVarint(pos_, end_, out); }
+
+    [[nodiscard]] bool nameId(u32& out) noexcept
+    {
+        u64 id = 0;
+        if (!varint(id) || id >= names_.size()) {
+            return false;
+        }
+        out = static_cast<u32>(id);
+        return true;
+    }
+
+    [[nodiscard]] bool name(String& out)
+    {
+        u32 id = 0;
+        if (!nameId(id)) {
+            return false;
+        }
+        out = names_[id];
+        return true;
+    }
+
+    [[nodiscard]] bool bytes(u64 length, String& out)
+    {
+        if (static_cast<u64>(end_ - pos_) < length) {
+            return false;
+        }
+        out.assign(reinterpret_cast<const char*>(pos_), static_cast<usize>(length));
+        pos_ += length;
+        return true;
+    }
+
+private:
+    const u8* pos_;
+    const u8* end_;
+    const std::vector<String>& names_;
+};
+
+}  // namespace
+
+// =============================================================================
+// Writer
+// =============================================================================
+
+DecisionLogWriter::~DecisionLogWriter()
+{
+    close();
+}
+
+bool DecisionLogWriter::open(const std::filesystem::path& path, const DecisionLogConfig& config)
+{
+    close();
+
+    file_ = std::fopen(path.string().c_str(), "wb");
+    if (!file_) {
+        LOG_ERROR("[Optimizer] Cannot create decision log {}", path.string());
+        return false;
+    }
+
+    config_ = config;
+    buffer_.reserve(config_.flushBytes + 1024);
+
+    DecisionLogHeader header;
+    std::memcpy(header.magic, DECISION_LOG_MAGIC, sizeof(DECISION_LOG_MAGIC));
+    header.version = DECISION_LOG_VERSION;
+    header.flags = config_.recordStats ? DECISION_LOG_FLAG_STATS : 0;
+    const auto* raw = reinterpret_cast<const u8*>(&header);
+    buffer_.insert(buffer_.end(), raw, raw + sizeof(header));
+    flush();
+
+    LOG_INFO("[Optimizer] Logging decisions to {}", path.string());
+    return true;
+}
+
+void DecisionLogWriter::close()
+{
+    if (!file_) {
+        return;
+    }
+    flush();
+    std::fclose(file_);
+    file_ = nullptr;
+    buffer_.clear();
+    written_ = 0;
+    full_ = false;
+    strings_.clear();
+    seriesStrings_.clear();
+}
+
+void DecisionLogWriter::flush()
+{
+    if (!file_ || buffer_.empty()) {
+        return;
+    }
+    if (std::fwrite(buffer_.data(), 1, buffer_.size(), file_) != buffer_.size()) {
+        LOG_ERROR("[Optimizer] Decision log write failed, logging stops");
+        full_ = true;
+    }
+    std::fflush(file_);
+    written_ += buffer_.size();
+    buffer_.clear();
+}
+
+void DecisionLogWriter::commit()
+{
+    if (written_ + buffer_.size() >= config_.maxBytes) {
+        flush();
+        full_ = true;
+        LOG_WARN("[Optimizer] Decision log reached {} bytes, logging stops", written_);
+        return;
+    }
+    if (buffer_.size() >= config_.flushBytes) {
+        flush();
+    }
+}
+
+void DecisionLogWriter::putVarint(u64 value)
+{
+    while (value >= 0x80) {
+        buffer_.push_back(static_cast<u8>(value | 0x80));
+        value >>= 7;
+    }
+    buffer_.push_back(static_cast<u8>(value));
+}
+
+void DecisionLogWriter::putF64(f64 value)
+{
+    u8 raw[sizeof(f64)];
+    std::memcpy(raw, &value, sizeof(f64));
+    buffer_.insert(buffer_.end(), raw, raw + sizeof(f64));
+}
+
+u32 DecisionLogWriter::intern(StringView name)
+{
+    auto [it, inserted] = strings_.try_emplace(String(name), static_cast<u32>(strings_.size()));
+    if (inserted) {
+        putByte(static_cast<u8>(DecisionRecordType::String));
+        putVarint(it->second);
+        putVarint(name.size());
+        buffer_.insert(buffer_.end(), name.begin(), name.end());
+    }
+    return it->second;
+}
+
+void DecisionLogWriter::writeFrame(u64 frame, f64 timeSeconds,
+                                   std::span<const analyzer::SeriesSample> samples,
+                                   const analyzer::TimeSeriesStore& series)
+{
+    if (!file_ || full_) {
+        return;
+    }
+    if (!config_.recordStats) {
+        samples = {};
+    }
+
+    // Names first: a String record cannot sit inside the frame record
+    for (const auto& sample : samples) {
+        if (sample.series >= seriesStrings_.size()) {
+            seriesStrings_.resize(usize{sample.series} + 1, ~u32{0});
+        }
+        u32& id = seriesStrings_[sample.series];
+        if (id == ~u32{0}) {
+            id = intern(series.seriesName(sample.series));
+        }
+    }
+
+    putByte(static_cast<u8>(DecisionRecordType::Frame));
+    putVarint(frame);
+    putF64(timeSeconds);
+    putVarint(samples.size());
+    for (const auto& sample : samples) {
+        putVarint(seriesStrings_[sample.series]);
+        putF64(sample.value);
+    }
+    commit();
+}
+
+void DecisionLogWriter::writeDecision(u64 frame, const FiredAction& fired, bool applied)
+{
+    if (!file_ || full_) {
+        return;
+    }
+
+    u32 rule = intern(fired.rule);
+    u32 target = intern(fired.action.target);
+    u32 argument = intern(fired.action.argument);
+    std::vector<u32> inputs;
+    inputs.reserve(fired.inputs.size());
+    for (const auto& input : fired.inputs) {
+        inputs.push_back(intern(input.series));
+    }
+
+    putByte(static_cast<u8>(DecisionRecordType::Decision));
+    putVarint(frame);
+    putVarint(rule);
+    putByte(static_cast<u8>(fired.action.kind));
+    putVarint(target);
+    putVarint(argument);
+    putByte(applied ? 1 : 0);
+    putVarint(fired.inputs.size());
+    for (usize i = 0; i < fired.inputs.size(); ++i) {
+        putVarint(inputs[i]);
+        putByte(static_cast<u8>(fired.inputs[i].stat));
+        putByte(static_cast<u8>(fired.inputs[i].window));
+        putF64(fired.inputs[i].value);
+    }
+    commit();
+}
+
+void DecisionLogWriter::writeEffect(u64 frame, const analyzer::RegressionResult& result,
+                                    bool rolledBack)
+{
+    if (!file_ || full_) {
+        return;
+    }
+
+    u32 subject = intern(result.subject);
+    u32 baseline = intern(result.baselineLabel);
+    u32 candidate = intern(result.candidateLabel);
+
+    putByte(static_cast<u8>(DecisionRecordType::Effect));
+    putVarint(frame);
+    putVarint(subject);
+    putVarint(baseline);
+    putVarint(candidate);
+    putByte(static_cast<u8>(result.verdict));
+    putF64(result.confidence);
+    putF64(result.relativeChange);
+    putF64(result.baselineMedian);
+    putF64(result.candidateMedian);
+    putByte(rolledBack ? 1 : 0);
+    commit();
+}
+
+void DecisionLogWriter::writeTunerEvent(u64 frame, const TunerEvent& event)
+{
+    if (!file_ || full_) {
+        return;
+    }
+
+    u32 system = intern(event.system);
+
+    putByte(static_cast<u8>(DecisionRecordType::Tuner));
+    putVarint(frame);
+    putVarint(system);
+    putByte(static_cast<u8>(event.kind));
+    putVarint(event.band);
+    putByte(static_cast<u8>(event.from));
+    putByte(static_cast<u8>(event.to));
+    putF64(event.nsPerEntity);
+    commit();
+
+    if (event.verdict) {
+        writeEffect(frame, *event.verdict, false);
+    }
+}
+
+// =============================================================================
+// Reader
+// =============================================================================
+
+void DecisionLogReader::clear()
+{
+    header_ = DecisionLogHeader{};
+    names_.clear();
+    frames_.clear();
+    decisions_.clear();
+    effects_.clear();
+    tunerEvents_.clear();
+    truncated_ = false;
+}
+
+bool DecisionLogReader::load(const std::filesystem::path& path)
+{
+    clear();
+
+    std::FILE* file = std::fopen(path.string().c_str(), "rb");
+    if (!file) {
+        lastError_ = "Cannot open " + path.string();
+        return false;
+    }
+    std::vector<u8> data;
+    u8 chunk[64 * 1024];
+    usize read = 0;
+    while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        data.insert(data.end(), chunk, chunk + read);
+    }
+    std::fclose(file);
+
+    const u8* pos = data.data();
+    const u8* end = data.data() + data.size();
+    if (!readRaw(pos, end, header_) ||
+        std::memcmp(header_.magic, DECISION_LOG_MAGIC, sizeof(DECISION_LOG_MAGIC)) != 0) {
+        lastError_ = "Not an Autophage decision log";
+        clear();
+        return false;
+    }
+    if (header_.version == 0 || header_.version > DECISION_LOG_VERSION) {
+        lastError_ = "Unsupported decision log version " + std::to_string(header_.version);
+        clear();
+        return false;
+    }
+
+    RecordDecoder in(pos, end, names_);
+    Optional<usize> decided;  // Tuner decision whose verdict is the next Effect record
+    while (!in.atEnd()) {
+        // Every record leads with a varint: the id of a String, the frame number of the others
+        u8 type = 0;
+        u8 flag = 0;
+        u64 lead = 0;
+        u64 count = 0;
+        bool ok = in.byte(type) && in.varint(lead);
+
+        switch (static_cast<DecisionRecordType>(type)) {
+            case DecisionRecordType::String: {
+                String name;
+                ok = ok && lead == names_.size() && in.varint(count) && in.bytes(count, name);
+                if (ok) {
+                    names_.push_back(std::move(name));
+                }
+                break;
+            }
+            case DecisionRecordType::Frame: {
+                LoggedFrame logged;
+                logged.frame = lead;
+                ok = ok && in.number(logged.timeSeconds) && in.varint(count);
+                for (u64 i = 0; ok && i < count; ++i) {
+                    LoggedSample& sample = logged.samples.emplace_back();
+                    ok = in.nameId(sample.name) && in.number(sample.value);
+                }
+                if (ok) {
+                    frames_.push_back(std::move(logged));
+                }
+                break;
+            }
+            case DecisionRecordType::Decision: {
+                LoggedDecision logged;
+                logged.frame = lead;
+                u8 kind = 0;
+                ok = ok && in.name(logged.fired.rule) && in.byte(kind) &&
+                     kind < static_cast<u8>(RuleActionKind::Count) &&
+                     in.name(logged.fired.action.target) &&
+                     in.name(logged.fired.action.argument) && in.byte(flag) && in.varint(count);
+                logged.fired.action.kind = static_cast<RuleActionKind>(kind);
+                logged.applied = flag != 0;
+                for (u64 i = 0; ok && i < count; ++i) {
+                    ConditionInput& input = logged.fired.inputs.emplace_back();
+                    u8 stat = 0;
+                    u8 window = 0;
+                    ok = in.name(input.series) && in.byte(stat) &&
+                         stat <= static_cast<u8>(MetricStat::Count) && in.byte(window) &&
+                         window < analyzer::TIME_WINDOW_COUNT && in.number(input.value);
+                    input.stat = static_cast<MetricStat>(stat);
+                    input.window = static_cast<analyzer::TimeWindow>(window);
+                }
+                if (ok) {
+                    decisions_.push_back(std::move(logged));
+                }
+                break;
+            }
+            case DecisionRecordType::Effect: {
+                LoggedEffect logged;
+                logged.frame = lead;
+                analyzer::RegressionResult& result = logged.result;
+                u8 verdict = 0;
+                ok = ok && in.name(result.subject) && in.name(result.baselineLabel) &&
+                     in.name(result.candidateLabel) && in.byte(verdict) &&
+                     verdict <= static_cast<u8>(analyzer::RegressionVerdict::Inconclusive) &&
+                     in.number(result.confidence) && in.number(result.relativeChange) &&
+                     in.number(result.baselineMedian) && in.number(result.candidateMedian) &&
+                     in.byte(flag);
+                result.verdict = static_cast<analyzer::RegressionVerdict>(verdict);
+                logged.rolledBack = flag != 0;
+                if (ok && decided) {
+                    logged.tuner = true;
+                    tunerEvents_[*decided].event.verdict = result;
+                }
+                if (ok) {
+                    effects_.push_back(std::move(logged));
+                }
+                break;
+            }
+            case DecisionRecordType::Tuner: {
+                LoggedTunerEvent logged;
+                logged.frame = lead;
+                TunerEvent& event = logged.event;
+                u8 kind = 0;
+                u8 from = 0;
+                u8 to = 0;
+                u64 band = 0;
+                ok = ok && in.name(event.system) && in.byte(kind) &&
+                     kind < TUNER_EVENT_KIND_COUNT && in.varint(band) && band <= ~u32{0} &&
+                     in.byte(from) && from < ecs::SYSTEM_VARIANT_COUNT && in.byte(to) &&
+                     to < ecs::SYSTEM_VARIANT_COUNT && in.number(event.nsPerEntity);
+                event.kind = static_cast<TunerEventKind>(kind);
+                event.band = static_cast<u32>(band);
+                event.from = static_cast<ecs::SystemVariant>(from);
+                event.to = static_cast<ecs::SystemVariant>(to);
+                if (ok) {
+                    tunerEvents_.push_back(std::move(logged));
+                }
+                break;
+            }
+            default:
+                ok = false;
+                break;
+        }
+
+        if (ok && type != static_cast<u8>(DecisionRecordType::String)) {
+            bool isDecision = type == static_cast<u8>(DecisionRecordType::Tuner) &&
+                              tunerEvents_.back().event.kind == TunerEventKind::Decided;
+            decided = isDecision ? Optional<usize>(tunerEvents_.size() - 1) : std::nullopt;
+        }
+        if (!ok) {
+            // Records are not resynchronizable; keep what was read before the damage
+            truncated_ = true;
+            LOG_WARN("[Optimizer] Decision log {} is truncated or corrupt after {} frames",
+                     path.string(), frames_.size());
+            break;
+        }
+    }
+
+    lastError_.clear();
+    return true;
+}
+
+// =============================================================================
+// Replay
+// =============================================================================
+
+std::vector<LoggedDecision> replayRules(const DecisionLogReader& log, RuleEngine& engine)
+{
+    std::vector<LoggedDecision> decisions;
+    analyzer::StatsCollector stats;
+    for (const LoggedFrame& frame : log.frames()) {
+        stats.advance(frame.timeSeconds);
+        for (const LoggedSample& sample : frame.samples) {
+            stats.record(log.names()[sample.name], sample.value);
+        }
+        for (auto& fired : engine.update(stats)) {
+            decisions.push_back({frame.frame, std::move(fired), false});
+        }
+    }
+    return decisions;
+}
+
+}  // namespace autophage::optimizer
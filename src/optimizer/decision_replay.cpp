@@ -0,0 +1,201 @@
+/// @file decision_replay.cpp
+/// @brief Offline inspection of decision logs and evaluation of alternative rule sets
+///
+/// Usage: autophage_decision_replay <decision log> [rule file]
+///
+/// Prints the logged decisions with the statistics that triggered them and the measured effect
+/// of each variant switch, then the variant tuner's band decisions and switch counts. Given a rule file, replays the log's stats trace through those rules
+/// and lists which logged decisions they would keep or drop and which new ones they would make.
+
+#include <autophage/core/logger.hpp>
+#include <autophage/optimizer/decision_log.hpp>
+
+#include <array>
+#include <cstdio>
+
+using namespace autophage;
+using namespace autophage::optimizer;
+
+namespace {
+
+[[nodiscard]] bool sameAction(const LoggedDecision& a, const LoggedDecision& b)
+{
+    return a.frame == b.frame && a.fired.action.kind == b.fired.action.kind &&
+           a.fired.action.target == b.fired.action.target &&
+           a.fired.action.argument == b.fired.action.argument;
+}
+
+/// @brief Verdict of the trial a logged variant switch started, if it finished
+[[nodiscard]] const LoggedEffect* effectOf(const DecisionLogReader& log,
+                                           const LoggedDecision& decision)
+{
+    const RuleAction& action = decision.fired.action;
+    if (!decision.applied || action.kind != RuleActionKind::SwitchVariant) {
+        return nullptr;
+    }
+    for (const LoggedEffect& effect : log.effects()) {
+        if (!effect.tuner && effect.frame >= decision.frame &&
+            effect.result.subject == action.target &&
+            effect.result.candidateLabel == action.argument) {
+            return &effect;
+        }
+    }
+    return nullptr;
+}
+
+void printAction(const char* prefix, const LoggedDecision& decision, bool logged = true)
+{
+    const RuleAction& action = decision.fired.action;
+    StringView kind = toString(action.kind);
+    std::printf("%sframe %-8llu %-24s %.*s %s %s%s\n", prefix,
+                static_cast<unsigned long long>(decision.frame), decision.fired.rule.c_str(),
+                static_cast<int>(kind.size()), kind.data(), action.target.c_str(),
+                action.argument.c_str(), logged && !decision.applied ? " (not applied)" : "");
+}
+
+void printEffect(const LoggedEffect& effect)
+{
+    const analyzer::RegressionResult& result = effect.result;
+    StringView verdict = analyzer::toString(result.verdict);
+    std::printf("        -> frame %llu: %.*s (%+.1f%% median, confidence %.3f)%s\n",
+                static_cast<unsigned long long>(effect.frame), static_cast<int>(verdict.size()),
+                verdict.data(), result.relativeChange * 100.0, result.confidence,
+                effect.rolledBack ? ", rolled back" : "");
+}
+
+void printDecision(const DecisionLogReader& log, const LoggedDecision& decision)
+{
+    printAction("  ", decision);
+    for (const ConditionInput& input : decision.fired.inputs) {
+        StringView stat = toString(input.stat);
+        StringView window = analyzer::toString(input.window);
+        std::printf("        %s %.*s %.*s = %g\n", input.series.c_str(),
+                    static_cast<int>(stat.size()), stat.data(), static_cast<int>(window.size()),
+                    window.data(), input.value);
+    }
+    if (const LoggedEffect* effect = effectOf(log, decision)) {
+        printEffect(*effect);
+    }
+}
+
+void printTuner(const DecisionLogReader& log)
+{
+    const auto& events = log.tunerEvents();
+    if (events.empty()) {
+        return;
+    }
+
+    std::array<usize, TUNER_EVENT_KIND_COUNT> counts{};
+    std::printf("\nTuner:\n");
+    for (const LoggedTunerEvent& logged : events) {
+        const TunerEvent& event = logged.event;
+        ++counts[static_cast<usize>(event.kind)];
+        if (event.kind != TunerEventKind::Decided) {
+            continue;
+        }
+        std::printf("  frame %-8llu %s %llu-%llu entities: %s -> %s (%.2f ns/entity)\n",
+                    static_cast<unsigned long long>(logged.frame), event.system.c_str(),
+                    static_cast<unsigned long long>(VariantTuner::bandStart(event.band)),
+                    static_cast<unsigned long long>(VariantTuner::bandStart(event.band + 1) - 1),
+                    ecs::toString(event.from), ecs::toString(event.to), event.nsPerEntity);
+        if (event.verdict) {
+            printEffect({logged.frame, *event.verdict, false, true});
+        }
+    }
+
+    std::printf("  switches:");
+    for (usize kind = 0; kind < counts.size(); ++kind) {
+        if (kind != static_cast<usize>(TunerEventKind::Decided)) {
+            std::printf(" %zu %s", counts[kind], toString(static_cast<TunerEventKind>(kind)));
+        }
+    }
+    std::printf("\n");
+}
+
+int replay(const DecisionLogReader& log, const char* rulePath)
+{
+    RuleEngine engine;
+    if (!engine.loadFile(rulePath)) {
+        std::fprintf(stderr, "%s\n", engine.lastError().c_str());
+        return 1;
+    }
+    if ((log.header().flags & DECISION_LOG_FLAG_STATS) == 0) {
+        std::fprintf(stderr, "The log was recorded without stats and cannot be replayed\n");
+        return 1;
+    }
+
+    const auto& logged = log.decisions();
+    auto replayed = replayRules(log, engine);
+    std::vector<bool> kept(logged.size(), false);
+
+    usize same = 0;
+    std::printf("\nReplay with %s:\n", rulePath);
+    for (const LoggedDecision& decision : replayed) {
+        bool found = false;
+        for (usize i = 0; i < logged.size() && !found; ++i) {
+            found = !kept[i] && sameAction(logged[i], decision);
+            kept[i] = kept[i] || found;
+        }
+        if (found) {
+            ++same;
+        } else {
+            printAction("  new      ", decision, false);
+        }
+    }
+
+    usize dropped = 0;
+    usize droppedImproved = 0;
+    usize droppedRegressed = 0;
+    for (usize i = 0; i < logged.size(); ++i) {
+        if (kept[i]) {
+            continue;
+        }
+        ++dropped;
+        printAction("  dropped  ", logged[i]);
+        if (const LoggedEffect* effect = effectOf(log, logged[i])) {
+            printEffect(*effect);
+            droppedImproved += effect->result.verdict == analyzer::RegressionVerdict::Improved;
+            droppedRegressed += effect->result.verdict == analyzer::RegressionVerdict::Regressed;
+        }
+    }
+
+    std::printf("\n%zu kept, %zu dropped (%zu measured improvements, %zu regressions), "
+                "%zu new (unmeasured)\n",
+                same, dropped, droppedImproved, droppedRegressed, replayed.size() - same);
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 2 || argc > 3) {
+        std::fprintf(stderr, "Usage: %s <decision log> [rule file]\n", argv[0]);
+        return 2;
+    }
+
+    initLogger("DecisionReplay", LogLevel::Warn);
+
+    DecisionLogReader log;
+    if (!log.load(argv[1])) {
+        std::fprintf(stderr, "%s: %s\n", argv[1], log.lastError().c_str());
+        return 1;
+    }
+
+    const auto& frames = log.frames();
+    std::printf("%s: %zu frames", argv[1], frames.size());
+    if (!frames.empty()) {
+        std::printf(" (%llu-%llu, %.1fs)", static_cast<unsigned long long>(frames.front().frame),
+                    static_cast<unsigned long long>(frames.back().frame),
+                    frames.back().timeSeconds - frames.front().timeSeconds);
+    }
+    std::printf(", %zu decisions, %zu measured effects%s\n", log.decisions().size(),
+                log.effects().size(), log.truncated() ? ", truncated" : "");
+
+    for (const LoggedDecision& decision : log.decisions()) {
+        printDecision(log, decision);
+    }
+    printTuner(log);
+
+    return argc == 3 ? replay(log, argv[2]) : 0;
+}
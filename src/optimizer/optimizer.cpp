@@ -1,38 +1,233 @@
 #include <autophage/core/logger.hpp>
-#include <autophage/ecs/systems/physics_system.hpp>
 #include <autophage/optimizer/optimizer.hpp>
 
-
 namespace autophage::optimizer {
 
-Optimizer::Optimizer(analyzer::StatsCollector& stats) : stats_(stats) {}
+namespace {
+
+[[nodiscard]] ecs::IVariantSystem* findVariantSystem(ecs::World& world, StringView name)
+{
+    for (const auto& system : world.systemRegistry().systems()) {
+        if (name == system->name()) {
+            return dynamic_cast<ecs::IVariantSystem*>(system.get());
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+Optimizer::Optimizer(analyzer::StatsCollector& stats,
+                     const analyzer::RegressionConfig& regressionConfig,
+                     const VariantTunerConfig& tunerConfig)
+    : stats_(stats), detector_(regressionConfig), tuner_(tunerConfig)
+{
+    tuner_.recordEvents(true);  // Drained every update
+}
 
 void Optimizer::update(ecs::World& world)
 {
-    // 1. Analyze stats (stub)
+    ++frame_;
+    bool logging = decisionLog_.isOpen();
+    if (logging) {
+        frameSamples_.clear();
+        stats_.captureSamples(&frameSamples_);
+    }
+
+    // 1. Analyze stats
     stats_.collect();
     auto hints = stats_.analyze();  // Returns generic hints
 
-    // 2. Specific Rule: Physics System Optimization
-    // Check entity count
-    usize entityCount = world.entityCount();
-
-    auto* physicsSystem = world.getSystem<ecs::PhysicsSystem>();
-    if (physicsSystem) {
-        auto current = physicsSystem->currentVariant();
-
-        if (entityCount > 500 && current == ecs::SystemVariant::Scalar) {
-            LOG_INFO(
-                "[Optimizer] High entity count detected ({}). Switching PhysicsSystem to SIMD.",
-                entityCount);
-            physicsSystem->switchVariant(ecs::SystemVariant::SIMD);
-        } else if (entityCount < 100 && current == ecs::SystemVariant::SIMD) {
-            LOG_INFO(
-                "[Optimizer] Low entity count detected ({}). Switching PhysicsSystem to Scalar.",
-                entityCount);
-            physicsSystem->switchVariant(ecs::SystemVariant::Scalar);
+    auto systems = world.systemRegistry().systemStats();
+    recordMetrics(world, systems);
+    analyzeExecution(systems);
+
+    if (logging) {
+        stats_.captureSamples(nullptr);
+        decisionLog_.writeFrame(frame_, stats_.lastTime(), frameSamples_, stats_.timeSeries());
+    }
+
+    // 2. Judge rule-driven switches and hot swaps on the update that just ran
+    for (const auto& system : systems) {
+        trackSystem(system, findVariantSystem(world, system.name));
+    }
+
+    // 3. Benchmark variants per entity-count band. A tuner switch starts a new history, so the
+    //    detector's baseline never mixes variants.
+    tuner_.update(world, systems);
+    for (const auto& event : tuner_.takeEvents()) {
+        decisionLog_.writeTunerEvent(frame_, event);
+        if (event.from != event.to) {
+            detector_.reset(event.system);
+        }
+    }
+
+    // 4. Apply the rules that fired; refused ones retry while their conditions hold
+    for (const auto& fired : rules_.update(stats_)) {
+        bool applied = apply(world, fired);
+        decisionLog_.writeDecision(frame_, fired, applied);
+        if (!applied) {
+            rules_.rearm(fired.rule);
+        }
+    }
+
+    if (!profilePath_.empty() && ++updatesSinceProfileSave_ >= PROFILE_SAVE_INTERVAL_UPDATES) {
+        saveTuningProfile();
+    }
+}
+
+bool Optimizer::useTuningProfile(const std::filesystem::path& path)
+{
+    profilePath_ = path;
+    updatesSinceProfileSave_ = 0;
+    if (!profile_.load(path)) {
+        return false;
+    }
+
+    auto bands = profile_.bandsFor(TuningProfileKey::current());
+    tuner_.importProfile(bands);
+    LOG_INFO("[Optimizer] Loaded {} tuned bands for this machine and build from {}",
+             bands.size(), path.string());
+    return true;
+}
+
+bool Optimizer::saveTuningProfile()
+{
+    updatesSinceProfileSave_ = 0;
+    if (profilePath_.empty()) {
+        return false;
+    }
+    profile_.store(TuningProfileKey::current(), tuner_.exportProfile());
+    return profile_.save(profilePath_);
+}
+
+void Optimizer::recordMetrics(ecs::World& world, const std::vector<ecs::SystemStats>& systems)
+{
+    stats_.record("world.entities", static_cast<f64>(world.entityCount()));
+    for (const auto& system : systems) {
+        String prefix = "system/" + system.name;
+        stats_.record(prefix + ".ns", system.lastNs);
+        if (system.lastEntities > 0) {
+            stats_.record(prefix + ".ns_per_entity",
+                          system.lastNs / static_cast<f64>(system.lastEntities));
         }
     }
 }
 
+void Optimizer::analyzeExecution(const std::vector<ecs::SystemStats>& systems)
+{
+    graph_ = analyzer::ExecutionGraph::fromSystems(systems, analyzer::SystemCost::Last);
+    criticalPath_ = graph_.analyze();
+    stats_.record("graph.critical_path_ms", criticalPath_.criticalPathNs / 1e6);
+    stats_.record("graph.parallelism", criticalPath_.parallelism);
+}
+
+void Optimizer::trackSystem(const ecs::SystemStats& stats, ecs::IVariantSystem* variants)
+{
+    SystemTrack& track = tracks_[stats.name];
+    if (track.cooldown > 0) {
+        --track.cooldown;
+    }
+
+    // One sample per update, in ns per entity so population changes don't register
+    if (stats.invocations == track.invocations) {
+        return;
+    }
+    track.invocations = stats.invocations;
+    detector_.addSample(stats.name, stats.lastNs, stats.lastEntities);
+
+    auto verdict = detector_.evaluate(stats.name);
+    if (!verdict) {
+        return;
+    }
+
+    LOG_INFO("[Optimizer] {} {} -> {}: {} ({:+.1f}% median, confidence {:.3f})",
+             verdict->subject, verdict->baselineLabel, verdict->candidateLabel,
+             toString(verdict->verdict), verdict->relativeChange * 100.0, verdict->confidence);
+
+    bool regressed = verdict->verdict == analyzer::RegressionVerdict::Regressed;
+    bool rollBack = regressed && track.variantTrial && variants;
+    if (rollBack) {
+        LOG_WARN("[Optimizer] Rolling {} back to {}", verdict->subject,
+                 ecs::toString(track.previous));
+        variants->switchVariant(track.previous);
+        track.cooldown = ROLLBACK_COOLDOWN_UPDATES;
+    } else if (regressed) {
+        LOG_WARN("[Optimizer] {} regressed after {}; it cannot be rolled back automatically",
+                 verdict->subject, verdict->candidateLabel);
+    }
+    track.variantTrial = false;
+    decisionLog_.writeEffect(frame_, *verdict, rollBack);
+    lastVerdict_ = std::move(verdict);
+}
+
+bool Optimizer::apply(ecs::World& world, const FiredAction& fired)
+{
+    const RuleAction& action = fired.action;
+    LOG_INFO("[Optimizer] Rule '{}' fired: {} {} {}", fired.rule, toString(action.kind),
+             action.target, action.argument);
+
+    // A hot swap is judged like a variant switch, so never stack one on an unjudged trial
+    bool hotSwap = action.kind == RuleActionKind::HotSwap;
+    if (hotSwap && detector_.hasTrial(action.target)) {
+        LOG_DEBUG("[Optimizer] Rule '{}': {} is on trial", fired.rule, action.target);
+        return false;
+    }
+
+    if (const auto& handler = handlers_[static_cast<usize>(action.kind)]) {
+        if (!handler(world, action)) {
+            LOG_WARN("[Optimizer] Rule '{}': {} was not applied", fired.rule,
+                     toString(action.kind));
+            return false;
+        }
+        if (hotSwap) {
+            tracks_[action.target].variantTrial = false;
+            detector_.beginTrial(action.target, "previous", action.argument);
+        }
+        return true;
+    }
+
+    if (action.kind == RuleActionKind::SwitchVariant) {
+        return switchVariant(world, fired);
+    }
+    LOG_WARN("[Optimizer] Rule '{}': no handler installed for {}", fired.rule,
+             toString(action.kind));
+    return false;
+}
+
+bool Optimizer::switchVariant(ecs::World& world, const FiredAction& fired)
+{
+    const RuleAction& action = fired.action;
+    ecs::IVariantSystem* system = findVariantSystem(world, action.target);
+    Optional<ecs::SystemVariant> target = ecs::variantFromString(action.argument);
+    if (!system || !target) AUTOPHAGE_UNLIKELY {
+        LOG_WARN("[Optimizer] Rule '{}': {} is not a variant system with variant {}", fired.rule,
+                 action.target, action.argument);
+        return false;
+    }
+
+    ecs::SystemVariant previous = system->currentVariant();
+    if (previous == *target) {
+        return true;
+    }
+
+    // Never stack a switch on top of an unjudged one, or retry a rolled-back variant early
+    SystemTrack& track = tracks_[action.target];
+    if (detector_.hasTrial(action.target) || track.cooldown > 0) {
+        LOG_DEBUG("[Optimizer] Rule '{}': {} is on trial or cooling down", fired.rule,
+                  action.target);
+        return false;
+    }
+
+    if (!system->switchVariant(*target)) {
+        LOG_WARN("[Optimizer] {} refused variant {}", action.target, action.argument);
+        return false;
+    }
+    tuner_.pin(action.target);
+    track.previous = previous;
+    track.variantTrial = true;
+    detector_.beginTrial(action.target, ecs::toString(previous), ecs::toString(*target));
+    return true;
+}
+
 }  // namespace autophage::optimizer
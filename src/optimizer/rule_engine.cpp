@@ -0,0 +1,554 @@
+#include <autophage/core/logger.hpp>
+#include <autophage/ecs/system.hpp>
+#include <autophage/optimizer/rule_engine.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <span>
+#include <unordered_map>
+
+namespace autophage::optimizer {
+
+namespace {
+
+// =============================================================================
+// Lexing
+// =============================================================================
+
+[[nodiscard]] std::vector<StringView> tokenize(StringView line)
+{
+    if (auto comment = line.find('#'); comment != StringView::npos) {
+        line = line.substr(0, comment);
+    }
+
+    std::vector<StringView> tokens;
+    usize i = 0;
+    while (i < line.size()) {
+        while (i < line.size() && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) {
+            ++i;
+        }
+        usize start = i;
+        while (i < line.size() && line[i] != ' ' && line[i] != '\t' && line[i] != '\r') {
+            ++i;
+        }
+        if (i > start) {
+            tokens.push_back(line.substr(start, i - start));
+        }
+    }
+    return tokens;
+}
+
+[[nodiscard]] bool parseNumber(StringView token, f64& value)
+{
+    auto [end, ec] = std::from_chars(token.data(), token.data() + token.size(), value);
+    return ec == std::errc{} && end == token.data() + token.size();
+}
+
+template <typename Int> [[nodiscard]] bool parseInteger(StringView token, Int& value)
+{
+    auto [end, ec] = std::from_chars(token.data(), token.data() + token.size(), value);
+    return ec == std::errc{} && end == token.data() + token.size();
+}
+
+[[nodiscard]] Optional<MetricStat> parseStat(StringView token)
+{
+    if (token == "mean") return MetricStat::Mean;
+    if (token == "min") return MetricStat::Min;
+    if (token == "max") return MetricStat::Max;
+    if (token == "stddev") return MetricStat::StdDev;
+    if (token == "slope") return MetricStat::Slope;
+    if (token == "count") return MetricStat::Count;
+    return std::nullopt;
+}
+
+[[nodiscard]] Optional<analyzer::TimeWindow> parseWindow(StringView token)
+{
+    for (usize i = 0; i < analyzer::TIME_WINDOW_COUNT; ++i) {
+        auto window = static_cast<analyzer::TimeWindow>(i);
+        if (token == analyzer::toString(window)) {
+            return window;
+        }
+    }
+    return std::nullopt;
+}
+
+[[nodiscard]] Optional<CompareOp> parseOp(StringView token)
+{
+    if (token == "<") return CompareOp::Less;
+    if (token == "<=") return CompareOp::LessEqual;
+    if (token == ">") return CompareOp::Greater;
+    if (token == ">=") return CompareOp::GreaterEqual;
+    if (token == "==") return CompareOp::Equal;
+    if (token == "!=") return CompareOp::NotEqual;
+    return std::nullopt;
+}
+
+// =============================================================================
+// Parsing
+// =============================================================================
+
+class RuleParser
+{
+public:
+    bool parse(StringView text, RuleSet& out)
+    {
+        RuleSet result;
+        Optional<Rule> current;
+
+        usize begin = 0;
+        while (begin <= text.size()) {
+            usize end = text.find('\n', begin);
+            if (end == StringView::npos) {
+                end = text.size();
+            }
+            ++line_;
+            auto tokens = tokenize(text.substr(begin, end - begin));
+            begin = end + 1;
+            if (tokens.empty()) {
+                continue;
+            }
+
+            StringView keyword = tokens[0];
+            std::span<const StringView> args(tokens.begin() + 1, tokens.end());
+            if (keyword == "evaluate") {
+                if (args.size() != 2 || args[0] != "every" ||
+                    !parseInteger(args[1], result.evaluateEvery) || result.evaluateEvery == 0) {
+                    return fail("expected 'evaluate every <frames>'");
+                }
+            } else if (keyword == "rule") {
+                if (current) {
+                    return fail("rule '" + current->name + "' is missing 'end'");
+                }
+                current.emplace();
+                if (!parseRuleHeader(args, *current)) {
+                    return false;
+                }
+                for (const auto& rule : result.rules) {
+                    if (rule.name == current->name) {
+                        return fail("duplicate rule '" + rule.name + "'");
+                    }
+                }
+            } else if (keyword == "when" || keyword == "and") {
+                if (!current) {
+                    return fail("'" + String(keyword) + "' outside a rule");
+                }
+                if (!parseCondition(args, current->conditions.emplace_back())) {
+                    return false;
+                }
+            } else if (keyword == "do") {
+                if (!current) {
+                    return fail("'do' outside a rule");
+                }
+                if (!parseAction(args, current->actions.emplace_back())) {
+                    return false;
+                }
+            } else if (keyword == "end") {
+                if (!current) {
+                    return fail("'end' outside a rule");
+                }
+                if (current->conditions.empty() || current->actions.empty()) {
+                    return fail("rule '" + current->name + "' needs a condition and an action");
+                }
+                result.rules.push_back(std::move(*current));
+                current.reset();
+            } else {
+                return fail("unknown keyword '" + String(keyword) + "'");
+            }
+        }
+
+        if (current) {
+            return fail("rule '" + current->name + "' is missing 'end'");
+        }
+
+        std::ranges::stable_sort(result.rules, std::ranges::greater{}, &Rule::priority);
+        out = std::move(result);
+        return true;
+    }
+
+    [[nodiscard]] const String& error() const noexcept { return error_; }
+
+private:
+    bool fail(const String& message)
+    {
+        error_ = std::to_string(line_) + ": " + message;
+        return false;
+    }
+
+    bool parseRuleHeader(std::span<const StringView> args, Rule& rule)
+    {
+        if (args.empty()) {
+            return fail("expected 'rule <name>'");
+        }
+        rule.name = String(args[0]);
+        for (usize i = 1; i < args.size(); i += 2) {
+            if (i + 1 >= args.size()) {
+                return fail("missing value for '" + String(args[i]) + "'");
+            }
+            if (args[i] == "priority") {
+                if (!parseInteger(args[i + 1], rule.priority)) {
+                    return fail("invalid priority '" + String(args[i + 1]) + "'");
+                }
+            } else if (args[i] == "cooldown") {
+                if (!parseInteger(args[i + 1], rule.cooldownFrames)) {
+                    return fail("invalid cooldown '" + String(args[i + 1]) + "'");
+                }
+            } else {
+                return fail("unknown rule attribute '" + String(args[i]) + "'");
+            }
+        }
+        return true;
+    }
+
+    bool parseCondition(std::span<const StringView> args, RuleCondition& condition)
+    {
+        usize i = 0;
+        if (i >= args.size()) {
+            return fail("expected a series name");
+        }
+        condition.series = String(args[i++]);
+
+        if (i < args.size()) {
+            if (auto stat = parseStat(args[i])) {
+                condition.stat = *stat;
+                ++i;
+            }
+        }
+        if (i < args.size()) {
+            if (auto window = parseWindow(args[i])) {
+                condition.window = *window;
+                ++i;
+            }
+        }
+
+        Optional<CompareOp> op = i < args.size() ? parseOp(args[i]) : std::nullopt;
+        if (!op) {
+            return fail("expected a comparison (< <= > >= == !=)");
+        }
+        condition.op = *op;
+        ++i;
+
+        if (i >= args.size() || !parseNumber(args[i], condition.threshold)) {
+            return fail("expected a number after the comparison");
+        }
+        ++i;
+
+        if (i < args.size()) {
+            if (args[i] != "hysteresis" || i + 2 != args.size() ||
+                !parseNumber(args[i + 1], condition.hysteresis) || condition.hysteresis < 0.0) {
+                return fail("expected 'hysteresis <non-negative number>' at end of condition");
+            }
+        }
+        return true;
+    }
+
+    bool parseAction(std::span<const StringView> args, RuleAction& action)
+    {
+        if (args.empty()) {
+            return fail("expected an action");
+        }
+        StringView name = args[0];
+        if (name == "switchVariant") {
+            if (args.size() != 3 || !ecs::variantFromString(args[2])) {
+                return fail("expected 'switchVariant <System> <Scalar|SIMD|GPU|Approximate>'");
+            }
+            action = {RuleActionKind::SwitchVariant, String(args[1]), String(args[2])};
+        } else if (name == "migrateLayout") {
+            if (args.size() != 3 || (args[2] != "AoS" && args[2] != "SoA")) {
+                return fail("expected 'migrateLayout <Component> <AoS|SoA>'");
+            }
+            action = {RuleActionKind::MigrateLayout, String(args[1]), String(args[2])};
+        } else if (name == "setThreadCount") {
+            u32 threads = 0;
+            if (args.size() != 2 || !parseInteger(args[1], threads) || threads == 0) {
+                return fail("expected 'setThreadCount <positive count>'");
+            }
+            action = {RuleActionKind::SetThreadCount, String(), String(args[1])};
+        } else if (name == "hotSwap") {
+            if (args.size() != 3) {
+                return fail("expected 'hotSwap <System> <source file>'");
+            }
+            action = {RuleActionKind::HotSwap, String(args[1]), String(args[2])};
+        } else {
+            return fail("unknown action '" + String(name) + "'");
+        }
+        return true;
+    }
+
+    usize line_ = 0;
+    String error_;
+};
+
+[[nodiscard]] bool compare(f64 value, CompareOp op, f64 threshold) noexcept
+{
+    switch (op) {
+        case CompareOp::Less:
+            return value < threshold;
+        case CompareOp::LessEqual:
+            return value <= threshold;
+        case CompareOp::Greater:
+            return value > threshold;
+        case CompareOp::GreaterEqual:
+            return value >= threshold;
+        case CompareOp::Equal:
+            return value == threshold;
+        case CompareOp::NotEqual:
+            return value != threshold;
+    }
+    return false;
+}
+
+[[nodiscard]] bool actionsOverlap(const Rule& a, const Rule& b)
+{
+    for (const auto& x : a.actions) {
+        for (const auto& y : b.actions) {
+            if (x.kind == y.kind && x.target == y.target) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+[[nodiscard]] bool readFile(const std::filesystem::path& path, String& contents)
+{
+    std::FILE* file = std::fopen(path.string().c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    contents.clear();
+    char buffer[4096];
+    usize read = 0;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        contents.append(buffer, read);
+    }
+    std::fclose(file);
+    return true;
+}
+
+}  // namespace
+
+bool parseRules(StringView text, RuleSet& out, String* error)
+{
+    RuleParser parser;
+    if (!parser.parse(text, out)) {
+        if (error) {
+            *error = parser.error();
+        }
+        return false;
+    }
+    return true;
+}
+
+// =============================================================================
+// Loading
+// =============================================================================
+
+bool RuleEngine::load(StringView text, StringView sourceName)
+{
+    RuleSet parsed;
+    String error;
+    if (!parseRules(text, parsed, &error)) {
+        lastError_ = String(sourceName) + ":" + error;
+        LOG_ERROR("[Optimizer] Rule error in {}; keeping previous rules", lastError_);
+        return false;
+    }
+
+    // Rules that survive a reload keep their trigger state, so they don't fire again
+    std::unordered_map<String, RuleState> previous;
+    for (usize i = 0; i < rules_.rules.size(); ++i) {
+        previous.emplace(rules_.rules[i].name, std::move(states_[i]));
+    }
+
+    rules_ = std::move(parsed);
+    states_.assign(rules_.rules.size(), RuleState{});
+    for (usize i = 0; i < rules_.rules.size(); ++i) {
+        if (auto it = previous.find(rules_.rules[i].name); it != previous.end()) {
+            states_[i].active = it->second.active;
+            states_[i].fired = it->second.fired;
+            states_[i].lastFiredFrame = it->second.lastFiredFrame;
+        }
+        states_[i].series.assign(rules_.rules[i].conditions.size(), analyzer::INVALID_SERIES_ID);
+    }
+
+    lastError_.clear();
+    LOG_INFO("[Optimizer] Loaded {} rules from {} (evaluated every {} frames)",
+             rules_.rules.size(), sourceName, rules_.evaluateEvery);
+    return true;
+}
+
+bool RuleEngine::loadFile(const std::filesystem::path& path)
+{
+    String contents;
+    if (!readFile(path, contents)) {
+        lastError_ = path.string() + ": cannot open file";
+        LOG_ERROR("[Optimizer] Cannot open rule file {}", path.string());
+        return false;
+    }
+
+    // Watch the file even if this version is malformed, so a fixed version gets picked up
+    path_ = path;
+    std::error_code ec;
+    loadedWriteTime_ = std::filesystem::last_write_time(path, ec);
+    return load(contents, path.string());
+}
+
+bool RuleEngine::reloadIfChanged()
+{
+    if (path_.empty()) {
+        return false;
+    }
+
+    std::error_code ec;
+    auto writeTime = std::filesystem::last_write_time(path_, ec);
+    if (ec || writeTime == loadedWriteTime_) {
+        return false;
+    }
+
+    String contents;
+    if (!readFile(path_, contents)) {
+        return false;
+    }
+    loadedWriteTime_ = writeTime;
+    return load(contents, path_.string());
+}
+
+// =============================================================================
+// Evaluation
+// =============================================================================
+
+std::vector<FiredAction> RuleEngine::update(const analyzer::StatsCollector& stats)
+{
+    ++frame_;
+    if (!path_.empty() && frame_ % RELOAD_CHECK_INTERVAL == 0) {
+        reloadIfChanged();
+    }
+    if (frame_ % rules_.evaluateEvery != 0) {
+        return {};
+    }
+    return evaluate(stats);
+}
+
+bool RuleEngine::conditionHolds(const RuleCondition& condition, analyzer::SeriesId& series,
+                                bool active, const analyzer::StatsCollector& stats,
+                                f64& value)
+{
+    const auto& store = stats.timeSeries();
+    if (series == analyzer::INVALID_SERIES_ID) {
+        series = store.findSeries(condition.series);
+        if (series == analyzer::INVALID_SERIES_ID) {
+            return false;  // Nothing recorded yet
+        }
+    }
+
+    analyzer::WindowAggregate aggregate = store.aggregate(series, condition.window);
+    if (aggregate.empty()) {
+        return false;
+    }
+
+    switch (condition.stat) {
+        case MetricStat::Mean:
+            value = aggregate.mean;
+            break;
+        case MetricStat::Min:
+            value = aggregate.min;
+            break;
+        case MetricStat::Max:
+            value = aggregate.max;
+            break;
+        case MetricStat::StdDev:
+            value = aggregate.stddev;
+            break;
+        case MetricStat::Slope:
+            value = aggregate.slopePerSecond;
+            break;
+        case MetricStat::Count:
+            value = static_cast<f64>(aggregate.count);
+            break;
+    }
+
+    // Once active, the threshold moves by the hysteresis band in the rule's favour
+    f64 threshold = condition.threshold;
+    if (active) {
+        if (condition.op == CompareOp::Greater || condition.op == CompareOp::GreaterEqual) {
+            threshold -= condition.hysteresis;
+        } else if (condition.op == CompareOp::Less || condition.op == CompareOp::LessEqual) {
+            threshold += condition.hysteresis;
+        }
+    }
+    return compare(value, condition.op, threshold);
+}
+
+std::vector<FiredAction> RuleEngine::evaluate(const analyzer::StatsCollector& stats)
+{
+    std::vector<FiredAction> fired;
+    const auto& rules = rules_.rules;
+
+    std::vector<bool> holds(rules.size(), false);
+    std::vector<std::vector<f64>> values(rules.size());
+    for (usize i = 0; i < rules.size(); ++i) {
+        RuleState& state = states_[i];
+        values[i].assign(rules[i].conditions.size(), 0.0);
+        bool all = true;
+        for (usize c = 0; c < rules[i].conditions.size() && all; ++c) {
+            all = conditionHolds(rules[i].conditions[c], state.series[c], state.active, stats,
+                                 values[i][c]);
+        }
+        holds[i] = all;
+        if (!all) {
+            state.active = false;
+        }
+    }
+
+    for (usize i = 0; i < rules.size(); ++i) {
+        RuleState& state = states_[i];
+        if (!holds[i] || state.active) {
+            continue;
+        }
+        if (state.fired && frame_ - state.lastFiredFrame < rules[i].cooldownFrames) {
+            continue;
+        }
+
+        // A holding rule of higher priority owns the targets it acts on
+        bool suppressed = false;
+        for (usize j = 0; j < i && !suppressed; ++j) {
+            suppressed = holds[j] && actionsOverlap(rules[j], rules[i]);
+        }
+        if (suppressed) {
+            continue;
+        }
+
+        state.active = true;
+        state.firedBefore = state.fired;
+        state.firedBeforeFrame = state.lastFiredFrame;
+        state.fired = true;
+        state.lastFiredFrame = frame_;
+
+        std::vector<ConditionInput> inputs;
+        inputs.reserve(rules[i].conditions.size());
+        for (usize c = 0; c < rules[i].conditions.size(); ++c) {
+            const RuleCondition& condition = rules[i].conditions[c];
+            inputs.push_back({condition.series, condition.stat, condition.window, values[i][c]});
+        }
+        for (const auto& action : rules[i].actions) {
+            fired.push_back({rules[i].name, action, inputs});
+        }
+    }
+    return fired;
+}
+
+void RuleEngine::rearm(StringView rule)
+{
+    for (usize i = 0; i < rules_.rules.size(); ++i) {
+        RuleState& state = states_[i];
+        if (rules_.rules[i].name != rule || !state.active) {
+            continue;
+        }
+        state.active = false;
+        state.fired = state.firedBefore;
+        state.lastFiredFrame = state.firedBeforeFrame;
+        return;
+    }
+}
+
+}  // namespace autophage::optimizer
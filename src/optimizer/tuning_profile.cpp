@@ -0,0 +1,293 @@
+#include <autophage/core/logger.hpp>
+#include <autophage/core/platform.hpp>
+#include <autophage/optimizer/tuning_profile.hpp>
+
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <system_error>
+#include <thread>
+
+namespace autophage::optimizer {
+
+namespace {
+
+constexpr usize FIELD_COUNT = 7;
+
+/// How long save() waits for another writer before giving up
+constexpr auto LOCK_TIMEOUT = std::chrono::seconds(2);
+constexpr auto LOCK_RETRY_INTERVAL = std::chrono::milliseconds(5);
+
+/// A lock file this old was left behind by a writer that died, and is taken over
+constexpr auto STALE_LOCK_AGE = std::chrono::seconds(30);
+
+[[nodiscard]] std::vector<StringView> split(StringView text, char separator)
+{
+    std::vector<StringView> parts;
+    usize begin = 0;
+    while (true) {
+        usize end = text.find(separator, begin);
+        if (end == StringView::npos) {
+            parts.push_back(text.substr(begin));
+            return parts;
+        }
+        parts.push_back(text.substr(begin, end - begin));
+        begin = end + 1;
+    }
+}
+
+template <typename T> [[nodiscard]] bool parseField(StringView text, T& value)
+{
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return ec == std::errc{} && end == text.data() + text.size();
+}
+
+[[nodiscard]] bool parseArm(StringView text, TunedArm& arm)
+{
+    auto parts = split(text, ':');
+    if (parts.size() != 4) {
+        return false;
+    }
+    auto variant = ecs::variantFromString(parts[0]);
+    if (!variant) {
+        return false;
+    }
+    arm.variant = *variant;
+    return parseField(parts[1], arm.stats.weight) && parseField(parts[2], arm.stats.mean) &&
+           parseField(parts[3], arm.stats.variance);
+}
+
+/// @brief Parse one profile line (without its newline)
+[[nodiscard]] bool parseLine(StringView line, TuningProfileKey& key, TunedBand& band)
+{
+    auto fields = split(line, '\t');
+    if (fields.size() != FIELD_COUNT) {
+        return false;
+    }
+
+    key.cpuModel = String(fields[0]);
+    key.buildHash = String(fields[2]);
+    band.system = String(fields[3]);
+    auto chosen = ecs::variantFromString(fields[5]);
+    if (!parseField(fields[1], key.logicalCores) || !parseField(fields[4], band.band) ||
+        !chosen || band.system.empty()) {
+        return false;
+    }
+    band.chosen = *chosen;
+
+    band.arms.clear();
+    if (!fields[6].empty()) {
+        for (StringView arm : split(fields[6], ',')) {
+            if (!parseArm(arm, band.arms.emplace_back())) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// @brief Exclusive writer lock on a profile file (a `.lock` file next to it, created with
+///        fopen's exclusive mode so the check and the creation are one step)
+class ProfileLock
+{
+public:
+    explicit ProfileLock(const std::filesystem::path& path) : path_(path)
+    {
+        path_ += ".lock";
+        auto deadline = std::chrono::steady_clock::now() + LOCK_TIMEOUT;
+        while (true) {
+            if (std::FILE* file = std::fopen(path_.string().c_str(), "wx")) {
+                std::fclose(file);
+                held_ = true;
+                return;
+            }
+            if (isStale()) {
+                LOG_WARN("[Optimizer] Removing stale tuning profile lock {}", path_.string());
+                std::error_code ec;
+                std::filesystem::remove(path_, ec);
+                continue;
+            }
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return;
+            }
+            std::this_thread::sleep_for(LOCK_RETRY_INTERVAL);
+        }
+    }
+
+    ~ProfileLock()
+    {
+        if (held_) {
+            std::error_code ec;
+            std::filesystem::remove(path_, ec);
+        }
+    }
+
+    ProfileLock(const ProfileLock&) = delete;
+    ProfileLock& operator=(const ProfileLock&) = delete;
+
+    [[nodiscard]] bool held() const noexcept { return held_; }
+    [[nodiscard]] const std::filesystem::path& path() const noexcept { return path_; }
+
+private:
+    [[nodiscard]] bool isStale() const
+    {
+        std::error_code ec;
+        auto written = std::filesystem::last_write_time(path_, ec);
+        return !ec && std::filesystem::file_time_type::clock::now() - written > STALE_LOCK_AGE;
+    }
+
+    std::filesystem::path path_;
+    bool held_ = false;
+};
+
+}  // namespace
+
+TuningProfileKey TuningProfileKey::current()
+{
+    const MachineInfo& machine = getMachineInfo();
+    return {machine.cpuModel, machine.logicalCores, getBuildHash()};
+}
+
+// =============================================================================
+// Persistence
+// =============================================================================
+
+bool TuningProfile::load(const std::filesystem::path& path)
+{
+    std::FILE* file = std::fopen(path.string().c_str(), "r");
+    if (!file) {
+        return false;
+    }
+
+    String line;
+    auto readLine = [&] {
+        line.clear();
+        int c = 0;
+        while ((c = std::fgetc(file)) != EOF && c != '\n') {
+            line.push_back(static_cast<char>(c));
+        }
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        return c != EOF || !line.empty();
+    };
+
+    if (!readLine() || line != FILE_HEADER) {
+        std::fclose(file);
+        LOG_WARN("[Optimizer] {} is not a tuning profile", path.string());
+        return false;
+    }
+
+    std::vector<Entry> entries;
+    usize skipped = 0;
+    while (readLine()) {
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+        Entry entry;
+        if (parseLine(line, entry.key, entry.band)) {
+            entries.push_back(std::move(entry));
+        } else {
+            ++skipped;
+        }
+    }
+    std::fclose(file);
+
+    if (skipped > 0) {
+        LOG_WARN("[Optimizer] Skipped {} malformed lines in tuning profile {}", skipped,
+                 path.string());
+    }
+    entries_ = std::move(entries);
+    return true;
+}
+
+bool TuningProfile::save(const std::filesystem::path& path) const
+{
+    ProfileLock lock(path);
+    if (!lock.held()) {
+        LOG_ERROR("[Optimizer] Timed out waiting for tuning profile lock {}",
+                  lock.path().string());
+        return false;
+    }
+
+    // Another process may have written its entries since this one loaded; keep them
+    TuningProfile merged;
+    if (std::filesystem::exists(path)) {
+        merged.load(path);
+    }
+    for (const Entry& entry : entries_) {
+        merged.storeEntry(entry.key, entry.band);
+    }
+
+    std::filesystem::path temporary = path;
+    temporary += ".tmp";
+
+    std::FILE* file = std::fopen(temporary.string().c_str(), "w");
+    if (!file) {
+        LOG_ERROR("[Optimizer] Cannot write tuning profile {}", temporary.string());
+        return false;
+    }
+
+    std::fprintf(file, "%.*s\n", static_cast<int>(FILE_HEADER.size()), FILE_HEADER.data());
+    for (const Entry& entry : merged.entries_) {
+        std::fprintf(file, "%s\t%u\t%s\t%s\t%u\t%s\t", entry.key.cpuModel.c_str(),
+                     entry.key.logicalCores, entry.key.buildHash.c_str(),
+                     entry.band.system.c_str(), entry.band.band,
+                     ecs::toString(entry.band.chosen));
+        for (usize i = 0; i < entry.band.arms.size(); ++i) {
+            const TunedArm& arm = entry.band.arms[i];
+            std::fprintf(file, "%s%s:%.17g:%.17g:%.17g", i > 0 ? "," : "",
+                         ecs::toString(arm.variant), arm.stats.weight, arm.stats.mean,
+                         arm.stats.variance);
+        }
+        std::fputc('\n', file);
+    }
+
+    bool ok = std::ferror(file) == 0;
+    ok = std::fclose(file) == 0 && ok;
+    std::error_code ec;
+    if (ok) {
+        std::filesystem::rename(temporary, path, ec);
+    }
+    if (!ok || ec) {
+        LOG_ERROR("[Optimizer] Failed to write tuning profile {}", path.string());
+        std::filesystem::remove(temporary, ec);
+        return false;
+    }
+    return true;
+}
+
+// =============================================================================
+// Entries
+// =============================================================================
+
+std::vector<TunedBand> TuningProfile::bandsFor(const TuningProfileKey& key) const
+{
+    std::vector<TunedBand> bands;
+    for (const Entry& entry : entries_) {
+        if (entry.key == key) {
+            bands.push_back(entry.band);
+        }
+    }
+    return bands;
+}
+
+void TuningProfile::store(const TuningProfileKey& key, const std::vector<TunedBand>& bands)
+{
+    for (const TunedBand& band : bands) {
+        storeEntry(key, band);
+    }
+}
+
+void TuningProfile::storeEntry(const TuningProfileKey& key, const TunedBand& band)
+{
+    for (Entry& entry : entries_) {
+        if (entry.key == key && entry.band.system == band.system && entry.band.band == band.band) {
+            entry.band = band;
+            return;
+        }
+    }
+    entries_.push_back({key, band});
+}
+
+}  // namespace autophage::optimizer
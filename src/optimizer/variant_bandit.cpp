@@ -0,0 +1,90 @@
+#include <autophage/optimizer/variant_bandit.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace autophage::optimizer {
+
+void VariantBandit::record(usize arm, f64 cost, f64 discount)
+{
+    for (auto& stats : arms_) {
+        stats.weight *= discount;
+    }
+
+    // Weighted incremental mean and variance (West's algorithm with exponential forgetting)
+    ArmStats& stats = arms_[arm];
+    f64 previousWeight = stats.weight;
+    stats.weight += 1.0;
+    f64 delta = cost - stats.mean;
+    stats.mean += delta / stats.weight;
+    stats.variance = (previousWeight * stats.variance + delta * (cost - stats.mean)) /
+                     stats.weight;
+}
+
+void VariantBandit::setPrior(usize arm, const ArmStats& stats, f64 maxWeight)
+{
+    arms_[arm] = stats;
+    arms_[arm].weight = std::min(stats.weight, maxWeight);
+}
+
+Optional<usize> VariantBandit::best() const noexcept
+{
+    Optional<usize> best;
+    for (usize i = 0; i < arms_.size(); ++i) {
+        if (!arms_[i].empty() && (!best || arms_[i].mean < arms_[*best].mean)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+usize VariantBandit::choose(const BanditConfig& config, std::mt19937_64& rng) const
+{
+    f64 totalWeight = 0.0;
+    for (usize i = 0; i < arms_.size(); ++i) {
+        if (arms_[i].empty()) {
+            return i;
+        }
+        totalWeight += arms_[i].weight;
+    }
+
+    usize chosen = 0;
+    f64 chosenScore = std::numeric_limits<f64>::infinity();
+    std::normal_distribution<f64> normal;
+    for (usize i = 0; i < arms_.size(); ++i) {
+        const ArmStats& stats = arms_[i];
+        f64 standardError = spread(stats) / std::sqrt(stats.weight);
+        f64 score = 0.0;
+        switch (config.policy) {
+            case BanditPolicy::Ucb:
+                score = stats.mean - config.ucbScale * standardError *
+                                         std::sqrt(2.0 * std::log(std::max(totalWeight, 1.0)));
+                break;
+            case BanditPolicy::Thompson:
+                score = stats.mean + standardError * normal(rng);
+                break;
+        }
+        if (score < chosenScore) {
+            chosen = i;
+            chosenScore = score;
+        }
+    }
+    return chosen;
+}
+
+f64 VariantBandit::expectedCost(usize arm) const noexcept
+{
+    if (!arms_[arm].empty()) {
+        return arms_[arm].mean;
+    }
+    auto best = this->best();
+    return best ? 2.0 * arms_[*best].mean : 0.0;
+}
+
+f64 VariantBandit::spread(const ArmStats& stats) const noexcept
+{
+    return std::max(std::sqrt(std::max(stats.variance, 0.0)), 0.01 * std::abs(stats.mean));
+}
+
+}  // namespace autophage::optimizer
@@ -0,0 +1,471 @@
+#include <autophage/analyzer/regression_detector.hpp>
+#include <autophage/core/logger.hpp>
+#include <autophage/ecs/world.hpp>
+#include <autophage/optimizer/variant_tuner.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace autophage::optimizer {
+
+namespace {
+
+/// @brief How a band's best challenger compared against the original variant
+[[nodiscard]] analyzer::RegressionResult bandVerdict(StringView name,
+                                                     ecs::SystemVariant original,
+                                                     const std::vector<f64>& originalSamples,
+                                                     ecs::SystemVariant challenger,
+                                                     const std::vector<f64>& challengerSamples,
+                                                     bool adopted,
+                                                     const VariantTunerConfig& config)
+{
+    analyzer::RegressionResult result;
+    result.subject = String(name);
+    result.baselineLabel = ecs::toString(original);
+    result.candidateLabel = ecs::toString(challenger);
+    result.baselineSamples = originalSamples.size();
+    result.candidateSamples = challengerSamples.size();
+    if (originalSamples.empty() || challengerSamples.empty()) {
+        return result;  // Inconclusive
+    }
+
+    result.baselineMedian = analyzer::median(originalSamples);
+    result.candidateMedian = analyzer::median(challengerSamples);
+    if (result.baselineMedian > 0.0) {
+        result.relativeChange = result.candidateMedian / result.baselineMedian - 1.0;
+    }
+    result.changeLow = result.relativeChange;
+    result.changeHigh = result.relativeChange;
+
+    auto test = analyzer::mannWhitneyU(originalSamples, challengerSamples);
+    result.pValue = test.pValue;
+    result.confidence = 1.0 - test.pValue;
+
+    bool significant = test.pValue <= 1.0 - config.confidence &&
+                       std::abs(result.relativeChange) >= config.minImprovement;
+    if (adopted) {
+        result.verdict = analyzer::RegressionVerdict::Improved;
+    } else if (significant && result.relativeChange > 0.0) {
+        result.verdict = analyzer::RegressionVerdict::Regressed;
+    } else {
+        result.verdict = analyzer::RegressionVerdict::NoChange;
+    }
+    return result;
+}
+
+}  // namespace
+
+// =============================================================================
+// Bands
+// =============================================================================
+
+u32 VariantTuner::bandOf(u64 entities) noexcept
+{
+    u32 log2 = entities == 0 ? 0 : static_cast<u32>(std::bit_width(entities)) - 1;
+    return log2 / BAND_LOG2_WIDTH;
+}
+
+u64 VariantTuner::bandStart(u32 band) noexcept
+{
+    return band == 0 ? 0 : u64{1} << (band * BAND_LOG2_WIDTH);
+}
+
+// =============================================================================
+// Observation
+// =============================================================================
+
+void VariantTuner::update(ecs::World& world, const std::vector<ecs::SystemStats>& systems)
+{
+    beginFrame();
+    const auto& registered = world.systemRegistry().systems();
+    for (const auto& stats : systems) {
+        auto it = std::ranges::find_if(registered, [&](const auto& system) {
+            return stats.name == system->name();
+        });
+        if (it == registered.end()) {
+            continue;
+        }
+        auto* variants = dynamic_cast<ecs::IVariantSystem*>(it->get());
+        if (!variants) {
+            continue;
+        }
+
+        // One observation per update of the system
+        SystemTuning& tuning = tuningFor(stats.name, *variants);
+        if (stats.invocations == tuning.invocations) {
+            continue;
+        }
+        tuning.invocations = stats.invocations;
+
+        u64 entities = stats.lastEntities > 0 ? stats.lastEntities : world.entityCount();
+        observe(stats.name, *variants, stats.lastNs, entities);
+    }
+}
+
+void VariantTuner::observe(StringView name, ecs::IVariantSystem& system, f64 costNs,
+                           u64 entities)
+{
+    SystemTuning& tuning = tuningFor(name, system);
+    if (tuning.pinned || tuning.variants.size() < 2) {
+        return;
+    }
+
+    u32 band = bandOf(entities);
+    BandTuning& state = bandFor(name, tuning, band);
+    if (config_.strategy == VariantStrategy::Bandit) {
+        observeBandit(name, band, system, tuning, state, costNs, entities);
+        return;
+    }
+
+    ecs::SystemVariant current = system.currentVariant();
+    if (state.decided) {
+        if (current != tuning.variants[state.best]) {
+            switchTo(name, band, system, tuning.variants[state.best], TunerEventKind::Apply,
+                     state.bestCost);
+        }
+        return;
+    }
+
+    // The measurement only counts if it ran the variant whose window is open
+    ecs::SystemVariant expected = tuning.variants[state.cursor];
+    if (current != expected) {
+        if (switchTo(name, band, system, expected, TunerEventKind::Trial)) {
+            tuning.warmup = config_.warmupUpdates;
+        } else {
+            state.cursor = (state.cursor + 1) % tuning.variants.size();  // Skip a refused one
+        }
+        return;
+    }
+    if (tuning.warmup > 0) {
+        --tuning.warmup;
+        return;
+    }
+
+    f64 cost = entities > 0 ? costNs / static_cast<f64>(entities) : costNs;
+    state.samples[state.cursor].push_back(cost);
+    if (++state.windowFill < config_.windowUpdates) {
+        return;
+    }
+
+    state.windowFill = 0;
+    state.cursor = (state.cursor + 1) % tuning.variants.size();
+    if (state.cursor == 0 && ++state.round >= config_.rounds) {
+        decide(name, band, tuning, state);
+    }
+
+    ecs::SystemVariant next = tuning.variants[state.decided ? state.best : state.cursor];
+    if (next != current &&
+        switchTo(name, band, system, next,
+                 state.decided ? TunerEventKind::Apply : TunerEventKind::Trial,
+                 state.decided ? state.bestCost : 0.0)) {
+        tuning.warmup = config_.warmupUpdates;
+    }
+}
+
+void VariantTuner::observeBandit(StringView name, u32 band, ecs::IVariantSystem& system,
+                                 SystemTuning& tuning, BandTuning& state, f64 cost,
+                                 u64 entities)
+{
+    auto current = std::ranges::find(tuning.variants, system.currentVariant());
+    if (current == tuning.variants.end()) {
+        return;
+    }
+
+    f64 scale = static_cast<f64>(std::max<u64>(entities, 1));
+    state.bandit.record(static_cast<usize>(current - tuning.variants.begin()), cost / scale,
+                        config_.bandit.discount);
+
+    // Exploring a variant expected to be slower spends its expected extra time from the budget
+    usize next = state.bandit.choose(config_.bandit, rng_);
+    auto best = state.bandit.best();
+    if (best && next != *best) {
+        f64 extraNs = (state.bandit.expectedCost(next) - state.bandit.arm(*best).mean) * scale;
+        if (extraNs > budgetNs_) {
+            next = *best;
+        } else {
+            budgetNs_ -= std::max(extraNs, 0.0);
+        }
+    }
+
+    if (tuning.variants[next] != *current) {
+        bool exploit = best && next == *best;
+        switchTo(name, band, system, tuning.variants[next],
+                 exploit ? TunerEventKind::Exploit : TunerEventKind::Explore,
+                 state.bandit.arm(next).mean);
+    }
+}
+
+bool VariantTuner::switchTo(StringView name, u32 band, ecs::IVariantSystem& system,
+                            ecs::SystemVariant variant, TunerEventKind kind, f64 nsPerEntity)
+{
+    ecs::SystemVariant from = system.currentVariant();
+    if (!system.switchVariant(variant)) {
+        return false;
+    }
+    if (recordEvents_) {
+        events_.push_back({String(name), band, kind, from, variant, nsPerEntity, std::nullopt});
+    }
+    return true;
+}
+
+void VariantTuner::decide(StringView name, u32 band, SystemTuning& tuning, BandTuning& state)
+{
+    std::vector<f64> medians(state.samples.size(), std::numeric_limits<f64>::infinity());
+    for (usize i = 0; i < state.samples.size(); ++i) {
+        if (!state.samples[i].empty()) {
+            medians[i] = analyzer::median(state.samples[i]);
+        }
+    }
+
+    // Leaving the original variant needs a significant and large enough win
+    usize best = 0;
+    usize fastest = 0;  // Cheapest challenger, for the verdict when none wins
+    for (usize i = 1; i < medians.size(); ++i) {
+        if (fastest == 0 || medians[i] < medians[fastest]) {
+            fastest = i;
+        }
+        if (medians[i] >= medians[best] || state.samples[0].empty()) {
+            continue;
+        }
+        auto test = analyzer::mannWhitneyU(state.samples[0], state.samples[i]);
+        f64 improvement = 1.0 - medians[i] / medians[0];
+        if (test.pValue <= 1.0 - config_.confidence && improvement >= config_.minImprovement) {
+            best = i;
+        }
+    }
+
+    state.decided = true;
+    state.best = best;
+    state.bestCost = medians[best];
+    state.summary.assign(state.samples.size(), ArmStats{});
+    for (usize i = 0; i < state.samples.size(); ++i) {
+        const auto& samples = state.samples[i];
+        if (samples.empty()) {
+            continue;
+        }
+        f64 variance = 0.0;
+        for (f64 sample : samples) {
+            variance += (sample - medians[i]) * (sample - medians[i]);
+        }
+        state.summary[i] = {static_cast<f64>(samples.size()), medians[i],
+                            variance / static_cast<f64>(samples.size())};
+    }
+    if (recordEvents_) {
+        usize challenger = best != 0 ? best : fastest;
+        events_.push_back({String(name), band, TunerEventKind::Decided, tuning.variants[0],
+                           tuning.variants[best], state.bestCost,
+                           bandVerdict(name, tuning.variants[0], state.samples[0],
+                                       tuning.variants[challenger], state.samples[challenger],
+                                       best != 0, config_)});
+    }
+    for (auto& samples : state.samples) {
+        samples = {};  // Decided bands no longer need their samples
+    }
+
+    LOG_INFO("[Optimizer] {} uses {} for {}-{} entities ({:.2f} ns/entity)", name,
+             ecs::toString(tuning.variants[best]), bandStart(band), bandStart(band + 1) - 1,
+             state.bestCost);
+}
+
+// =============================================================================
+// Control
+// =============================================================================
+
+VariantTuner::SystemTuning& VariantTuner::tuningFor(StringView name,
+                                                    const ecs::IVariantSystem& system)
+{
+    auto [it, inserted] = systems_.try_emplace(String(name));
+    SystemTuning& tuning = it->second;
+    if (inserted || tuning.variants.empty()) {
+        ecs::SystemVariant original = system.currentVariant();
+        tuning.variants.push_back(original);
+        for (ecs::SystemVariant variant : system.availableVariants()) {
+            if (variant != original) {
+                tuning.variants.push_back(variant);
+            }
+        }
+    }
+    return tuning;
+}
+
+VariantTuner::BandTuning& VariantTuner::bandFor(StringView name, SystemTuning& tuning,
+                                                u32 band)
+{
+    auto [it, inserted] = tuning.bands.try_emplace(band);
+    BandTuning& state = it->second;
+    if (!inserted) {
+        return state;
+    }
+
+    state.samples.resize(tuning.variants.size());
+    state.bandit = VariantBandit(tuning.variants.size());
+
+    auto imported = imported_.find(String(name));
+    if (imported == imported_.end()) {
+        return state;
+    }
+    auto tuned = std::ranges::find(imported->second, band, &TunedBand::band);
+    if (tuned == imported->second.end()) {
+        return state;
+    }
+
+    auto indexOf = [&](ecs::SystemVariant variant) -> Optional<usize> {
+        auto it = std::ranges::find(tuning.variants, variant);
+        if (it == tuning.variants.end()) {
+            return std::nullopt;  // Variant no longer available
+        }
+        return static_cast<usize>(it - tuning.variants.begin());
+    };
+
+    if (config_.strategy == VariantStrategy::Bandit) {
+        for (const TunedArm& arm : tuned->arms) {
+            if (auto index = indexOf(arm.variant)) {
+                state.bandit.setPrior(*index, arm.stats, config_.bandit.priorWeight);
+            }
+        }
+    } else if (auto best = indexOf(tuned->chosen)) {
+        state.decided = true;
+        state.best = *best;
+        state.summary.resize(tuning.variants.size());
+        for (const TunedArm& arm : tuned->arms) {
+            if (auto index = indexOf(arm.variant)) {
+                state.summary[*index] = arm.stats;
+            }
+        }
+        state.bestCost = state.summary[*best].mean;
+    }
+    return state;
+}
+
+void VariantTuner::pin(StringView name)
+{
+    systems_[String(name)].pinned = true;
+}
+
+void VariantTuner::unpin(StringView name)
+{
+    if (auto it = systems_.find(String(name)); it != systems_.end()) {
+        it->second.pinned = false;
+    }
+}
+
+bool VariantTuner::isPinned(StringView name) const
+{
+    auto it = systems_.find(String(name));
+    return it != systems_.end() && it->second.pinned;
+}
+
+Optional<ecs::SystemVariant> VariantTuner::chosenVariant(StringView name, u64 entities) const
+{
+    auto it = systems_.find(String(name));
+    if (it == systems_.end()) {
+        return std::nullopt;
+    }
+    auto band = it->second.bands.find(bandOf(entities));
+    if (band == it->second.bands.end()) {
+        return std::nullopt;
+    }
+    if (config_.strategy == VariantStrategy::Bandit) {
+        const VariantBandit& bandit = band->second.bandit;
+        for (usize i = 0; i < bandit.armCount(); ++i) {
+            if (bandit.arm(i).empty()) {
+                return std::nullopt;
+            }
+        }
+        return it->second.variants[bandit.best().value_or(0)];
+    }
+    if (!band->second.decided) {
+        return std::nullopt;
+    }
+    return it->second.variants[band->second.best];
+}
+
+std::vector<VariantChoice> VariantTuner::choices() const
+{
+    std::vector<VariantChoice> result;
+    for (const auto& [name, tuning] : systems_) {
+        for (const auto& [band, state] : tuning.bands) {
+            VariantChoice choice;
+            choice.system = name;
+            choice.band = band;
+            choice.minEntities = bandStart(band);
+            choice.maxEntities = bandStart(band + 1);
+            if (config_.strategy == VariantStrategy::Bandit) {
+                auto best = state.bandit.best();
+                choice.decided = chosenVariant(name, choice.minEntities).has_value();
+                choice.variant = tuning.variants[best.value_or(0)];
+                choice.nsPerEntity = best ? state.bandit.arm(*best).mean : 0.0;
+            } else {
+                choice.decided = state.decided;
+                choice.variant = tuning.variants[state.decided ? state.best : 0];
+                choice.nsPerEntity = state.decided ? state.bestCost : 0.0;
+            }
+            result.push_back(std::move(choice));
+        }
+    }
+    std::ranges::sort(result, [](const VariantChoice& a, const VariantChoice& b) {
+        return a.system != b.system ? a.system < b.system : a.band < b.band;
+    });
+    return result;
+}
+
+void VariantTuner::reset()
+{
+    for (auto& [name, tuning] : systems_) {
+        tuning.bands.clear();
+        tuning.warmup = 0;
+    }
+}
+
+// =============================================================================
+// Profiles
+// =============================================================================
+
+std::vector<TunedBand> VariantTuner::exportProfile() const
+{
+    std::vector<TunedBand> bands;
+    for (const auto& [name, tuning] : systems_) {
+        for (const auto& [band, state] : tuning.bands) {
+            TunedBand tuned;
+            tuned.system = name;
+            tuned.band = band;
+            if (config_.strategy == VariantStrategy::Bandit) {
+                auto best = state.bandit.best();
+                if (!best) {
+                    continue;
+                }
+                tuned.chosen = tuning.variants[*best];
+                for (usize arm = 0; arm < state.bandit.armCount(); ++arm) {
+                    if (!state.bandit.arm(arm).empty()) {
+                        tuned.arms.push_back({tuning.variants[arm], state.bandit.arm(arm)});
+                    }
+                }
+            } else {
+                if (!state.decided) {
+                    continue;
+                }
+                tuned.chosen = tuning.variants[state.best];
+                for (usize arm = 0; arm < state.summary.size(); ++arm) {
+                    if (!state.summary[arm].empty()) {
+                        tuned.arms.push_back({tuning.variants[arm], state.summary[arm]});
+                    }
+                }
+            }
+            bands.push_back(std::move(tuned));
+        }
+    }
+    return bands;
+}
+
+void VariantTuner::importProfile(const std::vector<TunedBand>& bands)
+{
+    for (const TunedBand& band : bands) {
+        auto& imported = imported_[band.system];
+        std::erase_if(imported, [&](const TunedBand& other) { return other.band == band.band; });
+        imported.push_back(band);
+    }
+}
+
+}  // namespace autophage::optimizer
@@ -0,0 +1,79 @@
+/// @file access_tracking.cpp
+/// @brief Per-zone aggregation of component access counters
+
+#include <autophage/profiler/access_tracking.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+namespace autophage {
+
+namespace {
+
+struct AccessAggregation
+{
+    std::mutex mutex;
+    std::unordered_map<ZoneId, ZoneAccessSample> pending;
+    std::vector<ZoneAccessSample> lastFrame;
+};
+
+AccessAggregation g_access;
+
+}  // namespace
+
+namespace detail {
+
+ThreadAccessState& engineAccessState() noexcept
+{
+    return t_accessState;
+}
+
+}  // namespace detail
+
+// =============================================================================
+// Per-Zone Aggregation
+// =============================================================================
+
+void submitZoneAccess(ZoneId zone, const AccessCounts& counts, u64 entities)
+{
+    if (zone == INVALID_ZONE_ID || (counts.empty() && entities == 0)) {
+        return;
+    }
+    std::lock_guard lock(g_access.mutex);
+    ZoneAccessSample& sample = g_access.pending[zone];
+    sample.counts += counts;
+    sample.entities += entities;
+}
+
+std::vector<ZoneAccessSample> getLastFrameAccess()
+{
+    std::lock_guard lock(g_access.mutex);
+    return g_access.lastFrame;
+}
+
+namespace detail {
+
+void collectFrameAccess()
+{
+    std::lock_guard lock(g_access.mutex);
+    g_access.lastFrame.clear();
+    for (const auto& [zone, sample] : g_access.pending) {
+        g_access.lastFrame.push_back(ZoneAccessSample{zone, sample.counts, sample.entities});
+    }
+    g_access.pending.clear();
+
+    std::sort(g_access.lastFrame.begin(), g_access.lastFrame.end(),
+              [](const ZoneAccessSample& a, const ZoneAccessSample& b) { return a.zone < b.zone; });
+}
+
+void resetFrameAccess()
+{
+    std::lock_guard lock(g_access.mutex);
+    g_access.pending.clear();
+    g_access.lastFrame.clear();
+}
+
+}  // namespace detail
+
+}  // namespace autophage
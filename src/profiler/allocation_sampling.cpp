@@ -0,0 +1,207 @@
+/// @file allocation_sampling.cpp
+/// @brief Sampled allocation call-site capture
+///
+/// Installs an AllocationSampleHook in core memory tracking. The hook runs on the allocating
+/// thread, captures the call stack with backtrace() and folds it into a map keyed by tag and
+/// raw addresses; symbolization is deferred until a report is requested.
+
+#include <autophage/core/logger.hpp>
+#include <autophage/core/platform.hpp>
+#include <autophage/profiler/allocation_sampling.hpp>
+#include <autophage/profiler/sampling.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+#if defined(AUTOPHAGE_PLATFORM_LINUX)
+    #include <execinfo.h>
+#endif
+
+namespace autophage {
+
+#if defined(AUTOPHAGE_PLATFORM_LINUX)
+
+namespace {
+
+/// @brief Raw site key: memory tag followed by leaf-first return addresses
+using SiteKey = std::vector<std::uintptr_t>;
+
+struct SiteKeyHash
+{
+    usize operator()(const SiteKey& key) const noexcept
+    {
+        u64 hash = 14695981039346656037ull;
+        for (std::uintptr_t value : key) {
+            hash = (hash ^ static_cast<u64>(value)) * 1099511628211ull;
+        }
+        return static_cast<usize>(hash);
+    }
+};
+
+struct SiteCounts
+{
+    u64 samples = 0;
+    u64 sampledBytes = 0;
+    u64 estimatedBytes = 0;
+};
+
+struct AllocationSamplingState
+{
+    std::mutex mutex;  // Guards sites and config
+    std::unordered_map<SiteKey, SiteCounts, SiteKeyHash> sites;
+    AllocationSamplingConfig config;
+
+    std::atomic<bool> active{false};
+    std::atomic<u32> maxDepth{32};
+};
+
+AllocationSamplingState g_allocSampling;
+
+/// Set while this thread builds a report; allocations it makes must not re-enter the map
+thread_local bool t_reporting = false;
+
+void onAllocationSample(MemoryTag tag, usize size)
+{
+    if (t_reporting || !g_allocSampling.active.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    // +1 for this function's own frame, which is dropped below
+    void* frames[MAX_SAMPLE_DEPTH + 1];
+    u32 maxDepth = g_allocSampling.maxDepth.load(std::memory_order_relaxed);
+    int depth = backtrace(frames, static_cast<int>(maxDepth + 1));
+
+    SiteKey key;
+    key.reserve(static_cast<usize>(std::max(depth, 1)));
+    key.push_back(static_cast<std::uintptr_t>(tag));
+    for (int i = 1; i < depth; ++i) {
+        key.push_back(reinterpret_cast<std::uintptr_t>(frames[i]));
+    }
+
+    std::lock_guard lock(g_allocSampling.mutex);
+    SiteCounts& counts = g_allocSampling.sites[std::move(key)];
+    ++counts.samples;
+    counts.sampledBytes += size;
+    // A sample stands for one interval's worth of bytes, or for itself if it is larger
+    counts.estimatedBytes += std::max<u64>(size, g_allocSampling.config.sampleIntervalBytes);
+}
+
+}  // namespace
+
+bool startAllocationSampling(const AllocationSamplingConfig& config)
+{
+    std::lock_guard lock(g_allocSampling.mutex);
+
+    if (g_allocSampling.active.load(std::memory_order_relaxed)) {
+        LOG_WARN("Allocation sampling already running");
+        return false;
+    }
+
+    g_allocSampling.config = config;
+    g_allocSampling.config.sampleIntervalBytes = std::max<usize>(config.sampleIntervalBytes, 1);
+    g_allocSampling.maxDepth.store(std::clamp<u32>(config.maxDepth, 1, MAX_SAMPLE_DEPTH),
+                                   std::memory_order_relaxed);
+    g_allocSampling.sites.clear();
+    g_allocSampling.active.store(true, std::memory_order_release);
+
+    setAllocationSampleHook(onAllocationSample, g_allocSampling.config.sampleIntervalBytes);
+
+    LOG_INFO("Allocation sampling started (1 sample per {} bytes)",
+             g_allocSampling.config.sampleIntervalBytes);
+    return true;
+}
+
+void stopAllocationSampling()
+{
+    std::lock_guard lock(g_allocSampling.mutex);
+
+    if (!g_allocSampling.active.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    setAllocationSampleHook(nullptr, 0);
+    g_allocSampling.active.store(false, std::memory_order_release);
+
+    LOG_INFO("Allocation sampling stopped ({} call sites)", g_allocSampling.sites.size());
+}
+
+bool isAllocationSamplingActive() noexcept
+{
+    return g_allocSampling.active.load(std::memory_order_acquire);
+}
+
+AllocationSamplingReport getAllocationSamplingReport()
+{
+    t_reporting = true;
+
+    AllocationSamplingReport report;
+    {
+        std::lock_guard lock(g_allocSampling.mutex);
+
+        std::unordered_map<std::uintptr_t, String> symbols;
+        std::unordered_map<String, usize> siteIndex;
+
+        String line;
+        for (const auto& [key, counts] : g_allocSampling.sites) {
+            auto tag = static_cast<MemoryTag>(key[0]);
+            line = toString(tag);
+
+            // Keys are leaf-first; flamegraphs want root-first
+            for (usize i = key.size(); i-- > 1;) {
+                auto [it, inserted] = symbols.try_emplace(key[i]);
+                if (inserted) {
+                    it->second = detail::symbolizeAddress(key[i]);
+                    std::replace(it->second.begin(), it->second.end(), ';', ':');
+                }
+                line += ';';
+                line += it->second;
+            }
+
+            // Distinct return addresses can symbolize to the same stack
+            auto [it, inserted] = siteIndex.try_emplace(line, report.sites.size());
+            if (inserted) {
+                report.sites.push_back({line, tag, 0, 0, 0});
+            }
+            AllocationSite& site = report.sites[it->second];
+            site.samples += counts.samples;
+            site.sampledBytes += counts.sampledBytes;
+            site.estimatedBytes += counts.estimatedBytes;
+
+            report.totalSamples += counts.samples;
+            report.estimatedBytes += counts.estimatedBytes;
+        }
+    }
+
+    std::sort(report.sites.begin(), report.sites.end(),
+              [](const auto& a, const auto& b) { return a.estimatedBytes > b.estimatedBytes; });
+
+    t_reporting = false;
+    return report;
+}
+
+#else  // !AUTOPHAGE_PLATFORM_LINUX
+
+bool startAllocationSampling(const AllocationSamplingConfig& /*config*/)
+{
+    LOG_WARN("Allocation sampling is not supported on {}", AUTOPHAGE_PLATFORM_NAME);
+    return false;
+}
+
+void stopAllocationSampling() {}
+
+bool isAllocationSamplingActive() noexcept
+{
+    return false;
+}
+
+AllocationSamplingReport getAllocationSamplingReport()
+{
+    return {};
+}
+
+#endif
+
+}  // namespace autophage
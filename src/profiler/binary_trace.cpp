@@ -0,0 +1,341 @@
+/// @file binary_trace.cpp
+/// @brief Memory-mapped binary trace reader
+
+#include <autophage/profiler/binary_trace.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+#if defined(AUTOPHAGE_PLATFORM_WINDOWS)
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace autophage {
+
+namespace {
+
+// =============================================================================
+// Decoding Helpers
+// =============================================================================
+
+template <typename T> [[nodiscard]] bool readRaw(const u8*& pos, const u8* end, T& out) noexcept
+{
+    if (static_cast<usize>(end - pos) < sizeof(T)) {
+        return false;
+    }
+    std::memcpy(&out, pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+[[nodiscard]] bool readVarint(const u8*& pos, const u8* end, u64& out) noexcept
+{
+    out = 0;
+    for (u32 shift = 0; shift < 64; shift += 7) {
+        if (pos >= end) {
+            return false;
+        }
+        u8 byte = *pos++;
+        out |= static_cast<u64>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+[[nodiscard]] i64 zigzagDecode(u64 value) noexcept
+{
+    return static_cast<i64>(value >> 1) ^ -static_cast<i64>(value & 1);
+}
+
+}  // namespace
+
+// =============================================================================
+// Open / Close
+// =============================================================================
+
+BinaryTraceReader::~BinaryTraceReader()
+{
+    close();
+}
+
+bool BinaryTraceReader::open(const String& path)
+{
+    close();
+
+#if defined(AUTOPHAGE_PLATFORM_WINDOWS)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        lastError_ = "Cannot open " + path;
+        return false;
+    }
+    LARGE_INTEGER fileSize{};
+    GetFileSizeEx(file, &fileSize);
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        lastError_ = "Cannot map " + path;
+        return false;
+    }
+    data_ = static_cast<const u8*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    size_ = static_cast<usize>(fileSize.QuadPart);
+    fileHandle_ = file;
+    mappingHandle_ = mapping;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        lastError_ = "Cannot open " + path;
+        return false;
+    }
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        lastError_ = "Cannot stat or empty file " + path;
+        return false;
+    }
+    size_ = static_cast<usize>(info.st_size);
+    void* mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        size_ = 0;
+        lastError_ = "Cannot map " + path;
+        return false;
+    }
+    madvise(mapped, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const u8*>(mapped);
+#endif
+
+    if (!data_) {
+        lastError_ = "Cannot map " + path;
+        close();
+        return false;
+    }
+
+    // Header
+    const u8* pos = data_;
+    const u8* end = data_ + size_;
+    if (!readRaw(pos, end, header_) ||
+        std::memcmp(header_.magic, BINARY_TRACE_MAGIC, sizeof(BINARY_TRACE_MAGIC)) != 0) {
+        lastError_ = "Not an Autophage binary trace";
+        close();
+        return false;
+    }
+    if (header_.version != BINARY_TRACE_VERSION) {
+        lastError_ = "Unsupported trace version " + std::to_string(header_.version);
+        close();
+        return false;
+    }
+
+    // Index blocks: only headers, strings and thread names are touched here
+    while (pos < end) {
+        usize offset = static_cast<usize>(pos - data_);
+        BinaryBlockHeader block{};
+        if (!readRaw(pos, end, block) || static_cast<usize>(end - pos) < block.size) {
+            // A truncated tail (e.g. crash during capture) ends the usable range
+            break;
+        }
+        const u8* payload = pos;
+        const u8* payloadEnd = pos + block.size;
+        pos = payloadEnd;
+
+        switch (block.type) {
+            case BinaryBlockType::Events:
+                eventBlocks_.push_back(offset);
+                eventCount_ += block.count;
+                break;
+            case BinaryBlockType::Strings:
+                for (u32 i = 0; i < block.count; ++i) {
+                    u64 id = 0;
+                    u64 length = 0;
+                    // Ids come in order, so a corrupt one cannot size the table
+                    if (!readVarint(payload, payloadEnd, id) || id != names_.size() ||
+                        !readVarint(payload, payloadEnd, length) ||
+                        static_cast<u64>(payloadEnd - payload) < length) {
+                        break;
+                    }
+                    names_.emplace_back(reinterpret_cast<const char*>(payload), length);
+                    payload += length;
+                }
+                break;
+            case BinaryBlockType::ThreadName:
+                threadNames_[block.tid] = StringView(reinterpret_cast<const char*>(payload),
+                                                     block.size);
+                break;
+        }
+    }
+
+    return true;
+}
+
+void BinaryTraceReader::close()
+{
+#if defined(AUTOPHAGE_PLATFORM_WINDOWS)
+    if (data_) {
+        UnmapViewOfFile(data_);
+    }
+    if (mappingHandle_) {
+        CloseHandle(mappingHandle_);
+    }
+    if (fileHandle_) {
+        CloseHandle(fileHandle_);
+    }
+    fileHandle_ = nullptr;
+    mappingHandle_ = nullptr;
+#else
+    if (data_) {
+        munmap(const_cast<u8*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    header_ = BinaryTraceHeader{};
+    eventBlocks_.clear();
+    names_.clear();
+    threadNames_.clear();
+    eventCount_ = 0;
+}
+
+// =============================================================================
+// Queries
+// =============================================================================
+
+StringView BinaryTraceReader::name(u32 id) const
+{
+    return id < names_.size() ? names_[id] : StringView{};
+}
+
+StringView BinaryTraceReader::threadName(u32 tid) const
+{
+    auto it = threadNames_.find(tid);
+    return it != threadNames_.end() ? it->second : StringView{};
+}
+
+i64 BinaryTraceReader::toNanoseconds(i64 ticks) const noexcept
+{
+    if (header_.nsPerTick == 1.0) {
+        return ticks;
+    }
+    return static_cast<i64>(std::llround(static_cast<f64>(ticks) * header_.nsPerTick));
+}
+
+std::vector<ZoneStatistics> BinaryTraceReader::zoneStatistics() const
+{
+    std::unordered_map<u32, ZoneStatistics> byName;
+
+    auto cursor = events();
+    TraceRecord record;
+    while (cursor.next(record)) {
+        if (record.type != BinaryRecordType::Zone) {
+            continue;
+        }
+        auto& stats = byName[record.nameId];
+        if (stats.count == 0) {
+            stats.nameId = record.nameId;
+            stats.name = name(record.nameId);
+            stats.minNs = record.durationNs;
+            stats.maxNs = record.durationNs;
+        }
+        ++stats.count;
+        stats.totalNs += record.durationNs;
+        stats.minNs = std::min(stats.minNs, record.durationNs);
+        stats.maxNs = std::max(stats.maxNs, record.durationNs);
+        stats.durations.record(static_cast<f64>(record.durationNs));
+    }
+
+    std::vector<ZoneStatistics> result;
+    result.reserve(byName.size());
+    for (auto& [id, stats] : byName) {
+        result.push_back(stats);
+    }
+    std::sort(result.begin(), result.end(),
+              [](const ZoneStatistics& a, const ZoneStatistics& b) { return a.totalNs > b.totalNs; });
+    return result;
+}
+
+// =============================================================================
+// Cursor
+// =============================================================================
+
+BinaryTraceReader::Cursor::Cursor(const BinaryTraceReader& reader) : reader_(&reader) {}
+
+bool BinaryTraceReader::Cursor::enterNextBlock()
+{
+    if (blockIndex_ >= reader_->eventBlocks_.size()) {
+        return false;
+    }
+
+    const u8* pos = reader_->data_ + reader_->eventBlocks_[blockIndex_++];
+    BinaryBlockHeader block{};
+    std::memcpy(&block, pos, sizeof(block));
+
+    pos_ = pos + sizeof(block);
+    end_ = pos_ + block.size;
+    remaining_ = block.count;
+    tid_ = block.tid;
+    prevTicks_ = block.baseTicks;
+    return true;
+}
+
+bool BinaryTraceReader::Cursor::next(TraceRecord& record)
+{
+    while (remaining_ == 0) {
+        if (failed_ || !enterNextBlock()) {
+            return false;
+        }
+    }
+    --remaining_;
+
+    u8 type = 0;
+    u64 delta = 0;
+    if (!readRaw(pos_, end_, type)) {
+        failed_ = true;
+        return false;
+    }
+
+    record = TraceRecord{};
+    record.type = static_cast<BinaryRecordType>(type);
+    record.tid = tid_;
+
+    u64 nameId = 0;
+    u64 duration = 0;
+    bool ok = true;
+    switch (record.type) {
+        case BinaryRecordType::Zone:
+            ok = readVarint(pos_, end_, nameId) && readVarint(pos_, end_, delta) &&
+                 readVarint(pos_, end_, duration);
+            break;
+        case BinaryRecordType::Frame:
+            ok = readVarint(pos_, end_, delta) && readVarint(pos_, end_, duration) &&
+                 readVarint(pos_, end_, record.frame);
+            break;
+        case BinaryRecordType::Counter:
+            ok = readVarint(pos_, end_, nameId) && readVarint(pos_, end_, delta) &&
+                 readRaw(pos_, end_, record.value);
+            break;
+        default:
+            ok = false;
+            break;
+    }
+    if (!ok) {
+        failed_ = true;
+        remaining_ = 0;
+        return false;
+    }
+
+    prevTicks_ += zigzagDecode(delta);
+    record.nameId = static_cast<u32>(nameId);
+    record.startNs = reader_->toNanoseconds(prevTicks_ - reader_->header_.originTicks);
+    record.durationNs = reader_->toNanoseconds(static_cast<i64>(duration));
+    return true;
+}
+
+}  // namespace autophage
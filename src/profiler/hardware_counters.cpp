@@ -0,0 +1,149 @@
+/// @file hardware_counters.cpp
+/// @brief CPU performance counter implementation (perf_event_open on Linux)
+
+#include <autophage/core/logger.hpp>
+#include <autophage/core/platform.hpp>
+#include <autophage/profiler/hardware_counters.hpp>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+
+#if defined(AUTOPHAGE_PLATFORM_LINUX)
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace autophage {
+
+namespace {
+
+enum CounterIndex : usize
+{
+    CACHE_MISSES,
+    BRANCH_MISSES,
+    DTLB_MISSES,
+    COUNTER_COUNT
+};
+
+struct HardwareCounterState
+{
+    std::mutex mutex;
+    std::array<int, COUNTER_COUNT> fds{-1, -1, -1};
+    std::atomic<bool> enabled{false};
+};
+
+HardwareCounterState g_counters;
+
+#if defined(AUTOPHAGE_PLATFORM_LINUX)
+
+[[nodiscard]] int openCounter(u32 type, u64 config) noexcept
+{
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    // Calling thread, any CPU
+    long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    ioctl(static_cast<int>(fd), PERF_EVENT_IOC_RESET, 0);
+    ioctl(static_cast<int>(fd), PERF_EVENT_IOC_ENABLE, 0);
+    return static_cast<int>(fd);
+}
+
+[[nodiscard]] u64 readCounter(int fd) noexcept
+{
+    u64 value = 0;
+    if (fd < 0 || read(fd, &value, sizeof(value)) != static_cast<ssize_t>(sizeof(value))) {
+        return 0;
+    }
+    return value;
+}
+
+#endif
+
+void closeCountersLocked()
+{
+#if defined(AUTOPHAGE_PLATFORM_LINUX)
+    for (int& fd : g_counters.fds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        fd = -1;
+    }
+#endif
+    g_counters.enabled.store(false, std::memory_order_release);
+}
+
+}  // namespace
+
+// =============================================================================
+// Hardware Counters
+// =============================================================================
+
+HardwareCounterAvailability enableHardwareCounters()
+{
+    std::lock_guard lock(g_counters.mutex);
+    closeCountersLocked();
+
+    HardwareCounterAvailability available{};
+#if defined(AUTOPHAGE_PLATFORM_LINUX)
+    g_counters.fds[CACHE_MISSES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    g_counters.fds[BRANCH_MISSES] =
+        openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    g_counters.fds[DTLB_MISSES] =
+        openCounter(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB |
+                                            (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+
+    available.cacheMisses = g_counters.fds[CACHE_MISSES] >= 0;
+    available.branchMispredictions = g_counters.fds[BRANCH_MISSES] >= 0;
+    available.dtlbMisses = g_counters.fds[DTLB_MISSES] >= 0;
+#endif
+
+    g_counters.enabled.store(available.any(), std::memory_order_release);
+    if (available.any()) {
+        LOG_INFO("Hardware counters enabled (cache: {}, branch: {}, dTLB: {})",
+                 available.cacheMisses, available.branchMispredictions, available.dtlbMisses);
+    } else {
+        LOG_WARN("Hardware counters unavailable on this system");
+    }
+    return available;
+}
+
+void disableHardwareCounters()
+{
+    std::lock_guard lock(g_counters.mutex);
+    closeCountersLocked();
+}
+
+bool areHardwareCountersEnabled() noexcept
+{
+    return g_counters.enabled.load(std::memory_order_acquire);
+}
+
+HardwareCounterValues readHardwareCounters() noexcept
+{
+    HardwareCounterValues values{};
+#if defined(AUTOPHAGE_PLATFORM_LINUX)
+    // Holding the lock keeps disableHardwareCounters() from closing (and the OS from reusing)
+    // the descriptors mid-read; this runs twice a frame, so the lock is uncontended
+    if (areHardwareCountersEnabled()) {
+        std::lock_guard lock(g_counters.mutex);
+        values.cacheMisses = readCounter(g_counters.fds[CACHE_MISSES]);
+        values.branchMispredictions = readCounter(g_counters.fds[BRANCH_MISSES]);
+        values.dtlbMisses = readCounter(g_counters.fds[DTLB_MISSES]);
+    }
+#endif
+    return values;
+}
+
+}  // namespace autophage
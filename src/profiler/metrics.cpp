@@ -0,0 +1,380 @@
+/// @file metrics.cpp
+/// @brief Metrics registry implementation
+///
+/// Counters and histograms are sharded per thread: each recording thread owns a shard and is
+/// the only writer of its slots, so the hot path is a relaxed load/store pair with no locked
+/// read-modify-write. endFrame() folds all shards under the registry mutex and reports
+/// per-frame deltas against the previous fold.
+
+#include <autophage/core/logger.hpp>
+#include <autophage/core/platform.hpp>
+#include <autophage/profiler/metrics.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace autophage {
+
+namespace {
+
+// =============================================================================
+// Registry State
+// =============================================================================
+
+struct HistogramShard
+{
+    std::array<std::atomic<u64>, HISTOGRAM_BUCKETS> buckets{};
+    std::atomic<u64> count{0};
+    std::atomic<f64> sum{0.0};
+    std::atomic<f64> min{std::numeric_limits<f64>::infinity()};
+    std::atomic<f64> max{-std::numeric_limits<f64>::infinity()};
+};
+
+/// @brief Per-thread metric storage (written only by the owning thread)
+struct MetricShard
+{
+    std::array<std::atomic<i64>, MAX_METRICS> counters{};
+    std::array<HistogramShard, MAX_HISTOGRAMS> histograms{};
+};
+
+struct MetricInfo
+{
+    String name;
+    MetricKind kind = MetricKind::Counter;
+    u32 histogramSlot = 0;
+};
+
+struct MetricRegistry
+{
+    std::mutex mutex;
+    std::unordered_map<String, MetricId> byName;
+    std::array<MetricInfo, MAX_METRICS> infos;
+    std::atomic<u32> count{0};
+    u32 histogramCount = 0;
+
+    std::vector<std::unique_ptr<MetricShard>> shards;
+    std::array<std::atomic<f64>, MAX_METRICS> gauges{};
+
+    // Totals at the previous fold, used to turn cumulative shards into per-frame deltas
+    std::array<i64, MAX_METRICS> counterBaselines{};
+    std::array<u64, MAX_HISTOGRAMS> histogramCountBaselines{};
+    std::array<f64, MAX_HISTOGRAMS> histogramSumBaselines{};
+};
+
+MetricRegistry g_metrics;
+
+thread_local MetricShard* t_shard = nullptr;
+thread_local std::unordered_map<String, MetricId, StringHash, std::equal_to<>> t_nameCache;
+
+MetricShard& localShard()
+{
+    if (!t_shard) AUTOPHAGE_UNLIKELY {
+        auto shard = std::make_unique<MetricShard>();
+        std::lock_guard lock(g_metrics.mutex);
+        t_shard = shard.get();
+        g_metrics.shards.push_back(std::move(shard));
+    }
+    return *t_shard;
+}
+
+/// @brief Single-writer add: no locked RMW since only the owning thread writes the slot
+template <typename T> void ownerAdd(std::atomic<T>& slot, T value) noexcept
+{
+    slot.store(slot.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+[[nodiscard]] bool isRegistered(MetricId id) noexcept
+{
+    return id < g_metrics.count.load(std::memory_order_acquire);
+}
+
+/// @brief Resolve a name through the thread-local cache
+/// @note Keyed by contents, so names may live in reused buffers. Only registered ids are
+///       cached, which bounds the cache at MAX_METRICS entries.
+MetricId resolve(const char* name, MetricKind kind)
+{
+    if (!name) {
+        return INVALID_METRIC_ID;
+    }
+
+    StringView text(name);
+    auto it = t_nameCache.find(text);
+    if (it != t_nameCache.end()) AUTOPHAGE_LIKELY {
+        return it->second;
+    }
+
+    MetricId id = registerMetric(text, kind);
+    if (id != INVALID_METRIC_ID) {
+        t_nameCache.emplace(String(text), id);
+    }
+    return id;
+}
+
+}  // namespace
+
+// =============================================================================
+// Histogram Statistics
+// =============================================================================
+
+usize histogramBucketIndex(f64 value) noexcept
+{
+    if (!(value >= 1.0)) {
+        return 0;
+    }
+    if (value >= 9.2e18) {
+        return HISTOGRAM_BUCKETS - 1;
+    }
+    auto width = static_cast<usize>(std::bit_width(static_cast<u64>(value)));
+    return std::min(width, HISTOGRAM_BUCKETS - 1);
+}
+
+void HistogramStats::record(f64 value) noexcept
+{
+    if (count == 0) {
+        min = value;
+        max = value;
+    } else {
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+    ++count;
+    sum += value;
+    ++buckets[histogramBucketIndex(value)];
+}
+
+f64 HistogramStats::percentile(f64 p) const noexcept
+{
+    if (count == 0) {
+        return 0.0;
+    }
+
+    auto target = static_cast<u64>(std::ceil(std::clamp(p, 0.0, 1.0) * static_cast<f64>(count)));
+    target = std::max<u64>(target, 1);
+
+    u64 seen = 0;
+    for (usize i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+        seen += buckets[i];
+        if (seen >= target) {
+            f64 upper = std::ldexp(1.0, static_cast<int>(i));
+            return std::clamp(upper, min, max);
+        }
+    }
+    return max;
+}
+
+// =============================================================================
+// Registry
+// =============================================================================
+
+MetricId registerMetric(StringView name, MetricKind kind)
+{
+    std::lock_guard lock(g_metrics.mutex);
+
+    auto it = g_metrics.byName.find(String(name));
+    if (it != g_metrics.byName.end()) {
+        if (g_metrics.infos[it->second].kind != kind) {
+            LOG_WARN("Metric '{}' already registered as {}, cannot re-register as {}", name,
+                     toString(g_metrics.infos[it->second].kind), toString(kind));
+            return INVALID_METRIC_ID;
+        }
+        return it->second;
+    }
+
+    u32 id = g_metrics.count.load(std::memory_order_relaxed);
+    if (id >= MAX_METRICS) {
+        LOG_WARN("Metric registry full ({} metrics), dropping '{}'", MAX_METRICS, name);
+        return INVALID_METRIC_ID;
+    }
+    if (kind == MetricKind::Histogram && g_metrics.histogramCount >= MAX_HISTOGRAMS) {
+        LOG_WARN("Histogram registry full ({} histograms), dropping '{}'", MAX_HISTOGRAMS, name);
+        return INVALID_METRIC_ID;
+    }
+
+    auto& info = g_metrics.infos[id];
+    info.name = String(name);
+    info.kind = kind;
+    if (kind == MetricKind::Histogram) {
+        info.histogramSlot = g_metrics.histogramCount++;
+    }
+
+    g_metrics.byName.emplace(info.name, id);
+    g_metrics.count.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+MetricId findMetric(StringView name)
+{
+    std::lock_guard lock(g_metrics.mutex);
+    auto it = g_metrics.byName.find(String(name));
+    return it != g_metrics.byName.end() ? it->second : INVALID_METRIC_ID;
+}
+
+StringView getMetricName(MetricId id)
+{
+    return isRegistered(id) ? StringView(g_metrics.infos[id].name) : StringView{};
+}
+
+MetricKind getMetricKind(MetricId id)
+{
+    return isRegistered(id) ? g_metrics.infos[id].kind : MetricKind::Counter;
+}
+
+usize getMetricCount()
+{
+    return g_metrics.count.load(std::memory_order_acquire);
+}
+
+HistogramStats getHistogramStats(MetricId id)
+{
+    HistogramStats stats{};
+    if (!isRegistered(id) || g_metrics.infos[id].kind != MetricKind::Histogram) {
+        return stats;
+    }
+
+    std::lock_guard lock(g_metrics.mutex);
+    u32 slot = g_metrics.infos[id].histogramSlot;
+
+    f64 min = std::numeric_limits<f64>::infinity();
+    f64 max = -std::numeric_limits<f64>::infinity();
+    for (const auto& shard : g_metrics.shards) {
+        const auto& hist = shard->histograms[slot];
+        u64 count = hist.count.load(std::memory_order_relaxed);
+        if (count == 0) {
+            continue;
+        }
+        stats.count += count;
+        stats.sum += hist.sum.load(std::memory_order_relaxed);
+        min = std::min(min, hist.min.load(std::memory_order_relaxed));
+        max = std::max(max, hist.max.load(std::memory_order_relaxed));
+        for (usize i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+            stats.buckets[i] += hist.buckets[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    if (stats.count > 0) {
+        stats.min = min;
+        stats.max = max;
+    }
+    return stats;
+}
+
+// =============================================================================
+// Recording
+// =============================================================================
+
+void recordCounter(const char* name, i64 value)
+{
+    recordCounter(resolve(name, MetricKind::Counter), value);
+}
+
+void recordCounter(MetricId id, i64 value)
+{
+    if (!isRegistered(id) || g_metrics.infos[id].kind != MetricKind::Counter) {
+        return;
+    }
+    ownerAdd(localShard().counters[id], value);
+}
+
+void recordGauge(const char* name, f64 value)
+{
+    recordGauge(resolve(name, MetricKind::Gauge), value);
+}
+
+void recordGauge(MetricId id, f64 value)
+{
+    if (!isRegistered(id) || g_metrics.infos[id].kind != MetricKind::Gauge) {
+        return;
+    }
+    g_metrics.gauges[id].store(value, std::memory_order_relaxed);
+}
+
+void recordHistogram(const char* name, f64 value)
+{
+    recordHistogram(resolve(name, MetricKind::Histogram), value);
+}
+
+void recordHistogram(MetricId id, f64 value)
+{
+    if (!isRegistered(id) || g_metrics.infos[id].kind != MetricKind::Histogram) {
+        return;
+    }
+
+    auto& hist = localShard().histograms[g_metrics.infos[id].histogramSlot];
+    ownerAdd(hist.buckets[histogramBucketIndex(value)], u64{1});
+    ownerAdd(hist.count, u64{1});
+    ownerAdd(hist.sum, value);
+    if (value < hist.min.load(std::memory_order_relaxed)) {
+        hist.min.store(value, std::memory_order_relaxed);
+    }
+    if (value > hist.max.load(std::memory_order_relaxed)) {
+        hist.max.store(value, std::memory_order_relaxed);
+    }
+}
+
+// =============================================================================
+// Frame Folding
+// =============================================================================
+
+namespace detail {
+
+void collectFrameMetrics(std::vector<MetricSample>& out)
+{
+    out.clear();
+
+    std::lock_guard lock(g_metrics.mutex);
+    u32 count = g_metrics.count.load(std::memory_order_relaxed);
+    out.reserve(count);
+
+    for (MetricId id = 0; id < count; ++id) {
+        const auto& info = g_metrics.infos[id];
+        MetricSample sample{.id = id, .kind = info.kind};
+
+        switch (info.kind) {
+            case MetricKind::Counter: {
+                i64 total = 0;
+                for (const auto& shard : g_metrics.shards) {
+                    total += shard->counters[id].load(std::memory_order_relaxed);
+                }
+                sample.value = static_cast<f64>(total - g_metrics.counterBaselines[id]);
+                g_metrics.counterBaselines[id] = total;
+                break;
+            }
+            case MetricKind::Gauge:
+                sample.value = g_metrics.gauges[id].load(std::memory_order_relaxed);
+                break;
+            case MetricKind::Histogram: {
+                u32 slot = info.histogramSlot;
+                u64 total = 0;
+                f64 sum = 0.0;
+                for (const auto& shard : g_metrics.shards) {
+                    total += shard->histograms[slot].count.load(std::memory_order_relaxed);
+                    sum += shard->histograms[slot].sum.load(std::memory_order_relaxed);
+                }
+                sample.count = total - g_metrics.histogramCountBaselines[slot];
+                sample.value = sum - g_metrics.histogramSumBaselines[slot];
+                g_metrics.histogramCountBaselines[slot] = total;
+                g_metrics.histogramSumBaselines[slot] = sum;
+                break;
+            }
+        }
+
+        out.push_back(sample);
+    }
+}
+
+void resetMetricBaselines()
+{
+    std::vector<MetricSample> discard;
+    collectFrameMetrics(discard);
+}
+
+}  // namespace detail
+
+}  // namespace autophage
@@ -1,14 +1,25 @@
 /// @file profiler.cpp
 /// @brief Profiler implementation
 
+#include <autophage/core/frame_allocator.hpp>
 #include <autophage/core/logger.hpp>
 #include <autophage/core/memory.hpp>
+#include <autophage/core/platform.hpp>
+#include <autophage/profiler/access_tracking.hpp>
+#include <autophage/profiler/hardware_counters.hpp>
 #include <autophage/profiler/profiler.hpp>
+#include <autophage/profiler/sampling.hpp>
+#include <autophage/profiler/tick_clock.hpp>
+#include <autophage/profiler/trace.hpp>
 
 #include <algorithm>
+#include <array>
 #include <atomic>
+#include <cstdint>
+#include <deque>
 #include <mutex>
 #include <numeric>
+#include <unordered_map>
 
 namespace autophage {
 
@@ -21,21 +32,169 @@ namespace {
 struct ProfilerState
 {
     std::vector<FrameStats> frameHistory;
-    std::vector<ProfileZone> currentZones;
-    std::vector<TimePoint> zoneStartTimes;
 
     FrameStats currentFrame;
-    TimePoint frameStart;
+    i64 frameStartTicks = 0;
 
     std::atomic<FrameNumber> frameNumber{0};
     std::atomic<bool> initialized{false};
 
+    // Bumped on every beginFrame/init; threads lazily clear their zones when it changes
+    std::atomic<u64> zoneEpoch{0};
+
+    // Per-tag memory counters at the previous endFrame, for per-frame deltas
+    std::array<MemoryStats, MEMORY_TAG_COUNT> memoryBaseline{};
+
+    // Hardware counter values at beginFrame
+    HardwareCounterValues counterBaseline{};
+
     usize historySize = 300;
     std::mutex mutex;
 };
 
 ProfilerState g_profiler;
 
+// =============================================================================
+// Zone Descriptor Registry
+// =============================================================================
+
+struct ZoneRegistry
+{
+    std::mutex mutex;  // Serializes registration; lookups by id are lock-free
+    std::array<ZoneDescriptor, MAX_ZONE_DESCRIPTORS> descriptors;
+    std::unordered_map<u64, ZoneId> bySite;
+    std::deque<String> ownedNames;  // Storage for runtime-named zones (stable addresses)
+    std::atomic<usize> count{0};
+};
+
+ZoneRegistry g_zones;
+
+/// Returned by beginZone when no zone was opened
+constexpr u64 NO_ZONE_INDEX = ~u64{0};
+
+/// @brief Hot-path zone entry: descriptor id plus raw timestamps
+struct ZoneRecord
+{
+    i64 startTicks = 0;
+    i64 endTicks = 0;
+    ZoneId descriptor = INVALID_ZONE_ID;
+};
+
+/// @brief Zones recorded by one thread during the current frame
+struct ThreadZoneState
+{
+    std::vector<ZoneRecord> records;
+    std::vector<ProfileZone> zones;  // Expanded from records by getZones()
+    u64 epoch = ~u64{0};
+};
+
+thread_local ThreadZoneState t_zones;
+
+/// @brief Descriptor ids for zones opened by name, keyed by (name pointer, line)
+struct NamedZoneKeyHash
+{
+    usize operator()(const std::pair<const char*, u32>& key) const noexcept
+    {
+        return static_cast<usize>(
+            detail::hashCombine(reinterpret_cast<std::uintptr_t>(key.first), key.second));
+    }
+};
+
+thread_local std::unordered_map<std::pair<const char*, u32>, ZoneId, NamedZoneKeyHash>
+    t_namedZones;
+
+[[nodiscard]] u64 siteKey(const ZoneDescriptor& descriptor) noexcept
+{
+    u64 fileHash = descriptor.file ? detail::fnv1aHash(descriptor.file) : 0;
+    return detail::hashCombine(descriptor.nameHash,
+                               detail::hashCombine(fileHash, descriptor.line));
+}
+
+/// @brief Find or add a descriptor (caller holds g_zones.mutex)
+ZoneId registerZoneLocked(const ZoneDescriptor& descriptor)
+{
+    u64 key = siteKey(descriptor);
+    if (auto it = g_zones.bySite.find(key); it != g_zones.bySite.end()) {
+        return it->second;
+    }
+
+    usize count = g_zones.count.load(std::memory_order_relaxed);
+    if (count >= MAX_ZONE_DESCRIPTORS) AUTOPHAGE_UNLIKELY {
+        LOG_WARN("Zone descriptor limit ({}) reached, '{}' will not be profiled",
+                 MAX_ZONE_DESCRIPTORS, descriptor.name ? descriptor.name : "?");
+        return INVALID_ZONE_ID;
+    }
+
+    auto id = static_cast<ZoneId>(count);
+    g_zones.descriptors[id] = descriptor;
+    g_zones.bySite.emplace(key, id);
+    g_zones.count.store(count + 1, std::memory_order_release);
+    return id;
+}
+
+/// @brief Counter delta that tolerates resetMemoryStats() between snapshots
+[[nodiscard]] u64 counterDelta(u64 now, u64 before) noexcept
+{
+    return now >= before ? now - before : now;
+}
+
+/// @brief Fold allocations since the previous call into the frame and advance the baseline
+void collectFrameMemory(FrameStats& frame)
+{
+    frame.allocationCount = 0;
+    frame.deallocationCount = 0;
+    frame.allocatedBytes = 0;
+    frame.freedBytes = 0;
+
+    for (usize i = 0; i < MEMORY_TAG_COUNT; ++i) {
+        MemoryStats now = getMemoryStats(static_cast<MemoryTag>(i));
+        MemoryStats& before = g_profiler.memoryBaseline[i];
+
+        MemoryFrameStats& delta = frame.memoryByTag[i];
+        delta.allocations = counterDelta(now.totalAllocations, before.totalAllocations);
+        delta.deallocations = counterDelta(now.totalDeallocations, before.totalDeallocations);
+        delta.allocatedBytes = counterDelta(now.totalAllocatedBytes, before.totalAllocatedBytes);
+        delta.freedBytes = counterDelta(now.totalFreedBytes, before.totalFreedBytes);
+
+        frame.allocationCount += delta.allocations;
+        frame.deallocationCount += delta.deallocations;
+        frame.allocatedBytes += delta.allocatedBytes;
+        frame.freedBytes += delta.freedBytes;
+        before = now;
+    }
+}
+
+void snapshotMemoryBaseline()
+{
+    for (usize i = 0; i < MEMORY_TAG_COUNT; ++i) {
+        g_profiler.memoryBaseline[i] = getMemoryStats(static_cast<MemoryTag>(i));
+    }
+}
+
+[[nodiscard]] MemoryTag memoryTagFromName(const char* name) noexcept
+{
+    if (name) {
+        for (usize i = 0; i < MEMORY_TAG_COUNT; ++i) {
+            auto tag = static_cast<MemoryTag>(i);
+            if (toString(tag) == name) {
+                return tag;
+            }
+        }
+    }
+    return MemoryTag::Unknown;
+}
+
+ThreadZoneState& threadZones()
+{
+    u64 epoch = g_profiler.zoneEpoch.load(std::memory_order_relaxed);
+    if (t_zones.epoch != epoch) {
+        t_zones.records.clear();
+        t_zones.zones.clear();
+        t_zones.epoch = epoch;
+    }
+    return t_zones;
+}
+
 }  // namespace
 
 // =============================================================================
@@ -44,25 +203,32 @@ ProfilerState g_profiler;
 
 void initProfiler(usize historySize)
 {
+    calibrateTickClock();
+
     std::lock_guard lock(g_profiler.mutex);
 
     g_profiler.historySize = historySize;
     g_profiler.frameHistory.reserve(historySize);
-    g_profiler.currentZones.reserve(256);
-    g_profiler.zoneStartTimes.reserve(256);
     g_profiler.frameNumber.store(0, std::memory_order_relaxed);
+    g_profiler.zoneEpoch.fetch_add(1, std::memory_order_relaxed);
+    snapshotMemoryBaseline();
+    detail::resetMetricBaselines();
+    detail::resetFrameAccess();
     g_profiler.initialized.store(true, std::memory_order_release);
 
+    setProfilerThreadName("Main");
+
     LOG_INFO("Profiler initialized with history size: {}", historySize);
 }
 
 void shutdownProfiler()
 {
+    stopTraceCapture();
+
     std::lock_guard lock(g_profiler.mutex);
 
     g_profiler.frameHistory.clear();
-    g_profiler.currentZones.clear();
-    g_profiler.zoneStartTimes.clear();
+    g_profiler.zoneEpoch.fetch_add(1, std::memory_order_relaxed);
     g_profiler.initialized.store(false, std::memory_order_release);
 
     LOG_INFO("Profiler shut down");
@@ -74,15 +240,18 @@ void shutdownProfiler()
 
 void beginFrame()
 {
+    // Frame-allocated memory from two frames ago becomes reusable
+    advanceFrameAllocators();
+
     if (!g_profiler.initialized.load(std::memory_order_acquire)) {
         return;
     }
 
-    g_profiler.frameStart = Clock::now();
+    g_profiler.frameStartTicks = readTicks();
     g_profiler.currentFrame = FrameStats{};
     g_profiler.currentFrame.frameNumber = g_profiler.frameNumber.load(std::memory_order_relaxed);
-    g_profiler.currentZones.clear();
-    g_profiler.zoneStartTimes.clear();
+    g_profiler.zoneEpoch.fetch_add(1, std::memory_order_relaxed);
+    g_profiler.counterBaseline = readHardwareCounters();
 }
 
 void endFrame()
@@ -91,43 +260,37 @@ void endFrame()
         return;
     }
 
-    auto frameEnd = Clock::now();
-    g_profiler.currentFrame.totalTime =
-        std::chrono::duration_cast<Duration>(frameEnd - g_profiler.frameStart);
-
-    // Capture memory metrics from Core
-    auto memStats = getTotalMemoryStats();
-    g_profiler.currentFrame.memoryUsed = memStats.currentBytes;
-    g_profiler.currentFrame.allocationCount =
-        memStats.totalAllocations;  // Note: This is cumulative, should ideally be delta
-
-    // For now we just snapshot the totals, but FrameStats implies per-frame.
-    // To get per-frame deltas, we need to track them ourselves or store previous frame's total.
-    // Let's rely on recordAllocation for per-frame counts if we want them,
-    // OR we can make 'frameStats' store the snapshot.
-    // The struct says 'allocationCount', usually implies "this frame".
-    // Let's leave reading from Core for total memory usage, and use our internal counters for
-    // per-frame allocs.
-    g_profiler.currentFrame.memoryUsed = memStats.currentBytes;
-
-    // Capture CPU cycles
-    // Note: This is a timestamp counter, not necessarily strict execution cycles,
-    // but useful for relative cost.
-    // On Windows/MSVC, __rdtsc() is available via <intrin.h> (included via specialized headers or
-    // implicitly) We need to ensure we have the intrinsic.
-#ifdef AUTOPHAGE_PLATFORM_WINDOWS
-    g_profiler.currentFrame.cpuCycles = __rdtsc();
-#else
-    // Fallback for x86_64 non-Windows (GCC/Clang)
-    unsigned int lo, hi;
-    __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
-    g_profiler.currentFrame.cpuCycles = ((unsigned long long)hi << 32) | lo;
-#endif
-
-    // TODO: Hardware counters for Cache/Branch are complex on Windows (require ETW/Drivers).
-    // We leave them as 0 for now or integrate a library later.
-    g_profiler.currentFrame.cacheMisses = 0;
-    g_profiler.currentFrame.branchMispredictions = 0;
+    i64 frameEndTicks = readTicks();
+    i64 frameTicks = frameEndTicks - g_profiler.frameStartTicks;
+    g_profiler.currentFrame.totalTime = ticksToDuration(frameTicks);
+    g_profiler.currentFrame.cpuCycles = static_cast<u64>(frameTicks);
+
+    // Memory usage is a snapshot; allocation counts are deltas since the previous frame
+    g_profiler.currentFrame.memoryUsed = getTotalMemoryStats().currentBytes;
+    collectFrameMemory(g_profiler.currentFrame);
+
+    // Hardware counters stay 0 unless enableHardwareCounters() opened them
+    HardwareCounterValues counters = readHardwareCounters();
+    const HardwareCounterValues& baseline = g_profiler.counterBaseline;
+    g_profiler.currentFrame.cacheMisses = counterDelta(counters.cacheMisses, baseline.cacheMisses);
+    g_profiler.currentFrame.branchMispredictions =
+        counterDelta(counters.branchMispredictions, baseline.branchMispredictions);
+    g_profiler.currentFrame.dtlbMisses = counterDelta(counters.dtlbMisses, baseline.dtlbMisses);
+
+    // Fold named metrics so they line up with this frame's timings
+    detail::collectFrameMetrics(g_profiler.currentFrame.metrics);
+    detail::collectFrameAccess();
+
+    if (isTraceCaptureActive()) {
+        detail::traceFrame(g_profiler.currentFrame.frameNumber, g_profiler.frameStartTicks,
+                           frameEndTicks);
+        for (const auto& sample : g_profiler.currentFrame.metrics) {
+            if (sample.kind != MetricKind::Histogram) {
+                detail::traceCounter(getMetricName(sample.id).data(), frameEndTicks,
+                                     sample.value);
+            }
+        }
+    }
 
     // Add to history
     {
@@ -191,13 +354,16 @@ ProfilerStats getProfilerStats()
     // Aggregate hardware metrics
     u64 totalMisses = 0;
     u64 totalBranchMisses = 0;
+    u64 totalTlbMisses = 0;
     for (const auto& frame : history) {
         totalMisses += frame.cacheMisses;
         totalBranchMisses += frame.branchMispredictions;
+        totalTlbMisses += frame.dtlbMisses;
     }
     stats.avgCacheMisses = static_cast<f64>(totalMisses) / static_cast<f64>(history.size());
     stats.avgBranchMispredictions =
         static_cast<f64>(totalBranchMisses) / static_cast<f64>(history.size());
+    stats.avgDtlbMisses = static_cast<f64>(totalTlbMisses) / static_cast<f64>(history.size());
 
     // Calculate percentiles
     std::vector<Duration> sortedTimes;
@@ -245,73 +411,152 @@ void resetProfilerStats()
 // Zone Management
 // =============================================================================
 
-u64 beginZone(const char* name, const char* file, u32 line)
+u64 beginZone(ZoneId descriptor)
 {
-    if (!g_profiler.initialized.load(std::memory_order_acquire)) {
-        return 0;
+    i64 startTicks = readTicks();
+    if (!g_profiler.initialized.load(std::memory_order_acquire) ||
+        descriptor >= g_zones.count.load(std::memory_order_acquire)) {
+        return NO_ZONE_INDEX;
     }
 
-    u64 zoneId = g_profiler.currentZones.size();
+    auto& state = threadZones();
+    u64 zoneId = state.records.size();
+    state.records.push_back({.startTicks = startTicks, .endTicks = 0, .descriptor = descriptor});
+    detail::pushSampleZone(g_zones.descriptors[descriptor].name);
 
-    ProfileZone zone{};
-    zone.id = zoneId;
-    zone.name = name;
-    zone.file = file;
-    zone.line = line;
-    zone.callCount = 1;
+    return zoneId;
+}
 
-    g_profiler.currentZones.push_back(zone);
-    g_profiler.zoneStartTimes.push_back(Clock::now());
+u64 beginZone(const char* name, const char* file, u32 line)
+{
+    if (!g_profiler.initialized.load(std::memory_order_acquire)) {
+        return NO_ZONE_INDEX;
+    }
 
-    return zoneId;
+    auto [it, inserted] = t_namedZones.try_emplace({name, line}, INVALID_ZONE_ID);
+    if (inserted) {
+        it->second = registerZone(ZoneDescriptor(name, file, line));
+    }
+    return beginZone(it->second);
 }
 
 void endZone(u64 zoneId)
 {
-    if (!g_profiler.initialized.load(std::memory_order_acquire)) {
+    i64 endTicks = readTicks();
+    if (zoneId == NO_ZONE_INDEX) {
         return;
     }
 
-    if (zoneId >= g_profiler.currentZones.size()) {
+    detail::popSampleZone();
+
+    auto& state = threadZones();
+    if (zoneId >= state.records.size()) {
         return;
     }
 
-    auto endTime = Clock::now();
-    auto& zone = g_profiler.currentZones[zoneId];
-    auto startTime = g_profiler.zoneStartTimes[zoneId];
+    auto& record = state.records[zoneId];
+    record.endTicks = endTicks;
 
-    zone.totalTime = std::chrono::duration_cast<Duration>(endTime - startTime);
-    zone.selfTime = zone.totalTime;  // TODO: Subtract child zones
+    if (isTraceCaptureActive()) {
+        detail::traceZone(g_zones.descriptors[record.descriptor].name, record.startTicks,
+                          endTicks);
+    }
 }
 
 const std::vector<ProfileZone>& getZones()
 {
-    return g_profiler.currentZones;
+    auto& state = threadZones();
+
+    state.zones.resize(state.records.size());
+    for (usize i = 0; i < state.records.size(); ++i) {
+        const auto& record = state.records[i];
+        const auto& descriptor = g_zones.descriptors[record.descriptor];
+
+        ProfileZone& zone = state.zones[i];
+        zone.id = i;
+        zone.descriptor = record.descriptor;
+        zone.name = descriptor.name;
+        zone.file = descriptor.file;
+        zone.line = descriptor.line;
+        zone.callCount = 1;
+        zone.totalTime = record.endTicks != 0 ? ticksToDuration(record.endTicks - record.startTicks)
+                                              : Duration{0};
+        zone.selfTime = zone.totalTime;  // TODO: Subtract child zones
+    }
+    return state.zones;
 }
 
 // =============================================================================
-// Metric Recording
+// Zone Descriptors
 // =============================================================================
 
-void recordCounter(const char* /*name*/, i64 /*value*/)
+ZoneId registerZone(const ZoneDescriptor& descriptor)
+{
+    std::lock_guard lock(g_zones.mutex);
+    return registerZoneLocked(descriptor);
+}
+
+ZoneId registerZone(StringView name)
+{
+    String owned(name);
+    ZoneDescriptor descriptor(owned.c_str(), nullptr, 0);
+
+    std::lock_guard lock(g_zones.mutex);
+    if (auto it = g_zones.bySite.find(siteKey(descriptor)); it != g_zones.bySite.end()) {
+        return it->second;
+    }
+    descriptor.name = g_zones.ownedNames.emplace_back(std::move(owned)).c_str();
+    return registerZoneLocked(descriptor);
+}
+
+const ZoneDescriptor* getZoneDescriptor(ZoneId id) noexcept
+{
+    return id < g_zones.count.load(std::memory_order_acquire) ? &g_zones.descriptors[id] : nullptr;
+}
+
+ZoneId findZone(u64 nameHash) noexcept
 {
-    // TODO: Implement counter tracking
+    usize count = g_zones.count.load(std::memory_order_acquire);
+    for (usize i = 0; i < count; ++i) {
+        if (g_zones.descriptors[i].nameHash == nameHash) {
+            return static_cast<ZoneId>(i);
+        }
+    }
+    return INVALID_ZONE_ID;
+}
+
+usize getZoneDescriptorCount() noexcept
+{
+    return g_zones.count.load(std::memory_order_acquire);
 }
 
-void recordGauge(const char* /*name*/, f64 /*value*/)
+// =============================================================================
+// Metric Recording
+// =============================================================================
+
+std::vector<f64> getMetricHistory(MetricId id)
 {
-    // TODO: Implement gauge tracking
+    std::lock_guard lock(g_profiler.mutex);
+
+    std::vector<f64> values;
+    values.reserve(g_profiler.frameHistory.size());
+    for (const auto& frame : g_profiler.frameHistory) {
+        // Samples are folded in MetricId order, so the ID doubles as the index
+        bool present = id < frame.metrics.size() && frame.metrics[id].id == id;
+        values.push_back(present ? frame.metrics[id].value : 0.0);
+    }
+    return values;
 }
 
-void recordAllocation(usize /*bytes*/, const char* /*tag*/)
+void recordAllocation(usize bytes, const char* tag)
 {
-    // g_profiler.currentFrame.memoryUsed is updated from Core at endFrame
-    g_profiler.currentFrame.allocationCount++;
+    // Folded into the frame's allocation deltas at endFrame
+    trackAllocation(memoryTagFromName(tag), bytes);
 }
 
-void recordDeallocation(usize /*bytes*/, const char* /*tag*/)
+void recordDeallocation(usize bytes, const char* tag)
 {
-    g_profiler.currentFrame.deallocationCount++;
+    trackDeallocation(memoryTagFromName(tag), bytes);
 }
 
 }  // namespace autophage
@@ -0,0 +1,649 @@
+/// @file sampling.cpp
+/// @brief Signal-based sampling profiler implementation
+///
+/// Each registered thread owns a preallocated single-producer/single-consumer ring. The SIGPROF
+/// handler runs on the sampled thread, so it is the only producer and must stay
+/// async-signal-safe: no locks, no allocation, no errno clobbering. A background thread folds
+/// raw address stacks into a hash map; symbolization only happens when a report is requested.
+
+#include <autophage/core/logger.hpp>
+#include <autophage/core/platform.hpp>
+#include <autophage/profiler/sampling.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(AUTOPHAGE_PLATFORM_LINUX)
+    #include <cerrno>
+    #include <csignal>
+    #include <ctime>
+    #include <cxxabi.h>
+    #include <dlfcn.h>
+    #include <pthread.h>
+    #include <sys/syscall.h>
+    #include <ucontext.h>
+    #include <unistd.h>
+
+    // Not exposed by older glibc headers
+    #ifndef sigev_notify_thread_id
+        #define sigev_notify_thread_id _sigev_un._tid
+    #endif
+#endif
+
+namespace autophage {
+
+namespace {
+
+constexpr u32 MAX_ZONE_DEPTH = 64;
+
+/// @brief Innermost zones of this thread, read from the signal handler
+thread_local const char* t_zoneStack[MAX_ZONE_DEPTH];
+thread_local volatile u32 t_zoneDepth = 0;
+
+}  // namespace
+
+namespace detail {
+
+void pushSampleZone(const char* name) noexcept
+{
+    u32 depth = t_zoneDepth;
+    if (depth < MAX_ZONE_DEPTH) {
+        t_zoneStack[depth] = name;
+    }
+    std::atomic_signal_fence(std::memory_order_release);
+    t_zoneDepth = depth + 1;
+}
+
+void popSampleZone() noexcept
+{
+    u32 depth = t_zoneDepth;
+    if (depth > 0) {
+        t_zoneDepth = depth - 1;
+    }
+}
+
+}  // namespace detail
+
+#if defined(AUTOPHAGE_PLATFORM_LINUX)
+
+namespace {
+
+constexpr const char* NO_ZONE = "<no zone>";
+
+// =============================================================================
+// Sample Ring
+// =============================================================================
+
+struct RawSample
+{
+    const char* zone = nullptr;
+    u32 depth = 0;
+    std::uintptr_t frames[MAX_SAMPLE_DEPTH];
+};
+
+/// @brief Bounded SPSC ring (producer: signal handler, consumer: drain thread)
+class SampleRing
+{
+public:
+    /// @brief Allocate storage (only while no timer targets the owning thread)
+    void resize(usize capacity)
+    {
+        samples_ = std::make_unique<RawSample[]>(std::bit_ceil(std::max<usize>(capacity, 2)));
+        mask_ = std::bit_ceil(std::max<usize>(capacity, 2)) - 1;
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] usize capacity() const noexcept { return samples_ ? mask_ + 1 : 0; }
+
+    /// @brief Slot for the next sample, or nullptr if full (producer side)
+    [[nodiscard]] RawSample* reserve() noexcept
+    {
+        u64 head = head_.load(std::memory_order_relaxed);
+        if (!samples_ || head - tail_.load(std::memory_order_acquire) > mask_) {
+            return nullptr;
+        }
+        return &samples_[head & mask_];
+    }
+
+    /// @brief Publish the slot returned by reserve() (producer side)
+    void commit() noexcept
+    {
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /// @brief Consume all pending samples (consumer side)
+    template <typename Func> usize drain(Func&& func)
+    {
+        u64 head = head_.load(std::memory_order_acquire);
+        u64 tail = tail_.load(std::memory_order_relaxed);
+        for (u64 i = tail; i < head; ++i) {
+            func(samples_[i & mask_]);
+        }
+        tail_.store(head, std::memory_order_release);
+        return static_cast<usize>(head - tail);
+    }
+
+private:
+    std::unique_ptr<RawSample[]> samples_;
+    usize mask_ = 0;
+    AUTOPHAGE_CACHE_ALIGNED std::atomic<u64> head_{0};
+    AUTOPHAGE_CACHE_ALIGNED std::atomic<u64> tail_{0};
+};
+
+struct ThreadSampleBuffer
+{
+    pid_t tid = 0;
+    pthread_t thread{};
+    std::uintptr_t stackLow = 0;
+    std::uintptr_t stackHigh = 0;
+
+    SampleRing ring;
+    std::atomic<u64> dropped{0};
+    u64 droppedAtStart = 0;
+
+    timer_t timer{};
+    bool timerArmed = false;
+    bool exited = false;
+};
+
+// =============================================================================
+// Aggregation
+// =============================================================================
+
+/// @brief Raw stack key: zone pointer followed by leaf-first return addresses
+using StackKey = std::vector<std::uintptr_t>;
+
+struct StackKeyHash
+{
+    usize operator()(const StackKey& key) const noexcept
+    {
+        u64 hash = 14695981039346656037ull;
+        for (std::uintptr_t value : key) {
+            hash = (hash ^ static_cast<u64>(value)) * 1099511628211ull;
+        }
+        return static_cast<usize>(hash);
+    }
+};
+
+// =============================================================================
+// Sampling State
+// =============================================================================
+
+struct SamplingState
+{
+    std::mutex mutex;  // Guards buffers, stacks, stats and config
+    std::vector<std::unique_ptr<ThreadSampleBuffer>> buffers;
+    std::unordered_map<StackKey, u64, StackKeyHash> stacks;
+    u64 totalSamples = 0;
+    u64 droppedSamples = 0;
+    SamplingConfig config;
+    bool handlerInstalled = false;
+
+    std::atomic<bool> active{false};
+    std::atomic<u32> maxDepth{MAX_SAMPLE_DEPTH};
+
+    std::thread drainer;
+    std::mutex drainMutex;
+    std::condition_variable drainSignal;
+    bool stopRequested = false;
+};
+
+SamplingState g_sampling;
+
+thread_local ThreadSampleBuffer* t_sampleBuffer = nullptr;
+
+// =============================================================================
+// Signal Handler
+// =============================================================================
+
+u32 captureStack(const ucontext_t& context, const ThreadSampleBuffer& buffer,
+                 std::uintptr_t* frames, u32 maxDepth) noexcept
+{
+    #if defined(AUTOPHAGE_ARCH_X64)
+    auto pc = static_cast<std::uintptr_t>(context.uc_mcontext.gregs[REG_RIP]);
+    auto fp = static_cast<std::uintptr_t>(context.uc_mcontext.gregs[REG_RBP]);
+    #elif defined(AUTOPHAGE_ARCH_ARM64)
+    auto pc = static_cast<std::uintptr_t>(context.uc_mcontext.pc);
+    auto fp = static_cast<std::uintptr_t>(context.uc_mcontext.regs[29]);
+    #else
+    std::uintptr_t pc = 0;
+    std::uintptr_t fp = 0;
+    #endif
+
+    u32 depth = 0;
+    frames[depth++] = pc;
+
+    // Walk the frame-pointer chain, trusting only frames inside this thread's stack
+    while (depth < maxDepth && buffer.stackHigh != 0) {
+        if (fp < buffer.stackLow || fp > buffer.stackHigh - 2 * sizeof(std::uintptr_t) ||
+            fp % alignof(std::uintptr_t) != 0) {
+            break;
+        }
+        const auto* frame = reinterpret_cast<const std::uintptr_t*>(fp);
+        std::uintptr_t next = frame[0];
+        std::uintptr_t returnAddress = frame[1];
+        if (returnAddress == 0) {
+            break;
+        }
+        frames[depth++] = returnAddress;
+        if (next <= fp) {
+            break;
+        }
+        fp = next;
+    }
+    return depth;
+}
+
+void onSigprof(int /*signal*/, siginfo_t* /*info*/, void* context)
+{
+    int savedErrno = errno;
+
+    ThreadSampleBuffer* buffer = t_sampleBuffer;
+    if (buffer && g_sampling.active.load(std::memory_order_relaxed)) {
+        if (RawSample* sample = buffer->ring.reserve()) {
+            std::atomic_signal_fence(std::memory_order_acquire);
+            u32 zoneDepth = t_zoneDepth;
+            sample->zone = zoneDepth == 0 ? nullptr
+                                          : t_zoneStack[std::min(zoneDepth, MAX_ZONE_DEPTH) - 1];
+            sample->depth = captureStack(*static_cast<const ucontext_t*>(context), *buffer,
+                                         sample->frames,
+                                         g_sampling.maxDepth.load(std::memory_order_relaxed));
+            buffer->ring.commit();
+        } else {
+            buffer->dropped.store(buffer->dropped.load(std::memory_order_relaxed) + 1,
+                                  std::memory_order_relaxed);
+        }
+    }
+
+    errno = savedErrno;
+}
+
+/// @brief Install the SIGPROF handler once
+/// @note It is never removed: a signal still pending after a timer is deleted must not hit the
+///       default action, which terminates the process.
+bool installHandlerLocked()
+{
+    if (g_sampling.handlerInstalled) {
+        return true;
+    }
+    struct sigaction action{};
+    action.sa_sigaction = onSigprof;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, nullptr) != 0) {
+        return false;
+    }
+    g_sampling.handlerInstalled = true;
+    return true;
+}
+
+// =============================================================================
+// Timers
+// =============================================================================
+
+bool armTimerLocked(ThreadSampleBuffer& buffer)
+{
+    if (buffer.timerArmed || buffer.exited) {
+        return true;
+    }
+
+    // Sample on the target thread's CPU clock so idle threads cost nothing
+    clockid_t clock{};
+    if (pthread_getcpuclockid(buffer.thread, &clock) != 0) {
+        return false;
+    }
+
+    sigevent event{};
+    event.sigev_notify = SIGEV_THREAD_ID;
+    event.sigev_signo = SIGPROF;
+    event.sigev_notify_thread_id = buffer.tid;
+    if (timer_create(clock, &event, &buffer.timer) != 0) {
+        return false;
+    }
+
+    u64 intervalNs = 1'000'000'000ull / std::max<u32>(g_sampling.config.frequencyHz, 1);
+    itimerspec spec{};
+    spec.it_interval.tv_sec = static_cast<time_t>(intervalNs / 1'000'000'000ull);
+    spec.it_interval.tv_nsec = static_cast<long>(intervalNs % 1'000'000'000ull);
+    spec.it_value = spec.it_interval;
+    if (timer_settime(buffer.timer, 0, &spec, nullptr) != 0) {
+        timer_delete(buffer.timer);
+        return false;
+    }
+
+    buffer.timerArmed = true;
+    return true;
+}
+
+void disarmTimerLocked(ThreadSampleBuffer& buffer)
+{
+    if (buffer.timerArmed) {
+        timer_delete(buffer.timer);
+        buffer.timerArmed = false;
+    }
+}
+
+// =============================================================================
+// Draining
+// =============================================================================
+
+/// @brief Fold every ring into the aggregate (caller holds g_sampling.mutex)
+void drainLocked()
+{
+    StackKey key;
+    for (auto& buffer : g_sampling.buffers) {
+        g_sampling.totalSamples += buffer->ring.drain([&](const RawSample& sample) {
+            key.assign(1, reinterpret_cast<std::uintptr_t>(sample.zone));
+            key.insert(key.end(), sample.frames, sample.frames + sample.depth);
+            ++g_sampling.stacks[key];
+        });
+    }
+}
+
+void drainLoop()
+{
+    std::unique_lock lock(g_sampling.drainMutex);
+    while (!g_sampling.stopRequested) {
+        g_sampling.drainSignal.wait_for(lock, g_sampling.config.drainInterval,
+                                        [] { return g_sampling.stopRequested; });
+        lock.unlock();
+        {
+            std::lock_guard stateLock(g_sampling.mutex);
+            drainLocked();
+        }
+        lock.lock();
+    }
+}
+
+/// @brief Unregisters the owning thread on exit
+struct SamplingThreadGuard
+{
+    ~SamplingThreadGuard()
+    {
+        if (!t_sampleBuffer) {
+            return;
+        }
+        std::lock_guard lock(g_sampling.mutex);
+        disarmTimerLocked(*t_sampleBuffer);
+        t_sampleBuffer->exited = true;
+        t_sampleBuffer = nullptr;
+    }
+};
+
+void registerThreadLocked()
+{
+    auto buffer = std::make_unique<ThreadSampleBuffer>();
+    buffer->tid = static_cast<pid_t>(syscall(SYS_gettid));
+    buffer->thread = pthread_self();
+
+    pthread_attr_t attr;
+    if (pthread_getattr_np(buffer->thread, &attr) == 0) {
+        void* stackAddr = nullptr;
+        usize stackSize = 0;
+        if (pthread_attr_getstack(&attr, &stackAddr, &stackSize) == 0) {
+            buffer->stackLow = reinterpret_cast<std::uintptr_t>(stackAddr);
+            buffer->stackHigh = buffer->stackLow + stackSize;
+        }
+        pthread_attr_destroy(&attr);
+    }
+
+    buffer->ring.resize(g_sampling.config.samplesPerThread);
+    t_sampleBuffer = buffer.get();
+    g_sampling.buffers.push_back(std::move(buffer));
+}
+
+}  // namespace
+
+// =============================================================================
+// Symbolization
+// =============================================================================
+
+namespace detail {
+
+String symbolizeAddress(std::uintptr_t address)
+{
+    char text[64];
+    Dl_info info{};
+    if (dladdr(reinterpret_cast<void*>(address), &info) != 0) {
+        if (info.dli_sname) {
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            String name = status == 0 && demangled ? demangled : info.dli_sname;
+            std::free(demangled);
+            return name;
+        }
+        if (info.dli_fname) {
+            String module = info.dli_fname;
+            if (auto slash = module.find_last_of('/'); slash != String::npos) {
+                module.erase(0, slash + 1);
+            }
+            std::snprintf(text, sizeof(text), "+0x%llx",
+                          static_cast<unsigned long long>(
+                              address - reinterpret_cast<std::uintptr_t>(info.dli_fbase)));
+            return module + text;
+        }
+    }
+    std::snprintf(text, sizeof(text), "0x%llx", static_cast<unsigned long long>(address));
+    return text;
+}
+
+}  // namespace detail
+
+// =============================================================================
+// Sampling Control
+// =============================================================================
+
+bool startSamplingProfiler(const SamplingConfig& config)
+{
+    std::lock_guard lock(g_sampling.mutex);
+
+    if (g_sampling.active.load(std::memory_order_acquire)) {
+        LOG_WARN("Sampling profiler already running");
+        return false;
+    }
+    if (!installHandlerLocked()) {
+        LOG_ERROR("Failed to install SIGPROF handler");
+        return false;
+    }
+
+    g_sampling.config = config;
+    g_sampling.maxDepth.store(std::clamp<u32>(config.maxDepth, 1, MAX_SAMPLE_DEPTH),
+                              std::memory_order_relaxed);
+    g_sampling.stacks.clear();
+    g_sampling.totalSamples = 0;
+    g_sampling.droppedSamples = 0;
+
+    // No timers are armed here, so rings can be resized safely
+    std::erase_if(g_sampling.buffers, [](const auto& buffer) { return buffer->exited; });
+    for (auto& buffer : g_sampling.buffers) {
+        if (buffer->ring.capacity() != std::bit_ceil(std::max<usize>(config.samplesPerThread, 2))) {
+            buffer->ring.resize(config.samplesPerThread);
+        } else {
+            buffer->ring.drain([](const RawSample&) {});
+        }
+        buffer->droppedAtStart = buffer->dropped.load(std::memory_order_relaxed);
+    }
+
+    if (!t_sampleBuffer) {
+        thread_local SamplingThreadGuard guard;
+        registerThreadLocked();
+    }
+
+    g_sampling.active.store(true, std::memory_order_release);
+    for (auto& buffer : g_sampling.buffers) {
+        if (!armTimerLocked(*buffer)) {
+            LOG_WARN("Failed to arm sampling timer for thread {}", buffer->tid);
+        }
+    }
+
+    g_sampling.stopRequested = false;
+    g_sampling.drainer = std::thread(drainLoop);
+
+    LOG_INFO("Sampling profiler started at {} Hz", config.frequencyHz);
+    return true;
+}
+
+void stopSamplingProfiler()
+{
+    {
+        std::lock_guard lock(g_sampling.mutex);
+        if (!g_sampling.active.exchange(false, std::memory_order_acq_rel)) {
+            return;
+        }
+        for (auto& buffer : g_sampling.buffers) {
+            disarmTimerLocked(*buffer);
+        }
+    }
+
+    {
+        std::lock_guard lock(g_sampling.drainMutex);
+        g_sampling.stopRequested = true;
+    }
+    g_sampling.drainSignal.notify_one();
+    g_sampling.drainer.join();
+
+    std::lock_guard lock(g_sampling.mutex);
+    drainLocked();
+    for (const auto& buffer : g_sampling.buffers) {
+        g_sampling.droppedSamples +=
+            buffer->dropped.load(std::memory_order_relaxed) - buffer->droppedAtStart;
+    }
+
+    LOG_INFO("Sampling profiler stopped: {} samples, {} dropped", g_sampling.totalSamples,
+             g_sampling.droppedSamples);
+}
+
+bool isSamplingProfilerActive() noexcept
+{
+    return g_sampling.active.load(std::memory_order_relaxed);
+}
+
+void registerSamplingThread()
+{
+    if (t_sampleBuffer) {
+        return;
+    }
+    thread_local SamplingThreadGuard guard;
+
+    std::lock_guard lock(g_sampling.mutex);
+    registerThreadLocked();
+    if (g_sampling.active.load(std::memory_order_relaxed) && !armTimerLocked(*t_sampleBuffer)) {
+        LOG_WARN("Failed to arm sampling timer for thread {}", t_sampleBuffer->tid);
+    }
+}
+
+SamplingReport getSamplingReport()
+{
+    std::lock_guard lock(g_sampling.mutex);
+    drainLocked();
+
+    SamplingReport report;
+    report.totalSamples = g_sampling.totalSamples;
+    report.droppedSamples = g_sampling.droppedSamples;
+    if (g_sampling.active.load(std::memory_order_relaxed)) {
+        for (const auto& buffer : g_sampling.buffers) {
+            report.droppedSamples +=
+                buffer->dropped.load(std::memory_order_relaxed) - buffer->droppedAtStart;
+        }
+    }
+
+    std::unordered_map<std::uintptr_t, String> symbols;
+    std::unordered_map<String, u64> folded;
+    std::unordered_map<String, u64> zones;
+
+    String line;
+    for (const auto& [key, count] : g_sampling.stacks) {
+        const auto* zone = reinterpret_cast<const char*>(key[0]);
+        line = zone ? zone : NO_ZONE;
+        zones[line] += count;
+
+        // Keys are leaf-first; flamegraphs want root-first
+        for (usize i = key.size(); i-- > 1;) {
+            auto [it, inserted] = symbols.try_emplace(key[i]);
+            if (inserted) {
+                it->second = detail::symbolizeAddress(key[i]);
+                std::replace(it->second.begin(), it->second.end(), ';', ':');
+            }
+            line += ';';
+            line += it->second;
+        }
+        folded[line] += count;
+    }
+
+    for (auto& [zone, count] : zones) {
+        report.zones.push_back({zone, count});
+    }
+    for (auto& [stack, count] : folded) {
+        report.stacks.push_back({stack, count});
+    }
+    std::sort(report.zones.begin(), report.zones.end(),
+              [](const auto& a, const auto& b) { return a.count > b.count; });
+    std::sort(report.stacks.begin(), report.stacks.end(),
+              [](const auto& a, const auto& b) { return a.count > b.count; });
+    return report;
+}
+
+#else  // !AUTOPHAGE_PLATFORM_LINUX
+
+bool startSamplingProfiler(const SamplingConfig& /*config*/)
+{
+    LOG_WARN("Sampling profiler is not supported on {}", AUTOPHAGE_PLATFORM_NAME);
+    return false;
+}
+
+void stopSamplingProfiler() {}
+
+bool isSamplingProfilerActive() noexcept
+{
+    return false;
+}
+
+void registerSamplingThread() {}
+
+SamplingReport getSamplingReport()
+{
+    return {};
+}
+
+namespace detail {
+
+String symbolizeAddress(std::uintptr_t address)
+{
+    char text[32];
+    std::snprintf(text, sizeof(text), "0x%llx", static_cast<unsigned long long>(address));
+    return text;
+}
+
+}  // namespace detail
+
+#endif
+
+bool writeFoldedStacks(const String& path)
+{
+    SamplingReport report = getSamplingReport();
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        LOG_ERROR("Failed to open folded stack file: {}", path);
+        return false;
+    }
+    for (const auto& stack : report.stacks) {
+        std::fprintf(file, "%s %llu\n", stack.stack.c_str(),
+                     static_cast<unsigned long long>(stack.count));
+    }
+    std::fclose(file);
+    return true;
+}
+
+}  // namespace autophage
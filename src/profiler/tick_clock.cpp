@@ -0,0 +1,107 @@
+/// @file tick_clock.cpp
+/// @brief Tick clock calibration
+
+#include <autophage/core/logger.hpp>
+#include <autophage/profiler/tick_clock.hpp>
+
+#include <mutex>
+
+#if (defined(AUTOPHAGE_ARCH_X64) || defined(AUTOPHAGE_ARCH_X86)) && \
+    !defined(AUTOPHAGE_COMPILER_MSVC)
+    #include <cpuid.h>
+#endif
+
+namespace autophage {
+
+namespace {
+
+constexpr auto CALIBRATION_WINDOW = std::chrono::milliseconds(10);
+
+std::once_flag g_calibrationOnce;
+std::atomic<bool> g_invariant{true};
+
+[[nodiscard]] bool detectInvariantCounter() noexcept
+{
+#if defined(AUTOPHAGE_ARCH_X64) || defined(AUTOPHAGE_ARCH_X86)
+    // CPUID.80000007H:EDX[8] - invariant TSC
+    #if defined(AUTOPHAGE_COMPILER_MSVC)
+    int regs[4] = {};
+    __cpuid(regs, static_cast<int>(0x80000000u));
+    if (static_cast<unsigned>(regs[0]) < 0x80000007u) {
+        return false;
+    }
+    __cpuid(regs, static_cast<int>(0x80000007u));
+    return (static_cast<unsigned>(regs[3]) & (1u << 8)) != 0;
+    #else
+    unsigned eax = 0;
+    unsigned ebx = 0;
+    unsigned ecx = 0;
+    unsigned edx = 0;
+    if (__get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx) == 0) {
+        return false;
+    }
+    return (edx & (1u << 8)) != 0;
+    #endif
+#else
+    // The ARM generic timer (and the steady_clock fallback) run at a fixed frequency
+    return true;
+#endif
+}
+
+void calibrate()
+{
+    g_invariant.store(detectInvariantCounter(), std::memory_order_relaxed);
+
+#if defined(AUTOPHAGE_ARCH_X64) || defined(AUTOPHAGE_ARCH_X86)
+    // A TSC that follows frequency scaling cannot be converted with one rate
+    if (!g_invariant.load(std::memory_order_relaxed)) {
+        LOG_WARN("TSC is not invariant, profiler timestamps use steady_clock");
+        return;
+    }
+#endif
+
+#if defined(AUTOPHAGE_ARCH_X64) || defined(AUTOPHAGE_ARCH_X86) || defined(AUTOPHAGE_ARCH_ARM64)
+    using SteadyClock = std::chrono::steady_clock;
+
+    // Spin rather than sleep so the window is not stretched by scheduler wakeup latency
+    auto wallStart = SteadyClock::now();
+    i64 tickStart = detail::readCounter();
+    auto wallEnd = wallStart;
+    do {
+        wallEnd = SteadyClock::now();
+    } while (wallEnd - wallStart < CALIBRATION_WINDOW);
+    i64 tickEnd = detail::readCounter();
+
+    auto elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(wallEnd - wallStart);
+    if (tickEnd <= tickStart) {
+        LOG_WARN("CPU counter did not advance, profiler timestamps use steady_clock");
+        return;
+    }
+    // The rate must be visible before any reader sees counter ticks
+    detail::g_nanosecondsPerTick.store(
+        static_cast<f64>(elapsedNs.count()) / static_cast<f64>(tickEnd - tickStart),
+        std::memory_order_relaxed);
+    detail::g_hardwareTicks.store(true, std::memory_order_release);
+#endif
+
+    LOG_INFO("Tick clock calibrated: {:.3f} MHz", getTicksPerSecond() / 1e6);
+}
+
+}  // namespace
+
+void calibrateTickClock()
+{
+    std::call_once(g_calibrationOnce, calibrate);
+}
+
+bool isTickClockInvariant() noexcept
+{
+    return g_invariant.load(std::memory_order_relaxed);
+}
+
+f64 getTicksPerSecond() noexcept
+{
+    return 1e9 / getNanosecondsPerTick();
+}
+
+}  // namespace autophage
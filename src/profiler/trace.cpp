@@ -0,0 +1,720 @@
+/// @file trace.cpp
+/// @brief Streaming trace capture implementation
+///
+/// Every recording thread owns a single-producer/single-consumer ring. Producers never lock or
+/// block: a full ring drops the event and bumps a counter. A background thread drains all rings
+/// on a fixed interval, formats the events and writes them with large buffered writes.
+
+#include <autophage/core/logger.hpp>
+#include <autophage/core/platform.hpp>
+#include <autophage/profiler/binary_trace.hpp>
+#include <autophage/profiler/tick_clock.hpp>
+#include <autophage/profiler/trace.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace autophage {
+
+namespace {
+
+// =============================================================================
+// Event Ring
+// =============================================================================
+
+enum class TraceEventType : u8
+{
+    Zone,
+    Frame,
+    Counter,
+};
+
+struct TraceEvent
+{
+    TraceEventType type = TraceEventType::Zone;
+    const char* name = nullptr;
+    i64 start = 0;
+    i64 end = 0;
+    f64 value = 0.0;
+};
+
+/// @brief Bounded SPSC ring (producer: owning thread, consumer: flush thread)
+class TraceRing
+{
+public:
+    /// @brief Push an event (producer side)
+    /// @return false if the ring is full
+    bool push(const TraceEvent& event, usize capacity) noexcept
+    {
+        u64 head = head_.load(std::memory_order_relaxed);
+        if (capacity != capacity_ || events_.empty()) AUTOPHAGE_UNLIKELY {
+            // Storage is allocated on the first event so idle threads cost nothing, and resized
+            // when a capture asks for another capacity. Only an empty ring is resized (the
+            // consumer is then not reading it); a capture starts with every ring empty.
+            if (head == tail_.load(std::memory_order_acquire)) {
+                events_.assign(std::bit_ceil(std::max<usize>(capacity, 2)), TraceEvent{});
+                events_.shrink_to_fit();
+                mask_ = events_.size() - 1;
+                capacity_ = capacity;
+            }
+        }
+        if (head - tail_.load(std::memory_order_acquire) > mask_) {
+            return false;
+        }
+        events_[head & mask_] = event;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Consume all pending events (consumer side)
+    template <typename Func> usize drain(Func&& func)
+    {
+        u64 head = head_.load(std::memory_order_acquire);
+        u64 tail = tail_.load(std::memory_order_relaxed);
+        for (u64 i = tail; i < head; ++i) {
+            func(events_[i & mask_]);
+        }
+        tail_.store(head, std::memory_order_release);
+        return static_cast<usize>(head - tail);
+    }
+
+    /// @brief Discard pending events (consumer side)
+    void skipPending() noexcept
+    {
+        tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+private:
+    std::vector<TraceEvent> events_;
+    usize mask_ = 0;
+    usize capacity_ = 0;  // Requested capacity events_ was sized for
+    AUTOPHAGE_CACHE_ALIGNED std::atomic<u64> head_{0};
+    AUTOPHAGE_CACHE_ALIGNED std::atomic<u64> tail_{0};
+};
+
+struct ThreadTraceBuffer
+{
+    u32 tid = 0;
+    String name;
+    bool nameDirty = true;
+    TraceRing ring;
+    std::atomic<u64> dropped{0};
+    u64 droppedAtStart = 0;
+};
+
+// =============================================================================
+// Sinks
+// =============================================================================
+
+/// @brief Output format backend (driven by the flush thread under g_trace.mutex)
+class TraceSink
+{
+public:
+    virtual ~TraceSink() = default;
+
+    /// @param originTicks Capture start; exported timestamps are relative to it
+    virtual bool open(const String& path, i64 originTicks) = 0;
+    virtual void close() = 0;
+    virtual void writeThreadName(u32 tid, const String& name) = 0;
+
+    /// @brief Events between beginBlock and endBlock all belong to `tid`
+    virtual void beginBlock(u32 tid) = 0;
+    virtual void writeEvent(const TraceEvent& event) = 0;
+    virtual void endBlock() = 0;
+
+    virtual void flush() = 0;
+    [[nodiscard]] virtual u64 bytesWritten() const noexcept = 0;
+};
+
+class ChromeJsonSink final : public TraceSink
+{
+public:
+    bool open(const String& path, i64 originTicks) override
+    {
+        file_ = std::fopen(path.c_str(), "wb");
+        if (!file_) {
+            return false;
+        }
+        originTicks_ = originTicks;
+        bytesWritten_ = 0;
+        buffer_.reserve(FLUSH_THRESHOLD * 2);
+        buffer_ += R"({"displayTimeUnit":"ns","traceEvents":[)";
+        first_ = true;
+        return true;
+    }
+
+    void close() override
+    {
+        if (!file_) {
+            return;
+        }
+        buffer_ += "\n]}\n";
+        flush();
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+
+    void writeThreadName(u32 tid, const String& name) override
+    {
+        beginEvent();
+        buffer_ += R"({"name":"thread_name","ph":"M","pid":1,"tid":)";
+        appendUnsigned(tid);
+        buffer_ += R"(,"args":{"name":)";
+        appendString(name.c_str());
+        buffer_ += "}}";
+    }
+
+    void beginBlock(u32 tid) override { tid_ = tid; }
+
+    void writeEvent(const TraceEvent& event) override
+    {
+        beginEvent();
+        switch (event.type) {
+            case TraceEventType::Zone:
+                buffer_ += R"({"name":)";
+                appendString(event.name);
+                buffer_ += R"(,"ph":"X","ts":)";
+                appendMicros(ticksToNanoseconds(event.start - originTicks_));
+                buffer_ += R"(,"dur":)";
+                appendMicros(ticksToNanoseconds(event.end - event.start));
+                buffer_ += R"(,"pid":1,"tid":)";
+                appendUnsigned(tid_);
+                buffer_ += "}";
+                break;
+            case TraceEventType::Frame:
+                buffer_ += R"({"name":"Frame","ph":"X","ts":)";
+                appendMicros(ticksToNanoseconds(event.start - originTicks_));
+                buffer_ += R"(,"dur":)";
+                appendMicros(ticksToNanoseconds(event.end - event.start));
+                buffer_ += R"(,"pid":1,"tid":)";
+                appendUnsigned(tid_);
+                buffer_ += R"(,"args":{"frame":)";
+                appendUnsigned(static_cast<u64>(event.value));
+                buffer_ += "}}";
+                break;
+            case TraceEventType::Counter:
+                buffer_ += R"({"name":)";
+                appendString(event.name);
+                buffer_ += R"(,"ph":"C","ts":)";
+                appendMicros(ticksToNanoseconds(event.start - originTicks_));
+                buffer_ += R"(,"pid":1,"args":{"value":)";
+                appendDouble(event.value);
+                buffer_ += "}}";
+                break;
+        }
+
+        if (buffer_.size() >= FLUSH_THRESHOLD) {
+            flush();
+        }
+    }
+
+    void endBlock() override {}
+
+    void flush() override
+    {
+        if (file_ && !buffer_.empty()) {
+            bytesWritten_ += std::fwrite(buffer_.data(), 1, buffer_.size(), file_);
+            buffer_.clear();
+        }
+    }
+
+    [[nodiscard]] u64 bytesWritten() const noexcept override { return bytesWritten_; }
+
+private:
+    static constexpr usize FLUSH_THRESHOLD = usize{1} << 20;
+
+    void beginEvent()
+    {
+        buffer_ += first_ ? "\n" : ",\n";
+        first_ = false;
+    }
+
+    void appendUnsigned(u64 value)
+    {
+        char text[32];
+        int len = std::snprintf(text, sizeof(text), "%llu", static_cast<unsigned long long>(value));
+        buffer_.append(text, static_cast<usize>(len));
+    }
+
+    void appendMicros(i64 ns)
+    {
+        char text[48];
+        int len = std::snprintf(text, sizeof(text), "%.3f", static_cast<f64>(ns) / 1000.0);
+        buffer_.append(text, static_cast<usize>(len));
+    }
+
+    void appendDouble(f64 value)
+    {
+        char text[48];
+        int len = std::snprintf(text, sizeof(text), "%.17g", value);
+        buffer_.append(text, static_cast<usize>(len));
+    }
+
+    void appendString(const char* text)
+    {
+        buffer_ += '"';
+        for (const char* c = text ? text : "?"; *c != '\0'; ++c) {
+            switch (*c) {
+                case '"':
+                    buffer_ += "\\\"";
+                    break;
+                case '\\':
+                    buffer_ += "\\\\";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(*c) < 0x20) {
+                        buffer_ += ' ';
+                    } else {
+                        buffer_ += *c;
+                    }
+                    break;
+            }
+        }
+        buffer_ += '"';
+    }
+
+    std::FILE* file_ = nullptr;
+    String buffer_;
+    bool first_ = true;
+    i64 originTicks_ = 0;
+    u32 tid_ = 0;
+    u64 bytesWritten_ = 0;
+};
+
+/// @brief Compact varint/delta encoded format (see binary_trace.hpp)
+class BinaryTraceSink final : public TraceSink
+{
+public:
+    bool open(const String& path, i64 originTicks) override
+    {
+        file_ = std::fopen(path.c_str(), "wb");
+        if (!file_) {
+            return false;
+        }
+        bytesWritten_ = 0;
+        out_.clear();
+        out_.reserve(FLUSH_THRESHOLD * 2);
+        names_.clear();
+        pendingStrings_.clear();
+        pendingStringCount_ = 0;
+
+        BinaryTraceHeader header;
+        std::memcpy(header.magic, BINARY_TRACE_MAGIC, sizeof(header.magic));
+        header.version = BINARY_TRACE_VERSION;
+        // Timestamps are stored as raw ticks; readers apply the calibrated scale
+        header.originTicks = originTicks;
+        header.nsPerTick = getNanosecondsPerTick();
+        appendRaw(out_, header);
+        return true;
+    }
+
+    void close() override
+    {
+        if (!file_) {
+            return;
+        }
+        flush();
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+
+    void writeThreadName(u32 tid, const String& name) override
+    {
+        BinaryBlockHeader block;
+        block.type = BinaryBlockType::ThreadName;
+        block.tid = tid;
+        block.size = static_cast<u32>(name.size());
+        block.count = 1;
+        appendRaw(out_, block);
+        out_.insert(out_.end(), name.begin(), name.end());
+    }
+
+    void beginBlock(u32 tid) override
+    {
+        tid_ = tid;
+        payload_.clear();
+        count_ = 0;
+    }
+
+    void writeEvent(const TraceEvent& event) override
+    {
+        if (count_ == 0) {
+            baseTicks_ = event.start;
+            prevTicks_ = event.start;
+        }
+
+        payload_.push_back(static_cast<u8>(toRecordType(event.type)));
+        switch (event.type) {
+            case TraceEventType::Zone:
+                appendVarint(payload_, intern(event.name));
+                appendVarint(payload_, zigzag(event.start - prevTicks_));
+                appendVarint(payload_, static_cast<u64>(event.end - event.start));
+                break;
+            case TraceEventType::Frame:
+                appendVarint(payload_, zigzag(event.start - prevTicks_));
+                appendVarint(payload_, static_cast<u64>(event.end - event.start));
+                appendVarint(payload_, static_cast<u64>(event.value));
+                break;
+            case TraceEventType::Counter:
+                appendVarint(payload_, intern(event.name));
+                appendVarint(payload_, zigzag(event.start - prevTicks_));
+                appendRaw(payload_, event.value);
+                break;
+        }
+        prevTicks_ = event.start;
+        ++count_;
+
+        // Bounded blocks keep the reader's per-block decode state small
+        if (payload_.size() >= MAX_BLOCK_PAYLOAD) {
+            endBlock();
+            beginBlock(tid_);
+        }
+    }
+
+    void endBlock() override
+    {
+        if (count_ == 0) {
+            return;
+        }
+
+        // Strings first so every id is defined before the block that uses it
+        if (pendingStringCount_ > 0) {
+            BinaryBlockHeader strings;
+            strings.type = BinaryBlockType::Strings;
+            strings.size = static_cast<u32>(pendingStrings_.size());
+            strings.count = pendingStringCount_;
+            appendRaw(out_, strings);
+            out_.insert(out_.end(), pendingStrings_.begin(), pendingStrings_.end());
+            pendingStrings_.clear();
+            pendingStringCount_ = 0;
+        }
+
+        BinaryBlockHeader block;
+        block.type = BinaryBlockType::Events;
+        block.tid = tid_;
+        block.size = static_cast<u32>(payload_.size());
+        block.count = count_;
+        block.baseTicks = baseTicks_;
+        appendRaw(out_, block);
+        out_.insert(out_.end(), payload_.begin(), payload_.end());
+
+        payload_.clear();
+        count_ = 0;
+
+        if (out_.size() >= FLUSH_THRESHOLD) {
+            flush();
+        }
+    }
+
+    void flush() override
+    {
+        if (file_ && !out_.empty()) {
+            bytesWritten_ += std::fwrite(out_.data(), 1, out_.size(), file_);
+            out_.clear();
+        }
+    }
+
+    [[nodiscard]] u64 bytesWritten() const noexcept override { return bytesWritten_; }
+
+private:
+    static constexpr usize FLUSH_THRESHOLD = usize{4} << 20;
+    static constexpr usize MAX_BLOCK_PAYLOAD = usize{64} << 10;
+
+    [[nodiscard]] static BinaryRecordType toRecordType(TraceEventType type) noexcept
+    {
+        switch (type) {
+            case TraceEventType::Zone:
+                return BinaryRecordType::Zone;
+            case TraceEventType::Frame:
+                return BinaryRecordType::Frame;
+            case TraceEventType::Counter:
+                return BinaryRecordType::Counter;
+        }
+        return BinaryRecordType::Zone;
+    }
+
+    [[nodiscard]] static u64 zigzag(i64 value) noexcept
+    {
+        return (static_cast<u64>(value) << 1) ^ static_cast<u64>(value >> 63);
+    }
+
+    static void appendVarint(std::vector<u8>& out, u64 value)
+    {
+        while (value >= 0x80) {
+            out.push_back(static_cast<u8>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<u8>(value));
+    }
+
+    template <typename T> static void appendRaw(std::vector<u8>& out, const T& value)
+    {
+        const auto* bytes = reinterpret_cast<const u8*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    /// @brief Map a name to its id, queueing a string definition on first use
+    /// @note Keyed by contents: a name pointer may be a reused buffer holding another name
+    u32 intern(const char* name)
+    {
+        StringView text = name ? StringView(name) : StringView("?");
+        if (auto it = names_.find(text); it != names_.end()) {
+            return it->second;
+        }
+
+        u32 id = static_cast<u32>(names_.size());
+        names_.emplace(String(text), id);
+        appendVarint(pendingStrings_, id);
+        appendVarint(pendingStrings_, text.size());
+        pendingStrings_.insert(pendingStrings_.end(), text.begin(), text.end());
+        ++pendingStringCount_;
+        return id;
+    }
+
+    std::FILE* file_ = nullptr;
+    std::vector<u8> out_;
+    u64 bytesWritten_ = 0;
+
+    u32 tid_ = 0;
+    std::vector<u8> payload_;
+    u32 count_ = 0;
+    i64 baseTicks_ = 0;
+    i64 prevTicks_ = 0;
+
+    std::unordered_map<String, u32, StringHash, std::equal_to<>> names_;
+    std::vector<u8> pendingStrings_;
+    u32 pendingStringCount_ = 0;
+};
+
+// =============================================================================
+// Capture State
+// =============================================================================
+
+struct TraceState
+{
+    std::mutex mutex;  // Guards buffers, sink and stats
+    std::vector<std::unique_ptr<ThreadTraceBuffer>> buffers;
+    std::unique_ptr<TraceSink> sink;
+    TraceCaptureStats stats;
+
+    std::atomic<bool> active{false};
+    std::atomic<usize> eventsPerThread{usize{1} << 16};
+
+    std::thread flusher;
+    std::mutex flushMutex;
+    std::condition_variable flushSignal;
+    bool stopRequested = false;
+    std::chrono::milliseconds flushInterval{50};
+};
+
+TraceState g_trace;
+
+thread_local ThreadTraceBuffer* t_buffer = nullptr;
+
+ThreadTraceBuffer& localBuffer()
+{
+    if (!t_buffer) AUTOPHAGE_UNLIKELY {
+        std::lock_guard lock(g_trace.mutex);
+        auto buffer = std::make_unique<ThreadTraceBuffer>();
+        buffer->tid = static_cast<u32>(g_trace.buffers.size());
+        buffer->name = "Thread " + std::to_string(buffer->tid);
+        t_buffer = buffer.get();
+        g_trace.buffers.push_back(std::move(buffer));
+    }
+    return *t_buffer;
+}
+
+void pushEvent(const TraceEvent& event)
+{
+    auto& buffer = localBuffer();
+    if (!buffer.ring.push(event, g_trace.eventsPerThread.load(std::memory_order_relaxed))) {
+        buffer.dropped.store(buffer.dropped.load(std::memory_order_relaxed) + 1,
+                             std::memory_order_relaxed);
+    }
+}
+
+/// @brief Drain every ring into the sink (caller holds g_trace.mutex)
+void drainLocked()
+{
+    for (auto& buffer : g_trace.buffers) {
+        if (buffer->nameDirty) {
+            g_trace.sink->writeThreadName(buffer->tid, buffer->name);
+            buffer->nameDirty = false;
+        }
+        g_trace.sink->beginBlock(buffer->tid);
+        g_trace.stats.eventsWritten +=
+            buffer->ring.drain([](const TraceEvent& event) { g_trace.sink->writeEvent(event); });
+        g_trace.sink->endBlock();
+    }
+    g_trace.sink->flush();
+    g_trace.stats.bytesWritten = g_trace.sink->bytesWritten();
+}
+
+void flushLoop()
+{
+    std::unique_lock lock(g_trace.flushMutex);
+    while (!g_trace.stopRequested) {
+        g_trace.flushSignal.wait_for(lock, g_trace.flushInterval,
+                                     [] { return g_trace.stopRequested; });
+        lock.unlock();
+        {
+            std::lock_guard stateLock(g_trace.mutex);
+            drainLocked();
+        }
+        lock.lock();
+    }
+}
+
+}  // namespace
+
+// =============================================================================
+// Capture Control
+// =============================================================================
+
+bool startTraceCapture(const TraceConfig& config)
+{
+    std::lock_guard lock(g_trace.mutex);
+
+    if (g_trace.active.load(std::memory_order_acquire)) {
+        LOG_WARN("Trace capture already running");
+        return false;
+    }
+
+    std::unique_ptr<TraceSink> sink;
+    switch (config.format) {
+        case TraceFormat::ChromeJson:
+            sink = std::make_unique<ChromeJsonSink>();
+            break;
+        case TraceFormat::Binary:
+            sink = std::make_unique<BinaryTraceSink>();
+            break;
+    }
+
+    calibrateTickClock();
+    if (!sink || !sink->open(config.path, readTicks())) {
+        LOG_ERROR("Failed to open trace file: {}", config.path);
+        return false;
+    }
+    g_trace.sink = std::move(sink);
+
+    // Drop anything recorded after the previous capture stopped
+    for (auto& buffer : g_trace.buffers) {
+        buffer->ring.skipPending();
+        buffer->droppedAtStart = buffer->dropped.load(std::memory_order_relaxed);
+        buffer->nameDirty = true;
+    }
+
+    g_trace.stats = TraceCaptureStats{};
+    g_trace.eventsPerThread.store(config.eventsPerThread, std::memory_order_relaxed);
+    g_trace.flushInterval = config.flushInterval;
+    g_trace.stopRequested = false;
+    g_trace.flusher = std::thread(flushLoop);
+    g_trace.active.store(true, std::memory_order_release);
+
+    LOG_INFO("Trace capture started: {}", config.path);
+    return true;
+}
+
+void stopTraceCapture()
+{
+    if (!g_trace.active.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    {
+        std::lock_guard lock(g_trace.flushMutex);
+        g_trace.stopRequested = true;
+    }
+    g_trace.flushSignal.notify_one();
+    g_trace.flusher.join();
+
+    std::lock_guard lock(g_trace.mutex);
+    drainLocked();
+    for (const auto& buffer : g_trace.buffers) {
+        g_trace.stats.eventsDropped +=
+            buffer->dropped.load(std::memory_order_relaxed) - buffer->droppedAtStart;
+    }
+    g_trace.sink->close();
+    g_trace.stats.bytesWritten = g_trace.sink->bytesWritten();
+
+    LOG_INFO("Trace capture stopped: {} events written, {} dropped", g_trace.stats.eventsWritten,
+             g_trace.stats.eventsDropped);
+}
+
+bool isTraceCaptureActive() noexcept
+{
+    return g_trace.active.load(std::memory_order_relaxed);
+}
+
+TraceCaptureStats getTraceCaptureStats()
+{
+    std::lock_guard lock(g_trace.mutex);
+    TraceCaptureStats stats = g_trace.stats;
+    if (g_trace.active.load(std::memory_order_relaxed)) {
+        for (const auto& buffer : g_trace.buffers) {
+            stats.eventsDropped +=
+                buffer->dropped.load(std::memory_order_relaxed) - buffer->droppedAtStart;
+        }
+    }
+    return stats;
+}
+
+void setProfilerThreadName(StringView name)
+{
+    auto& buffer = localBuffer();
+    std::lock_guard lock(g_trace.mutex);
+    buffer.name = String(name);
+    buffer.nameDirty = true;
+}
+
+// =============================================================================
+// Recording Hooks
+// =============================================================================
+
+namespace detail {
+
+void traceZone(const char* name, i64 startTicks, i64 endTicks)
+{
+    if (!isTraceCaptureActive()) {
+        return;
+    }
+    pushEvent({.type = TraceEventType::Zone, .name = name, .start = startTicks, .end = endTicks});
+}
+
+void traceFrame(FrameNumber frame, i64 startTicks, i64 endTicks)
+{
+    if (!isTraceCaptureActive()) {
+        return;
+    }
+    pushEvent({.type = TraceEventType::Frame,
+               .name = "Frame",
+               .start = startTicks,
+               .end = endTicks,
+               .value = static_cast<f64>(frame)});
+}
+
+void traceCounter(const char* name, i64 timestampTicks, f64 value)
+{
+    if (!isTraceCaptureActive()) {
+        return;
+    }
+    pushEvent({.type = TraceEventType::Counter,
+               .name = name,
+               .start = timestampTicks,
+               .end = timestampTicks,
+               .value = value});
+}
+
+}  // namespace detail
+
+}  // namespace autophage
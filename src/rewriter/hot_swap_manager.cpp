@@ -6,11 +6,15 @@ namespace autophage::rewriter {
 
 HotSwapManager::HotSwapManager(ecs::World& world)
     : world_(world), compiler_(std::make_unique<JITCompiler>())
-{}
+{
+    // Map necessary engine symbols (World, types, etc.) once; every compiled module sees them
+    compiler_->addSymbol("world", &world_);
+}
 
 HotSwapManager::~HotSwapManager() = default;
 
-bool HotSwapManager::hotSwapFromSource(const std::string& systemName, const std::string& source)
+bool HotSwapManager::hotSwapFromSource(const std::string& systemName, const std::string& source,
+                                       const std::string& functionName)
 {
     LOG_INFO("Attempting to hot-swap system '{}' from source...", systemName);
 
@@ -19,21 +23,18 @@ bool HotSwapManager::hotSwapFromSource(const std::string& systemName, const std:
         return false;
     }
 
-    // 1. Map necessary engine symbols (World, types, etc.)
-    compiler_->addSymbol("world", &world_);
-
-    // 2. Compile the source
-    void* funcPtr = compiler_->compile(source, "updateSystem");
+    // 1. Compile the source
+    void* funcPtr = compiler_->compile(source, functionName);
     if (!funcPtr) {
         LOG_ERROR("Failed to compile system source: {}", compiler_->getLastError());
         return false;
     }
 
-    // 3. Transform the function pointer to a JITSystem UpdateFunc
+    // 2. Transform the function pointer to a JITSystem UpdateFunc
     auto updateFunc = reinterpret_cast<JITSystem::UpdateFunc>(funcPtr);
 
-    // 4. Replace the system in the world
-    world_.replaceSystemByName<JITSystem>(systemName.c_str(), updateFunc);
+    // 3. Replace the system in the world
+    world_.replaceSystemByName<JITSystem>(systemName.c_str(), systemName, updateFunc);
 
     LOG_INFO("Successfully hot-swapped system '{}' with JIT'd implementation.", systemName);
 
@@ -2,28 +2,182 @@
 #include <autophage/rewriter/jit_compiler.hpp>
 
 #ifdef AUTOPHAGE_JIT_ENABLED
+    #include <clang/Basic/DiagnosticOptions.h>
+    #include <clang/Basic/TargetOptions.h>
+    #include <clang/CodeGen/CodeGenAction.h>
+    #include <clang/Frontend/CompilerInstance.h>
+    #include <clang/Frontend/CompilerInvocation.h>
+    #include <clang/Frontend/TextDiagnosticPrinter.h>
+    #include <clang/Frontend/Utils.h>
+    #include <clang/Lex/PreprocessorOptions.h>
+    #include <llvm/ADT/StringMap.h>
+    #include <llvm/Config/llvm-config.h>
+    #include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
     #include <llvm/ExecutionEngine/Orc/LLJIT.h>
     #include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
-    #include <llvm/IR/IRBuilder.h>
     #include <llvm/IR/LLVMContext.h>
     #include <llvm/IR/Module.h>
+    #include <llvm/Support/MemoryBuffer.h>
     #include <llvm/Support/TargetSelect.h>
+    #include <llvm/Support/VirtualFileSystem.h>
     #include <llvm/Support/raw_ostream.h>
+    #include <llvm/TargetParser/Host.h>
+    #include <llvm/TargetParser/SubtargetFeature.h>
+
+    // Matches the range accepted by src/rewriter/CMakeLists.txt; the guards below cover it
+    #if LLVM_VERSION_MAJOR < 17 || LLVM_VERSION_MAJOR > 20
+        #error "The JIT compiler supports LLVM/Clang 17 to 20"
+    #endif
+#endif
+
+// Set by the build: engine headers and the Clang resource directory (compiler builtin headers)
+#ifndef AUTOPHAGE_JIT_INCLUDE_DIR
+    #define AUTOPHAGE_JIT_INCLUDE_DIR ""
 #endif
+#ifndef AUTOPHAGE_CLANG_RESOURCE_DIR
+    #define AUTOPHAGE_CLANG_RESOURCE_DIR ""
+#endif
+
+#define AUTOPHAGE_JIT_STRINGIFY_IMPL(x) #x
+#define AUTOPHAGE_JIT_STRINGIFY(x) AUTOPHAGE_JIT_STRINGIFY_IMPL(x)
 
 namespace autophage::rewriter {
 
+namespace {
+
+#ifdef AUTOPHAGE_JIT_ENABLED
+
+[[nodiscard]] const char* optFlag(JITOptLevel level) noexcept
+{
+    switch (level) {
+        case JITOptLevel::O0:
+            return "-O0";
+        case JITOptLevel::O1:
+            return "-O1";
+        case JITOptLevel::O2:
+            return "-O2";
+        case JITOptLevel::O3:
+            return "-O3";
+    }
+    return "-O2";
+}
+
+    #if LLVM_VERSION_MAJOR >= 18
+using CodeGenLevel = llvm::CodeGenOptLevel;
+    #else
+using CodeGenLevel = llvm::CodeGenOpt::Level;
+    #endif
+
+[[nodiscard]] CodeGenLevel codeGenLevel(JITOptLevel level) noexcept
+{
+    switch (level) {
+        case JITOptLevel::O0:
+            return CodeGenLevel::None;
+        case JITOptLevel::O1:
+            return CodeGenLevel::Less;
+        case JITOptLevel::O2:
+            return CodeGenLevel::Default;
+        case JITOptLevel::O3:
+            return CodeGenLevel::Aggressive;
+    }
+    return CodeGenLevel::Default;
+}
+
+/// @brief Features of the host CPU, as "+feature" / "-feature"
+[[nodiscard]] std::vector<std::string> hostFeatures()
+{
+    #if LLVM_VERSION_MAJOR >= 19
+    llvm::StringMap<bool> features = llvm::sys::getHostCPUFeatures();
+    #else
+    llvm::StringMap<bool> features;
+    if (!llvm::sys::getHostCPUFeatures(features)) {
+        features.clear();
+    }
+    #endif
+
+    std::vector<std::string> result;
+    result.reserve(features.size());
+    for (const auto& feature : features) {
+        result.push_back((feature.getValue() ? "+" : "-") + feature.getKey().str());
+    }
+    return result;
+}
+
+/// @brief Driver command line for one source, matching how the engine itself was built
+[[nodiscard]] std::vector<std::string> commandLine(const JITConfig& config,
+                                                   const std::string& sourceName)
+{
+    std::vector<std::string> args = {
+        "clang++",
+        "--target=" + llvm::sys::getProcessTriple(),
+        "-std=c++23",
+        "-c",
+        optFlag(config.optLevel),
+    };
+
+    if (StringView resources = AUTOPHAGE_CLANG_RESOURCE_DIR; !resources.empty()) {
+        args.push_back("-resource-dir");
+        args.emplace_back(resources);
+    }
+    if (StringView engine = AUTOPHAGE_JIT_INCLUDE_DIR; !engine.empty()) {
+        args.push_back("-I");
+        args.emplace_back(engine);
+    }
+    for (const auto& dir : config.includeDirs) {
+        args.push_back("-I");
+        args.push_back(dir);
+    }
+
+    // Headers must see the same configuration as the engine they are linked against, and reach
+    // the engine's thread-locals through exported accessors (JIT code cannot define its own)
+    args.push_back("-DAUTOPHAGE_JIT_MODULE=1");
+    #ifdef AUTOPHAGE_PROFILE_LEVEL
+    args.push_back("-DAUTOPHAGE_PROFILE_LEVEL=" AUTOPHAGE_JIT_STRINGIFY(AUTOPHAGE_PROFILE_LEVEL));
+    #endif
+    #ifdef AUTOPHAGE_TRACK_GLOBAL_ALLOCATIONS
+    args.push_back("-DAUTOPHAGE_TRACK_GLOBAL_ALLOCATIONS=1");
+    #endif
+    #ifdef NDEBUG
+    args.push_back("-DNDEBUG");
+    #endif
+    for (const auto& define : config.defines) {
+        args.push_back("-D" + define);
+    }
+
+    args.push_back(sourceName);
+    return args;
+}
+
+#endif
+
+}  // namespace
+
 class JITCompiler::Impl
 {
 public:
-    Impl()
+    explicit Impl(JITConfig config) : config_(std::move(config))
     {
 #ifdef AUTOPHAGE_JIT_ENABLED
         LOG_INFO("Initializing LLVM JIT components...");
         llvm::InitializeNativeTarget();
         llvm::InitializeNativeTargetAsmPrinter();
+        llvm::InitializeNativeTargetAsmParser();
 
-        auto jitOrErr = llvm::orc::LLJITBuilder().create();
+        // The host builder already targets the exact CPU and its features
+        auto machine = llvm::orc::JITTargetMachineBuilder::detectHost();
+        if (!machine) {
+            lastError_ = llvm::toString(machine.takeError());
+            LOG_ERROR("Failed to detect the host target: {}", lastError_);
+            return;
+        }
+        if (!config_.targetHostCpu) {
+            machine->setCPU("generic");
+            machine->getFeatures() = llvm::SubtargetFeatures();
+        }
+        machine->setCodeGenOptLevel(codeGenLevel(config_.optLevel));
+
+        auto jitOrErr =
+            llvm::orc::LLJITBuilder().setJITTargetMachineBuilder(std::move(*machine)).create();
         if (auto err = jitOrErr.takeError()) {
             lastError_ = llvm::toString(std::move(err));
             LOG_ERROR("Failed to create LLJIT: {}", lastError_);
@@ -38,12 +192,84 @@ public:
     ~Impl() = default;
 
 #ifdef AUTOPHAGE_JIT_ENABLED
+    /// @brief Run the Clang frontend over a source string
+    /// @return The module, or nullptr with lastError_ holding the diagnostics
+    std::unique_ptr<llvm::Module> compileToModule(const std::string& source,
+                                                  const std::string& sourceName,
+                                                  llvm::LLVMContext& context)
+    {
+        std::string diagnostics;
+        llvm::raw_string_ostream diagnosticStream(diagnostics);
+
+        auto args = commandLine(config_, sourceName);
+        std::vector<const char*> argv;
+        argv.reserve(args.size());
+        for (const auto& arg : args) {
+            argv.push_back(arg.c_str());
+        }
+
+        // Clang 20 added the file system parameter to createDiagnostics()
+        llvm::IntrusiveRefCntPtr<clang::DiagnosticOptions> driverOptions =
+            new clang::DiagnosticOptions();
+        auto* driverPrinter = new clang::TextDiagnosticPrinter(diagnosticStream,
+                                                               driverOptions.get());
+        clang::CreateInvocationOptions invocationOptions;
+    #if LLVM_VERSION_MAJOR >= 20
+        invocationOptions.Diags = clang::CompilerInstance::createDiagnostics(
+            *llvm::vfs::getRealFileSystem(), driverOptions.get(), driverPrinter, true);
+    #else
+        invocationOptions.Diags =
+            clang::CompilerInstance::createDiagnostics(driverOptions.get(), driverPrinter, true);
+    #endif
+
+        std::shared_ptr<clang::CompilerInvocation> invocation =
+            clang::createInvocation(argv, std::move(invocationOptions));
+        if (!invocation) {
+            lastError_ = "Invalid compiler invocation: " + diagnosticStream.str();
+            return nullptr;
+        }
+
+        if (config_.targetHostCpu) {
+            clang::TargetOptions& target = invocation->getTargetOpts();
+            target.CPU = llvm::sys::getHostCPUName().str();
+            target.FeaturesAsWritten = hostFeatures();
+        }
+
+        // The source only exists in memory
+        invocation->getPreprocessorOpts().addRemappedFile(
+            sourceName, llvm::MemoryBuffer::getMemBufferCopy(source, sourceName).release());
+
+        clang::CompilerInstance compiler;
+        compiler.setInvocation(std::move(invocation));
+        auto* printer =
+            new clang::TextDiagnosticPrinter(diagnosticStream, &compiler.getDiagnosticOpts());
+    #if LLVM_VERSION_MAJOR >= 20
+        compiler.createDiagnostics(*llvm::vfs::getRealFileSystem(), printer, true);
+    #else
+        compiler.createDiagnostics(printer, true);
+    #endif
+
+        clang::EmitLLVMOnlyAction action(&context);
+        if (!compiler.ExecuteAction(action)) {
+            lastError_ = diagnosticStream.str();
+            return nullptr;
+        }
+
+        auto module = action.takeModule();
+        if (!module) {
+            lastError_ = "Clang produced no module: " + diagnosticStream.str();
+        }
+        return module;
+    }
+
     std::unique_ptr<llvm::orc::LLJIT> jit_;
+    u32 moduleCount_ = 0;
 #endif
+    JITConfig config_;
     std::string lastError_;
 };
 
-JITCompiler::JITCompiler() : impl_(std::make_unique<Impl>()) {}
+JITCompiler::JITCompiler(JITConfig config) : impl_(std::make_unique<Impl>(std::move(config))) {}
 JITCompiler::~JITCompiler() = default;
 
 void* JITCompiler::compile(const std::string& source, const std::string& functionName)
@@ -54,14 +280,52 @@ void* JITCompiler::compile(const std::string& source, const std::string& functio
         return nullptr;
     }
 
-    // For now, this is a placeholder for actual source compilation.
-    // Real implementation would use Clang to generate IR or build IR manually.
-    LOG_WARN("Source compilation not yet implemented. Use IR compilation or assembly.");
-    impl_->lastError_ = "Source compilation (C++ string) not yet implemented";
-    return nullptr;
+    u32 index = impl_->moduleCount_++;
+    std::string moduleName = "autophage_jit_" + std::to_string(index);
+    std::string sourceName = moduleName + ".cpp";
+
+    llvm::orc::ThreadSafeContext context(std::make_unique<llvm::LLVMContext>());
+    auto module = impl_->compileToModule(source, sourceName, *context.getContext());
+    if (!module) {
+        LOG_ERROR("Failed to compile '{}':\n{}", functionName, impl_->lastError_);
+        return nullptr;
+    }
+
+    // A fresh JITDylib per compile: recompiling a function name must not clash with the old one
+    auto& jit = *impl_->jit_;
+    auto dylib = jit.createJITDylib(moduleName);
+    if (!dylib) {
+        impl_->lastError_ = llvm::toString(dylib.takeError());
+        return nullptr;
+    }
+    dylib->addToLinkOrder(jit.getMainJITDylib());  // Symbols registered with addSymbol()
+    if (auto err = jit.addIRModule(*dylib,
+                                   llvm::orc::ThreadSafeModule(std::move(module), context))) {
+        impl_->lastError_ = llvm::toString(std::move(err));
+        LOG_ERROR("Failed to add module for '{}': {}", functionName, impl_->lastError_);
+        return nullptr;
+    }
+
+    // Static initializers of the new code run before anything is handed out
+    if (auto err = jit.initialize(*dylib)) {
+        impl_->lastError_ = llvm::toString(std::move(err));
+        LOG_ERROR("Failed to initialize module for '{}': {}", functionName, impl_->lastError_);
+        return nullptr;
+    }
+
+    auto symbol = jit.lookup(*dylib, functionName);
+    if (!symbol) {
+        impl_->lastError_ = llvm::toString(symbol.takeError());
+        LOG_ERROR("Compiled source has no function '{}': {}", functionName, impl_->lastError_);
+        return nullptr;
+    }
+
+    LOG_INFO("JIT compiled '{}' ({})", functionName, optFlag(impl_->config_.optLevel));
+    return symbol->toPtr<void*>();
 #else
     (void)source;
     (void)functionName;
+    impl_->lastError_ = "Built without LLVM JIT support (AUTOPHAGE_USE_LLVM_JIT)";
     return nullptr;
 #endif
 }
@@ -95,10 +359,15 @@ std::string JITCompiler::getLastError() const
 bool JITCompiler::isAvailable() const noexcept
 {
 #ifdef AUTOPHAGE_JIT_ENABLED
-    return true;
+    return impl_->jit_ != nullptr;
 #else
     return false;
 #endif
 }
 
+const JITConfig& JITCompiler::config() const noexcept
+{
+    return impl_->config_;
+}
+
 }  // namespace autophage::rewriter
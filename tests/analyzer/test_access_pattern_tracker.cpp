@@ -0,0 +1,72 @@
+/// @file test_access_pattern_tracker.cpp
+/// @brief Tests for per-system access pattern classification
+
+#include <catch2/catch_test_macros.hpp>
+#include <autophage/analyzer/access_pattern_tracker.hpp>
+
+using namespace autophage;
+using namespace autophage::analyzer;
+
+TEST_CASE("Access patterns are classified per frame window", "[analyzer][access]") {
+    AccessPatternTracker tracker;
+
+    SECTION("Frames count completed frames, not reports") {
+        tracker.recordAccess("Movement", AccessPattern::Linear, 100);
+        tracker.recordAccess("Movement", AccessPattern::Linear, 100);
+        REQUIRE(tracker.getStats().at("Movement").frames == 0);
+        REQUIRE(tracker.getStats().at("Movement").linearAccesses == 200);
+
+        tracker.endFrame();
+        tracker.endFrame();  // Nothing reported, not counted
+        REQUIRE(tracker.getStats().at("Movement").frames == 1);
+    }
+
+    SECTION("A changed pattern is picked up once old frames leave the window") {
+        for (usize frame = 0; frame < AccessPatternTracker::WINDOW_FRAMES; ++frame) {
+            tracker.recordAccess("Combat", AccessPattern::Linear, 1000);
+            tracker.endFrame();
+        }
+        REQUIRE(tracker.getStats().at("Combat").pattern == AccessPattern::Linear);
+
+        for (usize frame = 0; frame < AccessPatternTracker::WINDOW_FRAMES / 2; ++frame) {
+            tracker.recordAccess("Combat", AccessPattern::Random, 1000);
+            tracker.endFrame();
+        }
+        REQUIRE(tracker.getStats().at("Combat").pattern == AccessPattern::Mixed);
+
+        for (usize frame = 0; frame < AccessPatternTracker::WINDOW_FRAMES / 2; ++frame) {
+            tracker.recordAccess("Combat", AccessPattern::Random, 1000);
+            tracker.endFrame();
+        }
+        const SystemStats& stats = tracker.getStats().at("Combat");
+        REQUIRE(stats.pattern == AccessPattern::Random);
+        REQUIRE(stats.linearAccesses == 0);
+        REQUIRE(stats.randomAccesses == 1000 * AccessPatternTracker::WINDOW_FRAMES);
+        REQUIRE(stats.frames == 2 * AccessPatternTracker::WINDOW_FRAMES);
+    }
+
+    SECTION("Processed entities are per frame, not per window") {
+        AccessCounts counts;
+        counts.linear = 300;
+        for (usize frame = 0; frame < AccessPatternTracker::WINDOW_FRAMES; ++frame) {
+            tracker.recordCounts("Physics", counts, 100);
+            tracker.endFrame();
+        }
+        REQUIRE(tracker.getStats().at("Physics").processedEntities == 100);
+        REQUIRE(tracker.getStats().at("Physics").linearAccesses ==
+                300 * AccessPatternTracker::WINDOW_FRAMES);
+
+        tracker.recordCounts("Physics", {}, 40);
+        REQUIRE(tracker.getStats().at("Physics").processedEntities == 40);
+        tracker.endFrame();
+        tracker.endFrame();
+        REQUIRE(tracker.getStats().at("Physics").processedEntities == 40);
+    }
+
+    SECTION("Reset forgets everything") {
+        tracker.recordAccess("Movement", AccessPattern::Random, 10);
+        tracker.endFrame();
+        tracker.reset();
+        REQUIRE(tracker.getStats().empty());
+    }
+}
@@ -0,0 +1,133 @@
+/// @file test_execution_graph.cpp
+/// @brief Tests for the system execution graph and critical-path analysis
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <autophage/analyzer/execution_graph.hpp>
+
+#include <vector>
+
+using namespace autophage;
+using namespace autophage::analyzer;
+
+namespace {
+
+struct Position {};
+struct Velocity {};
+struct Bounds {};
+struct Sprite {};
+
+ExecutionNode makeNode(String name, std::vector<TypeId> reads, std::vector<TypeId> writes,
+                       f64 costNs)
+{
+    ExecutionNode node{std::move(name), {}, costNs};
+    for (TypeId id : reads) {
+        node.access.addRead(id);
+    }
+    for (TypeId id : writes) {
+        node.access.addWrite(id);
+    }
+    return node;
+}
+
+// Stand-in for ecs::SystemStats (the analyzer does not link the ECS library)
+struct FakeAccess
+{
+    std::vector<TypeId> reads;
+    std::vector<TypeId> writes;
+    bool structural = false;
+};
+
+struct FakeStats
+{
+    String name;
+    f64 lastNs = 0.0;
+    f64 meanNs = 0.0;
+    f64 p99Ns = 0.0;
+    FakeAccess access;
+};
+
+}  // namespace
+
+TEST_CASE("Execution graph edges follow access conflicts", "[analyzer][graph]") {
+    ExecutionGraph graph;
+    usize move = graph.addNode(
+        makeNode("Move", {typeId<Velocity>()}, {typeId<Position>()}, 4000.0));
+    usize bounds = graph.addNode(
+        makeNode("Bounds", {typeId<Position>()}, {typeId<Bounds>()}, 1000.0));
+    usize animate = graph.addNode(makeNode("Animate", {}, {typeId<Sprite>()}, 2000.0));
+    usize render = graph.addNode(
+        makeNode("Render", {typeId<Position>(), typeId<Sprite>()}, {}, 3000.0));
+
+    REQUIRE(graph.nodeCount() == 4);
+    REQUIRE(graph.dependencies(move).empty());
+    REQUIRE(graph.dependencies(bounds) == std::vector<usize>{move});  // Read after write
+    REQUIRE(graph.dependencies(animate).empty());                     // Disjoint
+    REQUIRE(graph.dependencies(render) == std::vector<usize>{move, animate});
+
+    SECTION("Readers of the same type do not conflict") {
+        ExecutionNode a = makeNode("A", {typeId<Position>()}, {}, 1.0);
+        ExecutionNode b = makeNode("B", {typeId<Position>()}, {}, 1.0);
+        REQUIRE_FALSE(nodesConflict(a, b));
+        b.access.structural = true;
+        REQUIRE(nodesConflict(a, b));
+        REQUIRE(nodesConflict(a, ExecutionNode{"Unknown", {}, 1.0}));
+    }
+
+    SECTION("Critical path and slack") {
+        CriticalPathReport report = graph.analyze();
+        REQUIRE(report.serialNs == Catch::Approx(10000.0));
+        REQUIRE(report.criticalPathNs == Catch::Approx(7000.0));  // Move -> Render
+        REQUIRE(report.parallelism == Catch::Approx(10.0 / 7.0));
+        REQUIRE(report.criticalPath == std::vector<usize>{move, render});
+
+        REQUIRE(report.nodes[move].critical);
+        REQUIRE(report.nodes[move].criticalShare == Catch::Approx(4.0 / 7.0));
+        REQUIRE(report.nodes[render].earliestStartNs == Catch::Approx(4000.0));
+        REQUIRE(report.nodes[bounds].slackNs == Catch::Approx(2000.0));
+        REQUIRE(report.nodes[animate].slackNs == Catch::Approx(2000.0));
+        REQUIRE_FALSE(report.nodes[bounds].critical);
+        REQUIRE(report.totalSlackNs == Catch::Approx(4000.0));
+
+        auto hints = graph.hints(report);
+        REQUIRE(hints.size() == 1);
+        REQUIRE(hints[0].subsystem == "Move");
+    }
+
+    SECTION("New timings can move the critical path") {
+        graph.setCost(animate, 9000.0);
+        CriticalPathReport report = graph.analyze();
+        REQUIRE(report.criticalPath == std::vector<usize>{animate, render});
+        REQUIRE(report.nodes[move].slackNs == Catch::Approx(5000.0));
+    }
+}
+
+TEST_CASE("Execution graph from system statistics", "[analyzer][graph]") {
+    std::vector<FakeStats> systems = {
+        {"Physics", 500.0, 400.0, 900.0, {{typeId<Velocity>()}, {typeId<Position>()}, false}},
+        {"Audio", 300.0, 300.0, 300.0, {{}, {typeId<Sprite>()}, false}},
+        {"Cleanup", 100.0, 100.0, 100.0, {{}, {}, true}},
+        {"Script", 50.0, 50.0, 50.0, {}},
+    };
+
+    ExecutionGraph last = ExecutionGraph::fromSystems(systems, SystemCost::Last);
+    REQUIRE(last.nodeCount() == 4);
+    REQUIRE(last.node(0).costNs == 500.0);
+    REQUIRE(last.dependencies(1).empty());
+    REQUIRE(last.dependencies(2) == std::vector<usize>{0, 1});
+    REQUIRE(last.dependencies(3) == std::vector<usize>{0, 1, 2});
+
+    CriticalPathReport report = last.analyze();
+    REQUIRE(report.criticalPathNs == Catch::Approx(650.0));
+    REQUIRE(report.criticalPath == std::vector<usize>{0, 2, 3});
+
+    auto hints = last.hints(report);
+    bool unknownReported = false;
+    for (const auto& hint : hints) {
+        unknownReported = unknownReported || hint.subsystem == "Script";
+    }
+    REQUIRE(unknownReported);
+
+    ExecutionGraph p99 = ExecutionGraph::fromSystems(systems, SystemCost::P99);
+    REQUIRE(p99.analyze().criticalPathNs == Catch::Approx(1050.0));
+}
@@ -0,0 +1,170 @@
+/// @file test_regression_detector.cpp
+/// @brief Tests for before/after regression detection
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <autophage/analyzer/regression_detector.hpp>
+
+#include <random>
+#include <vector>
+
+using namespace autophage;
+using namespace autophage::analyzer;
+
+namespace {
+
+std::vector<f64> noisySamples(usize count, f64 center, f64 spread, u64 seed)
+{
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<f64> noise(0.0, spread);
+    std::vector<f64> values;
+    for (usize i = 0; i < count; ++i) {
+        values.push_back(center + noise(rng));
+    }
+    return values;
+}
+
+}  // namespace
+
+TEST_CASE("Mann-Whitney U test", "[analyzer][regression]") {
+    SECTION("Known statistic") {
+        std::vector<f64> a = {1.0, 2.0, 3.0};
+        std::vector<f64> b = {4.0, 5.0, 6.0};
+        MannWhitneyResult result = mannWhitneyU(a, b);
+        REQUIRE(result.u == Catch::Approx(9.0));  // Every b exceeds every a
+        REQUIRE(result.z > 0.0);
+
+        MannWhitneyResult reversed = mannWhitneyU(b, a);
+        REQUIRE(reversed.u == Catch::Approx(0.0));
+        REQUIRE(reversed.pValue == Catch::Approx(result.pValue));
+    }
+
+    SECTION("Ties share ranks") {
+        std::vector<f64> a = {1.0, 2.0, 2.0};
+        std::vector<f64> b = {2.0, 3.0};
+        REQUIRE(mannWhitneyU(a, b).u == Catch::Approx(5.0));
+    }
+
+    SECTION("Identical or empty samples are not significant") {
+        std::vector<f64> same(20, 5.0);
+        REQUIRE(mannWhitneyU(same, same).pValue == 1.0);
+        REQUIRE(mannWhitneyU({}, same).pValue == 1.0);
+    }
+
+    SECTION("Shifted distributions are significant") {
+        auto a = noisySamples(100, 100.0, 5.0, 1);
+        auto b = noisySamples(100, 110.0, 5.0, 2);
+        REQUIRE(mannWhitneyU(a, b).pValue < 0.001);
+    }
+}
+
+TEST_CASE("Median and bootstrap interval", "[analyzer][regression]") {
+    std::vector<f64> odd = {5.0, 1.0, 3.0};
+    std::vector<f64> even = {4.0, 1.0, 3.0, 2.0};
+    REQUIRE(median(odd) == 3.0);
+    REQUIRE(median(even) == 2.5);
+    REQUIRE(median({}) == 0.0);
+
+    auto a = noisySamples(200, 100.0, 5.0, 3);
+    auto b = noisySamples(200, 120.0, 5.0, 4);
+    auto [low, high] = bootstrapMedianChange(a, b, 0.95, 500, 7);
+    REQUIRE(low < high);
+    REQUIRE(low > 0.1);
+    REQUIRE(high < 0.3);
+}
+
+TEST_CASE("Comparing samples yields a verdict", "[analyzer][regression]") {
+    RegressionConfig config;
+    auto baseline = noisySamples(100, 100.0, 5.0, 10);
+
+    SECTION("Slower candidate regresses") {
+        auto candidate = noisySamples(100, 115.0, 5.0, 11);
+        RegressionResult result = compareSamples(baseline, candidate, config);
+        REQUIRE(result.verdict == RegressionVerdict::Regressed);
+        REQUIRE(result.confidence > 0.99);
+        REQUIRE(result.relativeChange == Catch::Approx(0.15).margin(0.03));
+        REQUIRE(result.changeLow > 0.0);
+    }
+
+    SECTION("Faster candidate improves") {
+        auto candidate = noisySamples(100, 80.0, 5.0, 12);
+        REQUIRE(compareSamples(baseline, candidate, config).verdict ==
+                RegressionVerdict::Improved);
+    }
+
+    SECTION("Noise alone is no change") {
+        auto candidate = noisySamples(100, 100.0, 5.0, 13);
+        REQUIRE(compareSamples(baseline, candidate, config).verdict ==
+                RegressionVerdict::NoChange);
+    }
+
+    SECTION("Tiny effects are below the threshold") {
+        auto tight = noisySamples(200, 100.0, 0.1, 14);
+        auto shifted = noisySamples(200, 101.0, 0.1, 15);
+        RegressionResult result = compareSamples(tight, shifted, config);
+        REQUIRE(result.pValue < 0.001);
+        REQUIRE(result.verdict == RegressionVerdict::NoChange);
+    }
+
+    SECTION("Short baselines are inconclusive") {
+        std::vector<f64> shortBaseline(baseline.begin(), baseline.begin() + 5);
+        REQUIRE(compareSamples(shortBaseline, baseline, config).verdict ==
+                RegressionVerdict::Inconclusive);
+    }
+}
+
+TEST_CASE("Regression detector trials", "[analyzer][regression]") {
+    RegressionConfig config;
+    config.minSamples = 40;
+    config.warmupSamples = 3;
+    RegressionDetector detector(config);
+
+    // Baseline: 1000ns for 100 entities = 10ns per entity
+    for (f64 cost : noisySamples(60, 1000.0, 20.0, 20)) {
+        detector.addSample("Physics", cost, 100);
+    }
+    REQUIRE_FALSE(detector.hasTrial("Physics"));
+    REQUIRE_FALSE(detector.evaluate("Physics").has_value());
+
+    detector.beginTrial("Physics", "Scalar", "SIMD");
+    REQUIRE(detector.hasTrial("Physics"));
+
+    SECTION("Verdict once enough candidate samples arrive") {
+        // Twice the entities at the same per-entity cost, after a slow warmup
+        for (int i = 0; i < 3; ++i) {
+            detector.addSample("Physics", 1.0e6, 200);
+        }
+        auto samples = noisySamples(40, 2000.0, 40.0, 21);
+        for (usize i = 0; i + 1 < samples.size(); ++i) {
+            detector.addSample("Physics", samples[i], 200);
+        }
+        REQUIRE_FALSE(detector.evaluate("Physics").has_value());
+
+        detector.addSample("Physics", samples.back(), 200);
+        auto result = detector.evaluate("Physics");
+        REQUIRE(result.has_value());
+        REQUIRE(result->subject == "Physics");
+        REQUIRE(result->baselineLabel == "Scalar");
+        REQUIRE(result->candidateLabel == "SIMD");
+        REQUIRE(result->verdict == RegressionVerdict::NoChange);
+        REQUIRE(result->baselineMedian == Catch::Approx(10.0).epsilon(0.02));
+        REQUIRE_FALSE(detector.hasTrial("Physics"));
+    }
+
+    SECTION("Per-entity slowdown regresses") {
+        for (f64 cost : noisySamples(50, 1300.0, 20.0, 22)) {
+            detector.addSample("Physics", cost, 100);
+        }
+        auto result = detector.evaluate("Physics");
+        REQUIRE(result.has_value());
+        REQUIRE(result->verdict == RegressionVerdict::Regressed);
+    }
+
+    SECTION("Cancelled trials produce no verdict") {
+        detector.cancelTrial("Physics");
+        for (f64 cost : noisySamples(50, 1300.0, 20.0, 23)) {
+            detector.addSample("Physics", cost, 100);
+        }
+        REQUIRE_FALSE(detector.evaluate("Physics").has_value());
+    }
+}
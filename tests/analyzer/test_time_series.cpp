@@ -0,0 +1,108 @@
+/// @file test_time_series.cpp
+/// @brief Tests for the analyzer time-series store and windowed statistics
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <autophage/analyzer/stats_collector.hpp>
+#include <autophage/analyzer/time_series.hpp>
+
+#include <cmath>
+
+using namespace autophage;
+using namespace autophage::analyzer;
+
+TEST_CASE("Time series registration", "[analyzer][timeseries]") {
+    TimeSeriesStore store;
+
+    SeriesId a = store.series("system/Physics");
+    SeriesId b = store.series("system/Render");
+    REQUIRE(a != b);
+    REQUIRE(store.series("system/Physics") == a);
+    REQUIRE(store.findSeries("system/Render") == b);
+    REQUIRE(store.findSeries("missing") == INVALID_SERIES_ID);
+    REQUIRE(store.seriesName(a) == "system/Physics");
+    REQUIRE(store.seriesCount() == 2);
+
+    SECTION("Unknown series aggregate to empty") {
+        store.record(INVALID_SERIES_ID, 0.0, 1.0);
+        REQUIRE(store.aggregate(INVALID_SERIES_ID, TimeWindow::Last1s).empty());
+        REQUIRE(store.aggregate(a, TimeWindow::Last1s).empty());
+    }
+
+    SECTION("Clear drops everything") {
+        store.record(a, 0.5, 1.0);
+        store.clear();
+        REQUIRE(store.seriesCount() == 0);
+        REQUIRE(store.findSeries("system/Physics") == INVALID_SERIES_ID);
+    }
+}
+
+TEST_CASE("Time series windowed aggregates", "[analyzer][timeseries]") {
+    TimeSeriesStore store;
+    SeriesId id = store.series("frame");
+
+    // 60 samples per second for 20 seconds, value = second index
+    for (int i = 0; i < 20 * 60; ++i) {
+        f64 t = static_cast<f64>(i) / 60.0;
+        store.record(id, t, std::floor(t));
+    }
+    f64 now = store.latestTime();
+
+    SECTION("Last second holds only the final second's samples") {
+        WindowAggregate agg = store.aggregate(id, TimeWindow::Last1s, now);
+        REQUIRE(agg.count >= 59);
+        REQUIRE(agg.count <= 61);
+        REQUIRE(agg.min >= 18.0);
+        REQUIRE(agg.max == Catch::Approx(19.0));
+    }
+
+    SECTION("Last ten seconds") {
+        WindowAggregate agg = store.aggregate(id, TimeWindow::Last10s, now);
+        REQUIRE(agg.count == 600);
+        REQUIRE(agg.mean == Catch::Approx(14.5));
+        REQUIRE(agg.min == Catch::Approx(10.0).epsilon(0.01));
+        REQUIRE(agg.max == Catch::Approx(19.0));
+        REQUIRE(agg.stddev > 2.5);
+        REQUIRE(agg.slopePerSecond == Catch::Approx(1.0).epsilon(0.1));
+    }
+
+    SECTION("Last five minutes covers the whole run") {
+        WindowAggregate agg = store.aggregate(id, TimeWindow::Last5min, now);
+        REQUIRE(agg.count == 1200);
+        REQUIRE(agg.sum == Catch::Approx(60.0 * 190.0));
+        REQUIRE(agg.slopePerSecond == Catch::Approx(1.0));
+    }
+
+    SECTION("Buckets that fall out of the window are ignored") {
+        REQUIRE(store.aggregate(id, TimeWindow::Last1s, now + 5.0).empty());
+        REQUIRE(store.aggregate(id, TimeWindow::Last10s, now + 30.0).empty());
+
+        // Recording after a gap reuses ring slots without mixing in stale buckets
+        store.record(id, now + 30.0, 100.0);
+        WindowAggregate agg = store.aggregate(id, TimeWindow::Last10s);
+        REQUIRE(agg.count == 1);
+        REQUIRE(agg.mean == Catch::Approx(100.0));
+        REQUIRE(agg.stddev == Catch::Approx(0.0));
+        REQUIRE(agg.slopePerSecond == 0.0);
+    }
+}
+
+TEST_CASE("Stats collector keeps windowed history", "[analyzer][timeseries]") {
+    StatsCollector stats;
+
+    for (int i = 0; i < 100; ++i) {
+        f64 t = static_cast<f64>(i) * 0.1;
+        stats.collect(t);
+        stats.record("system/Custom", static_cast<f64>(i));
+    }
+
+    REQUIRE(stats.timeSeries().findSeries(StatsCollector::FRAME_TIME_MS) != INVALID_SERIES_ID);
+    REQUIRE(stats.aggregate(StatsCollector::ENTITY_COUNT, TimeWindow::Last10s).count == 100);
+
+    WindowAggregate custom = stats.aggregate("system/Custom", TimeWindow::Last10s);
+    REQUIRE(custom.count == 100);
+    REQUIRE(custom.mean == Catch::Approx(49.5));
+    REQUIRE(custom.slopePerSecond == Catch::Approx(10.0).epsilon(0.01));
+
+    REQUIRE(stats.aggregate("missing", TimeWindow::Last1s).empty());
+}
@@ -0,0 +1,115 @@
+/// @file test_frame_allocator.cpp
+/// @brief Tests for the double-buffered frame allocator
+
+#include <autophage/core/frame_allocator.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <thread>
+
+using namespace autophage;
+
+TEST_CASE("Frame allocation", "[core][memory]")
+{
+    advanceFrameAllocators();
+
+    SECTION("Alignment")
+    {
+        void* a = frameAlloc(3, 1);
+        void* b = frameAlloc(64, 64);
+        void* c = frameAlloc(16, 256);
+        REQUIRE(a != nullptr);
+        REQUIRE(reinterpret_cast<uintptr_t>(b) % 64 == 0);
+        REQUIRE(reinterpret_cast<uintptr_t>(c) % 256 == 0);
+    }
+
+    SECTION("Per-frame usage")
+    {
+        REQUIRE(getFrameAllocatorStats().bytesThisFrame == 0);
+        (void)frameAlloc(100);
+        (void)frameAlloc(200);
+        REQUIRE(getFrameAllocatorStats().bytesThisFrame == 300);
+
+        advanceFrameAllocators();
+        REQUIRE(getFrameAllocatorStats().bytesThisFrame == 0);
+    }
+}
+
+TEST_CASE("Frame allocations live until the end of the next frame", "[core][memory]")
+{
+    advanceFrameAllocators();
+    advanceFrameAllocators();
+
+    auto* frameN = frameAllocArray<u32>(16);
+    for (u32 i = 0; i < 16; ++i) {
+        frameN[i] = i;
+    }
+
+    // Frame N+1 allocates from the other buffer and leaves frame N's data intact
+    advanceFrameAllocators();
+    auto* frameN1 = frameAllocArray<u32>(16);
+    std::memset(frameN1, 0xFF, 16 * sizeof(u32));
+    REQUIRE(frameN1 != frameN);
+    for (u32 i = 0; i < 16; ++i) {
+        REQUIRE(frameN[i] == i);
+    }
+
+    // Frame N+2 reuses frame N's buffer
+    advanceFrameAllocators();
+    REQUIRE(frameAllocArray<u32>(16) == frameN);
+}
+
+TEST_CASE("Frame allocator chains blocks on overflow", "[core][memory]")
+{
+    setFrameAllocatorBlockSize(4096);
+    advanceFrameAllocators();
+    advanceFrameAllocators();
+
+    u64 overflowBefore = getFrameAllocatorStats().overflowBlocks;
+    for (int i = 0; i < 8; ++i) {
+        REQUIRE(frameAlloc(1024) != nullptr);
+    }
+    void* large = frameAlloc(512 * 1024);
+    REQUIRE(large != nullptr);
+    std::memset(large, 0, 512 * 1024);
+
+    auto stats = getFrameAllocatorStats();
+    REQUIRE(stats.overflowBlocks > overflowBefore);
+    REQUIRE(stats.bytesThisFrame == 8 * 1024 + 512 * 1024);
+
+    // Two frames later the buffer is coalesced, so the same load fits without overflowing
+    advanceFrameAllocators();
+    advanceFrameAllocators();
+    u64 overflowAfterReset = getFrameAllocatorStats().overflowBlocks;
+    for (int i = 0; i < 8; ++i) {
+        REQUIRE(frameAlloc(1024) != nullptr);
+    }
+    REQUIRE(frameAlloc(512 * 1024) != nullptr);
+    REQUIRE(getFrameAllocatorStats().overflowBlocks == overflowAfterReset);
+
+    setFrameAllocatorBlockSize(DEFAULT_FRAME_BLOCK_SIZE);
+}
+
+TEST_CASE("FrameVector and per-thread arenas", "[core][memory]")
+{
+    advanceFrameAllocators();
+
+    FrameVector<int> values;
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(i);
+    }
+    REQUIRE(values.size() == 1000);
+    REQUIRE(values.back() == 999);
+
+    usize mainBytes = getFrameAllocatorStats().bytesThisFrame;
+    usize workerBytes = 0;
+    std::thread worker([&] {
+        (void)frameAlloc(512);
+        workerBytes = getFrameAllocatorStats().bytesThisFrame;
+    });
+    worker.join();
+
+    REQUIRE(workerBytes == 512);
+    REQUIRE(getFrameAllocatorStats().bytesThisFrame == mainBytes);
+}
@@ -2,9 +2,17 @@
 /// @brief Tests for memory utilities
 
 #include <autophage/core/memory.hpp>
+#include <autophage/core/memory_resource.hpp>
+#include <autophage/core/virtual_memory.hpp>
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <cstring>
+#include <memory_resource>
+#include <set>
+#include <thread>
+#include <vector>
+
 using namespace autophage;
 
 TEST_CASE("Aligned allocation", "[core][memory]")
@@ -163,9 +171,363 @@ TEST_CASE("PoolAllocator", "[core][memory]")
     }
 }
 
+TEST_CASE("GrowablePoolAllocator", "[core][memory]")
+{
+    GrowablePoolAllocator<48, 16> pool(4);
+    REQUIRE(pool.capacity() == 0);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 10; ++i) {
+        void* ptr = pool.alloc();
+        REQUIRE(ptr != nullptr);
+        REQUIRE(reinterpret_cast<uintptr_t>(ptr) % 16 == 0);
+        blocks.push_back(ptr);
+    }
+    REQUIRE(pool.slabCount() == 3);
+    REQUIRE(pool.capacity() == 12);
+    REQUIRE(pool.allocated() == 10);
+
+    std::set<void*> unique(blocks.begin(), blocks.end());
+    REQUIRE(unique.size() == blocks.size());
+
+    for (void* ptr : blocks) {
+        pool.free(ptr);
+    }
+    REQUIRE(pool.allocated() == 0);
+
+    // Freed blocks are reused before growing again
+    for (int i = 0; i < 12; ++i) {
+        REQUIRE(pool.alloc() != nullptr);
+    }
+    REQUIRE(pool.slabCount() == 3);
+}
+
+TEST_CASE("ConcurrentPoolAllocator", "[core][memory]")
+{
+    struct Projectile
+    {
+        u64 owner;
+        f32 position[3];
+    };
+
+    ConcurrentPoolAllocator<sizeof(Projectile), alignof(Projectile)> pool(64);
+
+    SECTION("Workers allocate, main thread frees")
+    {
+        constexpr int WORKERS = 4;
+        constexpr int PER_WORKER = 2000;
+
+        std::vector<std::vector<Projectile*>> created(WORKERS);
+        std::vector<std::thread> threads;
+        for (int w = 0; w < WORKERS; ++w) {
+            threads.emplace_back([&, w] {
+                for (int i = 0; i < PER_WORKER; ++i) {
+                    auto* projectile =
+                        pool.create<Projectile>(Projectile{static_cast<u64>(w), {}});
+                    created[static_cast<usize>(w)].push_back(projectile);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        REQUIRE(pool.allocated() == WORKERS * PER_WORKER);
+
+        std::set<Projectile*> unique;
+        for (int w = 0; w < WORKERS; ++w) {
+            for (Projectile* projectile : created[static_cast<usize>(w)]) {
+                REQUIRE(projectile->owner == static_cast<u64>(w));
+                unique.insert(projectile);
+            }
+        }
+        REQUIRE(unique.size() == WORKERS * PER_WORKER);
+
+        for (Projectile* projectile : unique) {
+            pool.destroy(projectile);
+        }
+        REQUIRE(pool.allocated() == 0);
+        REQUIRE(pool.capacity() >= WORKERS * PER_WORKER);
+    }
+
+    SECTION("Concurrent alloc/free churn stays consistent")
+    {
+        std::vector<std::thread> threads;
+        for (int w = 0; w < 4; ++w) {
+            threads.emplace_back([&] {
+                std::vector<void*> held;
+                for (int i = 0; i < 20000; ++i) {
+                    if (held.size() < 32 && (i % 3) != 0) {
+                        held.push_back(pool.alloc());
+                    } else if (!held.empty()) {
+                        pool.free(held.back());
+                        held.pop_back();
+                    }
+                }
+                for (void* ptr : held) {
+                    pool.free(ptr);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        REQUIRE(pool.allocated() == 0);
+        REQUIRE(pool.capacity() <= 4 * 32 + 64);
+    }
+}
+
 TEST_CASE("MemoryTag toString", "[core][memory]")
 {
     REQUIRE(toString(MemoryTag::Core) == "Core");
     REQUIRE(toString(MemoryTag::ECS) == "ECS");
     REQUIRE(toString(MemoryTag::Profiler) == "Profiler");
 }
+
+TEST_CASE("Tagged allocation tracking", "[core][memory]")
+{
+    MemoryStats before = getMemoryStats(MemoryTag::Audio);
+
+    SECTION("Frees report the allocated size")
+    {
+        void* ptr = taggedAlloc(1000, MemoryTag::Audio);
+        REQUIRE(ptr != nullptr);
+        REQUIRE(taggedAllocationSize(ptr) == 1000);
+        REQUIRE(getMemoryStats(MemoryTag::Audio).currentBytes == before.currentBytes + 1000);
+
+        taggedFree(ptr, MemoryTag::Audio);
+        MemoryStats after = getMemoryStats(MemoryTag::Audio);
+        REQUIRE(after.currentBytes == before.currentBytes);
+        REQUIRE(after.totalAllocatedBytes == before.totalAllocatedBytes + 1000);
+        REQUIRE(after.totalFreedBytes == before.totalFreedBytes + 1000);
+        REQUIRE(after.totalDeallocations == before.totalDeallocations + 1);
+    }
+
+    SECTION("Aligned allocations keep their alignment and size")
+    {
+        void* ptr = taggedAlignedAlloc(300, 256, MemoryTag::Audio);
+        REQUIRE(ptr != nullptr);
+        REQUIRE(reinterpret_cast<uintptr_t>(ptr) % 256 == 0);
+        REQUIRE(taggedAllocationSize(ptr) == 300);
+
+        taggedAlignedFree(ptr, MemoryTag::Audio);
+        REQUIRE(getMemoryStats(MemoryTag::Audio).currentBytes == before.currentBytes);
+    }
+}
+
+namespace {
+
+u64 g_hookSamples = 0;
+u64 g_hookBytes = 0;
+
+void countSample(MemoryTag tag, usize size)
+{
+    if (tag == MemoryTag::Scripting) {
+        ++g_hookSamples;
+        g_hookBytes += size;
+    }
+}
+
+}  // namespace
+
+TEST_CASE("Allocation sample hook", "[core][memory]")
+{
+    g_hookSamples = 0;
+    g_hookBytes = 0;
+    setAllocationSampleHook(countSample, 4096);
+
+    for (int i = 0; i < 64; ++i) {
+        taggedFree(taggedAlloc(1024, MemoryTag::Scripting), MemoryTag::Scripting);
+    }
+    setAllocationSampleHook(nullptr, 0);
+    taggedFree(taggedAlloc(1024, MemoryTag::Scripting), MemoryTag::Scripting);
+
+    // 64 KiB allocated at one sample per 4 KiB
+    REQUIRE(g_hookSamples >= 15);
+    REQUIRE(g_hookSamples <= 17);
+    REQUIRE(g_hookBytes == g_hookSamples * 1024);
+}
+
+TEST_CASE("MemoryTagScope", "[core][memory]")
+{
+    REQUIRE(getCurrentMemoryTag() == MemoryTag::Unknown);
+    {
+        MemoryTagScope outer(MemoryTag::Physics);
+        REQUIRE(getCurrentMemoryTag() == MemoryTag::Physics);
+        {
+            MemoryTagScope inner(MemoryTag::Audio);
+            REQUIRE(getCurrentMemoryTag() == MemoryTag::Audio);
+        }
+        REQUIRE(getCurrentMemoryTag() == MemoryTag::Physics);
+    }
+    REQUIRE(getCurrentMemoryTag() == MemoryTag::Unknown);
+
+    SECTION("Thread counters include tagged allocations")
+    {
+        auto before = getThreadAllocationCounters();
+        taggedFree(taggedAlloc(100, MemoryTag::Debug), MemoryTag::Debug);
+        auto after = getThreadAllocationCounters();
+        REQUIRE(after.allocations >= before.allocations + 1);
+        REQUIRE(after.allocatedBytes >= before.allocatedBytes + 100);
+    }
+
+    if constexpr (isGlobalAllocationTrackingEnabled()) {
+        SECTION("Global new/delete is charged to the current tag")
+        {
+            MemoryStats before = getMemoryStats(MemoryTag::Renderer);
+            {
+                MemoryTagScope scope(MemoryTag::Renderer);
+                auto* values = new std::vector<u64>(1000);
+                REQUIRE(getMemoryStats(MemoryTag::Renderer).currentBytes >=
+                        before.currentBytes + 1000 * sizeof(u64));
+                delete values;
+            }
+            MemoryStats after = getMemoryStats(MemoryTag::Renderer);
+            REQUIRE(after.currentBytes == before.currentBytes);
+            REQUIRE(after.totalAllocations >= before.totalAllocations + 2);
+        }
+    }
+}
+
+TEST_CASE("Memory resource adapters", "[core][memory]")
+{
+    SECTION("LinearMemoryResource bump-allocates from the arena")
+    {
+        LinearAllocator arena(4096);
+        LinearMemoryResource resource(arena);
+
+        std::pmr::vector<u32> values(&resource);
+        values.reserve(16);
+        REQUIRE(arena.used() >= 16 * sizeof(u32));
+        REQUIRE(arena.used() <= 4096);
+
+        usize used = arena.used();
+        values.clear();
+        values.shrink_to_fit();
+        REQUIRE(arena.used() == used);  // Deallocation is a no-op
+
+        REQUIRE_THROWS_AS(resource.allocate(8192), std::bad_alloc);
+    }
+
+    SECTION("PoolMemoryResource serves small blocks from the pool")
+    {
+        PoolAllocator<64> pool(2);
+        std::pmr::monotonic_buffer_resource fallback;
+        PoolMemoryResource<64> resource(pool, &fallback);
+
+        void* a = resource.allocate(48);
+        void* b = resource.allocate(64);
+        REQUIRE(pool.owns(a));
+        REQUIRE(pool.owns(b));
+        REQUIRE(pool.available() == 0);
+
+        // Exhausted pool and oversize requests go upstream
+        void* c = resource.allocate(32);
+        void* d = resource.allocate(256);
+        REQUIRE_FALSE(pool.owns(c));
+        REQUIRE_FALSE(pool.owns(d));
+
+        resource.deallocate(c, 32);
+        resource.deallocate(d, 256);
+        resource.deallocate(a, 48);
+        resource.deallocate(b, 64);
+        REQUIRE(pool.available() == 2);
+    }
+
+    SECTION("TaggedMemoryResource accounts and enforces its budget")
+    {
+        MemoryStats before = getMemoryStats(MemoryTag::Scripting);
+        TaggedMemoryResource resource(MemoryTag::Scripting, 1024);
+
+        {
+            std::pmr::vector<u8> bytes(&resource);
+            bytes.resize(512);
+            REQUIRE(resource.bytesInUse() == 512);
+            REQUIRE(getMemoryStats(MemoryTag::Scripting).currentBytes == before.currentBytes + 512);
+
+            REQUIRE_THROWS_AS(bytes.resize(2048), std::bad_alloc);
+            REQUIRE(resource.rejectedAllocations() == 1);
+            REQUIRE(bytes.size() == 512);
+        }
+
+        REQUIRE(resource.bytesInUse() == 0);
+        REQUIRE(resource.peakBytes() == 512);
+        REQUIRE(getMemoryStats(MemoryTag::Scripting).currentBytes == before.currentBytes);
+
+        resource.setBudget(0);
+        void* large = resource.allocate(4096);
+        REQUIRE(resource.bytesInUse() == 4096);
+        resource.deallocate(large, 4096);
+    }
+}
+
+TEST_CASE("VirtualRange", "[core][memory]")
+{
+    usize page = getPageSize();
+    REQUIRE(page >= 4096);
+    REQUIRE((page & (page - 1)) == 0);
+
+    MemoryStats before = getMemoryStats(MemoryTag::Debug);
+    {
+        VirtualRange range(usize{64} * 1024 * 1024, MemoryTag::Debug);
+        REQUIRE(range.valid());
+        REQUIRE(range.committed() == 0);
+
+        REQUIRE(range.commit(100));
+        REQUIRE(range.committed() >= VirtualRange::MIN_COMMIT_SIZE);
+        Byte* base = range.data();
+        std::memset(base, 0x5A, range.committed());
+
+        // Growth commits in place and keeps earlier contents
+        REQUIRE(range.commit(usize{8} * 1024 * 1024));
+        REQUIRE(range.data() == base);
+        REQUIRE(base[0] == Byte{0x5A});
+        base[range.committed() - 1] = Byte{1};
+        REQUIRE(getMemoryStats(MemoryTag::Debug).currentBytes ==
+                before.currentBytes + range.committed());
+
+        REQUIRE_FALSE(range.commit(range.reserved() + 1));
+
+        range.shrink(page);
+        REQUIRE(range.committed() == page);
+        REQUIRE(base[0] == Byte{0x5A});
+    }
+    REQUIRE(getMemoryStats(MemoryTag::Debug).currentBytes == before.currentBytes);
+}
+
+TEST_CASE("Memory placement", "[core][memory]")
+{
+    usize hugePage = getHugePageSize();
+    REQUIRE(hugePage >= getPageSize());
+    REQUIRE((hugePage & (hugePage - 1)) == 0);
+    REQUIRE(getNumaNodeCount() >= 1);
+    REQUIRE(getCurrentNumaNode() < getNumaNodeCount());
+
+    SECTION("Huge page ranges fall back gracefully")
+    {
+        for (auto policy : {HugePagePolicy::Transparent, HugePagePolicy::Explicit}) {
+            VirtualRange range(usize{16} * 1024 * 1024, MemoryTag::Debug,
+                               MemoryPlacement{.hugePages = policy});
+            REQUIRE(range.valid());
+            if (range.hugePages() != HugePagePolicy::None) {
+                REQUIRE(reinterpret_cast<uintptr_t>(range.data()) % hugePage == 0);
+                REQUIRE(range.commitUnit() == hugePage);
+            }
+
+            REQUIRE(range.commit(100));
+            REQUIRE(range.committed() % range.commitUnit() == 0);
+            std::memset(range.data(), 0x11, range.committed());
+        }
+    }
+
+    SECTION("Ranges can be placed on the local NUMA node")
+    {
+        VirtualRange range(usize{4} * 1024 * 1024, MemoryTag::Debug,
+                           MemoryPlacement::localNode());
+        REQUIRE(range.valid());
+        REQUIRE(range.commit(usize{1} * 1024 * 1024));
+        std::memset(range.data(), 0x22, range.committed());
+        if (range.numaNode() != ANY_NUMA_NODE) {
+            REQUIRE(range.numaNode() == static_cast<i32>(getCurrentNumaNode()));
+        }
+    }
+}
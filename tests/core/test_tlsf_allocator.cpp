@@ -0,0 +1,205 @@
+/// @file test_tlsf_allocator.cpp
+/// @brief Tests for the TLSF allocator
+
+#include <autophage/core/tlsf_allocator.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <memory_resource>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace autophage;
+
+TEST_CASE("TLSF basic allocation", "[core][memory][tlsf]")
+{
+    TlsfAllocator tlsf(TlsfConfig{.poolSize = 1024 * 1024, .growable = false});
+    REQUIRE(tlsf.validate());
+    REQUIRE(tlsf.stats().poolCount == 1);
+
+    SECTION("Allocations are aligned and usable")
+    {
+        void* a = tlsf.alloc(1);
+        void* b = tlsf.alloc(100);
+        void* c = tlsf.alloc(5000);
+        REQUIRE(a != nullptr);
+        REQUIRE(b != nullptr);
+        REQUIRE(c != nullptr);
+        REQUIRE(reinterpret_cast<uintptr_t>(a) % TlsfAllocator::ALIGNMENT == 0);
+        REQUIRE(TlsfAllocator::usableSize(b) >= 100);
+        std::memset(c, 0xAB, 5000);
+        REQUIRE(tlsf.stats().liveAllocations == 3);
+        REQUIRE(tlsf.validate());
+
+        tlsf.free(b);
+        tlsf.free(a);
+        tlsf.free(c);
+        REQUIRE(tlsf.stats().liveAllocations == 0);
+        REQUIRE(tlsf.stats().usedBytes == 0);
+        REQUIRE(tlsf.validate());
+    }
+
+    SECTION("Over-aligned allocations")
+    {
+        std::vector<void*> blocks;
+        for (usize alignment : {32u, 64u, 256u, 4096u}) {
+            void* ptr = tlsf.alloc(48, alignment);
+            REQUIRE(ptr != nullptr);
+            REQUIRE(reinterpret_cast<uintptr_t>(ptr) % alignment == 0);
+            REQUIRE(tlsf.validate());
+            blocks.push_back(ptr);
+        }
+        for (void* ptr : blocks) {
+            tlsf.free(ptr);
+        }
+        REQUIRE(tlsf.validate());
+    }
+
+    SECTION("Freed neighbours coalesce back into one block")
+    {
+        usize freeBefore = tlsf.stats().freeBytes;
+        std::vector<void*> blocks;
+        for (int i = 0; i < 64; ++i) {
+            blocks.push_back(tlsf.alloc(256));
+        }
+        for (usize i = 0; i < blocks.size(); i += 2) {
+            tlsf.free(blocks[i]);
+        }
+        REQUIRE(tlsf.validate());
+        for (usize i = 1; i < blocks.size(); i += 2) {
+            tlsf.free(blocks[i]);
+        }
+        REQUIRE(tlsf.validate());
+        REQUIRE(tlsf.stats().freeBytes == freeBefore);
+
+        // The whole pool is one block again
+        void* whole = tlsf.alloc(1024 * 1024 - 64);
+        REQUIRE(whole != nullptr);
+        tlsf.free(whole);
+    }
+
+    SECTION("Exhaustion without growth returns nullptr")
+    {
+        REQUIRE(tlsf.alloc(2 * 1024 * 1024) == nullptr);
+        REQUIRE(tlsf.stats().poolCount == 1);
+    }
+}
+
+TEST_CASE("TLSF randomized alloc/free keeps invariants", "[core][memory][tlsf]")
+{
+    TlsfAllocator tlsf(TlsfConfig{.poolSize = 256 * 1024});
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<usize> sizeDist(1, 4096);
+    std::uniform_int_distribution<int> alignDist(4, 8);
+
+    struct Live
+    {
+        u8* ptr;
+        usize size;
+        u8 fill;
+    };
+    std::vector<Live> live;
+
+    for (int i = 0; i < 20000; ++i) {
+        if (live.empty() || rng() % 3 != 0) {
+            usize size = sizeDist(rng);
+            usize alignment = usize{1} << alignDist(rng);
+            auto* ptr = static_cast<u8*>(tlsf.alloc(size, alignment));
+            REQUIRE(ptr != nullptr);
+            REQUIRE(reinterpret_cast<uintptr_t>(ptr) % alignment == 0);
+            auto fill = static_cast<u8>(i);
+            std::memset(ptr, fill, size);
+            live.push_back({ptr, size, fill});
+        } else {
+            usize index = rng() % live.size();
+            Live entry = live[index];
+            REQUIRE(entry.ptr[0] == entry.fill);
+            REQUIRE(entry.ptr[entry.size - 1] == entry.fill);
+            tlsf.free(entry.ptr);
+            live[index] = live.back();
+            live.pop_back();
+        }
+        if (i % 1000 == 0) {
+            REQUIRE(tlsf.validate());
+        }
+    }
+
+    REQUIRE(tlsf.stats().poolCount > 1);
+    for (const auto& entry : live) {
+        tlsf.free(entry.ptr);
+    }
+    REQUIRE(tlsf.validate());
+    REQUIRE(tlsf.stats().liveAllocations == 0);
+}
+
+TEST_CASE("TLSF integrates with MemoryStats and pmr", "[core][memory][tlsf]")
+{
+    TlsfAllocator tlsf(TlsfConfig{.poolSize = 1024 * 1024, .tag = MemoryTag::Scripting});
+
+    SECTION("Live allocations are charged to the tag")
+    {
+        MemoryStats before = getMemoryStats(MemoryTag::Scripting);
+        void* ptr = tlsf.alloc(1000);
+        REQUIRE(getMemoryStats(MemoryTag::Scripting).currentBytes >= before.currentBytes + 1000);
+        tlsf.free(ptr);
+        REQUIRE(getMemoryStats(MemoryTag::Scripting).currentBytes == before.currentBytes);
+    }
+
+    SECTION("pmr containers")
+    {
+        std::pmr::vector<u64> values(&tlsf);
+        for (u64 i = 0; i < 10000; ++i) {
+            values.push_back(i);
+        }
+        REQUIRE(values[9999] == 9999);
+        REQUIRE(tlsf.stats().liveAllocations == 1);
+        REQUIRE(tlsf.is_equal(tlsf));
+    }
+}
+
+TEST_CASE("TLSF thread-safe mode", "[core][memory][tlsf]")
+{
+    TlsfAllocator tlsf(TlsfConfig{.poolSize = 512 * 1024, .threadSafe = true});
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&tlsf, t] {
+            std::vector<void*> held;
+            for (int i = 0; i < 5000; ++i) {
+                held.push_back(tlsf.alloc(static_cast<usize>(16 + (i * 37 + t) % 2000)));
+                if (held.size() > 16) {
+                    tlsf.free(held.front());
+                    held.erase(held.begin());
+                }
+            }
+            for (void* ptr : held) {
+                tlsf.free(ptr);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(tlsf.stats().liveAllocations == 0);
+    REQUIRE(tlsf.validate());
+}
+
+TEST_CASE("TLSF pools honour memory placement", "[core][memory][tlsf]")
+{
+    TlsfAllocator tlsf(TlsfConfig{
+        .poolSize = 1024 * 1024,
+        .placement = MemoryPlacement::localNode(HugePagePolicy::Transparent),
+    });
+
+    // Pools are rounded up to whole huge pages
+    REQUIRE(tlsf.stats().reservedBytes % getHugePageSize() == 0);
+
+    void* ptr = tlsf.alloc(1024 * 1024);
+    REQUIRE(ptr != nullptr);
+    std::memset(ptr, 0x33, 1024 * 1024);
+    REQUIRE(tlsf.validate());
+    tlsf.free(ptr);
+}
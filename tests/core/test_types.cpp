@@ -1,6 +1,7 @@
 /// @file test_types.cpp
 /// @brief Tests for core type definitions
 
+#include <autophage/core/type_id.hpp>
 #include <autophage/core/types.hpp>
 
 #include <catch2/catch_test_macros.hpp>
@@ -102,3 +103,19 @@ TEST_CASE("VoidResult fallback type", "[core][types]")
     }
 }
 #endif
+
+namespace type_id_test {
+struct Marker
+{};
+}  // namespace type_id_test
+
+TEST_CASE("Type ids hash the type name only", "[core][types]")
+{
+    // Independent of how the compiler spells the surrounding function signature
+    STATIC_REQUIRE(detail::typeName<int>() == "int");
+    STATIC_REQUIRE(detail::typeName<type_id_test::Marker>() == "type_id_test::Marker");
+    STATIC_REQUIRE(typeId<type_id_test::Marker>() ==
+                   TypeId{detail::fnv1aHash("type_id_test::Marker")});
+    STATIC_REQUIRE(typeId<const type_id_test::Marker&>() == typeId<type_id_test::Marker>());
+    STATIC_REQUIRE(typeId<int>() != typeId<unsigned>());
+}
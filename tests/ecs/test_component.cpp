@@ -3,8 +3,11 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <autophage/core/memory_resource.hpp>
 #include <autophage/ecs/component_storage.hpp>
 
+#include <limits>
+
 using namespace autophage;
 using namespace autophage::ecs;
 
@@ -245,3 +248,86 @@ TEST_CASE("ComponentRegistry", "[ecs][component]") {
         REQUIRE_FALSE(registry.isRegistered<Velocity>());
     }
 }
+
+TEST_CASE("ComponentArray with a memory resource", "[ecs][component]") {
+    TaggedMemoryResource resource(MemoryTag::Components);
+
+    SECTION("Array storage draws from the resource") {
+        ComponentArray<Position> positions(&resource);
+        REQUIRE(positions.resource() == &resource);
+
+        for (u32 i = 0; i < 100; ++i) {
+            positions.set(Entity{i, 1}, {static_cast<float>(i), 0.0f, 0.0f});
+        }
+        REQUIRE(resource.bytesInUse() >= 100 * (sizeof(Position) + sizeof(Entity)));
+        REQUIRE(positions.get(Entity{42, 1})->x == 42.0f);
+
+        positions.clear();
+    }
+
+    SECTION("Registry passes its resource to new arrays") {
+        ComponentRegistry registry(&resource);
+        std::pmr::monotonic_buffer_resource other;
+
+        registry.registerComponent<Velocity>(&other);
+        REQUIRE(registry.getArray<Position>().resource() == &resource);
+        REQUIRE(registry.getArray<Velocity>().resource() == &other);
+
+        registry.setMemoryResource(std::pmr::get_default_resource());
+        REQUIRE(registry.getArray<Health>().resource() == std::pmr::get_default_resource());
+        registry.clear();
+    }
+
+    REQUIRE(resource.bytesInUse() == 0);
+}
+
+TEST_CASE("ComponentArray with reserved storage", "[ecs][component]") {
+    ComponentArray<Position> positions(ReservedStorage{.maxComponents = 100000});
+    REQUIRE(positions.isReserved());
+
+    positions.set(Entity{0, 1}, {1.0f, 2.0f, 3.0f});
+    Position* first = positions.get(Entity{0, 1});
+    const Position* base = positions.data();
+
+    for (u32 i = 1; i < 50000; ++i) {
+        positions.set(Entity{i, 1}, {static_cast<float>(i), 0.0f, 0.0f});
+    }
+
+    // Growth never moves the data
+    REQUIRE(positions.data() == base);
+    REQUIRE(positions.get(Entity{0, 1}) == first);
+    REQUIRE(first->y == 2.0f);
+    REQUIRE(positions.get(Entity{49999, 1})->x == 49999.0f);
+
+    positions.remove(Entity{10, 1});
+    REQUIRE(positions.size() == 49999);
+    REQUIRE_FALSE(positions.has(Entity{10, 1}));
+
+    SECTION("Exceeding the reservation throws") {
+        ComponentArray<Health> small(ReservedStorage{.maxComponents = 4});
+        for (u32 i = 0; i < 4; ++i) {
+            small.set(Entity{i, 1}, {});
+        }
+        REQUIRE_THROWS_AS(small.set(Entity{4, 1}, {}), std::length_error);
+    }
+
+    SECTION("A reservation whose size overflows throws") {
+        constexpr usize tooMany = std::numeric_limits<usize>::max() / sizeof(Position) + 1;
+        REQUIRE_THROWS_AS(ComponentArray<Position>(ReservedStorage{.maxComponents = tooMany}),
+                          std::length_error);
+    }
+
+    SECTION("Removing moves the last component into the gap") {
+        float lastX = positions.data()[positions.size() - 1].x;
+        Position* removed = positions.get(Entity{20, 1});
+        positions.remove(Entity{20, 1});
+        REQUIRE(removed->x == lastX);  // The pointer now sees another entity's component
+    }
+
+    SECTION("Registry registers reserved arrays") {
+        ComponentRegistry registry;
+        registry.registerComponent<Velocity>(ReservedStorage{.maxComponents = 1000});
+        REQUIRE(registry.getArray<Velocity>().isReserved());
+        REQUIRE_FALSE(registry.getArray<Health>().isReserved());
+    }
+}
@@ -5,10 +5,14 @@
 #include <autophage/ecs/system.hpp>
 #include <autophage/ecs/systems.hpp>
 #include <autophage/ecs/world.hpp>
+#include <autophage/profiler/access_tracking.hpp>
 
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <chrono>
+#include <thread>
+
 using namespace autophage;
 using namespace autophage::ecs;
 
@@ -30,6 +34,50 @@ public:
     usize lastEntityCount = 0;
 };
 
+// Allocates scratch memory every update
+class ScratchSystem : public System<ScratchSystem>
+{
+public:
+    ScratchSystem() : System("ScratchSystem") {}
+
+    void update(World& /*world*/, f32 /*dt*/) override
+    {
+        taggedFree(taggedAlloc(256, MemoryTag::Temporary), MemoryTag::Temporary);
+        allocationTag = getCurrentMemoryTag();
+    }
+
+    MemoryTag allocationTag = MemoryTag::Unknown;
+};
+
+// Sleeps for about a millisecond every update
+class SleepSystem : public System<SleepSystem>
+{
+public:
+    SleepSystem() : System("SleepSystem") {}
+
+    void update(World& /*world*/, f32 /*dt*/) override
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+};
+
+// Looks components up entity by entity, jumping around the index space
+class LookupSystem : public System<LookupSystem>
+{
+public:
+    LookupSystem() : System("LookupSystem") {}
+
+    void update(World& world, f32 /*dt*/) override
+    {
+        for (u32 i = 0; i < 10; ++i) {
+            Entity entity{(i * 7) % 10, 1};
+            if (world.hasComponent<Velocity>(entity)) {
+                (void)world.getComponent<Velocity>(entity);
+            }
+        }
+    }
+};
+
 // System that modifies components
 class PositionModifierSystem : public System<PositionModifierSystem>
 {
@@ -342,3 +390,172 @@ TEST_CASE("System replacement (Hot-Swap)", "[ecs][system]")
         REQUIRE(world.getSystem<PositionModifierSystem>() == &newSys);
     }
 }
+
+TEST_CASE("SystemRegistry statistics", "[ecs][system]")
+{
+    World world;
+    for (int i = 0; i < 10; ++i) {
+        Entity e = world.createEntity();
+        world.addComponent<Transform>(e);
+        world.addComponent<Velocity>(e, Velocity{Vec3{1.0f, 0.0f, 0.0f}});
+    }
+
+    SECTION("Each update is timed with entity counts")
+    {
+        world.registerSystem<PositionModifierSystem>();
+        world.registerSystem<CounterSystem>();
+        for (int i = 0; i < 5; ++i) {
+            world.updateSystems(0.016f);
+        }
+
+        auto stats = world.systemRegistry().systemStats();
+        REQUIRE(stats.size() == 2);
+        REQUIRE(stats[0].name == "PositionModifierSystem");
+        REQUIRE(stats[0].invocations == 5);
+        REQUIRE(stats[0].windowSize == 5);
+        REQUIRE(stats[0].lastEntities == 10);
+        REQUIRE(stats[0].meanEntities == Catch::Approx(10.0));
+        REQUIRE(stats[0].minNs <= stats[0].meanNs);
+        REQUIRE(stats[0].meanNs <= stats[0].maxNs);
+        REQUIRE(stats[0].p99Ns <= stats[0].maxNs);
+        REQUIRE(stats[1].lastEntities == 0);
+
+        auto counter = world.systemRegistry().statsFor<CounterSystem>();
+        REQUIRE(counter.has_value());
+        REQUIRE(counter->invocations == 5);
+    }
+
+    SECTION("Timings are in nanoseconds without the profiler")
+    {
+        world.registerSystem<SleepSystem>();
+        for (int i = 0; i < 5; ++i) {
+            world.updateSystems(0.016f);
+        }
+
+        auto sleeper = world.systemRegistry().statsFor<SleepSystem>();
+        REQUIRE(sleeper.has_value());
+        REQUIRE(sleeper->meanNs >= 0.5e6);
+        REQUIRE(sleeper->meanNs <= 5e6);
+        REQUIRE(sleeper->minNs >= 0.5e6);
+    }
+
+    SECTION("Variant systems are tracked per variant")
+    {
+        VelocitySystem& system = world.registerSystem<VelocitySystem>();
+        system.switchVariant(SystemVariant::Scalar);
+        world.updateSystems(0.016f);
+        world.updateSystems(0.016f);
+        system.switchVariant(SystemVariant::SIMD);
+        world.updateSystems(0.016f);
+
+        auto& registry = world.systemRegistry();
+        REQUIRE(registry.statsFor<VelocitySystem>()->invocations == 3);
+        REQUIRE(registry.statsFor<VelocitySystem>(SystemVariant::Scalar)->invocations == 2);
+        REQUIRE(registry.statsFor<VelocitySystem>(SystemVariant::SIMD)->invocations == 1);
+        REQUIRE_FALSE(registry.statsFor<VelocitySystem>(SystemVariant::GPU).has_value());
+        REQUIRE(registry.variantStats().size() == 2);
+    }
+
+    SECTION("Allocations are attributed to the allocating system")
+    {
+        world.registerSystem<CounterSystem>();
+        ScratchSystem& scratch = world.registerSystem<ScratchSystem>();
+        for (int i = 0; i < 3; ++i) {
+            world.updateSystems(0.016f);
+        }
+
+        auto scratchStats = world.systemRegistry().statsFor<ScratchSystem>();
+        REQUIRE(scratchStats->lastAllocations == 1);
+        REQUIRE(scratchStats->meanAllocatedBytes == Catch::Approx(256.0));
+        REQUIRE(scratch.allocationTag == MemoryTag::Systems);
+        if constexpr (!isGlobalAllocationTrackingEnabled()) {
+            REQUIRE(world.systemRegistry().statsFor<CounterSystem>()->lastAllocations == 0);
+        }
+    }
+
+    SECTION("Component accesses are attributed per system")
+    {
+        initProfiler(16);
+        world.registerSystem<PositionModifierSystem>();
+        world.registerSystem<LookupSystem>();
+        beginFrame();
+        world.updateSystems(0.016f);
+        endFrame();
+
+        auto samples = getLastFrameAccess();
+        REQUIRE(samples.size() == 2);
+        for (const auto& sample : samples) {
+            StringView name = getZoneDescriptor(sample.zone)->name;
+            if (name == "PositionModifierSystem") {
+                REQUIRE(sample.counts.linear == 10);
+                REQUIRE(sample.counts.random == 0);
+            } else {
+                REQUIRE(name == "LookupSystem");
+                REQUIRE(sample.counts.linear == 0);
+                REQUIRE(sample.counts.random == 20);
+                REQUIRE(sample.counts.meanStride() > 1.0);
+                // has() then get() of the same entity (earlier tests on this thread may add more)
+                REQUIRE(sample.counts.reuseHits >= 10);
+                REQUIRE(sample.counts.meanReuseDistance() >= 1.0);
+            }
+        }
+
+        beginFrame();
+        endFrame();
+        REQUIRE(getLastFrameAccess().empty());
+        shutdownProfiler();
+    }
+
+    SECTION("Component read/write sets are declared or observed")
+    {
+        world.registerSystem<PositionModifierSystem>();
+        world.registerSystem<LookupSystem>();
+        world.registerSystem<GravitySystem>();
+        world.registerSystem<CounterSystem>();
+        world.registerSystem<CleanupSystem>();
+        world.updateSystems(0.016f);
+
+        auto modifier = world.systemRegistry().statsFor<PositionModifierSystem>();
+        REQUIRE_FALSE(modifier->accessDeclared);
+        REQUIRE(modifier->access.writes == std::vector<TypeId>{typeId<Transform>()});
+        REQUIRE(modifier->access.reads.empty());
+
+        // hasComponent reads, the mutable getComponent then upgrades the read to a write
+        auto lookup = world.systemRegistry().statsFor<LookupSystem>();
+        REQUIRE(lookup->access.writes == std::vector<TypeId>{typeId<Velocity>()});
+        REQUIRE(lookup->access.reads.empty());
+
+        auto gravity = world.systemRegistry().statsFor<GravitySystem>();
+        REQUIRE(gravity->accessDeclared);
+        REQUIRE(gravity->access.writes == std::vector<TypeId>{typeId<Velocity>()});
+        REQUIRE(gravity->access.reads.size() == 2);
+
+        auto counter = world.systemRegistry().statsFor<CounterSystem>();
+        REQUIRE(counter->access.empty());
+
+        auto cleanup = world.systemRegistry().statsFor<CleanupSystem>();
+        REQUIRE(cleanup->access.structural);
+
+        REQUIRE(gravity->access.conflictsWith(lookup->access));
+        REQUIRE_FALSE(gravity->access.conflictsWith(modifier->access));
+        REQUIRE(counter->access.conflictsWith(modifier->access));
+        REQUIRE(cleanup->access.conflictsWith(modifier->access));
+
+        world.systemRegistry().resetStats();
+        world.updateSystems(0.016f);
+        REQUIRE(world.systemRegistry().statsFor<LookupSystem>()->access.writes.size() == 1);
+    }
+
+    SECTION("Disabled profiling and reset")
+    {
+        world.registerSystem<CounterSystem>();
+        world.updateSystems(0.016f);
+        world.systemRegistry().resetStats();
+        REQUIRE(world.systemRegistry().systemStats().empty());
+
+        world.systemRegistry().setProfilingEnabled(false);
+        world.updateSystems(0.016f);
+        REQUIRE(world.systemRegistry().systemStats().empty());
+        REQUIRE(world.getSystem<CounterSystem>()->updateCount == 2);
+    }
+}
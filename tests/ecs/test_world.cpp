@@ -7,6 +7,9 @@
 #include <autophage/ecs/world.hpp>
 #include <autophage/ecs/components.hpp>
 
+#include <array>
+#include <memory_resource>
+
 using namespace autophage;
 using namespace autophage::ecs;
 
@@ -183,6 +186,16 @@ TEST_CASE("World query", "[ecs][world]") {
         REQUIRE(std::find(entities.begin(), entities.end(), e2) != entities.end());
     }
 
+    SECTION("Query entities() into a memory resource") {
+        std::array<std::byte, 256> buffer{};
+        std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(),
+                                                  std::pmr::null_memory_resource());
+        auto entities = world.query<TestPosition, TestVelocity>().entities(&arena);
+
+        REQUIRE(entities.size() == 2);
+        REQUIRE(entities.get_allocator().resource() == &arena);
+    }
+
     SECTION("Query count()") {
         auto q = world.query<TestPosition, TestVelocity>();
         REQUIRE(q.count() == 2);
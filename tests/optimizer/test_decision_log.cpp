@@ -0,0 +1,248 @@
+/// @file test_decision_log.cpp
+/// @brief Tests for the binary decision log and rule replay
+
+#include <catch2/catch_test_macros.hpp>
+#include <autophage/optimizer/decision_log.hpp>
+
+#include <cstdio>
+#include <filesystem>
+
+using namespace autophage;
+using namespace autophage::optimizer;
+
+namespace {
+
+const char* RULES = R"(
+    rule busy priority 1
+        when load > 0.8 hysteresis 0.1
+        do switchVariant PhysicsSystem SIMD
+    end
+    rule idle
+        when load < 0.2
+        do switchVariant PhysicsSystem Scalar
+    end
+)";
+
+/// Load rising and falling twice over 200 frames
+f64 loadAt(u64 frame)
+{
+    u64 phase = frame % 100;
+    return static_cast<f64>(phase < 50 ? phase : 100 - phase) / 50.0;
+}
+
+/// Run rules live over the synthetic load, logging like the optimizer does
+std::vector<LoggedDecision> runLive(DecisionLogWriter& writer)
+{
+    analyzer::StatsCollector stats;
+    RuleEngine engine;
+    REQUIRE(engine.load(RULES));
+
+    std::vector<LoggedDecision> decisions;
+    std::vector<analyzer::SeriesSample> samples;
+    for (u64 frame = 1; frame <= 200; ++frame) {
+        samples.clear();
+        stats.captureSamples(&samples);
+        stats.collect(static_cast<f64>(frame) * 2.0);  // 2s apart: 1s windows hold one sample
+        stats.record("load", loadAt(frame));
+        stats.captureSamples(nullptr);
+        writer.writeFrame(frame, stats.lastTime(), samples, stats.timeSeries());
+
+        for (auto& fired : engine.update(stats)) {
+            writer.writeDecision(frame, fired, true);
+            decisions.push_back({frame, std::move(fired), true});
+        }
+    }
+    return decisions;
+}
+
+}  // namespace
+
+TEST_CASE("Decision log round trip", "[optimizer][decisions]") {
+    auto path = std::filesystem::temp_directory_path() / "autophage_test_decisions.bin";
+
+    DecisionLogWriter writer;
+    REQUIRE(writer.open(path));
+    auto live = runLive(writer);
+
+    analyzer::RegressionResult verdict;
+    verdict.subject = "PhysicsSystem";
+    verdict.baselineLabel = "Scalar";
+    verdict.candidateLabel = "SIMD";
+    verdict.verdict = analyzer::RegressionVerdict::Regressed;
+    verdict.confidence = 0.99;
+    verdict.relativeChange = 0.25;
+    writer.writeEffect(120, verdict, true);
+    writer.close();
+    REQUIRE(live.size() == 5);  // idle, busy, idle, busy, idle
+
+    DecisionLogReader log;
+    REQUIRE(log.load(path));
+    REQUIRE_FALSE(log.truncated());
+    REQUIRE((log.header().flags & DECISION_LOG_FLAG_STATS) != 0);
+    REQUIRE(log.frames().size() == 200);
+    REQUIRE(log.frames()[9].frame == 10);
+    REQUIRE(log.frames()[9].timeSeconds == 20.0);
+
+    SECTION("Decisions keep the statistics that triggered them") {
+        REQUIRE(log.decisions().size() == live.size());
+        const LoggedDecision& first = log.decisions()[0];
+        REQUIRE(first.frame == live[0].frame);
+        REQUIRE(first.applied);
+        REQUIRE(first.fired.rule == "idle");
+        REQUIRE(first.fired.action.kind == RuleActionKind::SwitchVariant);
+        REQUIRE(first.fired.action.argument == "Scalar");
+        REQUIRE(first.fired.inputs.size() == 1);
+        REQUIRE(first.fired.inputs[0].series == "load");
+        REQUIRE(first.fired.inputs[0].stat == MetricStat::Mean);
+        REQUIRE(first.fired.inputs[0].value == loadAt(first.frame));
+    }
+
+    SECTION("Effects") {
+        REQUIRE(log.effects().size() == 1);
+        const LoggedEffect& effect = log.effects()[0];
+        REQUIRE(effect.frame == 120);
+        REQUIRE(effect.rolledBack);
+        REQUIRE(effect.result.subject == "PhysicsSystem");
+        REQUIRE(effect.result.candidateLabel == "SIMD");
+        REQUIRE(effect.result.verdict == analyzer::RegressionVerdict::Regressed);
+        REQUIRE(effect.result.relativeChange == 0.25);
+    }
+
+    SECTION("Replaying the same rules reproduces the decisions") {
+        RuleEngine engine;
+        REQUIRE(engine.load(RULES));
+        auto replayed = replayRules(log, engine);
+        REQUIRE(replayed.size() == live.size());
+        for (usize i = 0; i < live.size(); ++i) {
+            REQUIRE(replayed[i].frame == live[i].frame);
+            REQUIRE(replayed[i].fired.rule == live[i].fired.rule);
+            REQUIRE(replayed[i].fired.inputs[0].value == live[i].fired.inputs[0].value);
+        }
+    }
+
+    SECTION("Alternative rules are evaluated against the same trace") {
+        RuleEngine engine;
+        REQUIRE(engine.load(R"(
+            rule eager
+                when load > 0.5
+                do switchVariant PhysicsSystem SIMD
+            end
+        )"));
+        auto replayed = replayRules(log, engine);
+        REQUIRE(replayed.size() == 2);
+        REQUIRE(replayed[0].frame < live[1].frame);  // Fires before "busy" did
+    }
+
+    SECTION("A truncated tail keeps the records before it") {
+        auto size = std::filesystem::file_size(path);
+        std::filesystem::resize_file(path, size - 3);
+        DecisionLogReader cut;
+        REQUIRE(cut.load(path));
+        REQUIRE(cut.truncated());
+        REQUIRE(cut.frames().size() == 200);
+        REQUIRE(cut.effects().empty());
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Decision log records tuner events", "[optimizer][decisions]") {
+    auto path = std::filesystem::temp_directory_path() / "autophage_test_decisions_tuner.bin";
+
+    TunerEvent trial{"PhysicsSystem", 4, TunerEventKind::Trial, ecs::SystemVariant::Scalar,
+                     ecs::SystemVariant::SIMD, 0.0, std::nullopt};
+    TunerEvent decided = trial;
+    decided.kind = TunerEventKind::Decided;
+    decided.nsPerEntity = 2.5;
+    decided.verdict.emplace();
+    decided.verdict->subject = "PhysicsSystem";
+    decided.verdict->baselineLabel = "Scalar";
+    decided.verdict->candidateLabel = "SIMD";
+    decided.verdict->verdict = analyzer::RegressionVerdict::Improved;
+    decided.verdict->relativeChange = -0.5;
+
+    DecisionLogWriter writer;
+    REQUIRE(writer.open(path));
+    writer.writeTunerEvent(3, trial);
+    writer.writeTunerEvent(7, decided);
+    writer.close();
+
+    DecisionLogReader log;
+    REQUIRE(log.load(path));
+    REQUIRE_FALSE(log.truncated());
+    REQUIRE(log.tunerEvents().size() == 2);
+
+    const LoggedTunerEvent& first = log.tunerEvents()[0];
+    REQUIRE(first.frame == 3);
+    REQUIRE(first.event.kind == TunerEventKind::Trial);
+    REQUIRE(first.event.system == "PhysicsSystem");
+    REQUIRE(first.event.band == 4);
+    REQUIRE(first.event.to == ecs::SystemVariant::SIMD);
+    REQUIRE_FALSE(first.event.verdict.has_value());
+
+    const LoggedTunerEvent& second = log.tunerEvents()[1];
+    REQUIRE(second.event.kind == TunerEventKind::Decided);
+    REQUIRE(second.event.nsPerEntity == 2.5);
+    REQUIRE(second.event.verdict.has_value());
+    REQUIRE(second.event.verdict->relativeChange == -0.5);
+
+    // The verdict is an effect too, marked as the tuner's
+    REQUIRE(log.effects().size() == 1);
+    REQUIRE(log.effects()[0].tuner);
+    REQUIRE(log.effects()[0].frame == 7);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Decision log limits", "[optimizer][decisions]") {
+    auto path = std::filesystem::temp_directory_path() / "autophage_test_decisions_cap.bin";
+
+    SECTION("Logging stops at the size limit") {
+        DecisionLogConfig config;
+        config.flushBytes = 256;
+        config.maxBytes = 4096;
+        DecisionLogWriter writer;
+        REQUIRE(writer.open(path, config));
+        runLive(writer);
+        u64 size = writer.size();
+        writer.close();
+        REQUIRE(size >= config.maxBytes);
+        REQUIRE(size < config.maxBytes + 1024);
+        REQUIRE(std::filesystem::file_size(path) == size);
+
+        DecisionLogReader log;
+        REQUIRE(log.load(path));
+        REQUIRE_FALSE(log.frames().empty());
+        REQUIRE(log.frames().size() < 200);
+    }
+
+    SECTION("Without stats, frames carry no samples") {
+        DecisionLogConfig config;
+        config.recordStats = false;
+        DecisionLogWriter writer;
+        REQUIRE(writer.open(path, config));
+        runLive(writer);
+        writer.close();
+
+        DecisionLogReader log;
+        REQUIRE(log.load(path));
+        REQUIRE(log.header().flags == 0);
+        REQUIRE(log.frames().size() == 200);
+        REQUIRE(log.frames()[0].samples.empty());
+        REQUIRE(log.decisions().size() == 5);
+    }
+
+    SECTION("Other files are rejected") {
+        std::FILE* file = std::fopen(path.string().c_str(), "wb");
+        REQUIRE(file != nullptr);
+        std::fputs("not a decision log", file);
+        std::fclose(file);
+
+        DecisionLogReader log;
+        REQUIRE_FALSE(log.load(path));
+        REQUIRE_FALSE(log.lastError().empty());
+        REQUIRE_FALSE(log.load(path.string() + ".missing"));
+    }
+
+    std::filesystem::remove(path);
+}
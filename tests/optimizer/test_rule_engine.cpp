@@ -0,0 +1,284 @@
+/// @file test_rule_engine.cpp
+/// @brief Tests for the optimizer rule DSL and its evaluation engine
+
+#include <catch2/catch_test_macros.hpp>
+#include <autophage/optimizer/rule_engine.hpp>
+
+#include <cstdio>
+#include <filesystem>
+
+using namespace autophage;
+using namespace autophage::optimizer;
+
+namespace {
+
+/// Samples 2s apart, so the 1s window only ever holds the newest one
+void step(analyzer::StatsCollector& stats, f64& t, f64 load)
+{
+    t += 2.0;
+    stats.collect(t);
+    stats.record("load", load);
+}
+
+void writeText(const std::filesystem::path& path, const char* text)
+{
+    std::FILE* file = std::fopen(path.string().c_str(), "wb");
+    REQUIRE(file != nullptr);
+    std::fputs(text, file);
+    std::fclose(file);
+}
+
+}  // namespace
+
+TEST_CASE("Rule parsing", "[optimizer][rules]") {
+    const char* text = R"(
+        # Comments and blank lines are ignored
+        evaluate every 30
+
+        rule low priority 1
+            when load < 10
+            do setThreadCount 2
+        end
+
+        rule high priority 5 cooldown 600
+            when load max 10s > 0.5 hysteresis 0.1   # trailing comment
+            and  system/Physics.ns slope 5min >= -2
+            do   switchVariant PhysicsSystem SIMD
+            do   migrateLayout Transform SoA
+            do   hotSwap PhysicsSystem physics_v2.cpp
+        end
+    )";
+
+    RuleSet set;
+    String error;
+    REQUIRE(parseRules(text, set, &error));
+    REQUIRE(error.empty());
+    REQUIRE(set.evaluateEvery == 30);
+    REQUIRE(set.rules.size() == 2);
+
+    // Sorted by priority
+    const Rule& high = set.rules[0];
+    REQUIRE(high.name == "high");
+    REQUIRE(high.priority == 5);
+    REQUIRE(high.cooldownFrames == 600);
+    REQUIRE(high.conditions.size() == 2);
+    REQUIRE(high.conditions[0].series == "load");
+    REQUIRE(high.conditions[0].stat == MetricStat::Max);
+    REQUIRE(high.conditions[0].window == analyzer::TimeWindow::Last10s);
+    REQUIRE(high.conditions[0].op == CompareOp::Greater);
+    REQUIRE(high.conditions[0].threshold == 0.5);
+    REQUIRE(high.conditions[0].hysteresis == 0.1);
+    REQUIRE(high.conditions[1].stat == MetricStat::Slope);
+    REQUIRE(high.conditions[1].window == analyzer::TimeWindow::Last5min);
+    REQUIRE(high.conditions[1].op == CompareOp::GreaterEqual);
+    REQUIRE(high.conditions[1].threshold == -2.0);
+    REQUIRE(high.actions.size() == 3);
+    REQUIRE(high.actions[0].kind == RuleActionKind::SwitchVariant);
+    REQUIRE(high.actions[0].target == "PhysicsSystem");
+    REQUIRE(high.actions[0].argument == "SIMD");
+    REQUIRE(high.actions[1].kind == RuleActionKind::MigrateLayout);
+    REQUIRE(high.actions[2].kind == RuleActionKind::HotSwap);
+    REQUIRE(high.actions[2].argument == "physics_v2.cpp");
+
+    // Defaults
+    const Rule& low = set.rules[1];
+    REQUIRE(low.conditions[0].stat == MetricStat::Mean);
+    REQUIRE(low.conditions[0].window == analyzer::TimeWindow::Last1s);
+    REQUIRE(low.actions[0].kind == RuleActionKind::SetThreadCount);
+    REQUIRE(low.actions[0].argument == "2");
+}
+
+TEST_CASE("Rule parse errors name the line", "[optimizer][rules]") {
+    RuleSet set;
+    set.evaluateEvery = 7;
+    String error;
+
+    SECTION("Unknown keyword") {
+        REQUIRE_FALSE(parseRules("rule a\n  whenever load > 1\nend\n", set, &error));
+        REQUIRE(error.starts_with("2:"));
+    }
+    SECTION("Missing end") {
+        REQUIRE_FALSE(parseRules("rule a\nwhen load > 1\ndo setThreadCount 4\n", set, &error));
+        REQUIRE(error.find("missing 'end'") != String::npos);
+    }
+    SECTION("Unknown variant") {
+        REQUIRE_FALSE(parseRules("rule a\nwhen load > 1\ndo switchVariant P AVX\nend\n", set,
+                                 &error));
+        REQUIRE(error.starts_with("3:"));
+    }
+    SECTION("Missing comparison") {
+        REQUIRE_FALSE(parseRules("rule a\nwhen load mean 10\ndo setThreadCount 4\nend\n", set,
+                                 &error));
+        REQUIRE(error.starts_with("2:"));
+    }
+    SECTION("Rule without action") {
+        REQUIRE_FALSE(parseRules("rule a\nwhen load > 1\nend\n", set, &error));
+    }
+    SECTION("Duplicate rule") {
+        const char* text = "rule a\nwhen x > 1\ndo setThreadCount 1\nend\n"
+                           "rule a\nwhen x > 2\ndo setThreadCount 2\nend\n";
+        REQUIRE_FALSE(parseRules(text, set, &error));
+        REQUIRE(error.starts_with("5:"));
+    }
+
+    // Output untouched on failure
+    REQUIRE(set.evaluateEvery == 7);
+    REQUIRE(set.rules.empty());
+}
+
+TEST_CASE("Rules fire on edges with hysteresis", "[optimizer][rules]") {
+    analyzer::StatsCollector stats;
+    RuleEngine engine;
+    REQUIRE(engine.load("rule busy\n when load > 10 hysteresis 2\n do setThreadCount 8\nend\n"));
+
+    f64 t = 0.0;
+    REQUIRE(engine.evaluate(stats).empty());  // Series not recorded yet
+
+    step(stats, t, 5.0);
+    REQUIRE(engine.evaluate(stats).empty());
+
+    step(stats, t, 12.0);
+    auto fired = engine.evaluate(stats);
+    REQUIRE(fired.size() == 1);
+    REQUIRE(fired[0].rule == "busy");
+    REQUIRE(fired[0].action.kind == RuleActionKind::SetThreadCount);
+
+    // Still holding: no second firing
+    step(stats, t, 12.0);
+    REQUIRE(engine.evaluate(stats).empty());
+
+    // Inside the hysteresis band: still active, so dropping to 9 and rising again is silent
+    step(stats, t, 9.0);
+    REQUIRE(engine.evaluate(stats).empty());
+    step(stats, t, 11.0);
+    REQUIRE(engine.evaluate(stats).empty());
+
+    // Below the band: the rule re-arms and fires on the next rise
+    step(stats, t, 7.0);
+    REQUIRE(engine.evaluate(stats).empty());
+    step(stats, t, 11.0);
+    REQUIRE(engine.evaluate(stats).size() == 1);
+}
+
+TEST_CASE("Rule cooldown and evaluation interval", "[optimizer][rules]") {
+    analyzer::StatsCollector stats;
+    RuleEngine engine;
+    f64 t = 0.0;
+
+    SECTION("Cooldown") {
+        REQUIRE(engine.load("rule r cooldown 4\n when load > 10\n do setThreadCount 8\nend\n"));
+        step(stats, t, 20.0);
+        REQUIRE(engine.update(stats).size() == 1);  // Frame 1
+
+        step(stats, t, 0.0);
+        REQUIRE(engine.update(stats).empty());  // Frame 2, re-armed
+        step(stats, t, 20.0);
+        REQUIRE(engine.update(stats).empty());  // Frame 3, cooling down
+        step(stats, t, 20.0);
+        REQUIRE(engine.update(stats).empty());  // Frame 4
+        step(stats, t, 20.0);
+        REQUIRE(engine.update(stats).size() == 1);  // Frame 5
+    }
+
+    SECTION("Evaluate every N frames") {
+        REQUIRE(engine.load("evaluate every 3\nrule r\n when load > 10\n do setThreadCount 8\n"
+                            "end\n"));
+        step(stats, t, 20.0);
+        REQUIRE(engine.update(stats).empty());
+        REQUIRE(engine.update(stats).empty());
+        REQUIRE(engine.update(stats).size() == 1);
+        REQUIRE(engine.frame() == 3);
+    }
+}
+
+TEST_CASE("Rearmed rules fire again while their conditions hold", "[optimizer][rules]") {
+    analyzer::StatsCollector stats;
+    RuleEngine engine;
+    REQUIRE(engine.load("rule r cooldown 100\n when load > 10\n do setThreadCount 8\nend\n"));
+    f64 t = 0.0;
+
+    step(stats, t, 20.0);
+    REQUIRE(engine.update(stats).size() == 1);
+    engine.rearm("r");  // Not applied: no cooldown, retried next evaluation
+
+    step(stats, t, 20.0);
+    REQUIRE(engine.update(stats).size() == 1);
+
+    // Applied this time: armed-off and cooling down
+    step(stats, t, 20.0);
+    REQUIRE(engine.update(stats).empty());
+    step(stats, t, 0.0);
+    REQUIRE(engine.update(stats).empty());
+    step(stats, t, 20.0);
+    REQUIRE(engine.update(stats).empty());
+
+    engine.rearm("r");  // Not active: ignored
+    step(stats, t, 20.0);
+    REQUIRE(engine.update(stats).empty());
+}
+
+TEST_CASE("Higher priority rules own their targets", "[optimizer][rules]") {
+    analyzer::StatsCollector stats;
+    RuleEngine engine;
+    REQUIRE(engine.load(R"(
+        rule fallback priority 1
+            when load > 5
+            do switchVariant PhysicsSystem Scalar
+            do setThreadCount 2
+        end
+        rule preferred priority 9
+            when load > 10
+            do switchVariant PhysicsSystem SIMD
+        end
+    )"));
+
+    f64 t = 0.0;
+    step(stats, t, 20.0);
+    auto fired = engine.evaluate(stats);
+    REQUIRE(fired.size() == 1);
+    REQUIRE(fired[0].rule == "preferred");
+
+    // The lower rule stays suppressed while the higher one holds
+    step(stats, t, 20.0);
+    REQUIRE(engine.evaluate(stats).empty());
+
+    // Once the higher one lets go, the lower one takes over
+    step(stats, t, 7.0);
+    fired = engine.evaluate(stats);
+    REQUIRE(fired.size() == 2);
+    REQUIRE(fired[0].rule == "fallback");
+    REQUIRE(fired[0].action.argument == "Scalar");
+}
+
+TEST_CASE("Rule files reload when they change", "[optimizer][rules]") {
+    auto path = std::filesystem::temp_directory_path() / "autophage_test_rules.txt";
+    writeText(path, "rule r\n when load > 10\n do setThreadCount 8\nend\n");
+
+    analyzer::StatsCollector stats;
+    RuleEngine engine;
+    REQUIRE(engine.loadFile(path));
+    REQUIRE_FALSE(engine.reloadIfChanged());
+
+    f64 t = 0.0;
+    step(stats, t, 20.0);
+    REQUIRE(engine.evaluate(stats).size() == 1);
+
+    // Same rule name keeps its state: the new action does not fire while still active
+    writeText(path, "rule r\n when load > 10\n do setThreadCount 16\nend\n");
+    auto later = std::filesystem::last_write_time(path) + std::chrono::seconds(2);
+    std::filesystem::last_write_time(path, later);
+    REQUIRE(engine.reloadIfChanged());
+    REQUIRE(engine.rules().rules[0].actions[0].argument == "16");
+    step(stats, t, 20.0);
+    REQUIRE(engine.evaluate(stats).empty());
+
+    // A broken edit keeps the previous rules
+    writeText(path, "rule r\n when load >\nend\n");
+    std::filesystem::last_write_time(path, later + std::chrono::seconds(2));
+    REQUIRE_FALSE(engine.reloadIfChanged());
+    REQUIRE(engine.lastError().find("2:") != String::npos);
+    REQUIRE(engine.rules().rules.size() == 1);
+    REQUIRE(engine.rules().rules[0].actions[0].argument == "16");
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,133 @@
+/// @file test_tuning_profile.cpp
+/// @brief Tests for tuning results persisted across runs
+
+#include <catch2/catch_test_macros.hpp>
+#include <autophage/optimizer/tuning_profile.hpp>
+
+#include <cstdio>
+#include <filesystem>
+
+using namespace autophage;
+using namespace autophage::optimizer;
+using ecs::SystemVariant;
+
+namespace {
+
+TunedBand makeBand(const char* system, u32 band, SystemVariant chosen)
+{
+    TunedBand tuned;
+    tuned.system = system;
+    tuned.band = band;
+    tuned.chosen = chosen;
+    tuned.arms.push_back({SystemVariant::Scalar, {32.0, 8.25, 0.5}});
+    tuned.arms.push_back({SystemVariant::SIMD, {32.0, 4.125, 0.25}});
+    return tuned;
+}
+
+}  // namespace
+
+TEST_CASE("Tuning profile key", "[optimizer][profile]") {
+    TuningProfileKey key = TuningProfileKey::current();
+    REQUIRE_FALSE(key.cpuModel.empty());
+    REQUIRE(key.logicalCores >= 1);
+    REQUIRE(key.buildHash.size() == 16);
+    REQUIRE(key == TuningProfileKey::current());
+}
+
+TEST_CASE("Tuning profile entries", "[optimizer][profile]") {
+    TuningProfileKey here = TuningProfileKey::current();
+    TuningProfileKey elsewhere{"Other CPU @ 3.0GHz", 64, "0123456789abcdef"};
+
+    TuningProfile profile;
+    profile.store(here, {makeBand("PhysicsSystem", 4, SystemVariant::SIMD)});
+    profile.store(elsewhere, {makeBand("PhysicsSystem", 4, SystemVariant::Scalar)});
+    REQUIRE(profile.size() == 2);
+
+    // Same key, system and band replaces
+    profile.store(here, {makeBand("PhysicsSystem", 4, SystemVariant::Scalar),
+                         makeBand("PhysicsSystem", 2, SystemVariant::Scalar)});
+    REQUIRE(profile.size() == 3);
+
+    auto bands = profile.bandsFor(here);
+    REQUIRE(bands.size() == 2);
+    REQUIRE(bands[0].chosen == SystemVariant::Scalar);
+    REQUIRE(profile.bandsFor(elsewhere).size() == 1);
+}
+
+TEST_CASE("Tuning profile files", "[optimizer][profile]") {
+    auto path = std::filesystem::temp_directory_path() / "autophage_test_profile.txt";
+    TuningProfileKey here = TuningProfileKey::current();
+    TuningProfileKey elsewhere{"Other CPU @ 3.0GHz", 64, "0123456789abcdef"};
+
+    TuningProfile profile;
+    profile.store(here, {makeBand("PhysicsSystem", 4, SystemVariant::SIMD),
+                         makeBand("VelocitySystem", 1, SystemVariant::Scalar)});
+    profile.store(elsewhere, {makeBand("PhysicsSystem", 4, SystemVariant::Scalar)});
+    REQUIRE(profile.save(path));
+    REQUIRE_FALSE(std::filesystem::exists(path.string() + ".tmp"));
+    REQUIRE_FALSE(std::filesystem::exists(path.string() + ".lock"));
+
+    SECTION("Round trip keeps every machine's entries") {
+        TuningProfile loaded;
+        REQUIRE(loaded.load(path));
+        REQUIRE(loaded.size() == 3);
+
+        auto bands = loaded.bandsFor(here);
+        REQUIRE(bands.size() == 2);
+        REQUIRE(bands[0].system == "PhysicsSystem");
+        REQUIRE(bands[0].band == 4);
+        REQUIRE(bands[0].chosen == SystemVariant::SIMD);
+        REQUIRE(bands[0].arms.size() == 2);
+        REQUIRE(bands[0].arms[1].variant == SystemVariant::SIMD);
+        REQUIRE(bands[0].arms[1].stats.weight == 32.0);
+        REQUIRE(bands[0].arms[1].stats.mean == 4.125);
+        REQUIRE(bands[0].arms[1].stats.variance == 0.25);
+        REQUIRE(loaded.bandsFor(elsewhere)[0].chosen == SystemVariant::Scalar);
+    }
+
+    SECTION("Saving merges with entries other processes wrote") {
+        // A second process that loaded before the first one saved
+        TuningProfileKey third{"Third CPU @ 2.0GHz", 8, "fedcba9876543210"};
+        TuningProfile other;
+        other.store(third, {makeBand("PhysicsSystem", 3, SystemVariant::SIMD)});
+        other.store(here, {makeBand("PhysicsSystem", 4, SystemVariant::Scalar)});
+        REQUIRE(other.save(path));
+
+        TuningProfile loaded;
+        REQUIRE(loaded.load(path));
+        REQUIRE(loaded.size() == 4);
+        REQUIRE(loaded.bandsFor(third).size() == 1);
+        REQUIRE(loaded.bandsFor(elsewhere).size() == 1);
+
+        auto bands = loaded.bandsFor(here);
+        REQUIRE(bands.size() == 2);
+        REQUIRE(bands[0].chosen == SystemVariant::Scalar);  // The later save wins per band
+    }
+
+    SECTION("Malformed lines are skipped") {
+        std::FILE* file = std::fopen(path.string().c_str(), "a");
+        REQUIRE(file != nullptr);
+        std::fputs("garbage line\n", file);
+        std::fputs("cpu\t4\thash\tSys\t1\tAVX\tSIMD:1:1:0\n", file);  // Unknown variant
+        std::fclose(file);
+
+        TuningProfile loaded;
+        REQUIRE(loaded.load(path));
+        REQUIRE(loaded.size() == 3);
+    }
+
+    SECTION("Other files are rejected") {
+        std::FILE* file = std::fopen(path.string().c_str(), "w");
+        REQUIRE(file != nullptr);
+        std::fputs("not a profile\n", file);
+        std::fclose(file);
+
+        TuningProfile loaded;
+        loaded.store(here, {makeBand("PhysicsSystem", 4, SystemVariant::SIMD)});
+        REQUIRE_FALSE(loaded.load(path));
+        REQUIRE(loaded.size() == 1);
+        REQUIRE_FALSE(loaded.load(path.string() + ".missing"));
+    }
+
+    std::filesystem::remove(path);
+}
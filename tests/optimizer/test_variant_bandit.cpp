@@ -0,0 +1,85 @@
+/// @file test_variant_bandit.cpp
+/// @brief Tests for bandit selection over system variants
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <autophage/optimizer/variant_bandit.hpp>
+
+#include <array>
+
+using namespace autophage;
+using namespace autophage::optimizer;
+using Catch::Approx;
+
+namespace {
+
+/// Run a bandit over arms with fixed mean costs and +-10% deterministic noise
+std::array<u32, 3> simulate(const BanditConfig& config, const std::array<f64, 3>& costs,
+                            u32 steps, u32 countFrom = 0)
+{
+    VariantBandit bandit(costs.size());
+    std::mt19937_64 rng(config.seed);
+    std::array<u32, 3> picks{};
+    for (u32 step = 0; step < steps; ++step) {
+        usize arm = bandit.choose(config, rng);
+        f64 noise = 1.0 + 0.1 * (static_cast<f64>(step % 5) - 2.0) / 2.0;
+        bandit.record(arm, costs[arm] * noise, config.discount);
+        if (step >= countFrom) {
+            ++picks[arm];
+        }
+    }
+    return picks;
+}
+
+}  // namespace
+
+TEST_CASE("Bandit arm statistics", "[optimizer][bandit]") {
+    VariantBandit bandit(2);
+    REQUIRE_FALSE(bandit.best().has_value());
+
+    bandit.record(0, 2.0, 1.0);
+    bandit.record(0, 4.0, 1.0);
+    bandit.record(0, 6.0, 1.0);
+    REQUIRE(bandit.arm(0).weight == Approx(3.0));
+    REQUIRE(bandit.arm(0).mean == Approx(4.0));
+    REQUIRE(bandit.arm(0).variance == Approx(8.0 / 3.0));
+    REQUIRE(bandit.best() == 0u);
+
+    SECTION("Untried arms are chosen first and assumed slow") {
+        BanditConfig config;
+        std::mt19937_64 rng(1);
+        REQUIRE(bandit.choose(config, rng) == 1);
+        REQUIRE(bandit.expectedCost(1) == Approx(8.0));
+    }
+
+    SECTION("Discounting fades old samples") {
+        for (u32 i = 0; i < 200; ++i) {
+            bandit.record(0, 10.0, 0.9);
+        }
+        REQUIRE(bandit.arm(0).mean == Approx(10.0).margin(1e-6));
+        REQUIRE(bandit.arm(0).weight == Approx(10.0).epsilon(0.01));  // 1 / (1 - 0.9)
+    }
+
+    SECTION("Priors are capped") {
+        bandit.setPrior(1, {1000.0, 1.5, 0.1}, 8.0);
+        REQUIRE(bandit.arm(1).weight == 8.0);
+        REQUIRE(bandit.best() == 1u);
+    }
+}
+
+TEST_CASE("Bandit policies converge to the cheapest arm", "[optimizer][bandit]") {
+    BanditConfig config;
+    std::array<f64, 3> costs = {10.0, 6.0, 8.0};
+
+    SECTION("UCB") {
+        config.policy = BanditPolicy::Ucb;
+        auto picks = simulate(config, costs, 600, 300);
+        REQUIRE(picks[1] >= 270);
+    }
+
+    SECTION("Thompson sampling") {
+        config.policy = BanditPolicy::Thompson;
+        auto picks = simulate(config, costs, 600, 300);
+        REQUIRE(picks[1] >= 270);
+    }
+}
@@ -0,0 +1,289 @@
+/// @file test_variant_tuner.cpp
+/// @brief Tests for online variant benchmarking per entity-count band
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <autophage/optimizer/variant_tuner.hpp>
+
+#include <vector>
+
+using namespace autophage;
+using namespace autophage::optimizer;
+using ecs::SystemVariant;
+
+namespace {
+
+class FakeVariantSystem : public ecs::IVariantSystem
+{
+public:
+    [[nodiscard]] std::vector<SystemVariant> availableVariants() const override
+    {
+        return {SystemVariant::Scalar, SystemVariant::SIMD};
+    }
+
+    [[nodiscard]] SystemVariant currentVariant() const noexcept override { return variant_; }
+
+    bool switchVariant(SystemVariant variant) override
+    {
+        variant_ = variant;
+        ++switches;
+        return true;
+    }
+
+    /// SIMD pays a fixed setup cost, so it only wins on large batches
+    [[nodiscard]] f64 costNs(u64 entities, u32 jitter) const
+    {
+        f64 perEntity = variant_ == SystemVariant::SIMD ? 2.0 : 8.0;
+        f64 setup = variant_ == SystemVariant::SIMD ? simdSetupNs : 0.0;
+        return setup + perEntity * static_cast<f64>(entities) + static_cast<f64>(jitter % 7);
+    }
+
+    f64 simdSetupNs = 2000.0;
+    u32 switches = 0;
+
+private:
+    SystemVariant variant_ = SystemVariant::Scalar;
+};
+
+VariantTunerConfig smallConfig()
+{
+    VariantTunerConfig config;
+    config.windowUpdates = 4;
+    config.rounds = 3;
+    config.warmupUpdates = 1;
+    return config;
+}
+
+/// Run updates until the band of `entities` is decided (or a generous limit is hit)
+void runUntilDecided(VariantTuner& tuner, FakeVariantSystem& system, u64 entities,
+                     std::vector<SystemVariant>* trace = nullptr)
+{
+    for (u32 i = 0; i < 200 && !tuner.chosenVariant("Fake", entities); ++i) {
+        if (trace) {
+            trace->push_back(system.currentVariant());
+        }
+        tuner.observe("Fake", system, system.costNs(entities, i), entities);
+    }
+}
+
+}  // namespace
+
+TEST_CASE("Entity-count bands", "[optimizer][tuner]") {
+    REQUIRE(VariantTuner::bandOf(0) == 0);
+    REQUIRE(VariantTuner::bandOf(3) == 0);
+    REQUIRE(VariantTuner::bandOf(4) == 1);
+    REQUIRE(VariantTuner::bandOf(15) == 1);
+    REQUIRE(VariantTuner::bandOf(16) == 2);
+    REQUIRE(VariantTuner::bandOf(1000) == 4);
+    REQUIRE(VariantTuner::bandStart(0) == 0);
+    REQUIRE(VariantTuner::bandStart(4) == 256);
+    REQUIRE(VariantTuner::bandOf(VariantTuner::bandStart(5) - 1) == 4);
+}
+
+TEST_CASE("Variant tuning per band", "[optimizer][tuner]") {
+    VariantTuner tuner(smallConfig());
+    FakeVariantSystem system;
+
+    SECTION("Variants run interleaved windows") {
+        std::vector<SystemVariant> trace;
+        runUntilDecided(tuner, system, 1000, &trace);
+        REQUIRE(tuner.chosenVariant("Fake", 1000).has_value());
+
+        // Windows of 4 measured updates plus a warmup update after each switch
+        std::vector<SystemVariant> expected;
+        for (u32 round = 0; round < 3; ++round) {
+            expected.insert(expected.end(), 4, SystemVariant::Scalar);
+            expected.insert(expected.end(), 5, SystemVariant::SIMD);
+            expected.push_back(SystemVariant::Scalar);  // Warmup of the next round
+        }
+        expected.pop_back();
+        REQUIRE(trace.size() >= expected.size() - 1);
+        for (usize i = 1; i < expected.size(); ++i) {
+            REQUIRE(trace[i] == expected[i]);
+        }
+    }
+
+    SECTION("Fastest variant wins in each band") {
+        runUntilDecided(tuner, system, 1000);
+        REQUIRE(tuner.chosenVariant("Fake", 1000) == SystemVariant::SIMD);
+        REQUIRE(system.currentVariant() == SystemVariant::SIMD);
+
+        runUntilDecided(tuner, system, 20);
+        REQUIRE(tuner.chosenVariant("Fake", 20) == SystemVariant::Scalar);
+        REQUIRE(tuner.chosenVariant("Fake", 5000) == std::nullopt);  // Band never seen
+
+        // Decided bands apply as soon as the population moves back
+        tuner.observe("Fake", system, 1.0, 1000);
+        REQUIRE(system.currentVariant() == SystemVariant::SIMD);
+        tuner.observe("Fake", system, 1.0, 20);
+        REQUIRE(system.currentVariant() == SystemVariant::Scalar);
+
+        auto choices = tuner.choices();
+        REQUIRE(choices.size() == 2);
+        REQUIRE(choices[0].band == VariantTuner::bandOf(20));
+        REQUIRE(choices[0].minEntities == 16);
+        REQUIRE(choices[0].maxEntities == 64);
+        REQUIRE(choices[1].variant == SystemVariant::SIMD);
+        REQUIRE(choices[1].decided);
+        REQUIRE(choices[1].nsPerEntity > 0.0);
+    }
+
+    SECTION("Original variant kept without a significant win") {
+        // 1000 entities at 8 ns vs 2000 + 1000 * 2 ns: SIMD is only ~50% cheaper at this size,
+        // so demand more than that
+        VariantTunerConfig config = smallConfig();
+        config.minImprovement = 0.6;
+        VariantTuner strict(config);
+        runUntilDecided(strict, system, 1000);
+        REQUIRE(strict.chosenVariant("Fake", 1000) == SystemVariant::Scalar);
+    }
+
+    SECTION("Pinned systems are left alone") {
+        tuner.pin("Fake");
+        REQUIRE(tuner.isPinned("Fake"));
+        for (u32 i = 0; i < 50; ++i) {
+            tuner.observe("Fake", system, system.costNs(1000, i), 1000);
+        }
+        REQUIRE(system.switches == 0);
+        REQUIRE_FALSE(tuner.chosenVariant("Fake", 1000).has_value());
+
+        tuner.unpin("Fake");
+        runUntilDecided(tuner, system, 1000);
+        REQUIRE(tuner.chosenVariant("Fake", 1000) == SystemVariant::SIMD);
+    }
+
+    SECTION("Switches and decisions are recorded as events") {
+        tuner.recordEvents(true);
+        runUntilDecided(tuner, system, 1000);
+        auto events = tuner.takeEvents();
+        REQUIRE(tuner.takeEvents().empty());
+
+        usize trials = 0;
+        const TunerEvent* decided = nullptr;
+        for (const auto& event : events) {
+            REQUIRE(event.system == "Fake");
+            REQUIRE(event.band == VariantTuner::bandOf(1000));
+            trials += event.kind == TunerEventKind::Trial;
+            if (event.kind == TunerEventKind::Decided) {
+                decided = &event;
+            }
+        }
+        REQUIRE(trials == 5);  // Every window after the first of round one
+        REQUIRE(decided != nullptr);
+        REQUIRE(decided->from == SystemVariant::Scalar);
+        REQUIRE(decided->to == SystemVariant::SIMD);
+        REQUIRE(decided->verdict.has_value());
+        REQUIRE(decided->verdict->verdict == analyzer::RegressionVerdict::Improved);
+        REQUIRE(decided->verdict->relativeChange < 0.0);
+
+        // The decided band is enforced again after an outside switch
+        f64 decidedCost = decided->nsPerEntity;
+        system.switchVariant(SystemVariant::Scalar);
+        tuner.observe("Fake", system, 1.0, 1000);
+        events = tuner.takeEvents();
+        REQUIRE(events.size() == 1);
+        REQUIRE(events[0].kind == TunerEventKind::Apply);
+        REQUIRE(events[0].from == SystemVariant::Scalar);
+        REQUIRE(events[0].to == SystemVariant::SIMD);
+        REQUIRE(events[0].nsPerEntity == decidedCost);
+    }
+
+    SECTION("Reset forgets decisions") {
+        runUntilDecided(tuner, system, 1000);
+        tuner.reset();
+        REQUIRE_FALSE(tuner.chosenVariant("Fake", 1000).has_value());
+        REQUIRE(tuner.choices().empty());
+    }
+}
+
+TEST_CASE("Bandit variant tuning", "[optimizer][tuner][bandit]") {
+    VariantTunerConfig config;
+    config.strategy = VariantStrategy::Bandit;
+    FakeVariantSystem system;
+
+    auto run = [&](VariantTuner& tuner, u64 entities, u32 updates) {
+        u32 simd = 0;
+        for (u32 i = 0; i < updates; ++i) {
+            tuner.beginFrame();
+            simd += system.currentVariant() == SystemVariant::SIMD ? 1u : 0u;
+            tuner.observe("Fake", system, system.costNs(entities, i), entities);
+        }
+        return simd;
+    };
+
+    SECTION("Converges per band and keeps adapting") {
+        VariantTuner tuner(config);
+        u32 simd = run(tuner, 1000, 300);
+        REQUIRE(tuner.chosenVariant("Fake", 1000) == SystemVariant::SIMD);
+        REQUIRE(simd > 250);
+
+        run(tuner, 20, 300);
+        REQUIRE(tuner.chosenVariant("Fake", 20) == SystemVariant::Scalar);
+        REQUIRE(system.currentVariant() == SystemVariant::Scalar);
+
+        // SIMD gets slower (say, another process now shares the core): the choice follows
+        system.simdSetupNs = 10000.0;
+        run(tuner, 1000, 600);
+        REQUIRE(tuner.chosenVariant("Fake", 1000) == SystemVariant::Scalar);
+        REQUIRE(system.currentVariant() == SystemVariant::Scalar);
+    }
+
+    SECTION("Exploration stays within the frame budget") {
+        // Trying SIMD on 20 entities is expected to cost 160 ns extra; allow none
+        config.bandit.explorationBudgetUs = 0.1;
+        VariantTuner tuner(config);
+        REQUIRE(run(tuner, 20, 100) == 0);
+        REQUIRE_FALSE(tuner.chosenVariant("Fake", 20).has_value());
+
+        tuner.beginFrame();
+        REQUIRE(tuner.explorationBudgetLeftUs() == Catch::Approx(0.1));
+    }
+
+    SECTION("Imported results seed the arms") {
+        std::vector<TunedBand> profile;
+        {
+            VariantTuner tuner(config);
+            run(tuner, 1000, 300);
+            profile = tuner.exportProfile();
+        }
+        REQUIRE(profile.size() == 1);
+        REQUIRE(profile[0].chosen == SystemVariant::SIMD);
+        REQUIRE(profile[0].arms.size() == 2);
+
+        FakeVariantSystem fresh;
+        VariantTuner tuner(config);
+        tuner.importProfile(profile);
+        tuner.observe("Fake", fresh, fresh.costNs(1000, 0), 1000);
+        REQUIRE(tuner.chosenVariant("Fake", 1000) == SystemVariant::SIMD);
+        REQUIRE(fresh.currentVariant() == SystemVariant::SIMD);
+    }
+}
+
+TEST_CASE("Benchmark results survive export and import", "[optimizer][tuner]") {
+    std::vector<TunedBand> profile;
+    {
+        VariantTuner tuner(smallConfig());
+        FakeVariantSystem system;
+        runUntilDecided(tuner, system, 1000);
+        runUntilDecided(tuner, system, 20);
+        profile = tuner.exportProfile();
+    }
+    REQUIRE(profile.size() == 2);
+
+    // A restarted process starts tuned: no benchmarking, the first update applies the choice
+    VariantTuner tuner(smallConfig());
+    FakeVariantSystem system;
+    tuner.importProfile(profile);
+    tuner.observe("Fake", system, 1.0, 1000);
+    REQUIRE(system.currentVariant() == SystemVariant::SIMD);
+    REQUIRE(tuner.chosenVariant("Fake", 1000) == SystemVariant::SIMD);
+    tuner.observe("Fake", system, 1.0, 20);
+    REQUIRE(system.currentVariant() == SystemVariant::Scalar);
+    REQUIRE(system.switches == 2);
+
+    auto exported = tuner.exportProfile();
+    REQUIRE(exported.size() == 2);
+    for (const TunedBand& band : exported) {
+        REQUIRE_FALSE(band.arms.empty());
+    }
+}
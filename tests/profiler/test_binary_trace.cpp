@@ -0,0 +1,164 @@
+/// @file test_binary_trace.cpp
+/// @brief Tests for the binary trace format and reader
+
+#include <catch2/catch_test_macros.hpp>
+#include <autophage/profiler/binary_trace.hpp>
+#include <autophage/profiler/profiler.hpp>
+#include <autophage/profiler/scoped_timer.hpp>
+#include <autophage/profiler/trace.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+using namespace autophage;
+
+TEST_CASE("Binary trace round trip", "[profiler][trace]") {
+    auto path = std::filesystem::temp_directory_path() / "autophage_test_trace.aptrace";
+    initProfiler(100);
+
+    TraceConfig config;
+    config.path = path.string();
+    config.format = TraceFormat::Binary;
+    REQUIRE(startTraceCapture(config));
+
+    for (int frame = 0; frame < 4; ++frame) {
+        beginFrame();
+        {
+            ScopedTimer timer("MainZone");
+            recordCounter("test.binary.spawns", 3);
+        }
+        std::thread worker([] {
+            setProfilerThreadName("BinaryWorker");
+            for (int i = 0; i < 5; ++i) {
+                ScopedTimer timer("WorkerZone");
+            }
+        });
+        worker.join();
+        endFrame();
+    }
+    stopTraceCapture();
+    auto stats = getTraceCaptureStats();
+    shutdownProfiler();
+
+    BinaryTraceReader reader;
+    REQUIRE(reader.open(path.string()));
+    REQUIRE(reader.eventCount() == stats.eventsWritten);
+    REQUIRE(reader.blockCount() > 0);
+
+    u64 zones = 0;
+    u64 frames = 0;
+    u64 counters = 0;
+    i64 lastFrameStart = -1;
+    bool workerNamed = false;
+    auto cursor = reader.events();
+    TraceRecord record;
+    while (cursor.next(record)) {
+        switch (record.type) {
+            case BinaryRecordType::Zone:
+                ++zones;
+                REQUIRE(record.durationNs >= 0);
+                if (reader.name(record.nameId) == "WorkerZone") {
+                    workerNamed |= reader.threadName(record.tid) == "BinaryWorker";
+                }
+                break;
+            case BinaryRecordType::Frame:
+                ++frames;
+                REQUIRE(record.startNs >= lastFrameStart);
+                lastFrameStart = record.startNs;
+                break;
+            case BinaryRecordType::Counter:
+                ++counters;
+                break;
+        }
+    }
+    REQUIRE_FALSE(cursor.failed());
+    REQUIRE(zones + frames + counters == reader.eventCount());
+    REQUIRE(frames == 4);
+    REQUIRE(workerNamed);
+
+    auto zoneStats = reader.zoneStatistics();
+    u64 mainCount = 0;
+    u64 workerCount = 0;
+    for (const auto& zone : zoneStats) {
+        REQUIRE(zone.minNs <= zone.maxNs);
+        REQUIRE(zone.durations.count == zone.count);
+        if (zone.name == "MainZone") {
+            mainCount = zone.count;
+        } else if (zone.name == "WorkerZone") {
+            workerCount = zone.count;
+        }
+    }
+    REQUIRE(mainCount == 4);
+    REQUIRE(workerCount == 20);
+
+    reader.close();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Binary trace reader rejects foreign files", "[profiler][trace]") {
+    auto path = std::filesystem::temp_directory_path() / "autophage_test_not_a_trace.bin";
+    {
+        std::FILE* file = std::fopen(path.string().c_str(), "wb");
+        REQUIRE(file != nullptr);
+        std::fputs("{\"traceEvents\":[]} padding padding padding", file);
+        std::fclose(file);
+    }
+
+    BinaryTraceReader reader;
+    REQUIRE_FALSE(reader.open(path.string()));
+    REQUIRE_FALSE(reader.isOpen());
+    REQUIRE_FALSE(reader.lastError().empty());
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Binary trace reader bounds ids from the file", "[profiler][trace]") {
+    auto path = std::filesystem::temp_directory_path() / "autophage_test_corrupt.aptrace";
+    {
+        std::vector<u8> bytes;
+        auto append = [&](const void* data, usize size) {
+            const auto* raw = static_cast<const u8*>(data);
+            bytes.insert(bytes.end(), raw, raw + size);
+        };
+
+        BinaryTraceHeader header;
+        std::memcpy(header.magic, BINARY_TRACE_MAGIC, sizeof(header.magic));
+        header.version = BINARY_TRACE_VERSION;
+        append(&header, sizeof(header));
+
+        // Id 0 is fine, then an id of ~2^35 that must not size the name table
+        const u8 strings[] = {0x00, 0x01, 'A', 0x80, 0x80, 0x80, 0x80, 0x7F, 0x01, 'B'};
+        BinaryBlockHeader block;
+        block.type = BinaryBlockType::Strings;
+        block.size = sizeof(strings);
+        block.count = 2;
+        append(&block, sizeof(block));
+        append(strings, sizeof(strings));
+
+        const char name[] = "Far";
+        block.type = BinaryBlockType::ThreadName;
+        block.tid = 0xFFFFFFF0u;
+        block.size = 3;
+        block.count = 1;
+        append(&block, sizeof(block));
+        append(name, 3);
+
+        std::FILE* file = std::fopen(path.string().c_str(), "wb");
+        REQUIRE(file != nullptr);
+        std::fwrite(bytes.data(), 1, bytes.size(), file);
+        std::fclose(file);
+    }
+
+    BinaryTraceReader reader;
+    REQUIRE(reader.open(path.string()));
+    REQUIRE(reader.name(0) == "A");
+    REQUIRE(reader.name(1).empty());
+    REQUIRE(reader.threadName(0xFFFFFFF0u) == "Far");
+    REQUIRE(reader.threadName(0).empty());
+
+    reader.close();
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,147 @@
+/// @file test_metrics.cpp
+/// @brief Tests for the profiler metrics registry
+
+#include <catch2/catch_test_macros.hpp>
+#include <autophage/profiler/profiler.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace autophage;
+
+TEST_CASE("Metric registration", "[profiler][metrics]") {
+    MetricId spawns = registerMetric("test.reg.spawns", MetricKind::Counter);
+    REQUIRE(spawns != INVALID_METRIC_ID);
+
+    SECTION("Same name and kind returns same ID") {
+        REQUIRE(registerMetric("test.reg.spawns", MetricKind::Counter) == spawns);
+        REQUIRE(findMetric("test.reg.spawns") == spawns);
+    }
+
+    SECTION("Conflicting kind is rejected") {
+        REQUIRE(registerMetric("test.reg.spawns", MetricKind::Gauge) == INVALID_METRIC_ID);
+    }
+
+    SECTION("Name and kind are queryable") {
+        REQUIRE(getMetricName(spawns) == "test.reg.spawns");
+        REQUIRE(getMetricKind(spawns) == MetricKind::Counter);
+    }
+
+    SECTION("Unknown names are not found") {
+        REQUIRE(findMetric("test.reg.missing") == INVALID_METRIC_ID);
+    }
+}
+
+TEST_CASE("Counters report per-frame deltas", "[profiler][metrics]") {
+    initProfiler(100);
+
+    beginFrame();
+    recordCounter("test.counter.queries", 3);
+    recordCounter("test.counter.queries", 4);
+    endFrame();
+
+    beginFrame();
+    recordCounter("test.counter.queries", 5);
+    endFrame();
+
+    beginFrame();
+    endFrame();
+
+    MetricId id = findMetric("test.counter.queries");
+    REQUIRE(id != INVALID_METRIC_ID);
+
+    auto history = getMetricHistory(id);
+    REQUIRE(history.size() == 3);
+    REQUIRE(history[0] == 7.0);
+    REQUIRE(history[1] == 5.0);
+    REQUIRE(history[2] == 0.0);
+
+    shutdownProfiler();
+}
+
+TEST_CASE("Names in reused buffers resolve by contents", "[profiler][metrics]") {
+    initProfiler(100);
+
+    String name = "test.reuse.first";
+    beginFrame();
+    recordCounter(name.c_str(), 1);
+    name.replace(name.size() - 5, 5, "other");  // Same buffer, new name
+    recordCounter(name.c_str(), 2);
+    endFrame();
+
+    auto first = getMetricHistory(findMetric("test.reuse.first"));
+    auto other = getMetricHistory(findMetric("test.reuse.other"));
+    REQUIRE(first.size() == 1);
+    REQUIRE(first[0] == 1.0);
+    REQUIRE(other.size() == 1);
+    REQUIRE(other[0] == 2.0);
+
+    shutdownProfiler();
+}
+
+TEST_CASE("Counters are summed across threads", "[profiler][metrics]") {
+    initProfiler(100);
+    MetricId id = registerMetric("test.counter.bytes", MetricKind::Counter);
+
+    beginFrame();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([id] {
+            for (int i = 0; i < 1000; ++i) {
+                recordCounter(id, 2);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    endFrame();
+
+    const auto& frame = getCurrentFrameStats();
+    REQUIRE(frame.metrics.size() > id);
+    REQUIRE(frame.metrics[id].value == 8000.0);
+
+    shutdownProfiler();
+}
+
+TEST_CASE("Gauges keep the last value", "[profiler][metrics]") {
+    initProfiler(100);
+
+    beginFrame();
+    recordGauge("test.gauge.agents", 10.0);
+    recordGauge("test.gauge.agents", 12.5);
+    endFrame();
+
+    MetricId id = findMetric("test.gauge.agents");
+    auto history = getMetricHistory(id);
+    REQUIRE(history.size() == 1);
+    REQUIRE(history[0] == 12.5);
+
+    shutdownProfiler();
+}
+
+TEST_CASE("Histograms track distribution", "[profiler][metrics]") {
+    initProfiler(100);
+    MetricId id = registerMetric("test.hist.path_us", MetricKind::Histogram);
+
+    beginFrame();
+    for (int i = 1; i <= 100; ++i) {
+        recordHistogram(id, static_cast<f64>(i));
+    }
+    endFrame();
+
+    const auto& frame = getCurrentFrameStats();
+    REQUIRE(frame.metrics[id].count == 100);
+    REQUIRE(frame.metrics[id].value == 5050.0);
+
+    auto stats = getHistogramStats(id);
+    REQUIRE(stats.count == 100);
+    REQUIRE(stats.min == 1.0);
+    REQUIRE(stats.max == 100.0);
+    REQUIRE(stats.mean() == 50.5);
+    REQUIRE(stats.percentile(0.5) >= 32.0);
+    REQUIRE(stats.percentile(0.5) <= 64.0);
+    REQUIRE(stats.percentile(1.0) == 100.0);
+
+    shutdownProfiler();
+}
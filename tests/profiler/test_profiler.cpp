@@ -2,9 +2,12 @@
 /// @brief Tests for profiler system
 
 #include <catch2/catch_test_macros.hpp>
+#include <autophage/profiler/hardware_counters.hpp>
 #include <autophage/profiler/profiler.hpp>
+#include <autophage/profiler/scoped_timer.hpp>
 
 #include <thread>
+#include <vector>
 #include <chrono>
 
 using namespace autophage;
@@ -73,6 +76,74 @@ TEST_CASE("Profiler statistics", "[profiler]") {
     shutdownProfiler();
 }
 
+TEST_CASE("Per-frame allocation deltas", "[profiler]") {
+    initProfiler(100);
+
+    beginFrame();
+    void* a = taggedAlloc(1000, MemoryTag::Physics);
+    void* b = taggedAlloc(500, MemoryTag::Physics);
+    recordAllocation(64, "Renderer");
+    endFrame();
+
+    const FrameStats& first = getCurrentFrameStats();
+    const auto& physics = first.memoryByTag[static_cast<usize>(MemoryTag::Physics)];
+    REQUIRE(physics.allocations == 2);
+    REQUIRE(physics.allocatedBytes == 1500);
+    REQUIRE(physics.deallocations == 0);
+    REQUIRE(first.memoryByTag[static_cast<usize>(MemoryTag::Renderer)].allocatedBytes == 64);
+    REQUIRE(first.allocationCount >= 3);
+    REQUIRE(first.allocatedBytes >= 1564);
+
+    beginFrame();
+    taggedFree(a, MemoryTag::Physics);
+    endFrame();
+
+    const FrameStats& second = getCurrentFrameStats();
+    const auto& physicsAfter = second.memoryByTag[static_cast<usize>(MemoryTag::Physics)];
+    REQUIRE(physicsAfter.allocations == 0);
+    REQUIRE(physicsAfter.deallocations == 1);
+    REQUIRE(physicsAfter.freedBytes == 1000);
+
+    taggedFree(b, MemoryTag::Physics);
+    recordDeallocation(64, "Renderer");
+    shutdownProfiler();
+}
+
+TEST_CASE("Hardware counters", "[profiler]") {
+    initProfiler(100);
+
+    // Disabled counters report zero
+    beginFrame();
+    endFrame();
+    REQUIRE(getCurrentFrameStats().dtlbMisses == 0);
+    REQUIRE(getCurrentFrameStats().cacheMisses == 0);
+
+    // Counters may be refused in restricted environments; both outcomes are valid
+    HardwareCounterAvailability available = enableHardwareCounters();
+    REQUIRE(areHardwareCountersEnabled() == available.any());
+
+    HardwareCounterValues before = readHardwareCounters();
+    beginFrame();
+    std::vector<u64> touched(1 << 20, 1);
+    u64 sum = 0;
+    for (usize i = 0; i < touched.size(); i += 512) {
+        sum += touched[i];
+    }
+    REQUIRE(sum > 0);
+    endFrame();
+    HardwareCounterValues after = readHardwareCounters();
+
+    REQUIRE(after.dtlbMisses >= before.dtlbMisses);
+    REQUIRE(getCurrentFrameStats().dtlbMisses <= after.dtlbMisses - before.dtlbMisses);
+    if (!available.dtlbMisses) {
+        REQUIRE(after.dtlbMisses == 0);
+    }
+
+    disableHardwareCounters();
+    REQUIRE_FALSE(areHardwareCountersEnabled());
+    shutdownProfiler();
+}
+
 TEST_CASE("Profile zones", "[profiler]") {
     initProfiler(100);
 
@@ -89,6 +160,45 @@ TEST_CASE("Profile zones", "[profiler]") {
         REQUIRE(zones[0].totalTime.count() > 0);
     }
 
+    SECTION("Macro zones resolve to static descriptors") {
+        for (int i = 0; i < 3; ++i) {
+            AUTOPHAGE_PROFILE_SCOPE("MacroZone");
+            AUTOPHAGE_PROFILE_SCOPE_DETAIL("MacroDetailZone");
+        }
+
+        const auto& zones = getZones();
+        REQUIRE(zones.size() == 6);
+        REQUIRE(zones[0].descriptor == zones[2].descriptor);
+        REQUIRE(zones[1].descriptor == zones[3].descriptor);
+        REQUIRE(zones[0].descriptor != zones[1].descriptor);
+        REQUIRE(zones[0].name == std::string("MacroZone"));
+        REQUIRE(zones[0].line > 0);
+
+        ZoneId id = findZone(detail::fnv1aHash("MacroZone"));
+        REQUIRE(id == zones[0].descriptor);
+        REQUIRE(getZoneDescriptor(id)->nameHash == detail::fnv1aHash("MacroZone"));
+    }
+
+    SECTION("Named zones register each site once") {
+        usize before = getZoneDescriptorCount();
+        for (int i = 0; i < 10; ++i) {
+            ScopedTimer timer("RepeatedNamedZone", __FILE__, 1234);
+        }
+        REQUIRE(getZoneDescriptorCount() <= before + 1);
+        REQUIRE(getZones().size() == 10);
+    }
+
     endFrame();
     shutdownProfiler();
 }
+
+TEST_CASE("Zone descriptor registration", "[profiler]") {
+    static constexpr ZoneDescriptor site("RegisteredZone", "file.cpp", 42);
+    static_assert(site.nameHash == detail::fnv1aHash("RegisteredZone"));
+
+    ZoneId first = registerZone(site);
+    REQUIRE(first != INVALID_ZONE_ID);
+    REQUIRE(registerZone(site) == first);
+    REQUIRE(registerZone(ZoneDescriptor("RegisteredZone", "file.cpp", 43)) != first);
+    REQUIRE(getZoneDescriptor(INVALID_ZONE_ID) == nullptr);
+}
@@ -0,0 +1,124 @@
+/// @file test_sampling.cpp
+/// @brief Tests for the sampling profiler
+
+#include <catch2/catch_test_macros.hpp>
+#include <autophage/core/platform.hpp>
+#include <autophage/profiler/allocation_sampling.hpp>
+#include <autophage/profiler/profiler.hpp>
+#include <autophage/profiler/sampling.hpp>
+#include <autophage/profiler/scoped_timer.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace autophage;
+
+namespace {
+
+/// Spin on the CPU so the thread CPU-time timer fires
+u64 burnCpu(std::chrono::milliseconds duration) {
+    volatile u64 sink = 0;
+    auto end = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < end) {
+        for (u64 i = 0; i < 10'000; ++i) {
+            sink = sink + i * i;
+        }
+    }
+    return sink;
+}
+
+[[gnu::noinline]] void allocateFromHotPath(int count) {
+    for (int i = 0; i < count; ++i) {
+        taggedFree(taggedAlloc(256, MemoryTag::Physics), MemoryTag::Physics);
+    }
+}
+
+}  // namespace
+
+#if defined(AUTOPHAGE_PLATFORM_LINUX)
+
+TEST_CASE("Sampling profiler attributes samples to zones", "[profiler][sampling]") {
+    initProfiler(100);
+
+    SamplingConfig config;
+    config.frequencyHz = 1000;
+    REQUIRE(startSamplingProfiler(config));
+    REQUIRE(isSamplingProfilerActive());
+    REQUIRE_FALSE(startSamplingProfiler(config));
+
+    {
+        ScopedTimer timer("SampledZone");
+        burnCpu(std::chrono::milliseconds(300));
+    }
+    stopSamplingProfiler();
+    REQUIRE_FALSE(isSamplingProfilerActive());
+
+    auto report = getSamplingReport();
+    REQUIRE(report.totalSamples > 20);
+    REQUIRE_FALSE(report.zones.empty());
+    REQUIRE(report.zones.front().zone == "SampledZone");
+
+    u64 stackTotal = 0;
+    for (const auto& stack : report.stacks) {
+        REQUIRE(stack.count > 0);
+        stackTotal += stack.count;
+    }
+    REQUIRE(stackTotal == report.totalSamples);
+
+    SECTION("Folded stacks are written one per line") {
+        auto path = std::filesystem::temp_directory_path() / "autophage_test_samples.folded";
+        REQUIRE(writeFoldedStacks(path.string()));
+
+        std::ifstream file(path);
+        std::string line;
+        REQUIRE(std::getline(file, line));
+        REQUIRE(line.rfind("SampledZone", 0) == 0);
+        REQUIRE(line.find_last_of(' ') != std::string::npos);
+        file.close();
+        std::filesystem::remove(path);
+    }
+
+    shutdownProfiler();
+}
+
+TEST_CASE("Allocation sampling captures call sites", "[profiler][sampling]") {
+    AllocationSamplingConfig config;
+    config.sampleIntervalBytes = 1;  // Sample every allocation
+    REQUIRE(startAllocationSampling(config));
+    REQUIRE(isAllocationSamplingActive());
+    REQUIRE_FALSE(startAllocationSampling(config));
+
+    allocateFromHotPath(100);
+    stopAllocationSampling();
+    REQUIRE_FALSE(isAllocationSamplingActive());
+
+    // Not sampled once stopped
+    allocateFromHotPath(10);
+
+    auto report = getAllocationSamplingReport();
+    u64 physicsSamples = 0;
+    u64 physicsBytes = 0;
+    for (const auto& site : report.sites) {
+        if (site.tag == MemoryTag::Physics) {
+            physicsSamples += site.samples;
+            physicsBytes += site.sampledBytes;
+            REQUIRE(site.stack.rfind("Physics", 0) == 0);
+        }
+    }
+    REQUIRE(physicsSamples == 100);
+    REQUIRE(physicsBytes == 100 * 256);
+    REQUIRE(report.estimatedBytes >= physicsBytes);
+}
+
+#else
+
+TEST_CASE("Sampling profiler is unavailable on this platform", "[profiler][sampling]") {
+    REQUIRE_FALSE(startSamplingProfiler());
+    REQUIRE_FALSE(isSamplingProfilerActive());
+    REQUIRE(getSamplingReport().totalSamples == 0);
+    burnCpu(std::chrono::milliseconds(1));
+}
+
+#endif
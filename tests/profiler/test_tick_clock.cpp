@@ -0,0 +1,59 @@
+/// @file test_tick_clock.cpp
+/// @brief Tests for the calibrated tick clock
+
+#include <catch2/catch_test_macros.hpp>
+#include <autophage/profiler/tick_clock.hpp>
+
+#include <chrono>
+#include <thread>
+
+using namespace autophage;
+
+TEST_CASE("Tick clock calibration", "[profiler][clock]") {
+    calibrateTickClock();
+
+    SECTION("Frequency is plausible") {
+        // Anything from a 1 MHz generic timer to a 10 GHz TSC
+        REQUIRE(getTicksPerSecond() > 1e6);
+        REQUIRE(getTicksPerSecond() < 1e10);
+        REQUIRE(getNanosecondsPerTick() > 0.0);
+    }
+
+    SECTION("A non-invariant counter is not used") {
+        if (!isTickClockInvariant()) {
+            REQUIRE_FALSE(isTickClockHardware());
+            REQUIRE(getNanosecondsPerTick() == 1.0);
+        }
+    }
+
+#if defined(AUTOPHAGE_ARCH_X64) || defined(AUTOPHAGE_ARCH_X86) || defined(AUTOPHAGE_ARCH_ARM64)
+    SECTION("An invariant counter is used once calibrated") {
+        if (isTickClockInvariant()) {
+            REQUIRE(isTickClockHardware());
+        }
+    }
+#endif
+
+    SECTION("Ticks are monotonic") {
+        i64 previous = readTicks();
+        for (int i = 0; i < 1000; ++i) {
+            i64 now = readTicks();
+            REQUIRE(now >= previous);
+            previous = now;
+        }
+    }
+
+    SECTION("Converted durations track wall time") {
+        auto wallStart = std::chrono::steady_clock::now();
+        i64 tickStart = readTicks();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        i64 tickEnd = readTicks();
+        auto wallEnd = std::chrono::steady_clock::now();
+
+        auto wallNs = std::chrono::duration_cast<std::chrono::nanoseconds>(wallEnd - wallStart);
+        i64 tickNs = ticksToNanoseconds(tickEnd - tickStart);
+        REQUIRE(tickNs > wallNs.count() * 9 / 10);
+        REQUIRE(tickNs < wallNs.count() * 11 / 10);
+        REQUIRE(ticksToDuration(tickEnd - tickStart).count() == tickNs);
+    }
+}
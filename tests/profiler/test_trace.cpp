@@ -0,0 +1,114 @@
+/// @file test_trace.cpp
+/// @brief Tests for streaming trace capture
+
+#include <catch2/catch_test_macros.hpp>
+#include <autophage/profiler/profiler.hpp>
+#include <autophage/profiler/scoped_timer.hpp>
+#include <autophage/profiler/trace.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace autophage;
+
+namespace {
+
+std::string readFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+}  // namespace
+
+TEST_CASE("Chrome JSON trace capture", "[profiler][trace]") {
+    auto path = std::filesystem::temp_directory_path() / "autophage_test_trace.json";
+    initProfiler(100);
+
+    TraceConfig config;
+    config.path = path.string();
+    REQUIRE(startTraceCapture(config));
+    REQUIRE(isTraceCaptureActive());
+
+    SECTION("Second capture is rejected while running") {
+        REQUIRE_FALSE(startTraceCapture(config));
+    }
+
+    SECTION("Zones, counters and frames from multiple threads are written") {
+        for (int frame = 0; frame < 3; ++frame) {
+            beginFrame();
+            {
+                ScopedTimer timer("MainZone");
+                recordCounter("test.trace.spawns", 2);
+            }
+            std::thread worker([] {
+                setProfilerThreadName("Worker");
+                ScopedTimer timer("WorkerZone");
+            });
+            worker.join();
+            endFrame();
+        }
+        stopTraceCapture();
+
+        auto stats = getTraceCaptureStats();
+        REQUIRE(stats.eventsWritten >= 9);
+        REQUIRE(stats.eventsDropped == 0);
+        REQUIRE(stats.bytesWritten > 0);
+
+        std::string json = readFile(path);
+        REQUIRE(json.find("\"traceEvents\"") != std::string::npos);
+        REQUIRE(json.find("\"MainZone\"") != std::string::npos);
+        REQUIRE(json.find("\"WorkerZone\"") != std::string::npos);
+        REQUIRE(json.find("\"Worker\"") != std::string::npos);
+        REQUIRE(json.find("\"test.trace.spawns\"") != std::string::npos);
+        REQUIRE(json.find("\"Frame\"") != std::string::npos);
+        REQUIRE(json.rfind("]}") != std::string::npos);
+    }
+
+    stopTraceCapture();
+    REQUIRE_FALSE(isTraceCaptureActive());
+    shutdownProfiler();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Trace capture drops instead of blocking when full", "[profiler][trace]") {
+    auto path = std::filesystem::temp_directory_path() / "autophage_test_trace_drop.json";
+    initProfiler(100);
+
+    TraceConfig config;
+    config.path = path.string();
+    config.eventsPerThread = 8;
+    config.flushInterval = std::chrono::milliseconds(60'000);
+    REQUIRE(startTraceCapture(config));
+
+    // This thread's ring was sized by an earlier capture; this capture's capacity still applies
+    auto burst = [] {
+        for (int i = 0; i < 100; ++i) {
+            ScopedTimer timer("Burst");
+        }
+    };
+    burst();
+    stopTraceCapture();
+
+    auto stats = getTraceCaptureStats();
+    REQUIRE(stats.eventsWritten == 8);
+    REQUIRE(stats.eventsDropped == 92);
+
+    SECTION("A later capture with more room resizes the ring") {
+        config.eventsPerThread = 128;
+        REQUIRE(startTraceCapture(config));
+        burst();
+        stopTraceCapture();
+
+        stats = getTraceCaptureStats();
+        REQUIRE(stats.eventsWritten == 100);
+        REQUIRE(stats.eventsDropped == 0);
+    }
+
+    shutdownProfiler();
+    std::filesystem::remove(path);
+}
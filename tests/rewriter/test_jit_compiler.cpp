@@ -0,0 +1,160 @@
+/// @file test_jit_compiler.cpp
+/// @brief Tests for in-process C++ compilation and JIT hot swaps (built with LLVM JIT only)
+
+#include <catch2/catch_test_macros.hpp>
+#include <autophage/ecs/components.hpp>
+#include <autophage/rewriter/hot_swap_manager.hpp>
+#include <autophage/rewriter/jit_compiler.hpp>
+#include <autophage/rewriter/rewriter.hpp>
+
+#include <algorithm>
+
+using namespace autophage;
+using namespace autophage::rewriter;
+
+namespace {
+
+int g_ticks = 0;
+
+int hostValue()
+{
+    return 40;
+}
+
+struct CountingSystem : ecs::System<CountingSystem>
+{
+    CountingSystem() : System("CountingSystem") {}
+    void update(ecs::World& /*world*/, f32 /*dt*/) override { g_ticks += 100; }
+};
+
+struct MoveSystem : ecs::System<MoveSystem>
+{
+    MoveSystem() : System("MoveSystem") {}
+    void update(ecs::World& /*world*/, f32 /*dt*/) override {}
+};
+
+}  // namespace
+
+// Resolved by JIT-compiled code from the test executable's own symbols
+extern "C" void autophage_test_tick()
+{
+    ++g_ticks;
+}
+
+TEST_CASE("JIT compiles C++ source to callable functions", "[rewriter][jit]") {
+    JITCompiler compiler;
+    REQUIRE(compiler.isAvailable());
+
+    SECTION("A plain extern \"C\" function") {
+        void* add = compiler.compile("extern \"C\" int add(int a, int b) { return a + b; }", "add");
+        REQUIRE(add != nullptr);
+        REQUIRE(reinterpret_cast<int (*)(int, int)>(add)(2, 3) == 5);
+    }
+
+    SECTION("Engine headers and C++23 are available") {
+        void* sum = compiler.compile(R"(
+            #include <autophage/core/types.hpp>
+            #include <array>
+            #include <numeric>
+            extern "C" autophage::u64 sum() {
+                constexpr std::array<autophage::u64, 4> values{1, 2, 3, 4};
+                return std::accumulate(values.begin(), values.end(), autophage::u64{0});
+            }
+        )",
+                                     "sum");
+        REQUIRE(sum != nullptr);
+        REQUIRE(reinterpret_cast<u64 (*)()>(sum)() == 10);
+    }
+
+    SECTION("A function name can be compiled again") {
+        void* first = compiler.compile("extern \"C\" int version() { return 1; }", "version");
+        void* second = compiler.compile("extern \"C\" int version() { return 2; }", "version");
+        REQUIRE(first != nullptr);
+        REQUIRE(second != nullptr);
+        REQUIRE(reinterpret_cast<int (*)()>(first)() == 1);
+        REQUIRE(reinterpret_cast<int (*)()>(second)() == 2);
+    }
+
+    SECTION("Registered symbols resolve") {
+        compiler.addSymbol("hostValue", reinterpret_cast<void*>(&hostValue));
+        void* answer = compiler.compile(
+            "extern \"C\" int hostValue();\n"
+            "extern \"C\" int answer() { return hostValue() + 2; }",
+            "answer");
+        REQUIRE(answer != nullptr);
+        REQUIRE(reinterpret_cast<int (*)()>(answer)() == 42);
+    }
+
+    SECTION("Compile errors are reported") {
+        REQUIRE(compiler.compile("extern \"C\" int broken() { return missing; }", "broken") ==
+                nullptr);
+        REQUIRE(compiler.getLastError().find("missing") != std::string::npos);
+    }
+}
+
+TEST_CASE("Systems hot-swap to JIT-compiled source", "[rewriter][jit]") {
+    ecs::World world;
+    world.registerSystem<CountingSystem>();
+    HotSwapManager swapper(world);
+
+    g_ticks = 0;
+    world.update(0.016f);
+    REQUIRE(g_ticks == 100);
+
+    REQUIRE(swapper.hotSwapFromSource("CountingSystem", R"(
+        namespace autophage::ecs { class World; }
+        extern "C" void autophage_test_tick();
+        extern "C" void updateSystem(autophage::ecs::World&, float) { autophage_test_tick(); }
+    )"));
+
+    world.update(0.016f);
+    REQUIRE(g_ticks == 101);
+
+    // The replacement keeps the system's name, so it can be swapped again
+    REQUIRE(swapper.hotSwapFromSource("CountingSystem", R"(
+        namespace autophage::ecs { class World; }
+        extern "C" void autophage_test_tick();
+        extern "C" void updateSystem(autophage::ecs::World&, float) {
+            autophage_test_tick();
+            autophage_test_tick();
+        }
+    )"));
+
+    world.update(0.016f);
+    REQUIRE(g_ticks == 103);
+}
+
+TEST_CASE("Generated system source runs against a World", "[rewriter][jit]") {
+    ecs::World world;
+    for (int i = 0; i < 8; ++i) {
+        ecs::Entity entity = world.createEntity();
+        world.addComponent<ecs::Transform>(entity);
+        world.addComponent<ecs::Velocity>(entity, ecs::Velocity{ecs::Vec3{2.0f, 0.0f, 0.0f}});
+    }
+    ecs::Entity still = world.createEntity();
+    world.addComponent<ecs::Transform>(still);
+    world.registerSystem<MoveSystem>();
+
+    // Full engine headers: queries, component arrays, access and entity accounting
+    Rewriter rewriter;
+    std::string source = rewriter.generateSystemSource(
+        "moveSystem", {"autophage::ecs::Transform", "autophage::ecs::Velocity"},
+        "comp0.position += comp1.linear * dt;");
+
+    HotSwapManager swapper(world);
+    REQUIRE(swapper.hotSwapFromSource("MoveSystem", source, "moveSystem"));
+
+    world.update(0.5f);
+    world.query<ecs::Transform, ecs::Velocity>().forEach(
+        [](ecs::Entity, ecs::Transform& transform, ecs::Velocity&) {
+            REQUIRE(transform.position.x == 1.0f);
+        });
+    REQUIRE(world.getComponent<ecs::Transform>(still)->position.x == 0.0f);
+
+    // The JIT code shares the engine's thread-local accounting
+    auto stats = world.systemRegistry().systemStats();
+    auto move = std::ranges::find(stats, String("MoveSystem"), &ecs::SystemStats::name);
+    REQUIRE(move != stats.end());
+    REQUIRE(move->lastEntities == 8);
+    REQUIRE(std::ranges::binary_search(move->access.writes, typeId<ecs::Transform>()));
+}